@@ -0,0 +1,94 @@
+# Compiles the event table of patch_Settings_Cutscenes.asm into a header, so that the layer doesn't need to parse it from guest memory at startup.
+#   cmake -DCUTSCENE_PATCH=resources/BreathOfTheWild_BetterVR/patch_Settings_Cutscenes.asm -DOUTPUT=cutscene_table_data.h -P cmake/CutsceneTable.cmake
+
+cmake_minimum_required(VERSION 3.25)
+
+if(NOT CUTSCENE_PATCH OR NOT OUTPUT)
+    message(FATAL_ERROR "CUTSCENE_PATCH and OUTPUT need to be set")
+endif()
+
+include("${CMAKE_CURRENT_LIST_DIR}/GraphicPackUtils.cmake")
+
+# needs to match the bits in CutsceneTable
+set(FLAG_FP 1)
+set(FLAG_HND 2)
+set(FLAG_PAN 4)
+set(FLAG_CTRL 8)
+set(FLAG_ALT 16)
+
+read_lines("${CUTSCENE_PATCH}" asm_lines)
+set(event_names "")
+set(guest_entries 0)
+set(checksum 2166136261)
+foreach(line IN LISTS asm_lines)
+    string(REGEX REPLACE "#.*$" "" line "${line}")
+    string(STRIP "${line}" line)
+    if(NOT line MATCHES "^\\.string[ \t]+\"([^\"]*)\"")
+        continue()
+    endif()
+    set(entry "${CMAKE_MATCH_1}")
+    # the guest table ends at the first empty string
+    if(entry STREQUAL "")
+        break()
+    endif()
+    math(EXPR guest_entries "${guest_entries} + 1")
+
+    # entries without settings get skipped by initCutsceneDefaultSettings as well
+    string(REPLACE "," ";" tokens "${entry}")
+    list(LENGTH tokens token_count)
+    if(token_count LESS 2)
+        continue()
+    endif()
+    list(POP_FRONT tokens event_name)
+
+    set(flags 0)
+    foreach(token IN LISTS tokens)
+        if(token STREQUAL "FP_ON")
+            math(EXPR flags "${flags} | ${FLAG_FP}")
+        elseif(token STREQUAL "FP_OFF")
+            math(EXPR flags "${flags} & ~${FLAG_FP}")
+        elseif(token STREQUAL "HND_ON")
+            math(EXPR flags "${flags} & ~${FLAG_HND}")
+        elseif(token STREQUAL "HND_OFF")
+            math(EXPR flags "${flags} | ${FLAG_HND}")
+        elseif(token STREQUAL "PAN_ON")
+            math(EXPR flags "${flags} & ~${FLAG_PAN}")
+        elseif(token STREQUAL "PAN_OFF")
+            math(EXPR flags "${flags} | ${FLAG_PAN}")
+        elseif(token STREQUAL "CTRL_ON")
+            math(EXPR flags "${flags} & ~${FLAG_CTRL}")
+        elseif(token STREQUAL "CTRL_OFF")
+            math(EXPR flags "${flags} | ${FLAG_CTRL}")
+        elseif(token STREQUAL "ALT_ON")
+            math(EXPR flags "${flags} | ${FLAG_ALT}")
+        elseif(token STREQUAL "ALT_OFF")
+            math(EXPR flags "${flags} & ~${FLAG_ALT}")
+        else()
+            message(WARNING "Unknown cutscene setting ${token} for ${event_name}")
+        endif()
+    endforeach()
+
+    fnv1a("${event_name}" name_hash)
+    # same fold as CutsceneTable::MatchesGuestTable, in table order
+    math(EXPR checksum "(${checksum} ^ ${name_hash}) * 16777619 & 0xFFFFFFFF")
+    math(EXPR checksum "(${checksum} ^ ${flags}) * 16777619 & 0xFFFFFFFF")
+
+    # duplicates are resolved like insert_or_assign, the last one wins
+    if(NOT DEFINED event_flags_${event_name})
+        list(APPEND event_names "${event_name}")
+    endif()
+    set(event_flags_${event_name} ${flags})
+    set(event_hash_${event_name} ${name_hash})
+endforeach()
+list(SORT event_names)
+list(LENGTH event_names event_count)
+math(EXPR checksum "${checksum}" OUTPUT_FORMAT HEXADECIMAL)
+
+set(entries "")
+foreach(event_name IN LISTS event_names)
+    string(APPEND entries "        Entry{ \"${event_name}\", ${event_hash_${event_name}}, ${event_flags_${event_name}} },\n")
+endforeach()
+
+message(STATUS "Cutscene table: ${event_count} events from ${guest_entries} entries, checksum ${checksum}")
+
+write_if_changed("${OUTPUT}" "#pragma once\n\n// generated by cmake/CutsceneTable.cmake from patch_Settings_Cutscenes.asm, do not edit\nnamespace CutsceneTableData {\n    constexpr uint32_t GUEST_ENTRY_COUNT = ${guest_entries};\n    constexpr uint32_t CHECKSUM = ${checksum};\n\n    struct Entry {\n        std::string_view name;\n        uint32_t hash;\n        uint8_t flags;\n    };\n\n    // sorted by name\n    constexpr std::array ENTRIES = {\n${entries}    };\n}\n")
@@ -0,0 +1,99 @@
+# Compiles the hook references of the graphic pack's .asm patches into a header that CemuHooks checks its registered hooks against at compile time.
+# Also works as a standalone consistency checker, without needing the rest of the build:
+#   cmake -DGRAPHIC_PACK_DIR=resources/BreathOfTheWild_BetterVR -DHOOK_SOURCE=src/hooking/cemu_hooks.h [-DOUTPUT=graphic_pack_manifest.h] -P cmake/GraphicPackManifest.cmake
+
+cmake_minimum_required(VERSION 3.25)
+
+if(NOT GRAPHIC_PACK_DIR OR NOT HOOK_SOURCE)
+    message(FATAL_ERROR "GRAPHIC_PACK_DIR and HOOK_SOURCE need to be set")
+endif()
+
+include("${CMAKE_CURRENT_LIST_DIR}/GraphicPackUtils.cmake")
+
+# rules.txt version
+set(rules_version 0)
+read_lines("${GRAPHIC_PACK_DIR}/rules.txt" rules_lines)
+foreach(line IN LISTS rules_lines)
+    if(line MATCHES "^version[ \t]*=[ \t]*([0-9]+)")
+        set(rules_version ${CMAKE_MATCH_1})
+        break()
+    endif()
+endforeach()
+
+# collect every import.coreinit.hook_* call outside of comments, with the patch address or code cave label that it's called from
+file(GLOB asm_files "${GRAPHIC_PACK_DIR}/*.asm")
+list(SORT asm_files)
+set(pack_hooks "")
+foreach(asm_file IN LISTS asm_files)
+    get_filename_component(asm_name "${asm_file}" NAME)
+    read_lines("${asm_file}" asm_lines)
+    set(current_label "")
+    foreach(line IN LISTS asm_lines)
+        string(REGEX REPLACE "#.*$" "" line "${line}")
+        string(STRIP "${line}" line)
+        if(line MATCHES "^([A-Za-z_][A-Za-z0-9_]*):")
+            set(current_label "${CMAKE_MATCH_1}")
+        endif()
+        if(line MATCHES "import\\.coreinit\\.(hook_[A-Za-z0-9_]+)")
+            set(hook "${CMAKE_MATCH_1}")
+            if(line MATCHES "^(0x[0-9A-Fa-f]+)[ \t]*=")
+                set(site "${CMAKE_MATCH_1}")
+            elseif(current_label)
+                set(site "${current_label}")
+            else()
+                set(site "codecave")
+            endif()
+            if(NOT hook IN_LIST pack_hooks)
+                list(APPEND pack_hooks "${hook}")
+                set(hook_refs_${hook} 0)
+                set(hook_file_${hook} "${asm_name}")
+                set(hook_site_${hook} "${site}")
+            endif()
+            math(EXPR hook_refs_${hook} "${hook_refs_${hook}} + 1")
+        endif()
+    endforeach()
+endforeach()
+list(SORT pack_hooks)
+
+# collect the hooks that the layer registers
+read_lines("${HOOK_SOURCE}" source_lines)
+set(registered_hooks "")
+foreach(line IN LISTS source_lines)
+    if(line MATCHES "^[ \t]*//")
+        continue()
+    endif()
+    if(line MATCHES "\"(hook_[A-Za-z0-9_]+)\"")
+        list(APPEND registered_hooks "${CMAKE_MATCH_1}")
+    endif()
+endforeach()
+
+# consistency check
+set(issues 0)
+foreach(hook IN LISTS pack_hooks)
+    if(NOT hook IN_LIST registered_hooks)
+        message(WARNING "${hook} is called from ${hook_file_${hook}} (${hook_site_${hook}}) but isn't registered")
+        math(EXPR issues "${issues} + 1")
+    endif()
+endforeach()
+foreach(hook IN LISTS registered_hooks)
+    if(NOT hook IN_LIST pack_hooks)
+        message(WARNING "${hook} is registered but isn't called from any graphic pack patch")
+        math(EXPR issues "${issues} + 1")
+    endif()
+endforeach()
+list(LENGTH pack_hooks pack_hook_count)
+list(LENGTH registered_hooks registered_hook_count)
+message(STATUS "Graphic pack v${rules_version}: ${pack_hook_count} hooks called from patches, ${registered_hook_count} registered, ${issues} issue(s)")
+
+if(NOT OUTPUT)
+    return()
+endif()
+
+set(entries "")
+foreach(hook IN LISTS pack_hooks)
+    string(APPEND entries "        HookReference{ \"${hook}\", ${hook_refs_${hook}}, \"${hook_file_${hook}}\", \"${hook_site_${hook}}\" },\n")
+endforeach()
+
+set(header "#pragma once\n\n// generated by cmake/GraphicPackManifest.cmake from the graphic pack patches, do not edit\nnamespace GraphicPackManifest {\n    constexpr uint32_t RULES_VERSION = ${rules_version};\n\n    struct HookReference {\n        std::string_view name;\n        uint32_t references;\n        std::string_view file;\n        std::string_view site; // patched address, or the code cave label that it's called from\n    };\n\n    constexpr std::array HOOKS = {\n${entries}    };\n}\n")
+
+write_if_changed("${OUTPUT}" "${header}")
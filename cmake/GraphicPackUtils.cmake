@@ -0,0 +1,40 @@
+# Helpers shared by the scripts that compile the graphic pack patches into headers
+
+# reads a file as a list of lines, with characters that'd break cmake lists replaced
+function(read_lines path out_var)
+    file(READ "${path}" content)
+    string(REPLACE "[" "(" content "${content}")
+    string(REPLACE "]" ")" content "${content}")
+    string(REPLACE "\\" "/" content "${content}")
+    string(REPLACE ";" "#" content "${content}")
+    string(REPLACE "\r" "" content "${content}")
+    string(REPLACE "\n" ";" content "${content}")
+    set(${out_var} "${content}" PARENT_SCOPE)
+endfunction()
+
+# 32-bit fnv-1a, needs to match GuestStringHash
+function(fnv1a str out_var)
+    set(hash 2166136261)
+    string(HEX "${str}" hex)
+    string(LENGTH "${hex}" len)
+    if(len GREATER 0)
+        math(EXPR last "${len} - 2")
+        foreach(i RANGE 0 ${last} 2)
+            string(SUBSTRING "${hex}" ${i} 2 byte)
+            math(EXPR hash "(${hash} ^ 0x${byte}) * 16777619 & 0xFFFFFFFF")
+        endforeach()
+    endif()
+    math(EXPR hash "${hash}" OUTPUT_FORMAT HEXADECIMAL)
+    set(${out_var} "${hash}" PARENT_SCOPE)
+endfunction()
+
+# only touch the output when it changes to avoid needless rebuilds
+function(write_if_changed path content)
+    if(EXISTS "${path}")
+        file(READ "${path}" old_content)
+        if(old_content STREQUAL content)
+            return()
+        endif()
+    endif()
+    file(WRITE "${path}" "${content}")
+endfunction()
@@ -21,6 +21,13 @@ namespace sead {
             }
             return std::string(data, strnlen(data, sizeof(data)));
         }
+
+        std::string_view getView() const {
+            if (c_str.getLE() == 0) {
+                return std::string_view();
+            }
+            return std::string_view(data, strnlen(data, sizeof(data)));
+        }
     };
     static_assert(sizeof(FixedSafeString40) == 0x4C, "FixedSafeString40 size mismatch");
 
@@ -33,6 +40,13 @@ namespace sead {
             }
             return std::string(data, strnlen(data, sizeof(data)));
         }
+
+        std::string_view getView() const {
+            if (c_str.getLE() == 0) {
+                return std::string_view();
+            }
+            return std::string_view(data, strnlen(data, sizeof(data)));
+        }
     };
     static_assert(sizeof(FixedSafeString100) == 0x10C, "FixedSafeString100 size mismatch");
 
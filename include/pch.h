@@ -1,14 +1,19 @@
 #pragma once
 
 #include <atomic>
+#include <bit>
 #include <string>
 #include <variant>
 #include <functional>
 #include <type_traits>
 #include <ranges>
 #include <set>
+#include <span>
 #include <unordered_set>
 #include <queue>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <iostream>
 
 #include <Windows.h>
@@ -73,42 +78,7 @@ using Microsoft::WRL::ComPtr;
 
 #define ENABLE_VK_ROBUSTNESS 0
 
-inline glm::fvec2 ToGLM(const XrVector2f& vec) {
-    return glm::make_vec2(&vec.x);
-}
-
-inline glm::fvec3 ToGLM(const XrVector3f& vec) {
-    return glm::make_vec3(&vec.x);
-}
-
-inline glm::fquat ToGLM(const XrQuaternionf& quat) {
-    return glm::fquat(quat.w, quat.x, quat.y, quat.z);
-}
-
-
-inline XrVector2f ToXR(const glm::fvec2& vec) {
-    return { vec.x, vec.y };
-}
-
-inline XrVector3f ToXR(const glm::fvec3& vec) {
-    return { vec.x, vec.y, vec.z };
-}
-
-inline XrQuaternionf ToXR(const glm::fquat& quat) {
-    return { quat.x, quat.y, quat.z, quat.w };
-}
-
-inline glm::fmat4 ToMat4(const glm::fvec3& pos) {
-    return glm::translate(glm::identity<glm::fmat4>(), pos);
-}
-
-inline glm::fmat4 ToMat4(const glm::fquat& rot) {
-    return glm::mat4(rot);
-}
-
-inline glm::fmat4 ToMat4(const glm::fvec3& pos, const glm::fquat& rot) {
-    return ToMat4(pos) * ToMat4(rot);
-}
+#include "xr_glm.h"
 
 
 inline std::string toLower(std::string str) {
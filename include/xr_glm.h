@@ -0,0 +1,40 @@
+#pragma once
+
+// conversions between the OpenXR and glm types, which the tests share with the layer
+
+inline glm::fvec2 ToGLM(const XrVector2f& vec) {
+    return glm::make_vec2(&vec.x);
+}
+
+inline glm::fvec3 ToGLM(const XrVector3f& vec) {
+    return glm::make_vec3(&vec.x);
+}
+
+inline glm::fquat ToGLM(const XrQuaternionf& quat) {
+    return glm::fquat(quat.w, quat.x, quat.y, quat.z);
+}
+
+
+inline XrVector2f ToXR(const glm::fvec2& vec) {
+    return { vec.x, vec.y };
+}
+
+inline XrVector3f ToXR(const glm::fvec3& vec) {
+    return { vec.x, vec.y, vec.z };
+}
+
+inline XrQuaternionf ToXR(const glm::fquat& quat) {
+    return { quat.x, quat.y, quat.z, quat.w };
+}
+
+inline glm::fmat4 ToMat4(const glm::fvec3& pos) {
+    return glm::translate(glm::identity<glm::fmat4>(), pos);
+}
+
+inline glm::fmat4 ToMat4(const glm::fquat& rot) {
+    return glm::mat4(rot);
+}
+
+inline glm::fmat4 ToMat4(const glm::fvec3& pos, const glm::fquat& rot) {
+    return ToMat4(pos) * ToMat4(rot);
+}
@@ -13,6 +13,8 @@ moduleMatches = 0x6267BFD0
 
 ; This modification causes the game to do all the draw calls for all actors, and then present that to the regular screen twice. The Vulkan layer waits for Cemu to draw to the regular screen twice, after which it has obtained both the rendered images for both eyes.
 ; Its not as optimized as it could be since Cemu has to translate the draw calls twice which is usually the bottleneck for emulation, but it provides a great stable image which can later be interpolated so that performance is less of an issue.
+; - hook_BeginCameraSide for the first eye side returns whether the second eye side should be rendered at all. When the Vulkan layer only needs a single eye for a frame, the first eye side renders that eye and the second eye side isn't calculated, and the other eye is reprojected.
+;   The first eye side is still drawn in the second half of the frame, and the next frame skips drawing the second eye side that wasn't calculated. The jobs that would only run on the second eye side are run on the first one instead.
 
 currentEyeSide:
 .int 0
@@ -21,6 +23,10 @@ currentEyeSide:
 currentFrameCounter:
 .int 0
 
+; Set by hook_BeginCameraSide for the first eye side, 0 skips the second eye side for this frame
+renderSecondEyeSide:
+.int 1
+
 0x10463EB0 = FadeProgress__sInstance:
 0x031FB1B4 = sub_31FB1B4_getTimeForGameUpdateMaybe:
 0x0309F72C = sead_GameFramework_lockFrameDrawContext:
@@ -134,12 +140,20 @@ bctrl ; bl calculateUIMaybe
 ; FIRST EYE SIDE
 ; ========================================================================
 
+; the previous frame didn't calculate its second eye side, so there's nothing left to draw that wasn't drawn already
+lis r12, renderSecondEyeSide@ha
+lwz r0, renderSecondEyeSide@l(r12)
+cmpwi r0, 0
+beq skipFirstEyeSideDraw
+
 lwz r12, 0(r30)
 lwz r0, 0xF4(r12)
 mtctr r0
 mr r3, r30
 bctrl ; sead__GameFrameworkCafe__procDraw
 
+skipFirstEyeSideDraw:
+
 ; doesn't seem to be necessary
 ;bl import.gx2.GX2DrawDone
 
@@ -164,7 +178,12 @@ li r0, 0
 lis r12, currentEyeSide@ha
 stw r0, currentEyeSide@l(r12)
 li r3, 0
+lis r12, currentFrameCounter@ha
+lwz r4, currentFrameCounter@l(r12)
 bl import.coreinit.hook_BeginCameraSide
+; store whether the second eye side is rendered this frame
+lis r12, renderSecondEyeSide@ha
+stw r3, renderSecondEyeSide@l(r12)
 
 lwz r12, 0(r30)
 lwz r11, 0xFC(r12)
@@ -223,6 +242,11 @@ skipStallDuringLoadingScreens_one:
 li r3, 0
 bl import.coreinit.hook_EndCameraSide
 
+; the first eye side is always drawn, only calculating the second eye side is skipped
+lis r12, renderSecondEyeSide@ha
+lwz r0, renderSecondEyeSide@l(r12)
+cmpwi r0, 0
+beq skipSecondEyeSide
 
 li r0, 1
 lis r12, currentEyeSide@ha
@@ -242,6 +266,7 @@ mtctr r0
 mr r3, r30
 bctrl ; sead__Framework__procReset
 
+skipSecondEyeSide:
 lwz r12, 0x74(r30)
 clrlwi. r11, r12, 31
 li r31, 1
@@ -8,6 +8,7 @@ moduleMatches = 0x6267BFD0
 ; PAN: PAN_OFF/PAN_ON (Ignore Relative Camera Movement / Disable Panning)
 ; HND: HND_ON/HND_OFF (Disable player hands control / Use animated hands)
 ; CTRL: CTRL_ON/CTRL_OFF (Enable camera input; derived from Demo_EnableCameraInput node presence)
+; ALT: ALT_ON/ALT_OFF (Optional, allow rendering a single eye per frame when Alternate Eyes is enabled; off if left out)
 ; Entries without flags are commented out.
 data_TableOfCutsceneEventsSettings:
 
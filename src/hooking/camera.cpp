@@ -1,4 +1,6 @@
 #include "cemu_hooks.h"
+#include "camera_params.h"
+#include "cutscene_table.h"
 #include "instance.h"
 #include "rendering/openxr.h"
 
@@ -8,6 +10,18 @@ void CemuHooks::hook_BeginCameraSide(PPCInterpreter_t* hCPU) {
 
     OpenXR::EyeSide side = hCPU->gpr[0] == 0 ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
 
+    // the first pass schedules the eyes for the frame counter in r4, and returns whether the second pass renders the right eye
+    if (side == OpenXR::EyeSide::LEFT) {
+        const long frameIdx = (long)hCPU->gpr[4];
+        RND_Renderer* renderer = VRManager::instance().XR->GetRenderer();
+        EyeScheduler::Plan plan = {};
+        if (renderer != nullptr && renderer->IsInitialized()) {
+            plan = renderer->ScheduleEyes(frameIdx, AllowsSingleEyeFrames());
+        }
+        hCPU->gpr[3] = plan.IsSingleEye() ? 0 : 1;
+        side = (OpenXR::EyeSide)plan.firstEye;
+    }
+
     Log::print<RENDERING>("");
     Log::print<RENDERING>("===============================================================================");
     Log::print<RENDERING>("{0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0}", side);
@@ -138,7 +152,7 @@ void CemuHooks::hook_GetRenderCamera(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
     uint32_t cameraIn = hCPU->gpr[3];
     uint32_t cameraOut = hCPU->gpr[12];
-    OpenXR::EyeSide side = hCPU->gpr[11] == 0 ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
+    OpenXR::EyeSide side = VRManager::instance().XR->GetRenderer()->GetRenderSide(hCPU->gpr[11] == 0 ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT);
 
     if (CemuHooks::UseBlackBarsDuringEvents()) {
         return;
@@ -278,7 +292,7 @@ void CemuHooks::hook_GetRenderProjection(PPCInterpreter_t* hCPU) {
 
     uint32_t projectionIn = hCPU->gpr[3];
     uint32_t projectionOut = hCPU->gpr[12];
-    OpenXR::EyeSide side = hCPU->gpr[0] == 0 ? EyeSide::LEFT : EyeSide::RIGHT;
+    OpenXR::EyeSide side = VRManager::instance().XR->GetRenderer()->GetRenderSide(hCPU->gpr[0] == 0 ? EyeSide::LEFT : EyeSide::RIGHT);
 
     BESeadPerspectiveProjection perspectiveProjection = {};
     readMemory(projectionIn, &perspectiveProjection);
@@ -343,7 +357,7 @@ void CemuHooks::hook_ModifyLightPrePassProjectionMatrix(PPCInterpreter_t* hCPU)
     }
 
     uint32_t projectionIn = hCPU->gpr[3];
-    OpenXR::EyeSide side = hCPU->gpr[11] == 0 ? EyeSide::LEFT : EyeSide::RIGHT;
+    OpenXR::EyeSide side = VRManager::instance().XR->GetRenderer()->GetRenderSide(hCPU->gpr[11] == 0 ? EyeSide::LEFT : EyeSide::RIGHT);
 
     BESeadPerspectiveProjection perspectiveProjection = {};
     readMemory(projectionIn, &perspectiveProjection);
@@ -472,6 +486,7 @@ void CemuHooks::hook_CalculateModelOpacity(PPCInterpreter_t* hCPU) {
 std::string CemuHooks::s_currentEvent = {};
 CemuHooks::HybridEventSettings CemuHooks::s_currentEventSettings = {};
 std::unordered_map<std::string, CemuHooks::HybridEventSettings> CemuHooks::s_eventSettings = {};
+bool CemuHooks::s_useCompiledCutsceneTable = false;
 
 constexpr CemuHooks::HybridEventSettings defaultFirstPersonSettings = {
     .firstPerson = true,
@@ -479,71 +494,70 @@ constexpr CemuHooks::HybridEventSettings defaultFirstPersonSettings = {
     .ignoreCameraRotation = true
 };
 
+static CemuHooks::HybridEventSettings ToEventSettings(uint8_t flags) {
+    return {
+        .firstPerson = (flags & CutsceneTable::FIRST_PERSON) != 0,
+        .disablePlayerDrivenLinkHands = (flags & CutsceneTable::DISABLE_PLAYER_DRIVEN_HANDS) != 0,
+        .ignoreCameraRotation = (flags & CutsceneTable::IGNORE_CAMERA_ROTATION) != 0,
+        .demoEnableCameraInput = (flags & CutsceneTable::DEMO_ENABLE_CAMERA_INPUT) != 0,
+        .alternateEyes = (flags & CutsceneTable::ALTERNATE_EYES) != 0
+    };
+}
+
+static void parseGuestCutsceneTable(const char* currPtr, std::unordered_map<std::string, CemuHooks::HybridEventSettings>& eventSettings) {
+    while (*currPtr != '\0') {
+        std::string_view line(currPtr);
+        currPtr += line.size() + 1;
+
+        std::string_view eventName;
+        uint8_t flags = 0;
+        if (CutsceneTable::ParseEntry(line, eventName, flags)) {
+            eventSettings.insert_or_assign(std::string(eventName), ToEventSettings(flags));
+        }
+    }
+}
+
 void CemuHooks::initCutsceneDefaultSettings(uint32_t ppc_TableOfCutsceneEventsSettingsOffset) {
-    if (!s_eventSettings.empty()) {
+    if (s_useCompiledCutsceneTable || !s_eventSettings.empty()) {
+        return;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    const char* tablePtr = reinterpret_cast<const char*>(s_memoryBaseAddress + ppc_TableOfCutsceneEventsSettingsOffset);
+
+    // the graphic pack can be edited without rebuilding the layer, so only use the compiled table if it's still identical
+    if (CutsceneTable::MatchesGuestTable(tablePtr)) {
+        s_useCompiledCutsceneTable = true;
+        const auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
+        Log::print<INFO>("Using compiled cutscene settings for {} events (validated in {:.3f}ms, {} KB)", CutsceneTable::GetEventCount(), duration.count(), CutsceneTable::GetMemoryFootprint() / 1024);
         return;
     }
 
-    char* currPtr = reinterpret_cast<char*>(s_memoryBaseAddress + ppc_TableOfCutsceneEventsSettingsOffset);
-    while (true) {
-        const std::string line(currPtr);
-        if (line.empty()) {
-            break;
+    parseGuestCutsceneTable(tablePtr, s_eventSettings);
+
+    size_t memoryFootprint = s_eventSettings.bucket_count() * sizeof(void*);
+    for (const auto& [eventName, settings] : s_eventSettings) {
+        memoryFootprint += sizeof(std::pair<const std::string, HybridEventSettings>) + sizeof(void*) * 2;
+        if (eventName.capacity() >= sizeof(std::string)) {
+            memoryFootprint += eventName.capacity() + 1;
         }
-        size_t commaPos = line.find(',');
-        if (commaPos != std::string::npos) {
-            HybridEventSettings entry = {};
-            std::string settingsStr = line.substr(commaPos + 1);
-            std::string eventName = line.substr(0, commaPos);
-            size_t pos = 0;
-            while ((pos = settingsStr.find(',')) != std::string::npos) {
-                std::string setting = settingsStr.substr(0, pos);
-                if (setting == "FP_ON") entry.firstPerson = true;
-                else if (setting == "FP_OFF")
-                    entry.firstPerson = false;
-                else if (setting == "HND_ON")
-                    entry.disablePlayerDrivenLinkHands = false;
-                else if (setting == "HND_OFF")
-                    entry.disablePlayerDrivenLinkHands = true;
-                else if (setting == "PAN_ON")
-                    entry.ignoreCameraRotation = false;
-                else if (setting == "PAN_OFF")
-                    entry.ignoreCameraRotation = true;
-                else if (setting == "CTRL_ON")
-                    entry.demoEnableCameraInput = false;
-                else if (setting == "CTRL_OFF")
-                    entry.demoEnableCameraInput = true;
-                else {
-                    Log::print<WARNING>("Unknown cutscene default setting: {}", setting);
-                }
-                settingsStr.erase(0, pos + 1);
-            }
-            // last setting
-            std::string setting = settingsStr;
-            if (setting == "FP_ON") entry.firstPerson = true;
-            else if (setting == "FP_OFF")
-                entry.firstPerson = false;
-            else if (setting == "HND_ON")
-                entry.disablePlayerDrivenLinkHands = false;
-            else if (setting == "HND_OFF")
-                entry.disablePlayerDrivenLinkHands = true;
-            else if (setting == "PAN_ON")
-                entry.ignoreCameraRotation = false;
-            else if (setting == "PAN_OFF")
-                entry.ignoreCameraRotation = true;
-            else if (setting == "CTRL_ON")
-                entry.demoEnableCameraInput = false;
-            else if (setting == "CTRL_OFF")
-                entry.demoEnableCameraInput = true;
-            else {
-                Log::print<WARNING>("Unknown cutscene default setting: {}", setting);
-            }
-            s_eventSettings.insert_or_assign(eventName, entry);
+    }
+    const auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
+    Log::print<WARNING>("Cutscene settings in the graphic pack differ from the ones that BetterVR was built with, parsed {} events from guest memory instead (took {:.3f}ms, ~{} KB)", s_eventSettings.size(), duration.count(), memoryFootprint / 1024);
+}
+
+std::optional<CemuHooks::HybridEventSettings> CemuHooks::FindEventSettings(const std::string& eventName) {
+    if (s_useCompiledCutsceneTable) {
+        if (auto flags = CutsceneTable::Find(eventName); flags.has_value()) {
+            return ToEventSettings(*flags);
         }
-        currPtr += line.length() + 1;
+        return std::nullopt;
     }
 
-    Log::print<VERBOSE>("Initialized cutscene default settings for {} events.", s_eventSettings.size());
+    if (auto it = s_eventSettings.find(eventName); it != s_eventSettings.end()) {
+        return it->second;
+    }
+    return std::nullopt;
 }
 
 
@@ -556,19 +570,26 @@ void CemuHooks::hook_GetEventName(PPCInterpreter_t* hCPU) {
     uint32_t eventNamePtr = hCPU->gpr[4];
 
     if (isEventActive) {
-        std::string eventName = std::string((char*)s_memoryBaseAddress + eventNamePtr);
-        if (s_currentEvent == eventName) {
+        // this gets called every frame during events, so only allocate when the event changes
+        static GuestSymbol s_currentEventSymbol = {};
+        GuestSymbol eventSymbol = GuestStringPool::Intern(getStringView(eventNamePtr));
+        if (eventSymbol == s_currentEventSymbol && !s_currentEvent.empty()) {
             return;
         }
+        s_currentEventSymbol = eventSymbol;
+
+        std::string eventName = std::string(GuestStringPool::GetString(eventSymbol));
         Log::print<INFO>("Event '{}' is now active.", eventName);
         s_currentEvent = eventName;
+        GuestStringPool::LogStats();
+        CameraParamOverrides::LogStats();
 
-        auto it = s_eventSettings.find(eventName);
-        if (it != s_eventSettings.end()) {
-            HybridEventSettings settings = it->second;
+        if (auto eventSettings = FindEventSettings(eventName); eventSettings.has_value()) {
+            HybridEventSettings settings = eventSettings.value();
             Log::print<INFO>(" - First Person: {}", settings.firstPerson ? "ON" : "OFF");
             Log::print<INFO>(" - Ignore Camera Rotation: {}", settings.ignoreCameraRotation ? "ON" : "OFF");
             Log::print<INFO>(" - Disable Player-Driven Link Hands: {}", settings.disablePlayerDrivenLinkHands ? "ON" : "OFF");
+            Log::print<INFO>(" - Alternate Eyes: {}", settings.alternateEyes ? "ON" : "OFF");
             s_currentEventSettings = settings;
         }
         else {
@@ -593,30 +614,23 @@ void CemuHooks::hook_OverwriteCameraParam(PPCInterpreter_t* hCPU) {
 
     uint32_t actionPtr = hCPU->gpr[3];
     uint32_t destFloatPtr = hCPU->gpr[4];
-    const char* paramName = (const char*)(s_memoryBaseAddress + getMemory<BEType<uint32_t>>(hCPU->gpr[5]).getLE());
+    uint32_t paramNamePtr = getMemory<BEType<uint32_t>>(hCPU->gpr[5]).getLE();
 
-    if (actionPtr == 0 || destFloatPtr == 0 || paramName == nullptr) {
+    if (actionPtr == 0 || destFloatPtr == 0 || paramNamePtr == 0) {
         hCPU->instructionPointer = orig_GetStaticParam_float_funcAddr;
         return;
     }
-    
-    std::string paramNameStr = paramName;
 
-    hCPU->instructionPointer = hCPU->sprNew.LR;
-    if (paramNameStr == "JumpHeight") {
-        // override jump height to 1.2 in first person mode to temporarily workaround the increased gravity effect
-        uint32_t superLowAddress = 0x100C50D0; // points to 1.2
-        writeMemoryBE(hCPU->gpr[4], &superLowAddress);
-        return;
-    }
-
-    if (GetSettings().IsFirstPersonMode()) {
-        uint32_t superLowAddress = 0x102B3150; // points to 0.0000011920929
-        writeMemoryBE(hCPU->gpr[4], &superLowAddress);
+    // jump height is overridden to 1.2 to temporarily workaround the increased gravity effect, in first person all other params get nulled
+    auto profile = GetSettings().IsFirstPersonMode() ? CameraParamOverrides::Profile::FIRST_PERSON : CameraParamOverrides::Profile::THIRD_PERSON;
+    uint32_t overrideAddress = CameraParamOverrides::Resolve(paramNamePtr, (const char*)(s_memoryBaseAddress + paramNamePtr), profile, HasActiveCutscene());
+    if (overrideAddress == CameraParamOverrides::NO_OVERRIDE) {
+        hCPU->instructionPointer = orig_GetStaticParam_float_funcAddr;
         return;
     }
 
-    hCPU->instructionPointer = orig_GetStaticParam_float_funcAddr;
+    hCPU->instructionPointer = hCPU->sprNew.LR;
+    writeMemoryBE(destFloatPtr, &overrideAddress);
 }
 
 void CemuHooks::hook_FixLadder(PPCInterpreter_t* hCPU) {
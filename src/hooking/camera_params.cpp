@@ -0,0 +1,62 @@
+#include "camera_params.h"
+
+std::array<std::atomic_uint64_t, CameraParamOverrides::PTR_CACHE_SIZE> CameraParamOverrides::s_ptrCache = {};
+std::array<std::atomic_uint32_t, CameraParamOverrides::PARAM_COUNT> CameraParamOverrides::s_hits = {};
+std::atomic_uint32_t CameraParamOverrides::s_ptrCacheMisses = 0;
+
+uint32_t CameraParamOverrides::FindParamIndex(uint32_t paramNamePtr, const char* paramNameHostPtr) {
+    // entries are packed as (ptr << 32 | index), ptr 0 marks an empty slot
+    // the names are aligned, so the slot comes from the top bits of the product where every bit of the pointer has an effect
+    uint32_t slot = ((paramNamePtr * 0x9E3779B1u) >> 25) % PTR_CACHE_SIZE;
+    for (uint32_t i = 0; i < PTR_CACHE_PROBES; i++) {
+        uint64_t entry = s_ptrCache[(slot + i) % PTR_CACHE_SIZE].load(std::memory_order_relaxed);
+        if ((uint32_t)(entry >> 32) == paramNamePtr) {
+            return (uint32_t)entry;
+        }
+        if (entry == 0) {
+            break;
+        }
+    }
+
+    // fall back to hashing the name
+    s_ptrCacheMisses++;
+    GuestStringView paramName(paramNamePtr, paramNameHostPtr);
+    uint32_t hash = paramName.Hash();
+    uint32_t index = ANY_PARAM;
+    for (uint32_t i = 1; i < PARAM_COUNT; i++) {
+        if (s_params[i].hash == hash && s_params[i].name == paramName.View()) {
+            index = i;
+            break;
+        }
+    }
+
+    // racing inserts are harmless since every entry is written whole, at worst a pointer is looked up by name again
+    uint64_t newEntry = ((uint64_t)paramNamePtr << 32) | index;
+    for (uint32_t i = 0; i < PTR_CACHE_PROBES; i++) {
+        uint64_t expected = 0;
+        if (s_ptrCache[(slot + i) % PTR_CACHE_SIZE].compare_exchange_strong(expected, newEntry) || expected == newEntry) {
+            return index;
+        }
+    }
+    s_ptrCache[slot].store(newEntry, std::memory_order_relaxed);
+    return index;
+}
+
+uint32_t CameraParamOverrides::Resolve(uint32_t paramNamePtr, const char* paramNameHostPtr, Profile gameplayProfile, bool inCutscene) {
+    uint32_t index = FindParamIndex(paramNamePtr, paramNameHostPtr);
+    s_hits[index].fetch_add(1, std::memory_order_relaxed);
+
+    if (inCutscene) {
+        if (uint32_t value = s_values[(size_t)Profile::CUTSCENE][index]; value != NO_OVERRIDE) {
+            return value;
+        }
+    }
+    return s_values[(size_t)gameplayProfile][index];
+}
+
+void CameraParamOverrides::LogStats() {
+    for (uint32_t i = 0; i < PARAM_COUNT; i++) {
+        Log::print<INFO>("Camera param '{}' was requested {} times", s_params[i].name, s_hits[i].load());
+    }
+    Log::print<INFO>("Camera param pointer cache had {} misses", s_ptrCacheMisses.load());
+}
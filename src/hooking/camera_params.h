@@ -0,0 +1,57 @@
+#pragma once
+#include "guest_string.h"
+
+// resolves which float the game's getStaticParam<float> calls should be redirected to
+class CameraParamOverrides {
+public:
+    enum class Profile : uint8_t {
+        FIRST_PERSON,
+        THIRD_PERSON,
+        CUTSCENE, // layered on top of the gameplay profile, empty values fall through
+        COUNT
+    };
+
+    // index 0 is the fallback for any param that isn't listed explicitly
+    static constexpr uint32_t ANY_PARAM = 0;
+    static constexpr uint32_t NO_OVERRIDE = 0;
+
+    // returns the guest address of the replacement float or NO_OVERRIDE to run the original function
+    static uint32_t Resolve(uint32_t paramNamePtr, const char* paramNameHostPtr, Profile gameplayProfile, bool inCutscene);
+
+    static void LogStats();
+
+private:
+    struct Param {
+        std::string_view name;
+        uint32_t hash;
+    };
+
+    static uint32_t FindParamIndex(uint32_t paramNamePtr, const char* paramNameHostPtr);
+
+    static constexpr uint32_t FLOAT_1_2 = 0x100C50D0;
+    static constexpr uint32_t FLOAT_ALMOST_ZERO = 0x102B3150; // 0.0000011920929
+
+    static constexpr std::array s_params = {
+        Param{ "*", 0 },
+        Param{ "JumpHeight", GuestStringHash("JumpHeight") },
+    };
+    static constexpr uint32_t PARAM_COUNT = (uint32_t)s_params.size();
+
+    // clang-format off
+    static constexpr std::array<std::array<uint32_t, PARAM_COUNT>, (size_t)Profile::COUNT> s_values = {{
+        // *                  JumpHeight
+        { FLOAT_ALMOST_ZERO,  FLOAT_1_2   }, // FIRST_PERSON
+        { NO_OVERRIDE,        FLOAT_1_2   }, // THIRD_PERSON
+        { NO_OVERRIDE,        NO_OVERRIDE }, // CUTSCENE
+    }};
+    // clang-format on
+
+    // open-addressed cache from guest name pointer to param index, the names are static strings in the executable so their pointers are stable.
+    // a pointer is only looked for in the few slots after its home slot, and once those are taken it replaces whatever is in its home slot.
+    static constexpr uint32_t PTR_CACHE_SIZE = 128;
+    static constexpr uint32_t PTR_CACHE_PROBES = 4;
+    static std::array<std::atomic_uint64_t, PTR_CACHE_SIZE> s_ptrCache;
+
+    static std::array<std::atomic_uint32_t, PARAM_COUNT> s_hits;
+    static std::atomic_uint32_t s_ptrCacheMisses;
+};
@@ -0,0 +1,41 @@
+#include "capture_policy.h"
+
+CapturePolicy::ImageInfo CapturePolicy::ImageInfo::FromCreateInfo(const VkImageCreateInfo& createInfo) {
+    return {
+        .extent = { createInfo.extent.width, createInfo.extent.height },
+        .format = createInfo.format
+    };
+}
+
+bool CapturePolicy::IsTracked(const ImageInfo& info) {
+    return info.extent.width >= 1280 && info.extent.height >= 720;
+}
+
+CapturePolicy::ImageKind CapturePolicy::Classify(const ImageInfo& info) {
+    if (!IsTracked(info)) {
+        return ImageKind::OTHER;
+    }
+    switch (info.format) {
+        case VK_FORMAT_B10G11R11_UFLOAT_PACK32:
+            return ImageKind::COLOR;
+        case VK_FORMAT_D32_SFLOAT:
+            return ImageKind::DEPTH;
+        default:
+            return ImageKind::OTHER;
+    }
+}
+
+void CapturePolicy::OnImageCreated(VkImage image, const ImageInfo& info) {
+    if (IsTracked(info)) {
+        checkAssert(m_images.try_emplace(image, info).second, "Couldn't insert image into the capture policy!");
+    }
+}
+
+void CapturePolicy::OnImageDestroyed(VkImage image) {
+    m_images.erase(image);
+}
+
+const CapturePolicy::ImageInfo* CapturePolicy::FindImage(VkImage image) const {
+    auto it = m_images.find(image);
+    return it != m_images.end() ? &it->second : nullptr;
+}
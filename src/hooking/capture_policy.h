@@ -0,0 +1,30 @@
+#pragma once
+
+// classifies the images that Cemu creates, so that the clear hooks only capture the eyes from the ones that can hold them.
+// Cemu renders both eyes into the same image, so every capture is copied into the layer's own textures.
+class CapturePolicy {
+public:
+    enum class ImageKind {
+        OTHER,
+        COLOR, // the 3D scene color, which later also holds the HUD
+        DEPTH
+    };
+
+    struct ImageInfo {
+        VkExtent2D extent;
+        VkFormat format;
+
+        static ImageInfo FromCreateInfo(const VkImageCreateInfo& createInfo);
+    };
+
+    // only images that are at least 720p are tracked, since Cemu never renders the game at a lower resolution
+    static bool IsTracked(const ImageInfo& info);
+    static ImageKind Classify(const ImageInfo& info);
+
+    void OnImageCreated(VkImage image, const ImageInfo& info);
+    void OnImageDestroyed(VkImage image);
+    const ImageInfo* FindImage(VkImage image) const;
+
+private:
+    std::unordered_map<VkImage, ImageInfo> m_images;
+};
@@ -1,5 +1,9 @@
 #pragma once
 #include "entity_debugger.h"
+#include "guest_string.h"
+#include "held_weapons.h"
+#include "graphic_pack_manifest.h"
+#include "input_journal.h"
 
 
 class CemuHooks {
@@ -20,51 +24,8 @@ public:
         checkAssert(s_memoryBaseAddress != 0, "Failed to get memory base address of Cemu process!");
 
 
-        osLib_registerHLEFunction("coreinit", "hook_UpdateSettings", &hook_UpdateSettings);
-
-        // Actor Hooks
-        osLib_registerHLEFunction("coreinit", "hook_UpdateActorList", &hook_UpdateActorList);
-        osLib_registerHLEFunction("coreinit", "hook_CreateNewActor", &hook_CreateNewActor);
-
-        // Camera Hooks
-        osLib_registerHLEFunction("coreinit", "hook_BeginCameraSide", &hook_BeginCameraSide);
-        osLib_registerHLEFunction("coreinit", "hook_ModifyLightPrePassProjectionMatrix", &hook_ModifyLightPrePassProjectionMatrix);
-        osLib_registerHLEFunction("coreinit", "hook_UpdateCameraForGameplay", &hook_UpdateCameraForGameplay);
-        osLib_registerHLEFunction("coreinit", "hook_GetRenderCamera", &hook_GetRenderCamera);
-        osLib_registerHLEFunction("coreinit", "hook_GetRenderProjection", &hook_GetRenderProjection);
-        osLib_registerHLEFunction("coreinit", "hook_EndCameraSide", &hook_EndCameraSide);
-
-        osLib_registerHLEFunction("coreinit", "hook_UseCameraDistance", &hook_UseCameraDistance);
-        osLib_registerHLEFunction("coreinit", "hook_ReplaceCameraMode", &hook_ReplaceCameraMode);
-        osLib_registerHLEFunction("coreinit", "hook_GetEventName", &hook_GetEventName);
-        osLib_registerHLEFunction("coreinit", "hook_OverwriteCameraParam", &hook_OverwriteCameraParam);
-        osLib_registerHLEFunction("coreinit", "hook_PlayerLadderFix", &hook_PlayerLadderFix);
-
-        // First-Person Model Hooks
-        osLib_registerHLEFunction("coreinit", "hook_SetActorOpacity", &hook_SetActorOpacity);
-        osLib_registerHLEFunction("coreinit", "hook_CalculateModelOpacity", &hook_CalculateModelOpacity);
-        osLib_registerHLEFunction("coreinit", "hook_ModifyBoneMatrix", &hook_ModifyBoneMatrix);
-        osLib_registerHLEFunction("coreinit", "hook_ChangeWeaponMtx", &hook_ChangeWeaponMtx);
-
-        // First-Person Weapon Hooks
-        osLib_registerHLEFunction("coreinit", "hook_EquipWeapon", &hook_EquipWeapon);
-        osLib_registerHLEFunction("coreinit", "hook_DropEquipment", &hook_DropEquipment);
-        osLib_registerHLEFunction("coreinit", "hook_EnableWeaponAttackSensor", &hook_EnableWeaponAttackSensor);
-        osLib_registerHLEFunction("coreinit", "hook_SetPlayerWeaponScale", &hook_SetPlayerWeaponScale);
-        osLib_registerHLEFunction("coreinit", "hook_GetContactLayerOfAttack", &hook_GetContactLayerOfAttack);
-
-        // Input Hooks
-        osLib_registerHLEFunction("coreinit", "hook_InjectXRInput", &hook_InjectXRInput);
-        osLib_registerHLEFunction("coreinit", "hook_XRRumble_VPADControlMotor", &hook_XRRumble_VPADControlMotor);
-        osLib_registerHLEFunction("coreinit", "hook_XRRumble_VPADStopMotor", &hook_XRRumble_VPADStopMotor);
-
-        // Logging/Debugging Hooks
-        osLib_registerHLEFunction("coreinit", "hook_OSReportToConsole", &hook_OSReportToConsole);
-        osLib_registerHLEFunction("coreinit", "hook_DropWeaponLogging", &hook_DropWeaponLogging);
-        osLib_registerHLEFunction("coreinit", "hook_ModifyHandModelAccessSearch", &hook_ModifyHandModelAccessSearch);
-        osLib_registerHLEFunction("coreinit", "hook_CreateNewScreen", &hook_CreateNewScreen);
-        osLib_registerHLEFunction("coreinit", "hook_RouteActorJob", &hook_RouteActorJob);
-        osLib_registerHLEFunction("coreinit", "hook_FixLadder", &hook_FixLadder);
+        s_inputMapping.LoadProfile();
+        RegisterHooks();
     };
     ~CemuHooks() {
         FreeLibrary(m_cemuHandle);
@@ -77,6 +38,7 @@ public:
     static std::array<class WeaponMotionAnalyser, 2> m_motionAnalyzers;
     static std::array<uint32_t, 2> m_heldWeapons;
     static std::array<uint32_t, 2> m_heldWeaponsLastUpdate;
+    static HeldWeapons m_heldWeaponInfo;
     static uint32_t s_playerAddress;
     static uint32_t s_playerMtxAddress;
     static uint32_t s_cameraMtxAddress;
@@ -89,6 +51,7 @@ public:
         bool disablePlayerDrivenLinkHands; // let event control the hands instead of the VR controllers
         bool ignoreCameraRotation;         // some events will pan the camera, but in first-person it should usually be ignored to avoid nausea. Doors opening is okay, but panning down to a chest is not.
         bool demoEnableCameraInput;        // there's already events that allow user camera control. This isn't used or overwritten atm.
+        bool alternateEyes;                // the event's camera moves slowly enough that an eye can be reprojected instead of rendered every frame
     };
 
     static uint32_t GetFramesSinceLastCameraUpdate() { return s_framesSinceLastCameraUpdate.load(); }
@@ -102,8 +65,10 @@ public:
 
     static std::string s_currentEvent;
     static HybridEventSettings s_currentEventSettings;
-    static std::unordered_map<std::string, HybridEventSettings> s_eventSettings;
+    static std::unordered_map<std::string, HybridEventSettings> s_eventSettings; // only used if the graphic pack's table differs from the compiled one
+    static bool s_useCompiledCutsceneTable;
     static void initCutsceneDefaultSettings(uint32_t ppc_TableOfCutsceneEventsSettingsOffset);
+    static std::optional<HybridEventSettings> FindEventSettings(const std::string& eventName);
 
     static bool HasActiveCutscene() {
         return !s_currentEvent.empty();
@@ -176,11 +141,94 @@ public:
         return GetSettings().UseBlackBarsForCutscenes();
     }
 
+    // gameplay follows the headset, so the eye that isn't rendered can be reprojected. events have to opt in since their cameras cut and pan.
+    static bool AllowsSingleEyeFrames() {
+        if (!IsInGame()) {
+            return false;
+        }
+        if (HasActiveCutscene()) {
+            return s_currentEventSettings.alternateEyes;
+        }
+        return true;
+    }
+
     static void DrawDebugOverlays();
 
+    static InputMapping s_inputMapping;
+    static InputJournal s_inputJournal;
+
 private:
     HMODULE m_cemuHandle;
 
+    struct HookRegistration {
+        std::string_view name;
+        void (*hook)(PPCInterpreter_t* hCPU);
+    };
+
+    // every hook that the graphic pack's patches can call
+    static constexpr auto GetHookRegistrations() {
+        return std::array{
+            HookRegistration{ "hook_UpdateSettings", &hook_UpdateSettings },
+
+            // Actor Hooks
+            HookRegistration{ "hook_UpdateActorList", &hook_UpdateActorList },
+            HookRegistration{ "hook_CreateNewActor", &hook_CreateNewActor },
+
+            // Camera Hooks
+            HookRegistration{ "hook_BeginCameraSide", &hook_BeginCameraSide },
+            HookRegistration{ "hook_ModifyLightPrePassProjectionMatrix", &hook_ModifyLightPrePassProjectionMatrix },
+            HookRegistration{ "hook_UpdateCameraForGameplay", &hook_UpdateCameraForGameplay },
+            HookRegistration{ "hook_GetRenderCamera", &hook_GetRenderCamera },
+            HookRegistration{ "hook_GetRenderProjection", &hook_GetRenderProjection },
+            HookRegistration{ "hook_EndCameraSide", &hook_EndCameraSide },
+
+            HookRegistration{ "hook_UseCameraDistance", &hook_UseCameraDistance },
+            HookRegistration{ "hook_ReplaceCameraMode", &hook_ReplaceCameraMode },
+            HookRegistration{ "hook_GetEventName", &hook_GetEventName },
+            HookRegistration{ "hook_OverwriteCameraParam", &hook_OverwriteCameraParam },
+            HookRegistration{ "hook_PlayerLadderFix", &hook_PlayerLadderFix },
+
+            // First-Person Model Hooks
+            HookRegistration{ "hook_SetActorOpacity", &hook_SetActorOpacity },
+            HookRegistration{ "hook_CalculateModelOpacity", &hook_CalculateModelOpacity },
+            HookRegistration{ "hook_ModifyBoneMatrix", &hook_ModifyBoneMatrix },
+            HookRegistration{ "hook_ChangeWeaponMtx", &hook_ChangeWeaponMtx },
+
+            // First-Person Weapon Hooks
+            HookRegistration{ "hook_EquipWeapon", &hook_EquipWeapon },
+            HookRegistration{ "hook_DropEquipment", &hook_DropEquipment },
+            HookRegistration{ "hook_EnableWeaponAttackSensor", &hook_EnableWeaponAttackSensor },
+            HookRegistration{ "hook_SetPlayerWeaponScale", &hook_SetPlayerWeaponScale },
+            HookRegistration{ "hook_GetContactLayerOfAttack", &hook_GetContactLayerOfAttack },
+
+            // Input Hooks
+            HookRegistration{ "hook_InjectXRInput", &hook_InjectXRInput },
+            HookRegistration{ "hook_XRRumble_VPADControlMotor", &hook_XRRumble_VPADControlMotor },
+            HookRegistration{ "hook_XRRumble_VPADStopMotor", &hook_XRRumble_VPADStopMotor },
+
+            // Logging/Debugging Hooks
+            HookRegistration{ "hook_OSReportToConsole", &hook_OSReportToConsole },
+            HookRegistration{ "hook_DropWeaponLogging", &hook_DropWeaponLogging },
+            HookRegistration{ "hook_ModifyHandModelAccessSearch", &hook_ModifyHandModelAccessSearch },
+            HookRegistration{ "hook_CreateNewScreen", &hook_CreateNewScreen },
+            HookRegistration{ "hook_RouteActorJob", &hook_RouteActorJob },
+            HookRegistration{ "hook_FixLadder", &hook_FixLadder }
+        };
+    }
+
+    // the index of the first hook in GraphicPackManifest::HOOKS that isn't registered, or -1 if they all are
+    static consteval int32_t FindUnregisteredManifestHook() {
+        for (int32_t i = 0; i < (int32_t)GraphicPackManifest::HOOKS.size(); i++) {
+            if (std::ranges::none_of(GetHookRegistrations(), [&](const HookRegistration& registration) { return registration.name == GraphicPackManifest::HOOKS[i].name; })) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // registers the hooks with Cemu, it's checked at compile time that every hook that the patches call is among them
+    void RegisterHooks();
+
     osLib_registerHLEFunctionPtr_t osLib_registerHLEFunction;
     memory_getBasePtr_t memory_getBase;
     gameMeta_getTitleIdPtr_t gameMeta_getTitleId;
@@ -260,6 +308,21 @@ public:
         memcpy(resultPtr, (void*)memoryAddress, sizeof(T));
     }
 
+    // borrows a null-terminated string from guest memory without copying it
+    static GuestStringView getStringView(uint32_t guestAddr, size_t maxLength = GuestStringView::MAX_LENGTH) {
+        if (guestAddr == 0) {
+            return {};
+        }
+        return GuestStringView(guestAddr, (const char*)(s_memoryBaseAddress + guestAddr), maxLength);
+    }
+
+    // borrows the contents of a sead::FixedSafeString40/100 that's located at the given guest address
+    template <typename T>
+    static GuestStringView getSafeStringView(uint32_t safeStringAddr) {
+        uint32_t strPtr = getMemory<uint32_t>(safeStringAddr + offsetof(T, c_str)).getLE();
+        return getStringView(strPtr, sizeof(T::data));
+    }
+
     template <typename T>
     static auto getMemory(uint64_t offset) {
         if constexpr (is_BEType_v<T>) {
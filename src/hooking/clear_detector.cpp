@@ -0,0 +1,149 @@
+#include "clear_detector.h"
+
+ClearDetector::Match ClearDetector::MatchColor(const VkClearColorValue& color) {
+    // g and b hold the magic values, swapped for the right side. r is the capture idx (0 for 3D and 2 for 2D) and a the frame counter.
+    const double g = color.float32[1];
+    const double b = color.float32[2];
+    const uint32_t isLeft = (uint32_t)(g >= 0.12) & (uint32_t)(g <= 0.13) & (uint32_t)(b >= 0.97) & (uint32_t)(b <= 0.99);
+    const uint32_t isRight = (uint32_t)(b >= 0.12) & (uint32_t)(b <= 0.13) & (uint32_t)(g >= 0.97) & (uint32_t)(g <= 0.99);
+    const uint32_t is2D = (uint32_t)(color.float32[0] * 32.0f >= 1.0f);
+
+    return {
+        .kind = (Kind)((isLeft | isRight) * ((uint32_t)Kind::COLOR_3D + is2D)),
+        .side = (uint8_t)isRight,
+        .frameIdx = (uint8_t)(color.float32[3] >= 0.5f)
+    };
+}
+
+ClearDetector::Match ClearDetector::MatchDepth(const VkClearDepthStencilValue& depthStencil) {
+    // 0.0123456789 for the left side and 0.163987654 for the right side, the stencil is the frame counter
+    const double depth = depthStencil.depth;
+    const uint32_t isLeft = (uint32_t)(depth >= 0.011456789) & (uint32_t)(depth <= 0.013456789);
+    const uint32_t isRight = (uint32_t)(depth >= 0.153987654) & (uint32_t)(depth <= 0.173987654);
+
+    return {
+        .kind = (Kind)((isLeft | isRight) * (uint32_t)Kind::DEPTH_3D),
+        .side = (uint8_t)isRight,
+        .frameIdx = (uint8_t)depthStencil.stencil
+    };
+}
+
+ClearDetector::Step ClearDetector::ToStep(const Match& match) {
+    switch (match.kind) {
+        case Kind::COLOR_3D:
+        case Kind::DEPTH_3D:
+            return match.side == 0 ? FIRST_PASS_3D : SECOND_PASS_3D;
+        case Kind::COLOR_2D:
+            // the first pass clears the 2D layer with the right side's values, since its overlay is what's shown on the desktop
+            return match.side == 1 ? FIRST_PASS_2D : SECOND_PASS_2D;
+        default:
+            return NO_STEP;
+    }
+}
+
+size_t ClearDetector::GetHomeSlot(uintptr_t handle) {
+    const uint64_t hash = ((uint64_t)handle ^ ((uint64_t)handle >> 17)) * 0x9E3779B97F4A7C15ull;
+    return (size_t)(hash >> 32) % MAX_CANDIDATES;
+}
+
+void ClearDetector::OnImageCreated(VkImage image) {
+    if (m_isFull.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const uintptr_t handle = (uintptr_t)image;
+    const size_t homeSlot = GetHomeSlot(handle);
+    for (size_t i = 0; i < MAX_CANDIDATES; i++) {
+        std::atomic<uintptr_t>& slot = m_candidates[(homeSlot + i) % MAX_CANDIDATES];
+        const uintptr_t current = slot.load(std::memory_order_relaxed);
+        if (current == REMOVED_SLOT) {
+            slot.store(handle, std::memory_order_release);
+            return;
+        }
+        if (current == EMPTY_SLOT) {
+            // keep some empty slots around so that lookups of images that aren't candidates stay short
+            if (++m_usedSlots > MAX_CANDIDATES * 3 / 4) {
+                Log::print<WARNING>("Clear detector ran out of candidate slots, every clear will be checked for magic values from now on");
+                m_isFull.store(true, std::memory_order_release);
+                return;
+            }
+            slot.store(handle, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+void ClearDetector::OnImageDestroyed(VkImage image) {
+    const uintptr_t handle = (uintptr_t)image;
+    const size_t homeSlot = GetHomeSlot(handle);
+    for (size_t i = 0; i < MAX_CANDIDATES; i++) {
+        std::atomic<uintptr_t>& slot = m_candidates[(homeSlot + i) % MAX_CANDIDATES];
+        const uintptr_t current = slot.load(std::memory_order_relaxed);
+        if (current == handle) {
+            slot.store(REMOVED_SLOT, std::memory_order_release);
+            return;
+        }
+        if (current == EMPTY_SLOT) {
+            return;
+        }
+    }
+}
+
+bool ClearDetector::IsCandidate(VkImage image) const {
+    if (m_isFull.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    const uintptr_t handle = (uintptr_t)image;
+    const size_t homeSlot = GetHomeSlot(handle);
+    for (size_t i = 0; i < MAX_CANDIDATES; i++) {
+        const uintptr_t current = m_candidates[(homeSlot + i) % MAX_CANDIDATES].load(std::memory_order_acquire);
+        if (current == handle) {
+            return true;
+        }
+        if (current == EMPTY_SLOT) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool ClearDetector::Observe(const Match& match, bool singlePass) {
+    const Step step = ToStep(match);
+    if (step == NO_STEP) {
+        return true;
+    }
+
+    // the game's passes alternate between the frame slots, so a clear for another slot than the last one starts a new frame in it
+    const uint32_t frameIdx = match.frameIdx % FRAME_SLOTS;
+    FrameSlot& frame = m_frameSlots[frameIdx];
+    if (frameIdx != m_lastFrameIdx) {
+        // frames without any 3D, like the title screen, only clear the 2D layer
+        if ((frame.seenSteps & FIRST_PASS_3D) != 0 && (frame.seenSteps & frame.expectedSteps) != frame.expectedSteps) {
+            m_stats.incompleteFrames++;
+        }
+        frame = { .seenSteps = NO_STEP, .expectedSteps = (uint8_t)(singlePass ? SINGLE_PASS_STEPS : ALL_STEPS) };
+        m_lastFrameIdx = frameIdx;
+
+        // the window ends once the frame after it starts, so that the last frame's clears are counted in it
+        if (m_stats.frames == STATS_WINDOW) {
+            if (m_stats.incompleteFrames != 0 || m_stats.outOfOrderClears != 0) {
+                Log::print<WARNING>("Clear detector: of the last {} frames {} were missing a clear, and {} clears came out of order", STATS_WINDOW, m_stats.incompleteFrames, m_stats.outOfOrderClears);
+            }
+            std::scoped_lock lock(m_statsMutex);
+            m_lastStats = m_stats;
+            m_stats = {};
+        }
+        m_stats.frames++;
+    }
+
+    // steps can be left out, or repeated since Cemu clears the 2D layer twice, but never come after a later step of the same frame
+    const bool isAfterLaterStep = (frame.seenSteps & ~((step << 1) - 1)) != 0;
+    const bool isExpected = (frame.expectedSteps & step) != 0;
+    frame.seenSteps |= step;
+    if (isAfterLaterStep || !isExpected) {
+        m_stats.outOfOrderClears++;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+// finds the clears that the game's graphic pack tags with magic values, which tell which eye and layer Cemu is about to render.
+// every clear that Cemu records goes through the layer, so the images that could be tagged are flagged when they're created and
+// every other clear is rejected without looking at its values or taking a lock. the tagged clears are expected in the order that
+// the game's passes render them, which is checked per frame slot and counted when it's off. none of this touches the renderer,
+// so that it can be checked on its own with made up clears.
+class ClearDetector {
+public:
+    enum class Kind : uint8_t {
+        NONE,
+        COLOR_3D,
+        COLOR_2D,
+        DEPTH_3D
+    };
+
+    struct Match {
+        Kind kind = Kind::NONE;
+        uint8_t side = 0;     // the eye side of the game's pass, 0 for the first and 1 for the second
+        uint8_t frameIdx = 0; // the frame counter that the game's pass was calculated with
+    };
+
+    // what a tagged clear means for the order of a frame, the first pass also draws the 2D overlay that's shown on the desktop
+    enum Step : uint8_t {
+        NO_STEP = 0,
+        FIRST_PASS_3D = 1 << 0,
+        FIRST_PASS_2D = 1 << 1,
+        SECOND_PASS_3D = 1 << 2,
+        SECOND_PASS_2D = 1 << 3,
+        SINGLE_PASS_STEPS = FIRST_PASS_3D | FIRST_PASS_2D,
+        ALL_STEPS = SINGLE_PASS_STEPS | SECOND_PASS_3D | SECOND_PASS_2D
+    };
+
+    struct Stats {
+        uint32_t frames = 0;
+        uint32_t outOfOrderClears = 0;
+        uint32_t incompleteFrames = 0; // frames with 3D that were missing a step
+    };
+
+    // enough for every image that's at least 720p, which is all that Cemu renders the game into
+    static constexpr size_t MAX_CANDIDATES = 512;
+    static constexpr uint32_t FRAME_SLOTS = 2;
+    static constexpr uint32_t STATS_WINDOW = 500;
+
+    // compares the values without branching since every clear of a candidate image is checked. returns Kind::NONE if it's not tagged.
+    static Match MatchColor(const VkClearColorValue& color);
+    static Match MatchDepth(const VkClearDepthStencilValue& depthStencil);
+    static Step ToStep(const Match& match);
+
+    // candidates are added and removed under the same lock as the images that the capture policy tracks, but looked up without one
+    void OnImageCreated(VkImage image);
+    void OnImageDestroyed(VkImage image);
+    bool IsCandidate(VkImage image) const;
+
+    // records a tagged clear from Cemu's recording thread, singlePass is whether the frame skips the game's second pass.
+    // returns whether the clear was in the expected order.
+    bool Observe(const Match& match, bool singlePass);
+
+    // the counters of the last complete window, which the overlay reads from its own thread
+    Stats GetStats() const {
+        std::scoped_lock lock(m_statsMutex);
+        return m_lastStats;
+    }
+    // the counters of the window that's still being recorded, only valid on Cemu's recording thread
+    const Stats& GetCurrentStats() const { return m_stats; }
+
+private:
+    static constexpr uintptr_t EMPTY_SLOT = 0;
+    static constexpr uintptr_t REMOVED_SLOT = ~(uintptr_t)0;
+
+    static size_t GetHomeSlot(uintptr_t handle);
+
+    // open addressing, slots that are removed stay in the probe sequence so that lookups can stop at the first empty slot
+    std::array<std::atomic<uintptr_t>, MAX_CANDIDATES> m_candidates = {};
+    size_t m_usedSlots = 0;
+    // once the table fills up, every image is a candidate again, which is only slower
+    std::atomic_bool m_isFull = false;
+
+    struct FrameSlot {
+        uint8_t seenSteps = NO_STEP;
+        uint8_t expectedSteps = ALL_STEPS;
+    };
+    std::array<FrameSlot, FRAME_SLOTS> m_frameSlots = {};
+    uint32_t m_lastFrameIdx = FRAME_SLOTS;
+
+    Stats m_stats = {};
+    Stats m_lastStats = {};
+    mutable std::mutex m_statsMutex;
+};
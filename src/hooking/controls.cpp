@@ -1,35 +1,8 @@
 #include "cemu_hooks.h"
 #include "../instance.h"
 
-enum VPADButtons : uint32_t {
-    VPAD_BUTTON_A                 = 0x8000,
-    VPAD_BUTTON_B                 = 0x4000,
-    VPAD_BUTTON_X                 = 0x2000,
-    VPAD_BUTTON_Y                 = 0x1000,
-    VPAD_BUTTON_LEFT              = 0x0800,
-    VPAD_BUTTON_RIGHT             = 0x0400,
-    VPAD_BUTTON_UP                = 0x0200,
-    VPAD_BUTTON_DOWN              = 0x0100,
-    VPAD_BUTTON_ZL                = 0x0080,
-    VPAD_BUTTON_ZR                = 0x0040,
-    VPAD_BUTTON_L                 = 0x0020,
-    VPAD_BUTTON_R                 = 0x0010,
-    VPAD_BUTTON_PLUS              = 0x0008,
-    VPAD_BUTTON_MINUS             = 0x0004,
-    VPAD_BUTTON_HOME              = 0x0002,
-    VPAD_BUTTON_SYNC              = 0x0001,
-    VPAD_BUTTON_STICK_R           = 0x00020000,
-    VPAD_BUTTON_STICK_L           = 0x00040000,
-    VPAD_BUTTON_TV                = 0x00010000,
-    VPAD_STICK_R_EMULATION_LEFT   = 0x04000000,
-    VPAD_STICK_R_EMULATION_RIGHT  = 0x02000000,
-    VPAD_STICK_R_EMULATION_UP     = 0x01000000,
-    VPAD_STICK_R_EMULATION_DOWN   = 0x00800000,
-    VPAD_STICK_L_EMULATION_LEFT   = 0x40000000,
-    VPAD_STICK_L_EMULATION_RIGHT  = 0x20000000,
-    VPAD_STICK_L_EMULATION_UP     = 0x10000000,
-    VPAD_STICK_L_EMULATION_DOWN   = 0x08000000,
-};
+InputMapping CemuHooks::s_inputMapping = {};
+InputJournal CemuHooks::s_inputJournal = {};
 
 struct BEDir {
     BEVec3 x;
@@ -84,9 +57,6 @@ enum JoyDir {
     None
 };
 
-constexpr float AXIS_THRESHOLD = 0.5f;
-constexpr float HOLD_THRESHOLD = 0.1f;
-
 JoyDir GetJoystickDirection(const XrVector2f& stick)
 {
     if (stick.y >= AXIS_THRESHOLD)       return JoyDir::Up;
@@ -100,10 +70,6 @@ JoyDir GetJoystickDirection(const XrVector2f& stick)
 void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
-    auto mapXRButtonToVpad = [](XrActionStateBoolean& state, VPADButtons mapping) -> uint32_t {
-        return state.currentState ? mapping : 0;
-    };
-
     // read existing vpad as to not overwrite it
     uint32_t vpadStatusOffset = hCPU->gpr[4];
     VPADStatus vpadStatus = {};
@@ -122,7 +88,6 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
 
     // buttons
     static uint32_t oldCombinedHold = 0;
-    uint32_t newXRBtnHold = 0;
 
     // initializing gesture related variables
     bool leftHandBehindHead = false;
@@ -174,152 +139,115 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
         gameState.prevent_menu_time = now;
     }
 
-    if (gameState.in_game) 
-    {
-        if (!gameState.prevent_menu_inputs) {
-            if (inputs.inGame.mapAndInventoryState.lastEvent == ButtonState::Event::LongPress) {
-                newXRBtnHold |= VPAD_BUTTON_MINUS;
-                gameState.map_open = true;
-            }
-            if (inputs.inGame.mapAndInventoryState.lastEvent == ButtonState::Event::ShortPress) {
-                newXRBtnHold |= VPAD_BUTTON_PLUS;
-                gameState.map_open = false;
-            }
-        }
-        else if (now >= gameState.prevent_menu_time + delay)
-            gameState.prevent_menu_inputs = false;
+    //Dpad menu, applied before the mapping is evaluated so that grab_allowed already blocks the right hand grab in the same frame
+    if (gameState.in_game && !leftHandBehindHead && !gameState.prevent_menu_inputs && inputs.inGame.grabState[0].wasDownLastFrame && leftJoystickDir != JoyDir::None) {
+        gameState.prevent_grab_inputs = true;
+        gameState.prevent_grab_time = now;
+        //prevent movement while dpad is used, the stick zone is still set from leftJoystickDir
+        leftStickSource.currentState = { 0.0f, 0.0f };
+    }
 
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.jump, VPAD_BUTTON_X);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.crouch, VPAD_BUTTON_STICK_L);
-        //newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.run, VPAD_BUTTON_B);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.interact, VPAD_BUTTON_A);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.attack, VPAD_BUTTON_Y);
-        //newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.cancel, VPAD_BUTTON_B);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.useRune, VPAD_BUTTON_L);
-
-        //run
-        if (inputs.inGame.runState.lastEvent == ButtonState::Event::LongPress) {
-            newXRBtnHold |= VPAD_BUTTON_B;
+    // gather the signals that the input mapping is evaluated against
+    using Source = InputMapping::Source;
+    InputMapping::SourceMask sources = 0;
+    auto setSource = [&sources](Source source, bool active) {
+        if (active) {
+            sources |= InputMapping::SourceBit(source);
         }
+    };
 
-        if (!leftHandBehindHead) {
-
-            if (inputs.inGame.grabState[0].wasDownLastFrame) {
-                // Left Drop - Need dual wield implementation. Dropping left item currently makes the game freak out
-                // and the right weapon disappears. Equipping another sword make both the previous sword and actual appear in hand.
-                //if (leftJoystickDir == JoyDir::Down)
-                //{
-                //    inputs.inGame.drop_weapon[0] = true;
-                //    gameState.prevent_grab_inputs = true;
-                //    gameState.drop_weapon_time = now;
-                //}
-                //// Grab
-                //else if (!gameState.prevent_grab_inputs)
-                newXRBtnHold |= VPAD_BUTTON_A;
-                //else if (now >= gameState.drop_weapon_time + delay)
-                //{
-                //   gameState.prevent_grab_inputs = false;
-                //}
-            }
+    if (gameState.in_game) {
+        setSource(Source::JUMP, inputs.inGame.jump.currentState);
+        setSource(Source::CROUCH, inputs.inGame.crouch.currentState);
+        setSource(Source::RUN, inputs.inGame.run.currentState);
+        setSource(Source::ATTACK, inputs.inGame.attack.currentState);
+        setSource(Source::USE_RUNE, inputs.inGame.useRune.currentState);
+        setSource(Source::THROW_WEAPON, inputs.inGame.throwWeapon.currentState);
+        setSource(Source::CANCEL, inputs.inGame.cancel.currentState);
+        setSource(Source::INTERACT, inputs.inGame.interact.currentState);
+        setSource(Source::GRAB_LEFT, inputs.inGame.grabState[0].wasDownLastFrame);
+        setSource(Source::GRAB_RIGHT, inputs.inGame.grabState[1].wasDownLastFrame);
+        setSource(Source::MAP_INVENTORY, inputs.inGame.mapAndInventory.currentState);
+        setSource(Source::TRIGGER_LEFT, inputs.inGame.leftTrigger.currentState);
+        setSource(Source::TRIGGER_RIGHT, inputs.inGame.rightTrigger.currentState);
+    }
+    else {
+        setSource(Source::SELECT, inputs.inMenu.select.currentState);
+        setSource(Source::BACK, inputs.inMenu.back.currentState);
+        setSource(Source::SORT, inputs.inMenu.sort.currentState);
+        setSource(Source::HOLD, inputs.inMenu.hold.currentState);
+        setSource(Source::GRIP_LEFT, inputs.inMenu.leftGrip.currentState);
+        setSource(Source::GRIP_RIGHT, inputs.inMenu.rightGrip.currentState);
+        setSource(Source::MAP_INVENTORY, inputs.inMenu.mapAndInventory.currentState);
+        setSource(Source::TRIGGER_LEFT, inputs.inMenu.leftTrigger.currentState);
+        setSource(Source::TRIGGER_RIGHT, inputs.inMenu.rightTrigger.currentState);
+    }
 
+    // stick zones, in the same order as JoyDir
+    constexpr std::array leftStickZones = { Source::LEFT_STICK_UP, Source::LEFT_STICK_RIGHT, Source::LEFT_STICK_DOWN, Source::LEFT_STICK_LEFT };
+    constexpr std::array rightStickZones = { Source::RIGHT_STICK_UP, Source::RIGHT_STICK_RIGHT, Source::RIGHT_STICK_DOWN, Source::RIGHT_STICK_LEFT };
+    if (leftJoystickDir != JoyDir::None) {
+        setSource(leftStickZones[leftJoystickDir], true);
+    }
+    if (rightJoystickDir != JoyDir::None) {
+        setSource(rightStickZones[rightJoystickDir], true);
+    }
 
-            //Dpad menu
-            if (!gameState.prevent_menu_inputs) {
-                if (inputs.inGame.grabState[0].wasDownLastFrame) {
-                    switch (leftJoystickDir) 
-                    {
-                        case JoyDir::Up: newXRBtnHold |= VPAD_BUTTON_UP; break;
-                        case JoyDir::Right: newXRBtnHold |= VPAD_BUTTON_RIGHT; break;
-                        case JoyDir::Down: newXRBtnHold |= VPAD_BUTTON_DOWN; break;
-                        case JoyDir::Left: newXRBtnHold |= VPAD_BUTTON_LEFT; break;
-                    }
-                    if (leftJoystickDir != JoyDir::None) {
-                        gameState.prevent_grab_inputs = true;
-                        gameState.prevent_grab_time = now;
-                        //prevent movement while dpad is used
-                        leftStickSource.currentState = { 0.0f, 0.0f };
-                    }
-                }
-            }
-            else if (now >= gameState.prevent_menu_time + delay) 
-                gameState.prevent_menu_inputs = false;
-        }
+    setSource(Source::LEFT_HAND_BEHIND_HEAD, leftHandBehindHead);
+    setSource(Source::RIGHT_HAND_BEHIND_HEAD, rightHandBehindHead);
+    setSource(Source::LEFT_HAND_NEAR_HEAD, leftHandCloseEnoughFromHead);
+    setSource(Source::RIGHT_HAND_NEAR_HEAD, rightHandCloseEnoughFromHead);
+
+    setSource(Source::MENU_ALLOWED, !gameState.prevent_menu_inputs);
+    setSource(Source::GRAB_ALLOWED, !gameState.prevent_grab_inputs);
+    setSource(Source::MAP_OPEN, gameState.map_open);
+
+    InputMapping::Layer layer = InputMapping::LAYER_MENU;
+    if (gameState.in_game) {
+        layer = HasActiveCutscene() ? InputMapping::LAYER_CUTSCENE : InputMapping::LAYER_GAMEPLAY;
+    }
+
+    uint32_t newXRBtnHold = s_inputMapping.Evaluate(layer, sources, now);
+
+    // apply the side effects of the mapped buttons to the game state
+    if (gameState.in_game) {
+        if (gameState.prevent_menu_inputs && now >= gameState.prevent_menu_time + delay)
+            gameState.prevent_menu_inputs = false;
+
+        if (HAS_FLAG(newXRBtnHold, VPAD_BUTTON_MINUS))
+            gameState.map_open = true;
+        if (HAS_FLAG(newXRBtnHold, VPAD_BUTTON_PLUS))
+            gameState.map_open = false;
 
         if (leftHandCloseEnoughFromHead && leftHandBehindHead)
-        {
             VRManager::instance().XR->GetRumbleManager()->startSimpleRumble(true, 0.01f, 0.05f, 0.1f);
-            //Throw weapon left hand
-            if (inputs.inGame.grabState[0].wasDownLastFrame)
-                newXRBtnHold |= VPAD_BUTTON_R;
-        }
-            
-        if (!rightHandBehindHead)
-        {
-            if (inputs.inGame.grabState[1].wasDownLastFrame)
-            {
-                //Drop
-                if (rightJoystickDir == JoyDir::Down)
-                {
-                    inputs.inGame.drop_weapon[1] = true;
-                    gameState.prevent_grab_inputs = true;
-                    gameState.prevent_grab_time = now;
-                }  
-                // Grab
-                else if (!gameState.prevent_grab_inputs)
-                    newXRBtnHold |= VPAD_BUTTON_A;
-                else if (now >= gameState.prevent_grab_time + delay)
-                {
-                    gameState.prevent_grab_inputs = false;
-                }
-            }
-        }
-        
-        if (rightHandCloseEnoughFromHead && rightHandBehindHead) {
-            VRManager::instance().XR->GetRumbleManager()->startSimpleRumble(false, 0.01f, 0.05f, 0.1f);
-            //Throw weapon right hand
-            if (inputs.inGame.grabState[1].wasDownLastFrame)
-                newXRBtnHold |= VPAD_BUTTON_R;
-        }
 
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.leftTrigger, VPAD_BUTTON_ZL);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.rightTrigger, VPAD_BUTTON_ZR);
-    }
-    else {
-        if (!gameState.prevent_menu_inputs)
+        if (!rightHandBehindHead && inputs.inGame.grabState[1].wasDownLastFrame)
         {
-            if (gameState.map_open)
-                newXRBtnHold |= mapXRButtonToVpad(inputs.inMenu.mapAndInventory, VPAD_BUTTON_MINUS);
-            else
+            //Drop
+            if (rightJoystickDir == JoyDir::Down)
             {
-                newXRBtnHold |= mapXRButtonToVpad(inputs.inMenu.mapAndInventory, VPAD_BUTTON_PLUS);
+                inputs.inGame.drop_weapon[1] = true;
+                gameState.prevent_grab_inputs = true;
+                gameState.prevent_grab_time = now;
             }
-        }
-        else if (!inputs.inMenu.mapAndInventory.currentState)
-            gameState.prevent_menu_inputs = false;
-
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inMenu.select, VPAD_BUTTON_A);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inMenu.back, VPAD_BUTTON_B);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inMenu.sort, VPAD_BUTTON_Y);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inMenu.hold, VPAD_BUTTON_X);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inMenu.leftTrigger, VPAD_BUTTON_L);
-        newXRBtnHold |= mapXRButtonToVpad(inputs.inMenu.rightTrigger, VPAD_BUTTON_R);
-
-        if (inputs.inMenu.leftGrip.currentState) {
-            switch (leftJoystickDir)
+            else if (gameState.prevent_grab_inputs && now >= gameState.prevent_grab_time + delay)
             {
-                case JoyDir::Up: newXRBtnHold |= VPAD_BUTTON_UP; break;
-                case JoyDir::Right: newXRBtnHold |= VPAD_BUTTON_RIGHT; break;
-                case JoyDir::Down: newXRBtnHold |= VPAD_BUTTON_DOWN; break;
-                case JoyDir::Left: newXRBtnHold |= VPAD_BUTTON_LEFT; break;
+                gameState.prevent_grab_inputs = false;
             }
         }
+
+        if (rightHandCloseEnoughFromHead && rightHandBehindHead)
+            VRManager::instance().XR->GetRumbleManager()->startSimpleRumble(false, 0.01f, 0.05f, 0.1f);
+    }
+    else if (gameState.prevent_menu_inputs && !inputs.inMenu.mapAndInventory.currentState) {
+        gameState.prevent_menu_inputs = false;
     }
 
     // todo: see if select or grab is better
 
     // sticks
     static uint32_t oldXRStickHold = 0;
-    uint32_t newXRStickHold = 0;
 
     // movement/navigation stick
     if (inputs.inGame.in_game) {
@@ -355,28 +283,9 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
         vpadStatus.leftStick = { leftStickSource.currentState.x + vpadStatus.leftStick.x.getLE(), leftStickSource.currentState.y + vpadStatus.leftStick.y.getLE() };
     }
 
-    if (leftStickSource.currentState.x <= -AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_L_EMULATION_LEFT) && leftStickSource.currentState.x <= -HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_L_EMULATION_LEFT;
-    else if (leftStickSource.currentState.x >= AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_L_EMULATION_RIGHT) && leftStickSource.currentState.x >= HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_L_EMULATION_RIGHT;
-
-    if (leftStickSource.currentState.y <= -AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_L_EMULATION_DOWN) && leftStickSource.currentState.y <= -HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_L_EMULATION_DOWN;
-    else if (leftStickSource.currentState.y >= AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_L_EMULATION_UP) && leftStickSource.currentState.y >= HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_L_EMULATION_UP;
-
     vpadStatus.rightStick = {rightStickSource.currentState.x + vpadStatus.rightStick.x.getLE(), rightStickSource.currentState.y + vpadStatus.rightStick.y.getLE()};
 
-    if (rightStickSource.currentState.x <= -AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_R_EMULATION_LEFT) && rightStickSource.currentState.x <= -HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_R_EMULATION_LEFT;
-    else if (rightStickSource.currentState.x >= AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_R_EMULATION_RIGHT) && rightStickSource.currentState.x >= HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_R_EMULATION_RIGHT;
-
-    if (rightStickSource.currentState.y <= -AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_R_EMULATION_DOWN) && rightStickSource.currentState.y <= -HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_R_EMULATION_DOWN;
-    else if (rightStickSource.currentState.y >= AXIS_THRESHOLD || (HAS_FLAG(oldXRStickHold, VPAD_STICK_R_EMULATION_UP) && rightStickSource.currentState.y >= HOLD_THRESHOLD))
-        newXRStickHold |= VPAD_STICK_R_EMULATION_UP;
-
+    uint32_t newXRStickHold = InputMapping::EmulateStickButtons(oldXRStickHold, leftStickSource.currentState, rightStickSource.currentState);
     oldXRStickHold = newXRStickHold;
 
     // calculate new hold, trigger and release
@@ -403,6 +312,19 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
     // write the input back to VPADStatus
     writeMemory(vpadStatusOffset, &vpadStatus);
 
+    s_inputJournal.Record({
+        .time = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count(),
+        .sources = sources,
+        .layer = layer,
+        .xrLeftStick = leftStickSource.currentState,
+        .xrRightStick = rightStickSource.currentState,
+        .mappedButtons = newXRBtnHold,
+        .stickButtons = newXRStickHold,
+        .vpadHold = combinedHold,
+        .vpadLeftStick = { vpadStatus.leftStick.x.getLE(), vpadStatus.leftStick.y.getLE() },
+        .vpadRightStick = { vpadStatus.rightStick.x.getLE(), vpadStatus.rightStick.y.getLE() }
+    });
+
     // set r3 to 1 for hooked VPADRead function to return success
     hCPU->gpr[3] = 1;
 
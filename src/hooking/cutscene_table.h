@@ -0,0 +1,120 @@
+#pragma once
+#include "guest_string.h"
+#include "cutscene_table_data.h"
+
+// compile-time copy of the event table from patch_Settings_Cutscenes.asm, generated by cmake/CutsceneTable.cmake
+class CutsceneTable {
+public:
+    enum Flags : uint8_t {
+        FIRST_PERSON = 1 << 0,
+        DISABLE_PLAYER_DRIVEN_HANDS = 1 << 1,
+        IGNORE_CAMERA_ROTATION = 1 << 2,
+        DEMO_ENABLE_CAMERA_INPUT = 1 << 3,
+        ALTERNATE_EYES = 1 << 4,
+    };
+
+    static std::optional<uint8_t> Find(std::string_view eventName) {
+        uint32_t hash = GuestStringHash(eventName);
+        for (size_t slot = hash % SLOT_COUNT; s_slots[slot] != EMPTY_SLOT; slot = (slot + 1) % SLOT_COUNT) {
+            const auto& entry = CutsceneTableData::ENTRIES[s_slots[slot]];
+            if (entry.hash == hash && entry.name == eventName) {
+                return entry.flags;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // parses a "<event>,<setting>,<setting>,..." entry, needs to stay in sync with cmake/CutsceneTable.cmake
+    static bool ParseEntry(std::string_view entry, std::string_view& eventName, uint8_t& flags) {
+        size_t commaPos = entry.find(',');
+        if (commaPos == std::string_view::npos) {
+            return false;
+        }
+
+        eventName = entry.substr(0, commaPos);
+        flags = 0;
+
+        std::string_view settings = entry.substr(commaPos + 1);
+        while (true) {
+            size_t pos = settings.find(',');
+            std::string_view setting = settings.substr(0, pos);
+            if (setting == "FP_ON") flags |= FIRST_PERSON;
+            else if (setting == "FP_OFF")
+                flags &= ~FIRST_PERSON;
+            else if (setting == "HND_ON")
+                flags &= ~DISABLE_PLAYER_DRIVEN_HANDS;
+            else if (setting == "HND_OFF")
+                flags |= DISABLE_PLAYER_DRIVEN_HANDS;
+            else if (setting == "PAN_ON")
+                flags &= ~IGNORE_CAMERA_ROTATION;
+            else if (setting == "PAN_OFF")
+                flags |= IGNORE_CAMERA_ROTATION;
+            else if (setting == "CTRL_ON")
+                flags &= ~DEMO_ENABLE_CAMERA_INPUT;
+            else if (setting == "CTRL_OFF")
+                flags |= DEMO_ENABLE_CAMERA_INPUT;
+            else if (setting == "ALT_ON")
+                flags |= ALTERNATE_EYES;
+            else if (setting == "ALT_OFF")
+                flags &= ~ALTERNATE_EYES;
+            else {
+                Log::print<WARNING>("Unknown cutscene default setting: {}", setting);
+            }
+
+            if (pos == std::string_view::npos) {
+                break;
+            }
+            settings.remove_prefix(pos + 1);
+        }
+        return true;
+    }
+
+    // checks whether the table in guest memory is still the one that the layer was built with, without allocating anything
+    static bool MatchesGuestTable(const char* tablePtr) {
+        uint32_t checksum = GuestStringHash({});
+        uint32_t entryCount = 0;
+        while (*tablePtr != '\0') {
+            std::string_view entry(tablePtr);
+            tablePtr += entry.size() + 1;
+            entryCount++;
+
+            std::string_view eventName;
+            uint8_t flags = 0;
+            if (!ParseEntry(entry, eventName, flags)) {
+                continue;
+            }
+            checksum = (checksum ^ GuestStringHash(eventName)) * 0x01000193;
+            checksum = (checksum ^ flags) * 0x01000193;
+        }
+        return entryCount == CutsceneTableData::GUEST_ENTRY_COUNT && checksum == CutsceneTableData::CHECKSUM;
+    }
+
+    static constexpr size_t GetEventCount() { return CutsceneTableData::ENTRIES.size(); }
+
+    static constexpr size_t GetMemoryFootprint() {
+        size_t nameBytes = 0;
+        for (const auto& entry : CutsceneTableData::ENTRIES) {
+            nameBytes += entry.name.size() + 1;
+        }
+        return sizeof(CutsceneTableData::ENTRIES) + sizeof(s_slots) + nameBytes;
+    }
+
+private:
+    static constexpr uint16_t EMPTY_SLOT = UINT16_MAX;
+    static constexpr size_t SLOT_COUNT = std::bit_ceil(CutsceneTableData::ENTRIES.size() * 2);
+    static_assert(CutsceneTableData::ENTRIES.size() < EMPTY_SLOT);
+
+    // open-addressed index into the sorted entries, built at compile time so there's nothing to do at startup
+    static constexpr auto s_slots = [] {
+        std::array<uint16_t, SLOT_COUNT> slots = {};
+        slots.fill(EMPTY_SLOT);
+        for (uint16_t i = 0; i < (uint16_t)CutsceneTableData::ENTRIES.size(); i++) {
+            size_t slot = CutsceneTableData::ENTRIES[i].hash % SLOT_COUNT;
+            while (slots[slot] != EMPTY_SLOT) {
+                slot = (slot + 1) % SLOT_COUNT;
+            }
+            slots[slot] = i;
+        }
+        return slots;
+    }();
+};
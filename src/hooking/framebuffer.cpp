@@ -1,11 +1,11 @@
 #include "framebuffer.h"
 #include "instance.h"
 #include "layer.h"
-#include "utils/vulkan_utils.h"
 
 
 std::mutex lockImageResolutions;
-std::unordered_map<VkImage, std::pair<VkExtent2D, VkFormat>> imageResolutions;
+CapturePolicy s_capturePolicy;
+ClearDetector s_clearDetector;
 
 std::mutex s_activeCopyMutex;
 std::vector<std::pair<VkCommandBuffer, SharedTexture*>> s_activeCopyOperations;
@@ -15,12 +15,18 @@ VkImage s_curr3DDepthImage = VK_NULL_HANDLE;
 
 using namespace VRLayer;
 
+ClearDetector::Stats GetClearDetectorStats() {
+    return s_clearDetector.GetStats();
+}
+
 VkResult VkDeviceOverrides::CreateImage(const vkroots::VkDeviceDispatch& pDispatch, VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage) {
     VkResult res = pDispatch.CreateImage(device, pCreateInfo, pAllocator, pImage);
 
-    if (pCreateInfo->extent.width >= 1280 && pCreateInfo->extent.height >= 720) {
+    const CapturePolicy::ImageInfo info = CapturePolicy::ImageInfo::FromCreateInfo(*pCreateInfo);
+    if (res == VK_SUCCESS && CapturePolicy::IsTracked(info)) {
         lockImageResolutions.lock();
-        checkAssert(imageResolutions.try_emplace(*pImage, std::make_pair(VkExtent2D{ pCreateInfo->extent.width, pCreateInfo->extent.height }, pCreateInfo->format)).second, "Couldn't insert image resolution into map!");
+        s_capturePolicy.OnImageCreated(*pImage, info);
+        s_clearDetector.OnImageCreated(*pImage);
         lockImageResolutions.unlock();
     }
     return res;
@@ -28,7 +34,8 @@ VkResult VkDeviceOverrides::CreateImage(const vkroots::VkDeviceDispatch& pDispat
 
 void VkDeviceOverrides::DestroyImage(const vkroots::VkDeviceDispatch& pDispatch, VkDevice device, VkImage image, const VkAllocationCallbacks* pAllocator) {
     lockImageResolutions.lock();
-    imageResolutions.erase(image);
+    s_capturePolicy.OnImageDestroyed(image);
+    s_clearDetector.OnImageDestroyed(image);
     if (s_curr3DColorImage == image) {
         s_curr3DColorImage = VK_NULL_HANDLE;
     }
@@ -41,21 +48,21 @@ void VkDeviceOverrides::DestroyImage(const vkroots::VkDeviceDispatch& pDispatch,
 }
 
 void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatch& pDispatch, VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, const VkClearColorValue* pColor, uint32_t rangeCount, const VkImageSubresourceRange* pRanges) {
-    // check whether the magic values are there, and which order they are in to determine which eye
-    OpenXR::EyeSide side = (OpenXR::EyeSide)-1;
-    if (pColor->float32[1] >= 0.12 && pColor->float32[1] <= 0.13 && pColor->float32[2] >= 0.97 && pColor->float32[2] <= 0.99) {
-        side = OpenXR::EyeSide::LEFT;
-    }
-    else if (pColor->float32[2] >= 0.12 && pColor->float32[2] <= 0.13 && pColor->float32[1] >= 0.97 && pColor->float32[1] <= 0.99) {
-        side = OpenXR::EyeSide::RIGHT;
-    }
-
     if (!VRManager::instance().VK) {
         auto* dispatch = pDispatch.pDeviceDispatch;
         VRManager::instance().Init(dispatch->pPhysicalDeviceDispatch->pInstanceDispatch->Instance, dispatch->PhysicalDevice, dispatch->Device);
         VRManager::instance().InitSession();
     }
 
+    // most clears are for images that the magic values can't be in
+    if (!s_clearDetector.IsCandidate(image)) {
+        return pDispatch.CmdClearColorImage(commandBuffer, image, imageLayout, pColor, rangeCount, pRanges);
+    }
+
+    // check whether the magic values are there, and which order they are in to determine which eye
+    const ClearDetector::Match match = ClearDetector::MatchColor(*pColor);
+    OpenXR::EyeSide side = match.kind != ClearDetector::Kind::NONE ? (OpenXR::EyeSide)match.side : (OpenXR::EyeSide)-1;
+
     if (side != (OpenXR::EyeSide)-1) {
         // r value in magical clear value is the capture idx after rounding down
         const long captureIdx = std::lroundf(pColor->float32[0] * 32.0f);
@@ -69,6 +76,7 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
             Log::print<RENDERING>("Renderer is not initialized yet!");
             return pDispatch.CmdClearColorImage(commandBuffer, image, imageLayout, pColor, rangeCount, pRanges);
         }
+        s_clearDetector.Observe(match, renderer->IsSingleEyeFrame(frameIdx));
         auto& layer3D = renderer->m_layer3D;
         auto& layer2D = renderer->m_layer2D;
         auto& imguiOverlay = renderer->m_imguiOverlay;
@@ -77,19 +85,19 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
         if (captureIdx == 0 || captureIdx == 2) {
             if (!layer2D) {
                 lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
+                if (const CapturePolicy::ImageInfo* info = s_capturePolicy.FindImage(image)) {
                     auto viewConfs = VRManager::instance().XR->GetViewConfigurations();
 
-                    VkExtent2D swapchainRes = it->second.first;
+                    VkExtent2D swapchainRes = info->extent;
                     if (VRManager::instance().XR->m_capabilities.isMetaSimulator) {
                         swapchainRes = VkExtent2D{ viewConfs[0].recommendedImageRectWidth, viewConfs[0].recommendedImageRectHeight };
                     }
 
-                    layer3D = std::make_unique<RND_Renderer::Layer3D>(it->second.first, swapchainRes);
-                    layer2D = std::make_unique<RND_Renderer::Layer2D>(it->second.first, swapchainRes);
+                    layer3D = std::make_unique<RND_Renderer::Layer3D>(info->extent, swapchainRes);
+                    layer2D = std::make_unique<RND_Renderer::Layer2D>(info->extent, swapchainRes);
 
-                    Log::print<INFO>("Found rendering resolution {}x{} @ {} using capture #{}", it->second.first.width, it->second.first.height, it->second.second, captureIdx);
-                    imguiOverlay = std::make_unique<RND_Renderer::ImGuiOverlay>(commandBuffer, it->second.first.width, it->second.first.height, VK_FORMAT_A2B10G10R10_UNORM_PACK32);
+                    Log::print<INFO>("Found rendering resolution {}x{} @ {} using capture #{}", info->extent.width, info->extent.height, info->format, captureIdx);
+                    imguiOverlay = std::make_unique<RND_Renderer::ImGuiOverlay>(commandBuffer, info->extent.width, info->extent.height, VK_FORMAT_A2B10G10R10_UNORM_PACK32);
                     if (CemuHooks::GetSettings().ShowDebugOverlay()) {
                         VRManager::instance().Hooks->m_entityDebugger = std::make_unique<EntityDebugger>();
                     }
@@ -107,24 +115,25 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
 
         checkAssert(layer3D && layer2D, "Couldn't find 3D or 2D layer!");
 
-        // change source image to GENERAL layout
-        VulkanUtils::TransitionLayout(commandBuffer, image, imageLayout, VK_IMAGE_LAYOUT_GENERAL);
-        VulkanUtils::DebugPipelineBarrier(commandBuffer);
+        // the copies move the image to the GENERAL layout when they need it, and it's returned to Cemu's layout before Cemu's own commands continue
+        BarrierPlanner barriers;
+        barriers.Track(image, pRanges[0].aspectMask, imageLayout);
 
         auto returnToLayout = [&]() {
-            VulkanUtils::TransitionLayout(commandBuffer, image, VK_IMAGE_LAYOUT_GENERAL, imageLayout);
-            VulkanUtils::DebugPipelineBarrier(commandBuffer);
+            barriers.Release(image, imageLayout);
+            barriers.Flush(commandBuffer);
         };
 
         // 3D layer - color texture for 3D rendering
         if (captureIdx == 0) {
+            // when only a single eye is rendered for this frame, the game's first pass renders that eye
+            side = renderer->GetCaptureSide(side, frameIdx);
+
             // check if the color texture has the appropriate texture format
             if (s_curr3DColorImage == VK_NULL_HANDLE) {
                 lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
-                    if (it->second.second == VK_FORMAT_B10G11R11_UFLOAT_PACK32) {
-                        s_curr3DColorImage = it->first;
-                    }
+                if (const CapturePolicy::ImageInfo* info = s_capturePolicy.FindImage(image); info && CapturePolicy::Classify(*info) == CapturePolicy::ImageKind::COLOR) {
+                    s_curr3DColorImage = image;
                 }
                 lockImageResolutions.unlock();
             }
@@ -147,8 +156,8 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
                 return pDispatch.CmdClearColorImage(commandBuffer, image, imageLayout, &clearColor, rangeCount, pRanges);
             }
 
-            if (renderer->GetFrame(frameIdx).copiedColor[side]) {
-                // the color texture has already been copied to the layer
+            if (!renderer->CanCapture3DColor(side, frameIdx)) {
+                // the color texture has already been copied to the layer or the slot is still being presented
                 Log::print<RENDERING>("A 3D color texture is already been copied for the current frame!");
 
                 VkClearColorValue clearColor = {{ 0.0f, 0.0f, 0.0f, 0.0f }};
@@ -157,7 +166,7 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
             }
 
             // note: This uses vkCmdCopyImage to copy the image to the D3D12-created interop texture. s_activeCopyOperations queues a semaphore for the D3D12 side to wait on.
-            SharedTexture* texture = layer3D->CopyColorToLayer(side, commandBuffer, image, frameIdx);
+            SharedTexture* texture = layer3D->CopyColorToLayer(side, commandBuffer, barriers, image, frameIdx);
             renderer->On3DColorCopied(side, frameIdx);
 
             {
@@ -166,10 +175,10 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
             }
 
             // imgui needs only one eye to render Cemu's 2D output, so use right side since it looks better
-            if (side == EyeSide::RIGHT) {
+            if (side == EyeSide::RIGHT || renderer->IsSingleEyeFrame(frameIdx)) {
                 // note: Uses vkCmdCopyImage to copy the (right-eye-only) image to the imgui overlay's texture
                 float aspectRatio = layer3D->GetAspectRatio(side);
-                imguiOverlay->Draw3DLayerAsBackground(commandBuffer, image, aspectRatio, frameIdx);
+                imguiOverlay->Draw3DLayerAsBackground(commandBuffer, barriers, image, aspectRatio, frameIdx);
             }
 
             // clear the image to be transparent to allow for the HUD to be rendered on top of it which results in a transparent HUD layer
@@ -180,9 +189,11 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
 
         // 2D layer - color texture for HUD rendering
         if (captureIdx == 2) {
-            bool hudCopied = renderer->GetFrame(frameIdx).copied2D;
+            bool hudCopied = !renderer->CanCapture2D(frameIdx);
+            // the game's second pass is skipped when only a single eye is rendered, so the HUD is captured from the first pass instead of the desktop overlay
+            const bool captureHUD = side == OpenXR::EyeSide::LEFT || (renderer->IsSingleEyeFrame(frameIdx) && !hudCopied);
 
-            if (side == OpenXR::EyeSide::LEFT) {
+            if (captureHUD) {
                 if (hudCopied) {
                     // the 2D texture has already been copied to the layer
                     Log::print<RENDERING>("A 2D texture has already been copied for the current frame!");
@@ -194,8 +205,7 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
                 else {
                     // provide the HUD texture to the imgui overlay we'll use to recomposite Cemu's original flatscreen rendering
                     if (imguiOverlay && !hudCopied) {
-                        imguiOverlay->DrawHUDLayerAsBackground(commandBuffer, image, frameIdx);
-                        VulkanUtils::DebugPipelineBarrier(commandBuffer);
+                        imguiOverlay->DrawHUDLayerAsBackground(commandBuffer, barriers, image, frameIdx);
                     }
 
                     if (imguiOverlay && !hudCopied) {
@@ -203,13 +213,12 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
                         imguiOverlay->BeginFrame(frameIdx, false);
                         imguiOverlay->Update();
                         imguiOverlay->Render();
-                        imguiOverlay->DrawAndCopyToImage(commandBuffer, image, frameIdx);
-                        VulkanUtils::DebugPipelineBarrier(commandBuffer);
+                        imguiOverlay->DrawAndCopyToImage(commandBuffer, barriers, image, frameIdx);
                     }
 
                     // copy the HUD texture to D3D12 to be presented
                     // only copy the first attempt at capturing when GX2ClearColor is called with this capture index since the game/Cemu clears the 2D layer twice
-                    SharedTexture* texture = layer2D->CopyColorToLayer(commandBuffer, image, frameIdx);
+                    SharedTexture* texture = layer2D->CopyColorToLayer(commandBuffer, barriers, image, frameIdx);
                     renderer->On2DCopied(frameIdx);
 
                     {
@@ -218,14 +227,15 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
                     }
                 }
             }
-            if (side == OpenXR::EyeSide::RIGHT) {
+            if (side == OpenXR::EyeSide::RIGHT && !captureHUD) {
                 // render the imgui overlay on the right side
                 if (imguiOverlay) {
                     // render imgui, and then copy the framebuffer to the 2D layer
                     imguiOverlay->BeginFrame(frameIdx, true);
                     imguiOverlay->Update();
                     imguiOverlay->Render();
-                    imguiOverlay->DrawAndCopyToImage(commandBuffer, image, frameIdx);
+                    imguiOverlay->DrawAndCopyToImage(commandBuffer, barriers, image, frameIdx);
+                    returnToLayout();
                     return;
                 }
 
@@ -236,6 +246,7 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
                 }
             }
         }
+        returnToLayout();
         return;
     }
     else {
@@ -244,16 +255,14 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
 }
 
 void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBufferDispatch& pDispatch, VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, const VkClearDepthStencilValue* pDepthStencil, uint32_t rangeCount, const VkImageSubresourceRange* pRanges) {
-    // check for magical clear values
-    // check order and whether there's a match with the magical clear value
-    OpenXR::EyeSide side = (OpenXR::EyeSide)-1;
-    if (pDepthStencil->depth >= 0.011456789 && pDepthStencil->depth <= 0.013456789) { // 0.0123456789
-        side = OpenXR::EyeSide::LEFT;
-    }
-    else if (pDepthStencil->depth >= 0.153987654 && pDepthStencil->depth <= 0.173987654) { // 0.163987654
-        side = OpenXR::EyeSide::RIGHT;
+    if (!s_clearDetector.IsCandidate(image)) {
+        return pDispatch.CmdClearDepthStencilImage(commandBuffer, image, imageLayout, pDepthStencil, rangeCount, pRanges);
     }
 
+    // check for magical clear values
+    const ClearDetector::Match match = ClearDetector::MatchDepth(*pDepthStencil);
+    OpenXR::EyeSide side = match.kind != ClearDetector::Kind::NONE ? (OpenXR::EyeSide)match.side : (OpenXR::EyeSide)-1;
+
     if (rangeCount == 1 && side != (OpenXR::EyeSide)-1) {
         // stencil value is the frame counter
         const uint32_t frameCounter = pDepthStencil->stencil;
@@ -265,26 +274,25 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
         if (!VRManager::instance().XR->GetRenderer()->IsInitialized()) {
             return;
         }
+        s_clearDetector.Observe(match, VRManager::instance().XR->GetRenderer()->IsSingleEyeFrame(frameCounter));
 
         Log::print<RENDERING>("[{}] Clearing depth image for 3D layer for {} side", frameCounter, side == OpenXR::EyeSide::LEFT ? "left" : "right");
 
-        // change source image to GENERAL layout
-        VulkanUtils::TransitionLayout(commandBuffer, image, imageLayout, VK_IMAGE_LAYOUT_GENERAL);
-        VulkanUtils::DebugPipelineBarrier(commandBuffer);
+        BarrierPlanner barriers;
+        barriers.Track(image, pRanges[0].aspectMask, imageLayout);
 
         auto returnToLayout = [&]() {
-            VulkanUtils::TransitionLayout(commandBuffer, image, VK_IMAGE_LAYOUT_GENERAL, imageLayout);
-            VulkanUtils::DebugPipelineBarrier(commandBuffer);
+            barriers.Release(image, imageLayout);
+            barriers.Flush(commandBuffer);
         };
 
         if (side == OpenXR::EyeSide::LEFT || side == OpenXR::EyeSide::RIGHT) {
             // 3D layer - depth texture for 3D rendering
+            side = VRManager::instance().XR->GetRenderer()->GetCaptureSide(side, frameCounter);
             if (s_curr3DDepthImage == VK_NULL_HANDLE) {
                 lockImageResolutions.lock();
-                if (const auto it = imageResolutions.find(image); it != imageResolutions.end()) {
-                    if (it->second.second == VK_FORMAT_D32_SFLOAT) {
-                        s_curr3DDepthImage = it->first;
-                    }
+                if (const CapturePolicy::ImageInfo* info = s_capturePolicy.FindImage(image); info && CapturePolicy::Classify(*info) == CapturePolicy::ImageKind::DEPTH) {
+                    s_curr3DDepthImage = image;
                 }
                 lockImageResolutions.unlock();
             }
@@ -295,7 +303,7 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
                 return;
             }
 
-            if (VRManager::instance().XR->GetRenderer()->GetFrame(frameCounter).copiedDepth[side]) {
+            if (!VRManager::instance().XR->GetRenderer()->CanCapture3DDepth(side, frameCounter)) {
                 // the depth texture has already been copied to the layer
                 Log::print<RENDERING>("A depth texture is already bound for the current frame!");
                 returnToLayout();
@@ -312,7 +320,7 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
 
 
 
-            SharedTexture* texture = layer3D->CopyDepthToLayer(side, commandBuffer, image, frameCounter);
+            SharedTexture* texture = layer3D->CopyDepthToLayer(side, commandBuffer, barriers, image, frameCounter);
             VRManager::instance().XR->GetRenderer()->On3DDepthCopied(side, frameCounter);
 
             {
@@ -400,14 +408,14 @@ VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkQueueDispatch& pDispatc
                 for (auto it = s_activeCopyOperations.begin(); it != s_activeCopyOperations.end();) {
                     if (submitInfo.pCommandBuffers[j] == it->first) {
                         // Wait for D3D12/XR to finish with the previous shared texture render
-                        uint64_t waitValue = it->second->GetVulkanWaitValue();
-                        modifiedSubmitInfo.waitSemaphores.emplace_back(it->second->GetSemaphoreForWait(waitValue));
+                        uint64_t waitValue = it->second->WaitForHandoff(HandoffTracker::Api::VULKAN);
+                        modifiedSubmitInfo.waitSemaphores.emplace_back(it->second->GetSemaphore());
                         modifiedSubmitInfo.waitDstStageMasks.emplace_back(VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
                         modifiedSubmitInfo.timelineWaitValues.emplace_back(waitValue);
 
                         // Signal to D3D12/XR rendering that the shared texture can be rendered to VR headset
-                        uint64_t signalValue = it->second->GetVulkanSignalValue();
-                        modifiedSubmitInfo.signalSemaphores.emplace_back(it->second->GetSemaphoreForSignal(signalValue));
+                        uint64_t signalValue = it->second->SignalHandoff(HandoffTracker::Api::VULKAN);
+                        modifiedSubmitInfo.signalSemaphores.emplace_back(it->second->GetSemaphore());
                         modifiedSubmitInfo.timelineSignalValues.emplace_back(signalValue);
                         it = s_activeCopyOperations.erase(it);
                     }
@@ -1,4 +1,8 @@
 #pragma once
 
 #include "rendering/openxr.h"
-#include "rendering/texture.h"
\ No newline at end of file
+#include "rendering/texture.h"
+#include "capture_policy.h"
+#include "clear_detector.h"
+// the clear detector lives with the clear hooks, the overlay only reads its counters
+ClearDetector::Stats GetClearDetectorStats();
@@ -0,0 +1,105 @@
+#include "guest_string.h"
+
+#include <deque>
+#include <shared_mutex>
+
+std::atomic_uint64_t GuestStringPool::s_lookups = 0;
+std::atomic_uint64_t GuestStringPool::s_cacheHits = 0;
+std::atomic_uint64_t GuestStringPool::s_poolHits = 0;
+std::atomic_uint64_t GuestStringPool::s_insertions = 0;
+
+// strings are only ever added, a deque keeps the views into them stable
+static std::shared_mutex s_poolMutex;
+static std::deque<std::string> s_poolStrings = { std::string() };
+static std::vector<uint32_t> s_poolHashes = { GuestStringHash({}) };
+static std::unordered_map<std::string_view, uint32_t> s_poolLookup = { { std::string_view(), 0 } };
+
+GuestSymbol GuestStringPool::Find(std::string_view str) {
+    std::shared_lock lock(s_poolMutex);
+    auto it = s_poolLookup.find(str);
+    if (it == s_poolLookup.end()) {
+        return {};
+    }
+    return { it->second, s_poolHashes[it->second] };
+}
+
+GuestSymbol GuestStringPool::Intern(std::string_view str) {
+    s_lookups++;
+    {
+        std::shared_lock lock(s_poolMutex);
+        if (auto it = s_poolLookup.find(str); it != s_poolLookup.end()) {
+            s_poolHits++;
+            return { it->second, s_poolHashes[it->second] };
+        }
+    }
+
+    std::unique_lock lock(s_poolMutex);
+    // another thread might've inserted it in the meantime
+    if (auto it = s_poolLookup.find(str); it != s_poolLookup.end()) {
+        s_poolHits++;
+        return { it->second, s_poolHashes[it->second] };
+    }
+
+    uint32_t id = (uint32_t)s_poolStrings.size();
+    const std::string& stored = s_poolStrings.emplace_back(str);
+    s_poolHashes.emplace_back(GuestStringHash(stored));
+    s_poolLookup.emplace(stored, id);
+    s_insertions++;
+    return { id, s_poolHashes[id] };
+}
+
+GuestSymbol GuestStringPool::Intern(const GuestStringView& str) {
+    thread_local std::array<std::array<CacheEntry, CACHE_WAYS>, CACHE_SETS> s_cache = {};
+    thread_local uint32_t s_cacheTick = 0;
+
+    s_cacheTick++;
+
+    if (str.GetGuestAddress() != 0) {
+        // guest strings are at least word aligned, so the low bits don't tell them apart
+        std::array<CacheEntry, CACHE_WAYS>& set = s_cache[((str.GetGuestAddress() >> 2) * 0x9E3779B1u >> 25) % CACHE_SETS];
+        CacheEntry* oldest = &set[0];
+        for (CacheEntry& entry : set) {
+            // the guest can reuse a buffer for a different string, so the contents still need to match
+            if (entry.guestAddr == str.GetGuestAddress() && entry.str == str.View()) {
+                entry.lastUsed = s_cacheTick;
+                s_lookups++;
+                s_cacheHits++;
+                return entry.symbol;
+            }
+            if (entry.lastUsed < oldest->lastUsed) {
+                oldest = &entry;
+            }
+        }
+
+        GuestSymbol symbol = Intern(str.View());
+        *oldest = { str.GetGuestAddress(), s_cacheTick, symbol, GetString(symbol) };
+        return symbol;
+    }
+
+    return Intern(str.View());
+}
+
+std::string_view GuestStringPool::GetString(GuestSymbol symbol) {
+    std::shared_lock lock(s_poolMutex);
+    if (symbol.id >= s_poolStrings.size()) {
+        return {};
+    }
+    return s_poolStrings[symbol.id];
+}
+
+GuestStringPool::Stats GuestStringPool::GetStats() {
+    std::shared_lock lock(s_poolMutex);
+    return {
+        .lookups = s_lookups.load(),
+        .cacheHits = s_cacheHits.load(),
+        .poolHits = s_poolHits.load(),
+        .insertions = s_insertions.load(),
+        .symbols = (uint32_t)s_poolStrings.size()
+    };
+}
+
+void GuestStringPool::LogStats() {
+    Stats stats = GetStats();
+    double hitRate = stats.lookups == 0 ? 0.0 : (double)(stats.cacheHits + stats.poolHits) / (double)stats.lookups * 100.0;
+    Log::print<INFO>("Guest string pool: {} symbols, {} lookups, {} cache hits, {} pool hits, {} insertions ({:.2f}% hit rate)", stats.symbols, stats.lookups, stats.cacheHits, stats.poolHits, stats.insertions, hitRate);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+// fnv-1a, constexpr so that tables of known names can be hashed at compile time
+constexpr uint32_t GuestStringHash(std::string_view str) {
+    uint32_t hash = 0x811C9DC5;
+    for (char c : str) {
+        hash ^= (uint8_t)c;
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+// borrows a string directly from guest memory, never reads past maxLength bytes
+class GuestStringView {
+public:
+    static constexpr size_t MAX_LENGTH = 0x100;
+
+    GuestStringView() = default;
+    GuestStringView(uint32_t guestAddr, const char* hostPtr, size_t maxLength = MAX_LENGTH): m_guestAddr(guestAddr), m_view(hostPtr, hostPtr ? strnlen(hostPtr, maxLength) : 0) {}
+
+    uint32_t GetGuestAddress() const { return m_guestAddr; }
+    std::string_view View() const { return m_view; }
+    std::string Str() const { return std::string(m_view); }
+    bool Empty() const { return m_view.empty(); }
+    uint32_t Hash() const { return GuestStringHash(m_view); }
+
+    operator std::string_view() const { return m_view; }
+    bool operator==(std::string_view other) const { return m_view == other; }
+
+private:
+    uint32_t m_guestAddr = 0;
+    std::string_view m_view;
+};
+
+template <>
+struct std::formatter<GuestStringView> : std::formatter<std::string_view> {
+    auto format(const GuestStringView& str, format_context& ctx) const {
+        return std::formatter<std::string_view>::format(str.View(), ctx);
+    }
+};
+
+// stable 32-bit handle to an interned string, id 0 is reserved for the empty string
+struct GuestSymbol {
+    uint32_t id = 0;
+    uint32_t hash = GuestStringHash({});
+
+    bool operator==(const GuestSymbol& other) const { return id == other.id; }
+    explicit operator bool() const { return id != 0; }
+};
+
+class GuestStringPool {
+public:
+    struct Stats {
+        uint64_t lookups;
+        uint64_t cacheHits;
+        uint64_t poolHits;
+        uint64_t insertions;
+        uint32_t symbols;
+    };
+
+    // interns a string, only allocates the first time a string is seen
+    static GuestSymbol Intern(std::string_view str);
+    // same as above but first checks a small per-thread LRU cache keyed by the guest address, which skips hashing for repeated pointers
+    static GuestSymbol Intern(const GuestStringView& str);
+    // returns an empty symbol if the string was never interned
+    static GuestSymbol Find(std::string_view str);
+    static std::string_view GetString(GuestSymbol symbol);
+
+    static Stats GetStats();
+    static void LogStats();
+
+private:
+    // the cache is split into sets by guest address so that a lookup only compares against a few entries
+    static constexpr size_t CACHE_SETS = 128;
+    static constexpr size_t CACHE_WAYS = 4;
+
+    struct CacheEntry {
+        uint32_t guestAddr = 0;
+        uint32_t lastUsed = 0;
+        GuestSymbol symbol;
+        std::string_view str;
+    };
+
+    static std::atomic_uint64_t s_lookups;
+    static std::atomic_uint64_t s_cacheHits;
+    static std::atomic_uint64_t s_poolHits;
+    static std::atomic_uint64_t s_insertions;
+};
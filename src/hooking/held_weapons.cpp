@@ -0,0 +1,106 @@
+#include "held_weapons.h"
+
+bool HeldWeapons::IsDroppable(std::string_view actorName) {
+    static const std::string_view nonDroppableItems[] = {
+        "AncientArrow",
+        "Animal_Insect_A",
+        "Animal_Insect_B",
+        "Animal_Insect_F",
+        "Animal_Insect_H",
+        "Animal_Insect_M",
+        "Animal_Insect_S",
+        "Animal_Insect_X",
+        "Armor_Default_Extra_00",
+        "Armor_Default_Extra_01",
+        "bj_SupportApp_Wind",
+        "BombArrow_A",
+        "BrightArrow",
+        "BrightArrowTP",
+        "CarryBox",
+        "Dm_Npc_Gerudo_HeroSoul_Kago",
+        "Dm_Npc_Goron_HeroSoul_Kago",
+        "Dm_Npc_RevivalFairy",
+        "Dm_Npc_Rito_HeroSoul_Kago",
+        "Dm_Npc_Zora_HeroSoul_Kago",
+        "ElectricArrow",
+        "Explode",
+        "FireArrow",
+        "FireRodLv1Fire",
+        "FireRodLv2Fire",
+        "FireRodLv2FireChild",
+        "GameRomHorseReins_01",
+        "GameRomHorseReins_02",
+        "GameRomHorseReins_03",
+        "GameRomHorseReins_04",
+        "GameRomHorseReins_05",
+        "GameRomHorseReins_10",
+        "GameRomHorseSaddle_01",
+        "GameRomHorseSaddle_02",
+        "GameRomHorseSaddle_03",
+        "GameRomHorseSaddle_04",
+        "GameRomHorseSaddle_05",
+        "GameRomHorseSaddle_10",
+        "GameROMPlayer",
+        "Get_TwnObj_DLC_MemorialPicture_A_01",
+        "IceArrow",
+        "IceRodLv1Ice",
+        "IceRodLv2Ice",
+        "Item_Conductor",
+        "Item_CookSet",
+        "Item_Magnetglove",
+        "Item_Material_01",
+        "Item_Material_03",
+        "Item_Material_07",
+        "Item_Ore_F",
+        "KeySmall",
+        "NormalArrow",
+        "Obj_Armor_115_Head",
+        "Obj_DLC_HeroSeal_Gerudo",
+        "Obj_DLC_HeroSeal_Goron",
+        "Obj_DLC_HeroSeal_Rito",
+        "Obj_DLC_HeroSeal_Zora",
+        "Obj_DLC_HeroSoul_Gerudo",
+        "Obj_DLC_HeroSoul_Goron",
+        "Obj_DLC_HeroSoul_Rito",
+        "Obj_DLC_HeroSoul_Zora",
+        "Obj_DRStone_A_01",
+        "Obj_DRStone_Get",
+        "Obj_DungeonClearSeal",
+        "Obj_HeartUtuwa_A_01",
+        "Obj_HeroSoul_Gerudo",
+        "Obj_HeroSoul_Goron",
+        "Obj_HeroSoul_Rito",
+        "Obj_HeroSoul_Zora",
+        "Obj_IceMakerBlock",
+        "Obj_KorokNuts",
+        "Obj_Maracas",
+        "Obj_ProofBook",
+        "Obj_ProofGiantKiller",
+        "Obj_ProofGolemKiller",
+        "Obj_ProofKorok",
+        "Obj_ProofSandwormKiller",
+        "Obj_StaminaUtuwa_A_01",
+        "Obj_WarpDLC",
+        "PlayerStole2",
+        "PlayerStole2_Vagrant",
+        "Weapon_Bow_071",
+        "Weapon_Sword_056",
+        "Weapon_Sword_070",
+        "Weapon_Sword_080",
+        "Weapon_Sword_081",
+        "Weapon_Sword_502"
+    };
+
+    for (const auto& item : nonDroppableItems) {
+        if (actorName == item) {
+            return false;
+        }
+    }
+
+    // prevent dropping arrows
+    if (actorName.contains("Arrow")) {
+        return false;
+    }
+
+    return true;
+}
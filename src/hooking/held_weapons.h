@@ -0,0 +1,41 @@
+#pragma once
+#include "guest_string.h"
+
+// what's known about the weapon in each hand, only refreshed when a hand starts holding a different weapon
+class HeldWeapons {
+public:
+    struct Info {
+        uint32_t actorPtr = 0;
+        uint32_t nameHash = 0;
+        uint32_t type = 0;
+        bool droppable = false;
+    };
+
+    static bool IsDroppable(std::string_view actorName);
+
+    // the name is compared as well since the game can reuse the same actor memory for a new weapon.
+    // readType is only called when the weapon changed, returns whether it did
+    template <typename ReadType>
+    bool Update(uint32_t hand, uint32_t actorPtr, GuestStringView name, ReadType&& readType) {
+        Info& info = m_hands[hand];
+        const uint32_t nameHash = name.Hash();
+        if (info.actorPtr == actorPtr && info.nameHash == nameHash) {
+            return false;
+        }
+        info = {
+            .actorPtr = actorPtr,
+            .nameHash = nameHash,
+            .type = readType(),
+            .droppable = IsDroppable(name)
+        };
+        m_refreshes++;
+        return true;
+    }
+
+    const Info& Get(uint32_t hand) const { return m_hands[hand]; }
+    uint32_t GetRefreshes() const { return m_refreshes; }
+
+private:
+    std::array<Info, 2> m_hands = {};
+    uint32_t m_refreshes = 0;
+};
@@ -0,0 +1,41 @@
+#include "ik_solver.h"
+
+IKSolver::TwoBoneResult IKSolver::SolveTwoBone(const glm::fvec3& rootPos, float upperLength, float lowerLength, const glm::fvec3& targetPos, const glm::fvec3& poleDir, const JointLimits& limits) {
+    constexpr float epsilon = 0.001f;
+
+    glm::fvec3 dir = targetPos - rootPos;
+    float targetDist = glm::length(dir);
+    glm::fvec3 dirNorm = targetDist > 1e-6f ? dir / targetDist : glm::fvec3(1.0f, 0.0f, 0.0f);
+
+    // clamp distance to what the chain can reach
+    float dist = glm::clamp(targetDist, std::abs(upperLength - lowerLength) + epsilon, upperLength + lowerLength - epsilon);
+
+    // apply the joint limits by bending the middle joint to the limit and shortening/lengthening the reach to match
+    float cosBend = (dist * dist - upperLength * upperLength - lowerLength * lowerLength) / (2.0f * upperLength * lowerLength);
+    float bend = glm::acos(glm::clamp(cosBend, -1.0f, 1.0f));
+    float limitedBend = glm::clamp(bend, limits.minBend, limits.maxBend);
+    if (limitedBend != bend) {
+        dist = glm::sqrt(upperLength * upperLength + lowerLength * lowerLength + 2.0f * upperLength * lowerLength * glm::cos(limitedBend));
+    }
+
+    // law of cosines for angle at the root (alpha)
+    float cosAlpha = (upperLength * upperLength + dist * dist - lowerLength * lowerLength) / (2.0f * upperLength * dist);
+    float alpha = glm::acos(glm::clamp(cosAlpha, -1.0f, 1.0f));
+
+    // plane construction, falls back to any perpendicular axis when the pole is parallel to the target direction
+    glm::fvec3 planeNormal = glm::cross(dirNorm, poleDir);
+    if (glm::length2(planeNormal) < 1e-10f) {
+        planeNormal = glm::cross(dirNorm, std::abs(dirNorm.y) < 0.99f ? glm::fvec3(0.0f, 1.0f, 0.0f) : glm::fvec3(1.0f, 0.0f, 0.0f));
+    }
+    planeNormal = glm::normalize(planeNormal);
+    glm::fvec3 ortho = glm::normalize(glm::cross(planeNormal, dirNorm));
+
+    TwoBoneResult result = {};
+    result.planeNormal = planeNormal;
+    result.upperDir = glm::normalize(dirNorm * glm::cos(alpha) + ortho * glm::sin(alpha));
+    result.midPos = rootPos + result.upperDir * upperLength;
+    result.endPos = rootPos + dirNorm * dist;
+    result.lowerDir = glm::normalize(result.endPos - result.midPos);
+    result.reachError = glm::distance(result.endPos, targetPos);
+    return result;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// analytic two-bone solver, used to place Link's arms on the controllers. it only does math so that it can be checked on its own.
+class IKSolver {
+public:
+    // limits on how far the middle joint bends away from a straight chain, in radians
+    struct JointLimits {
+        float minBend = 0.0f;
+        float maxBend = glm::pi<float>();
+    };
+
+    struct TwoBoneResult {
+        glm::fvec3 upperDir;    // root to middle joint
+        glm::fvec3 lowerDir;    // middle joint to end
+        glm::fvec3 planeNormal; // normal of the plane the chain bends in
+        glm::fvec3 midPos;
+        glm::fvec3 endPos;
+        float reachError;       // distance between the end and the target, non-zero when out of reach or limited
+    };
+
+    // the pole is a direction that the middle joint bends towards
+    static TwoBoneResult SolveTwoBone(const glm::fvec3& rootPos, float upperLength, float lowerLength, const glm::fvec3& targetPos, const glm::fvec3& poleDir, const JointLimits& limits);
+};
@@ -0,0 +1,218 @@
+#include "input_journal.h"
+#include <fstream>
+
+// file layout: magic, version, profile hash and frame count as uint32, followed by the frames.
+// each frame is a uint16 of FieldFlags, the time since the previous frame as a varint and then only the fields that changed.
+template <typename T>
+static void AppendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool ReadRaw(std::string_view& in, T& value) {
+    if (in.size() < sizeof(T)) {
+        return false;
+    }
+    memcpy(&value, in.data(), sizeof(T));
+    in.remove_prefix(sizeof(T));
+    return true;
+}
+
+static void AppendVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((char)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char)value);
+}
+
+static bool ReadVarint(std::string_view& in, uint64_t& value) {
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (in.empty()) {
+            return false;
+        }
+        uint8_t byte = (uint8_t)in.front();
+        in.remove_prefix(1);
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool operator==(const XrVector2f& a, const XrVector2f& b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+void InputJournal::Record(const Frame& frame) {
+    std::lock_guard lock(m_mutex);
+    m_frames[m_next] = frame;
+    m_next = (m_next + 1) % CAPACITY;
+    m_count = std::min(m_count + 1, CAPACITY);
+}
+
+void InputJournal::Encode(std::string& out, const Frame& frame, const Frame& previous) {
+    uint16_t fields = 0;
+    if (frame.sources != previous.sources) fields |= FIELD_SOURCES;
+    if (frame.layer != previous.layer) fields |= FIELD_LAYER;
+    if (!(frame.xrLeftStick == previous.xrLeftStick)) fields |= FIELD_XR_LEFT_STICK;
+    if (!(frame.xrRightStick == previous.xrRightStick)) fields |= FIELD_XR_RIGHT_STICK;
+    if (frame.mappedButtons != previous.mappedButtons) fields |= FIELD_MAPPED_BUTTONS;
+    if (frame.stickButtons != previous.stickButtons) fields |= FIELD_STICK_BUTTONS;
+    if (frame.vpadHold != previous.vpadHold) fields |= FIELD_VPAD_HOLD;
+    if (!(frame.vpadLeftStick == previous.vpadLeftStick)) fields |= FIELD_VPAD_LEFT_STICK;
+    if (!(frame.vpadRightStick == previous.vpadRightStick)) fields |= FIELD_VPAD_RIGHT_STICK;
+
+    AppendRaw(out, fields);
+    AppendVarint(out, (uint64_t)std::max<int64_t>(frame.time - previous.time, 0));
+    if (fields & FIELD_SOURCES) AppendRaw(out, frame.sources);
+    if (fields & FIELD_LAYER) AppendRaw(out, frame.layer);
+    if (fields & FIELD_XR_LEFT_STICK) AppendRaw(out, frame.xrLeftStick);
+    if (fields & FIELD_XR_RIGHT_STICK) AppendRaw(out, frame.xrRightStick);
+    if (fields & FIELD_MAPPED_BUTTONS) AppendRaw(out, frame.mappedButtons);
+    if (fields & FIELD_STICK_BUTTONS) AppendRaw(out, frame.stickButtons);
+    if (fields & FIELD_VPAD_HOLD) AppendRaw(out, frame.vpadHold);
+    if (fields & FIELD_VPAD_LEFT_STICK) AppendRaw(out, frame.vpadLeftStick);
+    if (fields & FIELD_VPAD_RIGHT_STICK) AppendRaw(out, frame.vpadRightStick);
+}
+
+bool InputJournal::Decode(std::string_view& in, Frame& frame, const Frame& previous) {
+    uint16_t fields = 0;
+    uint64_t timeDelta = 0;
+    if (!ReadRaw(in, fields) || !ReadVarint(in, timeDelta)) {
+        return false;
+    }
+
+    frame = previous;
+    frame.time = previous.time + (int64_t)timeDelta;
+    bool valid = true;
+    if (fields & FIELD_SOURCES) valid &= ReadRaw(in, frame.sources);
+    if (fields & FIELD_LAYER) valid &= ReadRaw(in, frame.layer);
+    if (fields & FIELD_XR_LEFT_STICK) valid &= ReadRaw(in, frame.xrLeftStick);
+    if (fields & FIELD_XR_RIGHT_STICK) valid &= ReadRaw(in, frame.xrRightStick);
+    if (fields & FIELD_MAPPED_BUTTONS) valid &= ReadRaw(in, frame.mappedButtons);
+    if (fields & FIELD_STICK_BUTTONS) valid &= ReadRaw(in, frame.stickButtons);
+    if (fields & FIELD_VPAD_HOLD) valid &= ReadRaw(in, frame.vpadHold);
+    if (fields & FIELD_VPAD_LEFT_STICK) valid &= ReadRaw(in, frame.vpadLeftStick);
+    if (fields & FIELD_VPAD_RIGHT_STICK) valid &= ReadRaw(in, frame.vpadRightStick);
+    return valid;
+}
+
+std::string InputJournal::Serialize(uint32_t profileHash) const {
+    // copy the frames out first so that the hook isn't blocked while encoding
+    std::vector<Frame> frames;
+    {
+        std::lock_guard lock(m_mutex);
+        frames.reserve(m_count);
+        for (size_t i = 0; i < m_count; i++) {
+            frames.emplace_back(m_frames[(m_next + CAPACITY - m_count + i) % CAPACITY]);
+        }
+    }
+
+    std::string out;
+    out.reserve(16 + frames.size() * 8);
+    AppendRaw(out, FILE_MAGIC);
+    AppendRaw(out, FILE_VERSION);
+    AppendRaw(out, profileHash);
+    AppendRaw(out, (uint32_t)frames.size());
+
+    // the first frame is encoded against an empty frame at its own time, so the replayed times start at zero
+    Frame previous = { .time = frames.empty() ? 0 : frames.front().time };
+    for (const Frame& frame : frames) {
+        Encode(out, frame, previous);
+        previous = frame;
+    }
+    return out;
+}
+
+bool InputJournal::Save(const std::string& path, uint32_t profileHash) const {
+    const std::string out = Serialize(profileHash);
+
+    std::ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) {
+        Log::print<WARNING>("Failed to open {} to save the input journal", path);
+        return false;
+    }
+    f.write(out.data(), (std::streamsize)out.size());
+    Log::print<INFO>("Saved the input journal to {} ({} bytes)", path, out.size());
+    return true;
+}
+
+std::optional<InputJournal::ReplayResult> InputJournal::Replay(std::string_view in, InputMapping& mapping) {
+    uint32_t magic = 0, version = 0, profileHash = 0, frameCount = 0;
+    if (!ReadRaw(in, magic) || !ReadRaw(in, version) || !ReadRaw(in, profileHash) || !ReadRaw(in, frameCount) || magic != FILE_MAGIC || version != FILE_VERSION) {
+        Log::print<WARNING>("Input journal has an unsupported header");
+        return std::nullopt;
+    }
+
+    ReplayResult result = {
+        .frames = 0,
+        .comparedFrames = 0,
+        .mappingDivergences = 0,
+        .stickDivergences = 0,
+        .profileMatches = mapping.GetProfileHash() == profileHash
+    };
+    if (!result.profileMatches) {
+        Log::print<WARNING>("Input journal was recorded with a different input profile, expect divergences");
+    }
+
+    Frame previous = {};
+    bool comparing = false;
+    for (uint32_t i = 0; i < frameCount; i++) {
+        Frame frame;
+        if (!Decode(in, frame, previous)) {
+            Log::print<WARNING>("Input journal is truncated after {} frames", i);
+            break;
+        }
+        result.frames++;
+
+        const uint32_t mappedButtons = mapping.Evaluate((InputMapping::Layer)frame.layer, frame.sources, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(frame.time)));
+        // the timed triggers can't be restored from the middle of a press, so only start comparing once every button was released
+        comparing = comparing || (frame.sources & InputMapping::BUTTON_SOURCES) == 0;
+
+        // the stick emulation only depends on the previous frame, so it can be checked from the second frame onwards
+        const uint32_t stickButtons = InputMapping::EmulateStickButtons(previous.stickButtons, frame.xrLeftStick, frame.xrRightStick);
+        if (i > 0 && stickButtons != frame.stickButtons && result.stickDivergences++ < 16) {
+            Log::print<WARNING>("Input journal frame {} diverged in stick emulation: recorded 0x{:08X}, replayed 0x{:08X}", i, frame.stickButtons, stickButtons);
+        }
+
+        if (comparing) {
+            result.comparedFrames++;
+            if (mappedButtons != frame.mappedButtons && result.mappingDivergences++ < 16) {
+                Log::print<WARNING>("Input journal frame {} diverged in mapped buttons: recorded 0x{:08X}, replayed 0x{:08X} (sources 0x{:016X}, layer {})", i, frame.mappedButtons, mappedButtons, frame.sources, frame.layer);
+            }
+        }
+        previous = frame;
+    }
+    return result;
+}
+
+std::optional<InputJournal::ReplayResult> InputJournal::ReplayFile(const std::string& path) {
+    std::ifstream f(path, std::ios::in | std::ios::binary);
+    if (!f.is_open()) {
+        Log::print<WARNING>("Failed to open input journal {}", path);
+        return std::nullopt;
+    }
+    const std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    InputMapping mapping;
+    mapping.LoadProfile();
+    std::optional<ReplayResult> result = Replay(data, mapping);
+    if (result) {
+        Log::print<INFO>("Replayed {} input journal frames from {}: {} mapping divergences over {} compared frames, {} stick divergences", result->frames, path, result->mappingDivergences, result->comparedFrames, result->stickDivergences);
+    }
+    return result;
+}
+
+std::string InputJournal::GetDefaultPath() {
+    char path[MAX_PATH];
+    if (GetModuleFileNameA(nullptr, path, MAX_PATH) == 0) {
+        return "BetterVR_input_journal.bin";
+    }
+    std::string exePath(path);
+    const size_t lastSlash = exePath.find_last_of("\\/");
+    const std::string dir = (lastSlash == std::string::npos) ? std::string() : exePath.substr(0, lastSlash + 1);
+    return dir + "BetterVR_input_journal.bin";
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "input_mapping.h"
+
+// keeps the last few thousand frames of what hook_InjectXRInput saw and wrote into VPADStatus, so input bugs can be saved and replayed
+class InputJournal {
+public:
+    static constexpr size_t CAPACITY = 4096; // a bit over two minutes at 30 fps
+    static constexpr uint32_t FILE_MAGIC = 0x4256524A; // "JRVB" as it's written to the file
+    static constexpr uint32_t FILE_VERSION = 1;
+
+    struct Frame {
+        int64_t time; // steady_clock nanoseconds
+        InputMapping::SourceMask sources;
+        uint8_t layer;
+        // the XR sticks after the hook adjusted them, which is what the stick emulation saw
+        XrVector2f xrLeftStick;
+        XrVector2f xrRightStick;
+        uint32_t mappedButtons;
+        uint32_t stickButtons;
+        // what was written into VPADStatus, which includes any gamepad input
+        uint32_t vpadHold;
+        XrVector2f vpadLeftStick;
+        XrVector2f vpadRightStick;
+    };
+
+    struct ReplayResult {
+        size_t frames;
+        size_t comparedFrames;
+        size_t mappingDivergences;
+        size_t stickDivergences;
+        bool profileMatches;
+    };
+
+    // only called from the emulated CPU thread
+    void Record(const Frame& frame);
+
+    // delta encodes the recorded frames, oldest first
+    std::string Serialize(uint32_t profileHash) const;
+    bool Save(const std::string& path, uint32_t profileHash) const;
+
+    // feeds serialized frames back through the given mapping and the stick emulation and compares the results. the mapping should
+    // be freshly compiled, since its timed triggers carry over between evaluations. it doesn't need the game or any files.
+    static std::optional<ReplayResult> Replay(std::string_view data, InputMapping& mapping);
+    // replays a saved journal against the input profile that's currently in Cemu's directory
+    static std::optional<ReplayResult> ReplayFile(const std::string& path);
+
+    static std::string GetDefaultPath();
+
+private:
+    enum FieldFlags : uint16_t {
+        FIELD_SOURCES = 1 << 0,
+        FIELD_LAYER = 1 << 1,
+        FIELD_XR_LEFT_STICK = 1 << 2,
+        FIELD_XR_RIGHT_STICK = 1 << 3,
+        FIELD_MAPPED_BUTTONS = 1 << 4,
+        FIELD_STICK_BUTTONS = 1 << 5,
+        FIELD_VPAD_HOLD = 1 << 6,
+        FIELD_VPAD_LEFT_STICK = 1 << 7,
+        FIELD_VPAD_RIGHT_STICK = 1 << 8,
+    };
+
+    static void Encode(std::string& out, const Frame& frame, const Frame& previous);
+    static bool Decode(std::string_view& in, Frame& frame, const Frame& previous);
+
+    mutable std::mutex m_mutex;
+    std::array<Frame, CAPACITY> m_frames = {};
+    size_t m_next = 0;
+    size_t m_count = 0;
+};
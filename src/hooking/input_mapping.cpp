@@ -0,0 +1,299 @@
+#include "input_mapping.h"
+#include "guest_string.h"
+#include <fstream>
+
+// reproduces the mappings that used to be hard-coded in hook_InjectXRInput
+static constexpr std::string_view s_defaultProfile = R"(
+# layers           trigger  chord                                                                    -> buttons
+gameplay,cutscene  long     map_inventory + menu_allowed                                             -> minus
+gameplay,cutscene  tap      map_inventory + menu_allowed                                             -> plus
+gameplay,cutscene  hold     jump                                                                     -> x
+gameplay,cutscene  hold     crouch                                                                   -> stick_l
+gameplay,cutscene  hold     interact                                                                 -> a
+gameplay,cutscene  hold     attack                                                                   -> y
+gameplay,cutscene  hold     use_rune                                                                 -> l
+gameplay,cutscene  long     run                                                                      -> b
+gameplay,cutscene  hold     grab_left + !left_hand_behind_head                                       -> a
+gameplay,cutscene  hold     grab_left + !left_hand_behind_head + left_stick_up + menu_allowed        -> up
+gameplay,cutscene  hold     grab_left + !left_hand_behind_head + left_stick_right + menu_allowed     -> right
+gameplay,cutscene  hold     grab_left + !left_hand_behind_head + left_stick_down + menu_allowed      -> down
+gameplay,cutscene  hold     grab_left + !left_hand_behind_head + left_stick_left + menu_allowed      -> left
+gameplay,cutscene  hold     grab_left + left_hand_behind_head + left_hand_near_head                  -> r
+gameplay,cutscene  hold     grab_right + !right_hand_behind_head + !right_stick_down + grab_allowed  -> a
+gameplay,cutscene  hold     grab_right + right_hand_behind_head + right_hand_near_head               -> r
+gameplay,cutscene  hold     trigger_left                                                             -> zl
+gameplay,cutscene  hold     trigger_right                                                            -> zr
+menu               hold     map_inventory + menu_allowed + map_open                                  -> minus
+menu               hold     map_inventory + menu_allowed + !map_open                                 -> plus
+menu               hold     select                                                                   -> a
+menu               hold     back                                                                     -> b
+menu               hold     sort                                                                     -> y
+menu               hold     hold                                                                     -> x
+menu               hold     trigger_left                                                             -> l
+menu               hold     trigger_right                                                            -> r
+menu               hold     grip_left + left_stick_up                                                -> up
+menu               hold     grip_left + left_stick_right                                             -> right
+menu               hold     grip_left + left_stick_down                                              -> down
+menu               hold     grip_left + left_stick_left                                              -> left
+)";
+
+static constexpr std::array<std::string_view, (size_t)InputMapping::Source::COUNT> s_sourceNames = {
+    "jump", "crouch", "run", "attack", "use_rune", "throw_weapon", "cancel", "interact", "grab_left", "grab_right",
+    "select", "back", "sort", "hold", "grip_left", "grip_right",
+    "map_inventory", "trigger_left", "trigger_right",
+    "left_stick_up", "left_stick_right", "left_stick_down", "left_stick_left",
+    "right_stick_up", "right_stick_right", "right_stick_down", "right_stick_left",
+    "left_hand_behind_head", "right_hand_behind_head", "left_hand_near_head", "right_hand_near_head",
+    "menu_allowed", "grab_allowed", "map_open"
+};
+
+static constexpr std::array<std::pair<std::string_view, VPADButtons>, 19> s_buttonNames = { {
+    { "a", VPAD_BUTTON_A }, { "b", VPAD_BUTTON_B }, { "x", VPAD_BUTTON_X }, { "y", VPAD_BUTTON_Y },
+    { "left", VPAD_BUTTON_LEFT }, { "right", VPAD_BUTTON_RIGHT }, { "up", VPAD_BUTTON_UP }, { "down", VPAD_BUTTON_DOWN },
+    { "zl", VPAD_BUTTON_ZL }, { "zr", VPAD_BUTTON_ZR }, { "l", VPAD_BUTTON_L }, { "r", VPAD_BUTTON_R },
+    { "plus", VPAD_BUTTON_PLUS }, { "minus", VPAD_BUTTON_MINUS }, { "home", VPAD_BUTTON_HOME },
+    { "stick_l", VPAD_BUTTON_STICK_L }, { "stick_r", VPAD_BUTTON_STICK_R }, { "tv", VPAD_BUTTON_TV }, { "sync", VPAD_BUTTON_SYNC }
+} };
+
+// game state sources only gate whether a node can fire, they don't count as pressing or releasing its chord.
+// this way a button that's still held from the previous layer can't start a tap once the gate opens.
+static constexpr InputMapping::SourceMask CONDITION_SOURCES = InputMapping::SourceBit(InputMapping::Source::MENU_ALLOWED) | InputMapping::SourceBit(InputMapping::Source::GRAB_ALLOWED) | InputMapping::SourceBit(InputMapping::Source::MAP_OPEN);
+
+static std::string_view Trim(std::string_view str) {
+    size_t start = str.find_first_not_of(" \t\r");
+    if (start == std::string_view::npos) {
+        return {};
+    }
+    return str.substr(start, str.find_last_not_of(" \t\r") - start + 1);
+}
+
+// calls the callback for every trimmed part of the string that's separated by the delimiter, stops early if it returns false
+template <typename F>
+static bool ForEachPart(std::string_view str, char delimiter, F&& callback) {
+    while (true) {
+        size_t pos = str.find(delimiter);
+        if (!callback(Trim(str.substr(0, pos)))) {
+            return false;
+        }
+        if (pos == std::string_view::npos) {
+            return true;
+        }
+        str.remove_prefix(pos + 1);
+    }
+}
+
+std::optional<InputMapping::Node> InputMapping::ParseLine(std::string_view line, std::string& error) {
+    size_t arrowPos = line.find("->");
+    if (arrowPos == std::string_view::npos) {
+        error = "missing '->'";
+        return std::nullopt;
+    }
+
+    std::string_view lhs = Trim(line.substr(0, arrowPos));
+    size_t layersEnd = lhs.find_first_of(" \t");
+    size_t triggerStart = lhs.find_first_not_of(" \t", layersEnd);
+    size_t triggerEnd = lhs.find_first_of(" \t", triggerStart);
+    if (layersEnd == std::string_view::npos || triggerStart == std::string_view::npos || triggerEnd == std::string_view::npos) {
+        error = "expected '<layers> <trigger> <chord> -> <buttons>'";
+        return std::nullopt;
+    }
+
+    Node node = {};
+    bool valid = ForEachPart(lhs.substr(0, layersEnd), ',', [&](std::string_view layer) {
+        if (layer == "menu") node.layers |= LAYER_MENU;
+        else if (layer == "gameplay") node.layers |= LAYER_GAMEPLAY;
+        else if (layer == "cutscene") node.layers |= LAYER_CUTSCENE;
+        else {
+            error = std::format("unknown layer '{}'", layer);
+            return false;
+        }
+        return true;
+    });
+    if (!valid) {
+        return std::nullopt;
+    }
+
+    std::string_view trigger = lhs.substr(triggerStart, triggerEnd - triggerStart);
+    if (trigger == "hold") node.trigger = Trigger::HOLD;
+    else if (trigger == "long") node.trigger = Trigger::LONG_PRESS;
+    else if (trigger == "tap") node.trigger = Trigger::TAP;
+    else if (trigger == "double") node.trigger = Trigger::DOUBLE_TAP;
+    else {
+        error = std::format("unknown trigger '{}'", trigger);
+        return std::nullopt;
+    }
+
+    valid = ForEachPart(lhs.substr(triggerEnd), '+', [&](std::string_view sourceName) {
+        bool negated = sourceName.starts_with('!');
+        if (negated) {
+            sourceName = Trim(sourceName.substr(1));
+        }
+        auto it = std::ranges::find(s_sourceNames, sourceName);
+        if (it == s_sourceNames.end()) {
+            error = std::format("unknown source '{}'", sourceName);
+            return false;
+        }
+        (negated ? node.blocked : node.required) |= SourceBit((Source)std::distance(s_sourceNames.begin(), it));
+        return true;
+    });
+    if (!valid) {
+        return std::nullopt;
+    }
+    if ((node.required & node.blocked) != 0) {
+        error = "a source can't be both required and blocked";
+        return std::nullopt;
+    }
+
+    valid = ForEachPart(line.substr(arrowPos + 2), '|', [&](std::string_view buttonName) {
+        auto it = std::ranges::find(s_buttonNames, buttonName, &std::pair<std::string_view, VPADButtons>::first);
+        if (it == s_buttonNames.end()) {
+            error = std::format("unknown button '{}'", buttonName);
+            return false;
+        }
+        node.buttons |= it->second;
+        return true;
+    });
+    if (!valid) {
+        return std::nullopt;
+    }
+    return node;
+}
+
+bool InputMapping::Compile(std::string_view profile, std::string_view profileName) {
+    std::vector<Node> nodes;
+    bool valid = true;
+    uint32_t lineNumber = 0;
+    ForEachPart(profile, '\n', [&](std::string_view line) {
+        lineNumber++;
+        line = Trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            return true;
+        }
+
+        std::string error;
+        if (std::optional<Node> node = ParseLine(line, error)) {
+            nodes.emplace_back(*node);
+        }
+        else {
+            Log::print<WARNING>("Invalid input mapping in {} on line {}: {}", profileName, lineNumber, error);
+            valid = false;
+        }
+        return true;
+    });
+
+    if (!valid) {
+        return false;
+    }
+    m_nodes = std::move(nodes);
+    m_states.assign(m_nodes.size(), NodeState{});
+    m_profileHash = GuestStringHash(profile);
+    return true;
+}
+
+void InputMapping::LoadProfile() {
+    char path[MAX_PATH];
+    if (GetModuleFileNameA(nullptr, path, MAX_PATH) != 0) {
+        std::string exePath(path);
+        const size_t lastSlash = exePath.find_last_of("\\/");
+        const std::string dir = (lastSlash == std::string::npos) ? std::string() : exePath.substr(0, lastSlash + 1);
+        const std::string filePath = dir + "BetterVR_input_profile.txt";
+
+        std::ifstream f(filePath, std::ios::in);
+        if (f.is_open()) {
+            std::string profile((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+            if (Compile(profile, filePath)) {
+                Log::print<CONTROLS>("Loaded {} input mappings from {}", m_nodes.size(), filePath);
+                return;
+            }
+            Log::print<WARNING>("Falling back to the default input mappings since {} is invalid", filePath);
+        }
+    }
+
+    checkAssert(Compile(s_defaultProfile, "the default input profile"), "The default input profile should always compile!");
+    Log::print<CONTROLS>("Loaded {} default input mappings", m_nodes.size());
+}
+
+uint32_t InputMapping::Evaluate(Layer layer, SourceMask sources, std::chrono::steady_clock::time_point now) {
+    uint32_t buttons = 0;
+    for (size_t i = 0; i < m_nodes.size(); i++) {
+        const Node& node = m_nodes[i];
+        NodeState& state = m_states[i];
+
+        // every node keeps tracking its chord even when its layer isn't active, so switching layers doesn't create fake presses
+        const bool held = (sources & node.required & ~CONDITION_SOURCES) == (node.required & ~CONDITION_SOURCES) && (sources & node.blocked & ~CONDITION_SOURCES) == 0;
+        const bool conditionsMet = (sources & node.required & CONDITION_SOURCES) == (node.required & CONDITION_SOURCES) && (sources & node.blocked & CONDITION_SOURCES) == 0;
+        const bool pressed = held && !state.wasHeld;
+        const bool released = !held && state.wasHeld;
+        state.wasHeld = held;
+
+        bool active = false;
+        switch (node.trigger) {
+            case Trigger::HOLD: {
+                active = held;
+                break;
+            }
+            case Trigger::LONG_PRESS: {
+                if (pressed) {
+                    state.pressStartTime = now;
+                }
+                active = held && now - state.pressStartTime >= LONG_PRESS_TIME;
+                break;
+            }
+            case Trigger::TAP:
+            case Trigger::DOUBLE_TAP: {
+                const bool windowExpired = state.waitingForSecond && now - state.lastReleaseTime > DOUBLE_TAP_WINDOW;
+                if (pressed) {
+                    state.isSecondPress = state.waitingForSecond && !windowExpired;
+                    // if the evaluations were too far apart to see the window expire, the previous tap still counts
+                    active = node.trigger == Trigger::DOUBLE_TAP ? state.isSecondPress : windowExpired;
+                    state.waitingForSecond = false;
+                    state.pressStartTime = now;
+                }
+                else if (released) {
+                    if (!state.isSecondPress && now - state.pressStartTime < LONG_PRESS_TIME) {
+                        state.waitingForSecond = true;
+                        state.lastReleaseTime = now;
+                    }
+                    state.isSecondPress = false;
+                }
+                else if (windowExpired) {
+                    state.waitingForSecond = false;
+                    active = node.trigger == Trigger::TAP;
+                }
+                break;
+            }
+        }
+
+        if (active && conditionsMet && (node.layers & layer) != 0) {
+            buttons |= node.buttons;
+        }
+    }
+
+    return buttons;
+}
+
+uint32_t InputMapping::EmulateStickButtons(uint32_t previous, const XrVector2f& leftStick, const XrVector2f& rightStick) {
+    uint32_t buttons = 0;
+
+    if (leftStick.x <= -AXIS_THRESHOLD || (HAS_FLAG(previous, VPAD_STICK_L_EMULATION_LEFT) && leftStick.x <= -HOLD_THRESHOLD))
+        buttons |= VPAD_STICK_L_EMULATION_LEFT;
+    else if (leftStick.x >= AXIS_THRESHOLD || (HAS_FLAG(previous, VPAD_STICK_L_EMULATION_RIGHT) && leftStick.x >= HOLD_THRESHOLD))
+        buttons |= VPAD_STICK_L_EMULATION_RIGHT;
+
+    if (leftStick.y <= -AXIS_THRESHOLD || (HAS_FLAG(previous, VPAD_STICK_L_EMULATION_DOWN) && leftStick.y <= -HOLD_THRESHOLD))
+        buttons |= VPAD_STICK_L_EMULATION_DOWN;
+    else if (leftStick.y >= AXIS_THRESHOLD || (HAS_FLAG(previous, VPAD_STICK_L_EMULATION_UP) && leftStick.y >= HOLD_THRESHOLD))
+        buttons |= VPAD_STICK_L_EMULATION_UP;
+
+    if (rightStick.x <= -AXIS_THRESHOLD || (HAS_FLAG(previous, VPAD_STICK_R_EMULATION_LEFT) && rightStick.x <= -HOLD_THRESHOLD))
+        buttons |= VPAD_STICK_R_EMULATION_LEFT;
+    else if (rightStick.x >= AXIS_THRESHOLD || (HAS_FLAG(previous, VPAD_STICK_R_EMULATION_RIGHT) && rightStick.x >= HOLD_THRESHOLD))
+        buttons |= VPAD_STICK_R_EMULATION_RIGHT;
+
+    if (rightStick.y <= -AXIS_THRESHOLD || (HAS_FLAG(previous, VPAD_STICK_R_EMULATION_DOWN) && rightStick.y <= -HOLD_THRESHOLD))
+        buttons |= VPAD_STICK_R_EMULATION_DOWN;
+    else if (rightStick.y >= AXIS_THRESHOLD || (HAS_FLAG(previous, VPAD_STICK_R_EMULATION_UP) && rightStick.y >= HOLD_THRESHOLD))
+        buttons |= VPAD_STICK_R_EMULATION_UP;
+
+    return buttons;
+}
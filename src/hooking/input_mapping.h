@@ -0,0 +1,143 @@
+#pragma once
+
+enum VPADButtons : uint32_t {
+    VPAD_BUTTON_A                 = 0x8000,
+    VPAD_BUTTON_B                 = 0x4000,
+    VPAD_BUTTON_X                 = 0x2000,
+    VPAD_BUTTON_Y                 = 0x1000,
+    VPAD_BUTTON_LEFT              = 0x0800,
+    VPAD_BUTTON_RIGHT             = 0x0400,
+    VPAD_BUTTON_UP                = 0x0200,
+    VPAD_BUTTON_DOWN              = 0x0100,
+    VPAD_BUTTON_ZL                = 0x0080,
+    VPAD_BUTTON_ZR                = 0x0040,
+    VPAD_BUTTON_L                 = 0x0020,
+    VPAD_BUTTON_R                 = 0x0010,
+    VPAD_BUTTON_PLUS              = 0x0008,
+    VPAD_BUTTON_MINUS             = 0x0004,
+    VPAD_BUTTON_HOME              = 0x0002,
+    VPAD_BUTTON_SYNC              = 0x0001,
+    VPAD_BUTTON_STICK_R           = 0x00020000,
+    VPAD_BUTTON_STICK_L           = 0x00040000,
+    VPAD_BUTTON_TV                = 0x00010000,
+    VPAD_STICK_R_EMULATION_LEFT   = 0x04000000,
+    VPAD_STICK_R_EMULATION_RIGHT  = 0x02000000,
+    VPAD_STICK_R_EMULATION_UP     = 0x01000000,
+    VPAD_STICK_R_EMULATION_DOWN   = 0x00800000,
+    VPAD_STICK_L_EMULATION_LEFT   = 0x40000000,
+    VPAD_STICK_L_EMULATION_RIGHT  = 0x20000000,
+    VPAD_STICK_L_EMULATION_UP     = 0x10000000,
+    VPAD_STICK_L_EMULATION_DOWN   = 0x08000000,
+};
+
+constexpr float AXIS_THRESHOLD = 0.5f;
+constexpr float HOLD_THRESHOLD = 0.1f;
+
+// turns the per-frame XR input signals into VPAD buttons using a flat list of nodes that's compiled once from a text profile.
+// a profile line looks like "<layers> <trigger> <source> + <source> + !<source> -> <button> | <button>", see s_defaultProfile for the built-in one.
+class InputMapping {
+public:
+    enum Layer : uint8_t {
+        LAYER_MENU = 1 << 0,
+        LAYER_GAMEPLAY = 1 << 1,
+        LAYER_CUTSCENE = 1 << 2,
+    };
+
+    enum class Source : uint8_t {
+        // gameplay
+        JUMP,
+        CROUCH,
+        RUN,
+        ATTACK,
+        USE_RUNE,
+        THROW_WEAPON,
+        CANCEL,
+        INTERACT,
+        GRAB_LEFT,
+        GRAB_RIGHT,
+        // menu
+        SELECT,
+        BACK,
+        SORT,
+        HOLD,
+        GRIP_LEFT,
+        GRIP_RIGHT,
+        // shared
+        MAP_INVENTORY,
+        TRIGGER_LEFT,
+        TRIGGER_RIGHT,
+        // stick zones, only one zone per stick is active at a time
+        LEFT_STICK_UP,
+        LEFT_STICK_RIGHT,
+        LEFT_STICK_DOWN,
+        LEFT_STICK_LEFT,
+        RIGHT_STICK_UP,
+        RIGHT_STICK_RIGHT,
+        RIGHT_STICK_DOWN,
+        RIGHT_STICK_LEFT,
+        // gestures
+        LEFT_HAND_BEHIND_HEAD,
+        RIGHT_HAND_BEHIND_HEAD,
+        LEFT_HAND_NEAR_HEAD,
+        RIGHT_HAND_NEAR_HEAD,
+        // game state
+        MENU_ALLOWED,
+        GRAB_ALLOWED,
+        MAP_OPEN,
+        COUNT
+    };
+    static_assert((size_t)Source::COUNT <= 64, "Sources need to fit into a single mask");
+
+    using SourceMask = uint64_t;
+    static constexpr SourceMask SourceBit(Source source) { return 1ull << (uint8_t)source; }
+    // the sources up to and including the triggers are buttons that can be pressed and released
+    static constexpr SourceMask BUTTON_SOURCES = (1ull << ((uint8_t)Source::TRIGGER_RIGHT + 1)) - 1;
+
+    enum class Trigger : uint8_t {
+        HOLD,       // active for as long as the chord is held
+        LONG_PRESS, // active while the chord is held for longer than LONG_PRESS_TIME
+        TAP,        // active for one evaluation once a short press didn't turn into a double tap
+        DOUBLE_TAP, // active for one evaluation when the chord is pressed again within DOUBLE_TAP_WINDOW
+    };
+
+    // same timings that ButtonState used in OpenXR::UpdateActions
+    static constexpr std::chrono::milliseconds LONG_PRESS_TIME{ 250 };
+    static constexpr std::chrono::milliseconds DOUBLE_TAP_WINDOW{ 150 };
+
+    struct Node {
+        uint8_t layers;
+        Trigger trigger;
+        SourceMask required; // all of these need to be active
+        SourceMask blocked;  // none of these can be active
+        uint32_t buttons;
+    };
+
+    // replaces the current nodes, returns false and keeps the old ones if any line fails to parse
+    bool Compile(std::string_view profile, std::string_view profileName);
+    // loads BetterVR_input_profile.txt from Cemu's directory, or the built-in profile if there's none or it's invalid
+    void LoadProfile();
+
+    // single pass over the nodes, doesn't allocate and only depends on the given time so scripted timelines replay the same way
+    uint32_t Evaluate(Layer layer, SourceMask sources, std::chrono::steady_clock::time_point now);
+
+    // digital stick directions with hysteresis, previous is the result of the last call
+    static uint32_t EmulateStickButtons(uint32_t previous, const XrVector2f& leftStick, const XrVector2f& rightStick);
+
+    size_t GetNodeCount() const { return m_nodes.size(); }
+    uint32_t GetProfileHash() const { return m_profileHash; }
+
+private:
+    struct NodeState {
+        bool wasHeld = false;
+        bool waitingForSecond = false;
+        bool isSecondPress = false;
+        std::chrono::steady_clock::time_point pressStartTime;
+        std::chrono::steady_clock::time_point lastReleaseTime;
+    };
+
+    static std::optional<Node> ParseLine(std::string_view line, std::string& error);
+
+    std::vector<Node> m_nodes;
+    std::vector<NodeState> m_states;
+    uint32_t m_profileHash = 0;
+};
@@ -0,0 +1,222 @@
+#include "player_skeleton.h"
+
+static const std::string SKELETON_DATA = R"(
+Root | 0 0 0 | 0 0 0
+  Skl_Root | 0 0.99426 0 | 0 0 0
+    Spine_1 | 0 0 0 | 1.5708 0 1.5708
+      Spine_2 | 0.136 0 0 | 0 0 0
+        Clavicle_L | 0.23961 -0.00002 0.03291 | 0 -1.5708 0
+          Arm_1_L | 0.15 0 0.01074 | 0 0 0
+            Arm_1_Assist_L | 0.06 0.00002 0 | 0 0 0
+            Arm_2_L | 0.24 0 0 | 0 0 0
+              Elbow_L | 0.04151 -0.02934 0.00021 | 0 0 0
+              Wrist_Assist_L | 0.25809 0.00002 -0.00012 | 0 0 0
+              Wrist_L | 0.27718 0 0 | 0 0 0
+                Weapon_L | 0.1069 0.00002 0.02769 | 1.5708 0 3.14159
+          Clavicle_Assist_L | 0.116 0 0.0107 | 0 0 0
+        Clavicle_R | 0.2396 -0.00002 -0.03291 | 3.14159 -1.5708 0
+          Arm_1_R | -0.15 0 -0.01074 | 0 0 0
+            Arm_1_Assist_R | -0.06 -0.00002 0 | 0 0 0
+            Arm_2_R | -0.24 0 0 | 0 0 0
+              Elbow_R | -0.04151 0.02934 -0.0002 | 0 0 0
+              Wrist_Assist_R | -0.25809 -0.00002 0.00012 | 0 0 0
+              Wrist_R | -0.27718 0 0 | 0 0 0
+                Weapon_R | -0.1069 -0.00002 -0.02769 | 1.5708 0 0
+          Clavicle_Assist_R | -0.116 0 -0.0107 | 0 0 0
+        Neck | 0.26326 0 0 | 0 0 0
+          Head | 0.12447 0 0 | 0 0 0
+            Face_Root | 0 0 0 | 0 0 0
+              Chin | 0.04787 0.05757 0 | 0 0 2.53073
+              Eyeball_L | 0.07017 0.12036 0.04815 | 0 0 0
+              Eyeball_R | 0.07017 0.12036 -0.04815 | 0 0 0
+)";
+
+/*
+    Waist | 0 0 0 | 1.5708 0 -1.5708
+      Leg_1_L | 0.10854 0.0165 -0.11209 | 0 0 0
+        Knee_L | 0.39619 0.0308 0 | 0 0 0
+        Leg_2_L | 0.42 0 -0.08727 | 0 0 0
+      Leg_1_R | 0.10854 0.0165 0.11209 | 0 0 3.14159
+        Knee_R | -0.39619 -0.0308 0 | 0 0 0
+        Leg_2_R | -0.42 0 -0.08727 | 0 0 0
+ */
+
+bool PlayerSkeleton::IsFaceBone(std::string_view boneName) {
+    if (boneName.starts_with("Eye" /*lid*/) || boneName.starts_with("Cheek") || boneName.starts_with("Lip") || boneName.starts_with("Hair")) {
+        return true;
+    }
+    if (boneName == "Nose" || boneName == "Ponytail_A_1" || boneName == "Neck" || boneName == "Head" || boneName.starts_with("Teeth_") || boneName.starts_with("Chin")) {
+        return true;
+    }
+    return false;
+}
+
+PlayerSkeleton::PlayerSkeleton() {
+    m_skeleton.Parse(SKELETON_DATA);
+    m_localMatrices.resize(m_skeleton.GetBoneCount());
+
+    glm::fquat wristRotationHardcodedLeft = glm::identity<glm::fquat>();
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(90.0f), glm::fvec3(0, 1, 0));
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(-90.0f), glm::fvec3(0, 0, 1));
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(-45.0f), glm::fvec3(1, 0, 0));
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(45.0f), glm::fvec3(1, 0, 0));
+
+    glm::fquat wristRotationHardcodedRight = glm::identity<glm::fquat>();
+    wristRotationHardcodedRight *= glm::angleAxis(glm::radians(-90.0f), glm::fvec3(0, 0, 1));
+    wristRotationHardcodedRight *= glm::angleAxis(glm::radians(-180.0f), glm::fvec3(0, 1, 0));
+    wristRotationHardcodedRight *= glm::angleAxis(glm::radians(270.0f), glm::fvec3(1, 0, 0));
+
+    // slightly tweak it for a nicer alignment of the virtual hands
+    wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(30.0f), glm::fvec3(0, 0, 1));
+    wristRotationHardcodedRight *= glm::angleAxis(glm::radians(30.0f), glm::fvec3(0, 0, 1));
+
+    m_handCorrectionRotations = { glm::mat4_cast(wristRotationHardcodedLeft), glm::mat4_cast(wristRotationHardcodedRight) };
+
+    // calculate eye offset from eyeball bones
+    Bone* eyeL = m_skeleton.GetBone("Eyeball_L");
+    Bone* eyeR = m_skeleton.GetBone("Eyeball_R");
+    Bone* sklRoot = m_skeleton.GetBone("Skl_Root");
+    if (eyeL && eyeR && sklRoot) {
+        glm::vec3 eyePos = (glm::vec3(eyeL->worldMatrix[3]) + glm::vec3(eyeR->worldMatrix[3])) * 0.5f;
+        glm::vec3 rootPos = glm::vec3(sklRoot->worldMatrix[3]);
+        m_eyeOffset = eyePos - rootPos;
+    }
+}
+
+// the wrist's target in model space
+glm::mat4 PlayerSkeleton::CalculateWristTarget(uint8_t side, const std::pair<glm::fvec3, glm::fquat>& hand, const PassInputs& inputs) {
+    const auto& [controllerPos, controllerRot] = hand;
+
+    // construct controller matrix in tracking space
+    glm::mat4 controllerMat = glm::translate(glm::identity<glm::mat4>(), controllerPos) * glm::mat4_cast(controllerRot) * m_handCorrectionRotations[side];
+
+    // transform to world space
+    // we treat the camera as the origin of the tracking space
+    glm::mat4 targetWorld = inputs.cameraMtx * controllerMat;
+
+    if (Bone* weaponBone = m_skeleton.GetBone(side == 0 ? "Weapon_L" : "Weapon_R")) {
+        glm::vec3 weaponOffset = glm::vec3(weaponBone->localMatrix[3]);
+        targetWorld = targetWorld * glm::translate(glm::identity<glm::mat4>(), -weaponOffset);
+    }
+
+    // convert targetWorld to model space
+    return glm::inverse(inputs.playerMtx) * targetWorld;
+}
+
+// solves the upper arm ik for both arms so the hands reach the vr controllers
+void PlayerSkeleton::SolveArms(const PassInputs& inputs) {
+    struct ArmBones {
+        int arm1;
+        int arm2;
+        int wrist;
+    };
+    const std::array<ArmBones, 2> armBones = {
+        ArmBones{ m_skeleton.GetBoneIndex("Arm_1_L"), m_skeleton.GetBoneIndex("Arm_2_L"), m_skeleton.GetBoneIndex("Wrist_L") },
+        ArmBones{ m_skeleton.GetBoneIndex("Arm_1_R"), m_skeleton.GetBoneIndex("Arm_2_R"), m_skeleton.GetBoneIndex("Wrist_R") }
+    };
+
+    // rotate the pole vectors by the body rotation (Skl_Root)
+    glm::quat rootRot = glm::identity<glm::quat>();
+    if (Bone* rootBone = m_skeleton.GetBone("Skl_Root")) {
+        rootRot = glm::quat_cast(rootBone->localMatrix);
+    }
+
+    // the arms don't share any bones, so each one is applied right away and the world matrices are only updated once
+    for (uint8_t side = 0; side < 2; side++) {
+        m_wristTargets[side] = std::nullopt;
+
+        const ArmBones& bones = armBones[side];
+        glm::fvec3 rootPos;
+        float upperLength, lowerLength;
+        if (!inputs.hands[side].has_value() || !m_skeleton.GetTwoBoneChain(bones.arm1, bones.arm2, bones.wrist, rootPos, upperLength, lowerLength)) {
+            continue;
+        }
+
+        m_wristTargets[side] = CalculateWristTarget(side, *inputs.hands[side], inputs);
+
+        // pole vector (elbow direction)
+        // left: left-down-back, right: right-down-back
+        const glm::fvec3 targetPos = glm::vec3((*m_wristTargets[side])[3]);
+        const glm::fvec3 poleDir = rootRot * (side == 0 ? glm::vec3(-1.0f, -1.0f, -0.5f) : glm::vec3(1.0f, -1.0f, -0.5f));
+        const IKSolver::TwoBoneResult result = IKSolver::SolveTwoBone(rootPos, upperLength, lowerLength, targetPos, poleDir, m_elbowLimits);
+        m_skeleton.ApplyTwoBoneIK(bones.arm1, bones.arm2, result, side == 0 ? 1.0f : -1.0f);
+    }
+    m_skeleton.UpdateWorldMatrices();
+}
+
+// override the root transform so the body aligns with the headset yaw
+void PlayerSkeleton::AlignRootWithHeadset(const PassInputs& inputs) {
+    // transform headset matrix to world space
+    glm::mat4 headsetWorld = inputs.cameraMtx * inputs.headsetMtx;
+
+    // transform to model space (skeleton root space)
+    glm::mat4 headsetModel = glm::inverse(inputs.playerMtx) * headsetWorld;
+
+    // extract rotation
+    glm::quat headsetRot = glm::quat_cast(headsetModel);
+
+    // extract yaw (twist around y)
+    glm::vec3 axis(0, 1, 0);
+    glm::vec3 r(headsetRot.x, headsetRot.y, headsetRot.z);
+    float dot = glm::dot(r, axis);
+    glm::vec3 proj = axis * dot;
+    glm::quat yawRot(headsetRot.w, proj.x, proj.y, proj.z);
+
+    // normalize
+    float lenSq = glm::dot(yawRot, yawRot);
+    if (lenSq > 0.000001f) {
+        yawRot = yawRot * (1.0f / sqrtf(lenSq));
+    }
+    else {
+        yawRot = glm::identity<glm::quat>();
+    }
+
+    // fix body inversion
+    yawRot = yawRot * glm::angleAxis(glm::radians(180.0f), glm::vec3(0, 1, 0));
+
+    // calculate target position
+    // headset position in model space
+    glm::vec3 headsetPosModel = glm::vec3(headsetModel[3]);
+    // we want: rootpos + yawrot * eyeoffset = headsetpos
+    // so: rootpos = headsetpos - yawrot * eyeoffset
+    glm::vec3 targetPos = headsetPosModel - (yawRot * m_eyeOffset);
+
+    // apply manual offset
+    targetPos += yawRot * m_manualBodyOffset;
+
+    // update the skeleton so that children bones (hands) are calculated correctly relative to the new root
+    if (Bone* rootBone = m_skeleton.GetBone("Skl_Root")) {
+        rootBone->localMatrix = glm::translate(glm::identity<glm::mat4>(), targetPos) * glm::mat4_cast(yawRot);
+        m_skeleton.UpdateWorldMatrices();
+    }
+}
+
+const std::vector<glm::fmat4x3>& PlayerSkeleton::ComputePass(const PassInputs& inputs) {
+    const std::array<int, 2> wristBones = { m_skeleton.GetBoneIndex("Wrist_L"), m_skeleton.GetBoneIndex("Wrist_R") };
+
+    // the root bone isn't a left bone, so it follows the right controller like the other unsided bones
+    if (inputs.hands[1].has_value()) {
+        AlignRootWithHeadset(inputs);
+    }
+    SolveArms(inputs);
+
+    for (int i = 0; i < (int)m_skeleton.GetBoneCount(); i++) {
+        glm::mat4 calculatedLocalMat = m_skeleton.GetBone(i)->localMatrix;
+
+        // align the wrist (and its weapon) with the controller pose.
+        for (uint8_t side = 0; side < 2; side++) {
+            if (i != wristBones[side] || !inputs.hands[side].has_value()) {
+                continue;
+            }
+
+            const glm::mat4 targetModel = m_wristTargets[side].has_value() ? *m_wristTargets[side] : CalculateWristTarget(side, *inputs.hands[side], inputs);
+
+            // calculate local matrix to reach target model matrix
+            // note: this assumes the parent bones are in the pose defined by SKELETON_DATA
+            calculatedLocalMat = m_skeleton.CalculateLocalMatrixFromWorld(i, targetModel);
+        }
+
+        m_localMatrices[i] = glm::fmat4x3(calculatedLocalMat);
+    }
+    return m_localMatrices;
+}
@@ -0,0 +1,218 @@
+#pragma once
+#include "ik_solver.h"
+
+struct Bone {
+    std::string name;
+    glm::vec3 localPos;
+    glm::vec3 localRotEuler; // in radians
+    glm::mat4 localMatrix;
+    glm::mat4 worldMatrix;
+    int parentIndex = -1;
+    std::vector<int> childrenIndices;
+    int indentLevel = 0;
+};
+
+class Skeleton {
+public:
+    void Parse(const std::string& data) {
+        m_bones.clear();
+        m_boneNameMap.clear();
+
+        std::stringstream ss(data);
+        std::string line;
+
+        // this parses the bone hierarchy using the indentation levels to calculate parent-child relationships and model space transforms
+        std::vector<std::pair<int, int>> parentStack;
+        parentStack.push_back({ -1, -1 }); // Root parent is -1
+
+        while (std::getline(ss, line)) {
+            if (line.empty()) continue;
+
+            int indent = 0;
+            while (indent < line.length() && line[indent] == ' ') indent++;
+
+            size_t start = line.find_first_not_of(" \t");
+            if (start == std::string::npos) continue;
+
+            std::string content = line.substr(start);
+            size_t p1 = content.find('|');
+            if (p1 == std::string::npos) continue;
+
+            std::string currentName = content.substr(0, p1);
+            size_t lastChar = currentName.find_last_not_of(' ');
+            if (lastChar != std::string::npos) currentName = currentName.substr(0, lastChar + 1);
+
+            size_t p2 = content.find('|', p1 + 1);
+            if (p2 == std::string::npos) continue;
+
+            glm::vec3 pos, rotEuler;
+            std::stringstream ssPos(content.substr(p1 + 1, p2 - p1 - 1));
+            ssPos >> pos.x >> pos.y >> pos.z;
+            std::stringstream ssRot(content.substr(p2 + 1));
+            ssRot >> rotEuler.x >> rotEuler.y >> rotEuler.z;
+
+            Bone bone;
+            bone.name = currentName;
+            bone.localPos = pos;
+            bone.localRotEuler = rotEuler;
+            bone.indentLevel = indent;
+            bone.localMatrix = glm::translate(glm::identity<glm::mat4>(), pos) * glm::eulerAngleZYX(rotEuler.x, rotEuler.y, rotEuler.z);
+
+            while (parentStack.size() > 1 && parentStack.back().first >= indent) {
+                parentStack.pop_back();
+            }
+
+            bone.parentIndex = parentStack.back().second;
+
+            int newIndex = (int)m_bones.size();
+            if (bone.parentIndex != -1) {
+                m_bones[bone.parentIndex].childrenIndices.push_back(newIndex);
+            }
+
+            m_bones.push_back(bone);
+            m_boneNameMap[bone.name] = newIndex;
+
+            parentStack.push_back({ indent, newIndex });
+        }
+
+        UpdateWorldMatrices();
+    }
+
+    void UpdateWorldMatrices() {
+        for (auto& bone : m_bones) {
+            if (bone.parentIndex == -1) {
+                bone.worldMatrix = bone.localMatrix;
+            }
+            else {
+                bone.worldMatrix = m_bones[bone.parentIndex].worldMatrix * bone.localMatrix;
+            }
+        }
+    }
+
+    glm::mat4 CalculateLocalMatrixFromWorld(int boneIndex, const glm::mat4& targetWorldMatrix) {
+        if (boneIndex < 0 || boneIndex >= m_bones.size()) return glm::identity<glm::mat4>();
+
+        const Bone& bone = m_bones[boneIndex];
+        if (bone.parentIndex == -1) {
+            return targetWorldMatrix;
+        }
+
+        const glm::mat4& parentWorldMatrix = m_bones[bone.parentIndex].worldMatrix;
+        return glm::inverse(parentWorldMatrix) * targetWorldMatrix;
+    }
+
+    // world position of the chain's root and the lengths of its two bones, in the pose that the skeleton is currently in
+    bool GetTwoBoneChain(int rootIdx, int midIdx, int endIdx, glm::vec3& rootPos, float& upperLength, float& lowerLength) const {
+        if (rootIdx < 0 || rootIdx >= m_bones.size() ||
+            midIdx < 0 || midIdx >= m_bones.size() ||
+            endIdx < 0 || endIdx >= m_bones.size()) {
+            return false;
+        }
+
+        const Bone& rootBone = m_bones[rootIdx];
+        glm::mat4 parentWorld = rootBone.parentIndex != -1 ? m_bones[rootBone.parentIndex].worldMatrix : glm::identity<glm::mat4>();
+        rootPos = glm::vec3(parentWorld * glm::vec4(rootBone.localPos, 1.0f));
+        upperLength = glm::length(m_bones[midIdx].localPos);
+        lowerLength = glm::length(m_bones[endIdx].localPos);
+        return true;
+    }
+
+    // rotates the two bones to match the solved chain, the world matrices need to be updated afterwards
+    void ApplyTwoBoneIK(int rootIdx, int midIdx, const IKSolver::TwoBoneResult& result, float boneForwardSign) {
+        Bone& rootBone = m_bones[rootIdx];
+        Bone& midBone = m_bones[midIdx];
+
+        // get parent world matrix (clavicle)
+        glm::mat4 parentWorld = glm::identity<glm::mat4>();
+        if (rootBone.parentIndex != -1) {
+            parentWorld = m_bones[rootBone.parentIndex].worldMatrix;
+        }
+
+        // construct rotation matrices
+        glm::vec3 x1 = result.upperDir * boneForwardSign;
+        glm::vec3 z1 = result.planeNormal;
+        glm::vec3 y1 = glm::cross(z1, x1);
+        glm::mat3 rot1World = glm::mat3(x1, y1, z1);
+
+        glm::vec3 x2 = result.lowerDir * boneForwardSign;
+        glm::vec3 z2 = result.planeNormal;
+        glm::vec3 y2 = glm::cross(z2, x2);
+        glm::mat3 rot2World = glm::mat3(x2, y2, z2);
+
+        // convert to local space
+        glm::mat4 arm1Local = glm::inverse(parentWorld) * glm::mat4(rot1World);
+        arm1Local[3] = glm::vec4(rootBone.localPos, 1.0f); // restore translation
+
+        glm::mat4 arm1World = parentWorld * arm1Local;
+        glm::mat4 arm2Local = glm::inverse(arm1World) * glm::mat4(rot2World);
+        arm2Local[3] = glm::vec4(midBone.localPos, 1.0f); // restore translation
+
+        // update skeleton
+        rootBone.localMatrix = arm1Local;
+        midBone.localMatrix = arm2Local;
+    }
+
+    int GetBoneIndex(std::string_view name) const {
+        auto it = m_boneNameMap.find(name);
+        if (it != m_boneNameMap.end()) return it->second;
+        return -1;
+    }
+
+    Bone* GetBone(int index) {
+        if (index < 0 || index >= m_bones.size()) return nullptr;
+        return &m_bones[index];
+    }
+
+    Bone* GetBone(std::string_view name) {
+        int idx = GetBoneIndex(name);
+        if (idx == -1) return nullptr;
+        return &m_bones[idx];
+    }
+
+    size_t GetBoneCount() const { return m_bones.size(); }
+
+private:
+    std::vector<Bone> m_bones;
+    std::map<std::string, int, std::less<>> m_boneNameMap;
+};
+
+// poses the player's skeleton to follow the headset and the controllers. a pass only depends on the inputs that are gathered
+// for it and not on the game's own bone matrices, so the whole skeleton is posed at once and the bone hook only copies it out.
+// it only does math so that it can be checked on its own.
+class PlayerSkeleton {
+public:
+    // everything that a pass depends on. sides are 0 for the left hand and 1 for the right hand, like OpenXR::EyeSide.
+    struct PassInputs {
+        glm::fmat4 cameraMtx;
+        glm::fmat4 playerMtx;
+        glm::fmat4 headsetMtx; // the middle of the eyes in tracking space
+        // controller poses in tracking space, or nullopt for the hands that aren't tracked. bones without a side follow the right hand.
+        std::array<std::optional<std::pair<glm::fvec3, glm::fquat>>, 2> hands;
+    };
+
+    PlayerSkeleton();
+
+    // poses the skeleton and returns the local matrix of every bone, indexed like GetBoneIndex. only the bones on the side of a
+    // tracked hand are posed, the others are left in the pose of the previous pass.
+    const std::vector<glm::fmat4x3>& ComputePass(const PassInputs& inputs);
+
+    int GetBoneIndex(std::string_view name) const { return m_skeleton.GetBoneIndex(name); }
+    size_t GetBoneCount() const { return m_skeleton.GetBoneCount(); }
+
+    // face bones are hidden instead of posed, since they'd otherwise end up in front of the eyes
+    static bool IsFaceBone(std::string_view boneName);
+
+private:
+    void AlignRootWithHeadset(const PassInputs& inputs);
+    void SolveArms(const PassInputs& inputs);
+    glm::mat4 CalculateWristTarget(uint8_t side, const std::pair<glm::fvec3, glm::fquat>& hand, const PassInputs& inputs);
+
+    Skeleton m_skeleton;
+    std::array<glm::mat4, 2> m_handCorrectionRotations = {};
+    glm::vec3 m_eyeOffset = glm::vec3(0.0f);
+    std::array<std::optional<glm::mat4>, 2> m_wristTargets = {};
+    std::vector<glm::fmat4x3> m_localMatrices;
+
+    glm::vec3 m_manualBodyOffset = glm::vec3(0.0f, 0.0f, -0.125f);
+    IKSolver::JointLimits m_elbowLimits = { .minBend = glm::radians(2.0f), .maxBend = glm::radians(150.0f) };
+};
@@ -8,6 +8,16 @@ data_VRSettingsIn g_settings = {};
 uint64_t CemuHooks::s_memoryBaseAddress = 0;
 std::atomic_uint32_t CemuHooks::s_framesSinceLastCameraUpdate = 0;
 
+void CemuHooks::RegisterHooks() {
+    // the manifest is generated from the graphic pack's patches, a hook that the game reaches without it being registered crashes Cemu.
+    // the warnings of cmake/GraphicPackManifest.cmake in the build output name the hook if this fails.
+    static_assert(FindUnregisteredManifestHook() == -1, "A hook that the graphic pack's patches call isn't registered!");
+
+    for (const HookRegistration& registration : GetHookRegistrations()) {
+        osLib_registerHLEFunction("coreinit", registration.name.data(), registration.hook);
+    }
+    Log::print<INFO>("Registered {} hooks for graphic pack version {}", GetHookRegistrations().size(), GraphicPackManifest::RULES_VERSION);
+}
 
 bool CemuHooks::IsScreenOpen(ScreenId screen) {
     uint32_t screenManagerInstance = getMemory<BEType<uint32_t>>(0x1047E650).getLE();
@@ -102,11 +112,8 @@ void CemuHooks::hook_RouteActorJob(PPCInterpreter_t* hCPU) {
     uint32_t jobName = hCPU->gpr[4];
     uint32_t side = hCPU->gpr[5]; // 0 = left, 1 = right
 
-    std::string jobNameStr = std::string((char*)(s_memoryBaseAddress + jobName));
-
-    ActorWiiU actor;
-    readMemory(actorPtr, &actor);
-    std::string actorName = actor.name.getLE();
+    GuestStringView jobNameStr = getStringView(jobName);
+    GuestStringView actorName = getSafeStringView<sead::FixedSafeString40>(actorPtr + offsetof(ActorWiiU, name));
 
 #define SKIP_ON_LEFT_SIDE if (side == 0) { hCPU->gpr[3] = 1; }
 #define SKIP_ON_RIGHT_SIDE if (side == 1) { hCPU->gpr[3] = 1; }
@@ -114,6 +121,13 @@ void CemuHooks::hook_RouteActorJob(PPCInterpreter_t* hCPU) {
 #define USE_ALTERED_PATH_ON_RIGHT_SIDE if (side == 1) { hCPU->gpr[3] = 2; }
 
     hCPU->gpr[3] = 0;
+
+    // frames that skip the second eye side run every job on the first one, like the game does without the stereo rendering
+    RND_Renderer* renderer = VRManager::instance().XR->GetRenderer();
+    if (side == 0 && renderer != nullptr && renderer->IsSingleEyePass()) {
+        return;
+    }
+
     if (actorName == "GameROMPlayer") {
         if (jobNameStr == "job0_1") {
             // this only runs the climbing portion of this actor job on the left eye's side
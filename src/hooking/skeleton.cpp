@@ -1,258 +1,77 @@
 #include "instance.h"
 #include "cemu_hooks.h"
 #include "rendering/openxr.h"
+#include "player_skeleton.h"
 
-struct Bone {
-    std::string name;
-    glm::vec3 localPos;
-    glm::vec3 localRotEuler; // in radians
-    glm::mat4 localMatrix;
-    glm::mat4 worldMatrix;
-    int parentIndex = -1;
-    std::vector<int> childrenIndices;
-    int indentLevel = 0;
-};
-
-class Skeleton {
-public:
-    void Parse(const std::string& data) {
-        m_bones.clear();
-        m_boneNameMap.clear();
-
-        std::stringstream ss(data);
-        std::string line;
-
-        // this parses the bone hierarchy using the indentation levels to calculate parent-child relationships and model space transforms
-        std::vector<std::pair<int, int>> parentStack;
-        parentStack.push_back({ -1, -1 }); // Root parent is -1
-
-        while (std::getline(ss, line)) {
-            if (line.empty()) continue;
-
-            int indent = 0;
-            while (indent < line.length() && line[indent] == ' ') indent++;
-
-            size_t start = line.find_first_not_of(" \t");
-            if (start == std::string::npos) continue;
-
-            std::string content = line.substr(start);
-            size_t p1 = content.find('|');
-            if (p1 == std::string::npos) continue;
-
-            std::string currentName = content.substr(0, p1);
-            size_t lastChar = currentName.find_last_not_of(' ');
-            if (lastChar != std::string::npos) currentName = currentName.substr(0, lastChar + 1);
-
-            size_t p2 = content.find('|', p1 + 1);
-            if (p2 == std::string::npos) continue;
-
-            glm::vec3 pos, rotEuler;
-            std::stringstream ssPos(content.substr(p1 + 1, p2 - p1 - 1));
-            ssPos >> pos.x >> pos.y >> pos.z;
-            std::stringstream ssRot(content.substr(p2 + 1));
-            ssRot >> rotEuler.x >> rotEuler.y >> rotEuler.z;
-
-            Bone bone;
-            bone.name = currentName;
-            bone.localPos = pos;
-            bone.localRotEuler = rotEuler;
-            bone.indentLevel = indent;
-            bone.localMatrix = glm::translate(glm::identity<glm::mat4>(), pos) * glm::eulerAngleZYX(rotEuler.x, rotEuler.y, rotEuler.z);
-
-            while (parentStack.size() > 1 && parentStack.back().first >= indent) {
-                parentStack.pop_back();
-            }
-
-            bone.parentIndex = parentStack.back().second;
-
-            int newIndex = (int)m_bones.size();
-            if (bone.parentIndex != -1) {
-                m_bones[bone.parentIndex].childrenIndices.push_back(newIndex);
-            }
-
-            m_bones.push_back(bone);
-            m_boneNameMap[bone.name] = newIndex;
+// parsed when the player model is first seen
+static std::optional<PlayerSkeleton> s_skeleton;
 
-            parentStack.push_back({ indent, newIndex });
-        }
-
-        UpdateWorldMatrices();
+static std::pair<glm::fvec3, glm::fquat> GetControllerPose(const OpenXR::InputState& inputs, OpenXR::EyeSide side) {
+    const auto& pose = inputs.inGame.poseLocation[side];
+    glm::fvec3 controllerPos = glm::fvec3();
+    glm::fquat controllerRot = glm::identity<glm::fquat>();
+    if (pose.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) {
+        controllerPos = ToGLM(pose.pose.position);
     }
-
-    void UpdateWorldMatrices() {
-        for (auto& bone : m_bones) {
-            if (bone.parentIndex == -1) {
-                bone.worldMatrix = bone.localMatrix;
-            }
-            else {
-                bone.worldMatrix = m_bones[bone.parentIndex].worldMatrix * bone.localMatrix;
-            }
-        }
+    if (pose.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) {
+        controllerRot = ToGLM(pose.pose.orientation);
     }
 
-    glm::mat4 CalculateLocalMatrixFromWorld(int boneIndex, const glm::mat4& targetWorldMatrix) {
-        if (boneIndex < 0 || boneIndex >= m_bones.size()) return glm::identity<glm::mat4>();
-
-        const Bone& bone = m_bones[boneIndex];
-        if (bone.parentIndex == -1) {
-            return targetWorldMatrix;
-        }
-
-        const glm::mat4& parentWorldMatrix = m_bones[bone.parentIndex].worldMatrix;
-        return glm::inverse(parentWorldMatrix) * targetWorldMatrix;
+    // late-latch the controller pose to when this frame will actually be shown, the pose above was located at the start of the frame
+    PosePredictor& posePredictor = VRManager::instance().XR->GetPosePredictor();
+    if (auto predicted = posePredictor.PoseAt(PosePredictor::HandDevice(side), posePredictor.GetTargetTime())) {
+        controllerPos = predicted->position;
+        controllerRot = predicted->orientation;
     }
+    return { controllerPos, controllerRot };
+}
 
-    void SolveTwoBoneIK(int rootIdx, int midIdx, int endIdx, const glm::vec3& targetPos, const glm::vec3& poleVector, float boneForwardSign) {
-        if (rootIdx < 0 || rootIdx >= m_bones.size() ||
-            midIdx < 0 || midIdx >= m_bones.size() ||
-            endIdx < 0 || endIdx >= m_bones.size()) {
-            return;
-        }
+// what hook_ModifyBoneMatrix writes only depends on the headset, the controllers and the player matrix and not on the game's own bone matrices.
+// so the whole skeleton is computed once when a new pass over the player's bones starts, and each bone call after that only copies its matrix out.
+struct BoneSlot {
+    enum class Kind : uint8_t {
+        IGNORED,
+        FACE,
+        SKELETON
+    };
+    Kind kind = Kind::IGNORED;
+    OpenXR::EyeSide side = OpenXR::EyeSide::RIGHT;
+    int boneIndex = -1;
+    uint32_t lastPass = std::numeric_limits<uint32_t>::max();
+};
 
-        Bone& rootBone = m_bones[rootIdx];
-        Bone& midBone = m_bones[midIdx];
-        Bone& endBone = m_bones[endIdx];
+// keyed by the guest address of the bone name, which comes from the model resource and doesn't move while the player model exists
+static std::unordered_map<uint32_t, BoneSlot> s_boneSlots;
+static uint32_t s_playerModelPtr = 0;
+static uint32_t s_bonePass = 0;
+static bool s_bonePassComputed = false;
+static std::array<bool, 2> s_bonePassSides = {};
+// already byte-swapped, indexed like the skeleton's bones
+static std::vector<BEMatrix34> s_boneMatrices;
+
+static bool IsPlayerModel(uint32_t gsysModelPtr) {
+    return CemuHooks::getSafeStringView<sead::FixedSafeString100>(gsysModelPtr + 0x128) == "GameROMPlayer";
+}
 
-        // get parent world matrix (clavicle)
-        glm::mat4 parentWorld = glm::identity<glm::mat4>();
-        if (rootBone.parentIndex != -1) {
-            parentWorld = m_bones[rootBone.parentIndex].worldMatrix;
+static void ComputeSkeletonPass(const OpenXR::InputState& inputs, const glm::mat4& cameraMtx, const glm::fmat4& playerMtx) {
+    PlayerSkeleton::PassInputs passInputs = {
+        .cameraMtx = cameraMtx,
+        .playerMtx = playerMtx,
+        .headsetMtx = VRManager::instance().XR->GetRenderer()->GetMiddlePose().value_or(ToMat4(glm::fvec3(0)))
+    };
+    for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        if (s_bonePassSides[side]) {
+            passInputs.hands[side] = GetControllerPose(inputs, side);
         }
-
-        glm::vec3 rootPos = glm::vec3(parentWorld * glm::vec4(rootBone.localPos, 1.0f));
-
-        // get lengths
-        float l1 = glm::length(midBone.localPos);
-        float l2 = glm::length(endBone.localPos);
-
-        // solve IK
-        glm::vec3 dir = targetPos - rootPos;
-        float dist = glm::length(dir);
-
-        // clamp distance
-        float epsilon = 0.001f;
-        dist = glm::clamp(dist, epsilon, l1 + l2 - epsilon);
-
-        // law of cosines for angle at shoulder (alpha)
-        float cosAlpha = (l1 * l1 + dist * dist - l2 * l2) / (2 * l1 * dist);
-        float alpha = glm::acos(glm::clamp(cosAlpha, -1.0f, 1.0f));
-
-        // plane construction
-        glm::vec3 dirNorm = glm::normalize(dir);
-        glm::vec3 planeNormal = glm::normalize(glm::cross(dirNorm, poleVector));
-        glm::vec3 ortho = glm::normalize(glm::cross(planeNormal, dirNorm));
-
-        // arm 1 direction (world)
-        glm::vec3 arm1Dir = glm::normalize(dirNorm * cos(alpha) + ortho * sin(alpha));
-
-        // arm 2 direction (world)
-        glm::vec3 elbowPos = rootPos + arm1Dir * l1;
-        glm::vec3 arm2Dir = glm::normalize(targetPos - elbowPos);
-
-        // construct rotation matrices
-        glm::vec3 x1 = arm1Dir * boneForwardSign;
-        glm::vec3 z1 = planeNormal;
-        glm::vec3 y1 = glm::cross(z1, x1);
-        glm::mat3 rot1World = glm::mat3(x1, y1, z1);
-
-        glm::vec3 x2 = arm2Dir * boneForwardSign;
-        glm::vec3 z2 = planeNormal;
-        glm::vec3 y2 = glm::cross(z2, x2);
-        glm::mat3 rot2World = glm::mat3(x2, y2, z2);
-
-        // convert to local space
-        glm::mat4 arm1Local = glm::inverse(parentWorld) * glm::mat4(rot1World);
-        arm1Local[3] = glm::vec4(rootBone.localPos, 1.0f); // restore translation
-
-        glm::mat4 arm1World = parentWorld * arm1Local;
-        glm::mat4 arm2Local = glm::inverse(arm1World) * glm::mat4(rot2World);
-        arm2Local[3] = glm::vec4(midBone.localPos, 1.0f); // restore translation
-
-        // update skeleton
-        rootBone.localMatrix = arm1Local;
-        midBone.localMatrix = arm2Local;
-        UpdateWorldMatrices();
-    }
-
-    int GetBoneIndex(const std::string& name) const {
-        auto it = m_boneNameMap.find(name);
-        if (it != m_boneNameMap.end()) return it->second;
-        return -1;
-    }
-
-    Bone* GetBone(int index) {
-        if (index < 0 || index >= m_bones.size()) return nullptr;
-        return &m_bones[index];
     }
 
-    Bone* GetBone(const std::string& name) {
-        int idx = GetBoneIndex(name);
-        if (idx == -1) return nullptr;
-        return &m_bones[idx];
+    const std::vector<glm::fmat4x3>& localMatrices = s_skeleton->ComputePass(passInputs);
+    s_boneMatrices.resize(localMatrices.size());
+    for (size_t i = 0; i < localMatrices.size(); i++) {
+        s_boneMatrices[i].setLEMatrix(localMatrices[i]);
     }
-
-private:
-    std::vector<Bone> m_bones;
-    std::map<std::string, int> m_boneNameMap;
-};
-
-const std::string SKELETON_DATA = R"(
-Root | 0 0 0 | 0 0 0
-  Skl_Root | 0 0.99426 0 | 0 0 0
-    Spine_1 | 0 0 0 | 1.5708 0 1.5708
-      Spine_2 | 0.136 0 0 | 0 0 0
-        Clavicle_L | 0.23961 -0.00002 0.03291 | 0 -1.5708 0
-          Arm_1_L | 0.15 0 0.01074 | 0 0 0
-            Arm_1_Assist_L | 0.06 0.00002 0 | 0 0 0
-            Arm_2_L | 0.24 0 0 | 0 0 0
-              Elbow_L | 0.04151 -0.02934 0.00021 | 0 0 0
-              Wrist_Assist_L | 0.25809 0.00002 -0.00012 | 0 0 0
-              Wrist_L | 0.27718 0 0 | 0 0 0
-                Weapon_L | 0.1069 0.00002 0.02769 | 1.5708 0 3.14159
-          Clavicle_Assist_L | 0.116 0 0.0107 | 0 0 0
-        Clavicle_R | 0.2396 -0.00002 -0.03291 | 3.14159 -1.5708 0
-          Arm_1_R | -0.15 0 -0.01074 | 0 0 0
-            Arm_1_Assist_R | -0.06 -0.00002 0 | 0 0 0
-            Arm_2_R | -0.24 0 0 | 0 0 0
-              Elbow_R | -0.04151 0.02934 -0.0002 | 0 0 0
-              Wrist_Assist_R | -0.25809 -0.00002 0.00012 | 0 0 0
-              Wrist_R | -0.27718 0 0 | 0 0 0
-                Weapon_R | -0.1069 -0.00002 -0.02769 | 1.5708 0 0
-          Clavicle_Assist_R | -0.116 0 -0.0107 | 0 0 0
-        Neck | 0.26326 0 0 | 0 0 0
-          Head | 0.12447 0 0 | 0 0 0
-            Face_Root | 0 0 0 | 0 0 0
-              Chin | 0.04787 0.05757 0 | 0 0 2.53073
-              Eyeball_L | 0.07017 0.12036 0.04815 | 0 0 0
-              Eyeball_R | 0.07017 0.12036 -0.04815 | 0 0 0
-)";
-
-/*
-    Waist | 0 0 0 | 1.5708 0 -1.5708
-      Leg_1_L | 0.10854 0.0165 -0.11209 | 0 0 0
-        Knee_L | 0.39619 0.0308 0 | 0 0 0
-        Leg_2_L | 0.42 0 -0.08727 | 0 0 0
-      Leg_1_R | 0.10854 0.0165 0.11209 | 0 0 3.14159
-        Knee_R | -0.39619 -0.0308 0 | 0 0 0
-        Leg_2_R | -0.42 0 -0.08727 | 0 0 0
- */
-
-static bool isFaceBone(const std::string_view& boneName) {
-    if (boneName.starts_with("Eye" /*lid*/) || boneName.starts_with("Cheek") || boneName.starts_with("Lip") || boneName.starts_with("Hair")) {
-        return true;
-    }
-    if (boneName == "Nose" || boneName == "Ponytail_A_1" || boneName == "Neck" || boneName == "Head" || boneName.starts_with("Teeth_") || boneName.starts_with("Chin")) {
-        return true;
-    }
-    return false;
 }
 
-static Skeleton s_skeleton;
-static bool s_skeletonParsed = false;
-static glm::vec3 s_manualBodyOffset = glm::vec3(0.0f, 0.0f, -0.125f);
-static glm::mat4 s_handCorrectionRotationLeft = glm::mat4(1.0f);
-static glm::mat4 s_handCorrectionRotationRight = glm::mat4(1.0f);
-
 void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
@@ -264,245 +83,84 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
     const uint32_t boneNamePtr = hCPU->gpr[6];
     if (!gsysModelPtr || !matrixPtr || !scalePtr || !boneNamePtr) return;
 
-    const auto modelName = getMemory<sead::FixedSafeString100>(gsysModelPtr + 0x128);
-    if (modelName.getLE() != "GameROMPlayer") return;
-
-    // get bone data
-    std::string boneName((char*)(s_memoryBaseAddress + boneNamePtr));
-    const bool isLeft = boneName.ends_with("_L");
-    const OpenXR::EyeSide side = isLeft ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
-
-    // get bone position data
-    glm::mat4x3 gameMtx = getMemory<BEMatrix34>(matrixPtr).getLEMatrix();
-    glm::vec3 bonePos = gameMtx[3];
-    glm::quat boneRot = glm::normalize(glm::quat_cast(glm::mat3(gameMtx)));
-    glm::fvec3 boneScale = getMemory<BEVec3>(scalePtr).getLE();
-
-    // get player data
-    const glm::fmat4 playerMtx4 = glm::fmat4(getMemory<BEMatrix34>(s_playerMtxAddress).getLEMatrix());
-    const glm::fmat4 playerPosMtx = glm::translate(glm::fmat4(1.0f), glm::fvec3(playerMtx4[3]));
-
-    // get camera data
-    glm::mat4 cameraMtx = s_lastCameraMtx;
-    glm::mat4 cameraPositionOnlyMtx = glm::translate(glm::identity<glm::fmat4>(), glm::fvec3(cameraMtx[3]));
-    glm::fquat cameraQuat = glm::quat_cast(cameraMtx);
-    glm::mat4 cameraRotationOnlyMtx = glm::mat4_cast(cameraQuat);
-
-    // get vr controller position and rotation
-    const OpenXR::InputState inputs = VRManager::instance().XR->m_input.load();
-    if (!inputs.inGame.in_game || !inputs.inGame.pose[side].isActive)
-        return;
-
-    const auto& pose = inputs.inGame.poseLocation[side];
-    glm::fvec3 controllerPos = glm::fvec3();
-    glm::fquat controllerRot = glm::identity<glm::fquat>();
-    if (pose.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) {
-        controllerPos = ToGLM(pose.pose.position);
-    }
-    if (pose.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) {
-        controllerRot = ToGLM(pose.pose.orientation);
+    // the model name is only checked again when the pointer changes or a new pass starts
+    if (gsysModelPtr != s_playerModelPtr) {
+        if (!IsPlayerModel(gsysModelPtr)) return;
+        s_playerModelPtr = gsysModelPtr;
+        s_boneSlots.clear();
+        s_bonePassComputed = false;
     }
 
-
     // initialize skeleton and hand correction rotations
-    if (!s_skeletonParsed) {
-        s_skeleton.Parse(SKELETON_DATA);
-        s_skeletonParsed = true;
-
-        glm::fquat wristRotationHardcodedLeft = glm::identity<glm::fquat>();
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(90.0f), glm::fvec3(0, 1, 0));
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(-90.0f), glm::fvec3(0, 0, 1));
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(-45.0f), glm::fvec3(1, 0, 0));
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(45.0f), glm::fvec3(1, 0, 0));
-
-        glm::fquat wristRotationHardcodedRight = glm::identity<glm::fquat>();
-        wristRotationHardcodedRight *= glm::angleAxis(glm::radians(-90.0f), glm::fvec3(0, 0, 1));
-        wristRotationHardcodedRight *= glm::angleAxis(glm::radians(-180.0f), glm::fvec3(0, 1, 0));
-        wristRotationHardcodedRight *= glm::angleAxis(glm::radians(270.0f), glm::fvec3(1, 0, 0));
-
-        // slightly tweak it for a nicer alignment of the virtual hands
-        wristRotationHardcodedLeft *= glm::angleAxis(glm::radians(30.0f), glm::fvec3(0, 0, 1));
-        wristRotationHardcodedRight *= glm::angleAxis(glm::radians(30.0f), glm::fvec3(0, 0, 1));
-
-        s_handCorrectionRotationLeft = glm::mat4_cast(wristRotationHardcodedLeft);
-        s_handCorrectionRotationRight = glm::mat4_cast(wristRotationHardcodedRight);
-    }
-
-    // reset face bones so they don't react to vr-driven poses
-    if (isFaceBone(boneName)) {
-        BEMatrix34 finalMtx;
-        finalMtx.setPos(glm::fvec3());
-        finalMtx.setRotLE(glm::identity<glm::fquat>());
-        writeMemory(matrixPtr, &finalMtx);
-
-        BEVec3 finalScale;
-        finalScale = glm::fvec3(0.05);
-        writeMemory(scalePtr, &finalScale);
-        return;
-    }
-
-    int boneIndex = s_skeleton.GetBoneIndex(boneName);
-    if (boneIndex == -1) {
-        return;
-    }
-    Bone* bone = s_skeleton.GetBone(boneIndex);
-
-    glm::mat4 calculatedLocalMat = bone->localMatrix;
-
-    // override the root transform so the body aligns with the headset yaw
-    if (boneName == "Skl_Root") {
-        auto headsetPose = VRManager::instance().XR->GetRenderer()->GetMiddlePose();
-        glm::mat4 s_headsetMtx = headsetPose.value_or(ToMat4(glm::fvec3(0)));
-
-        // calculate eye offset from eyeball bones
-        static glm::vec3 eyeOffset = glm::vec3(0.0f);
-        static bool offsetCalculated = false;
-        if (!offsetCalculated) {
-            Bone* eyeL = s_skeleton.GetBone("Eyeball_L");
-            Bone* eyeR = s_skeleton.GetBone("Eyeball_R");
-            Bone* sklRoot = s_skeleton.GetBone("Skl_Root");
-
-            if (eyeL && eyeR && sklRoot) {
-                glm::vec3 eyePos = (glm::vec3(eyeL->worldMatrix[3]) + glm::vec3(eyeR->worldMatrix[3])) * 0.5f;
-                glm::vec3 rootPos = glm::vec3(sklRoot->worldMatrix[3]);
-                eyeOffset = eyePos - rootPos;
-                offsetCalculated = true;
-            }
+    if (!s_skeleton) {
+        s_skeleton.emplace();
+    }
+
+    // resolve the bone name once per model
+    auto [slotIt, inserted] = s_boneSlots.try_emplace(boneNamePtr);
+    BoneSlot& slot = slotIt->second;
+    if (inserted) {
+        const std::string_view boneName = getStringView(boneNamePtr);
+        slot.side = boneName.ends_with("_L") ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
+        // reset face bones so they don't react to vr-driven poses
+        if (PlayerSkeleton::IsFaceBone(boneName)) {
+            slot.kind = BoneSlot::Kind::FACE;
         }
-
-        // transform headset matrix to world space
-        glm::mat4 headsetWorld = cameraMtx * s_headsetMtx;
-
-        // transform to model space (skeleton root space)
-        glm::mat4 headsetModel = glm::inverse(playerMtx4) * headsetWorld;
-
-        // extract rotation
-        glm::quat headsetRot = glm::quat_cast(headsetModel);
-
-        // extract yaw (twist around y)
-        glm::vec3 axis(0, 1, 0);
-        glm::vec3 r(headsetRot.x, headsetRot.y, headsetRot.z);
-        float dot = glm::dot(r, axis);
-        glm::vec3 proj = axis * dot;
-        glm::quat yawRot(headsetRot.w, proj.x, proj.y, proj.z);
-
-        // normalize
-        float lenSq = glm::dot(yawRot, yawRot);
-        if (lenSq > 0.000001f) {
-            yawRot = yawRot * (1.0f / sqrtf(lenSq));
+        else if ((slot.boneIndex = s_skeleton->GetBoneIndex(boneName)) != -1) {
+            slot.kind = BoneSlot::Kind::SKELETON;
         }
-        else {
-            yawRot = glm::identity<glm::quat>();
-        }
-
-        // fix body inversion
-        yawRot = yawRot * glm::angleAxis(glm::radians(180.0f), glm::vec3(0, 1, 0));
-
-        // calculate target position
-        // headset position in model space
-        glm::vec3 headsetPosModel = glm::vec3(headsetModel[3]);
-        // we want: rootpos + yawrot * eyeoffset = headsetpos
-        // so: rootpos = headsetpos - yawrot * eyeoffset
-        glm::vec3 targetPos = headsetPosModel - (yawRot * eyeOffset);
-
-        // apply manual offset
-        targetPos += yawRot * s_manualBodyOffset;
-
-        // update s_skeleton so that children bones (hands) are calculated correctly relative to the new root
-        if (Bone* rootBone = s_skeleton.GetBone("Skl_Root")) {
-            rootBone->localMatrix = glm::translate(glm::identity<glm::mat4>(), targetPos) * glm::mat4_cast(yawRot);
-            s_skeleton.UpdateWorldMatrices();
-        }
-
-        BEMatrix34 finalMtx;
-        finalMtx.setPos(targetPos);
-        finalMtx.setRotLE(yawRot);
-        writeMemory(matrixPtr, &finalMtx);
-
-        BEVec3 finalScale;
-        finalScale = boneScale;
-        writeMemory(scalePtr, &finalScale);
-        return;
     }
+    if (slot.kind == BoneSlot::Kind::IGNORED) return;
 
-    // solve upper arm ik so the hands reach the vr controllers
-    if (boneName == "Arm_1_L" || boneName == "Arm_1_R" ||
-        boneName == "Elbow_L" || boneName == "Elbow_R" ||
-        boneName == "Wrist_Assist_L" || boneName == "Wrist_Assist_R") {
-        std::string arm1Name = isLeft ? "Arm_1_L" : "Arm_1_R";
-        std::string arm2Name = isLeft ? "Arm_2_L" : "Arm_2_R";
-        std::string wristName = isLeft ? "Wrist_L" : "Wrist_R";
-        std::string weaponName = isLeft ? "Weapon_L" : "Weapon_R";
-
-        int arm1Index = s_skeleton.GetBoneIndex(arm1Name);
-        int arm2Index = s_skeleton.GetBoneIndex(arm2Name);
-        int wristIndex = s_skeleton.GetBoneIndex(wristName);
-        Bone* weapon = s_skeleton.GetBone(weaponName);
-
-        if (arm1Index != -1 && arm2Index != -1 && wristIndex != -1) {
-            glm::mat4 handCorrectionMtx = isLeft ? s_handCorrectionRotationLeft : s_handCorrectionRotationRight;
+    // a bone that was already written in this pass means that the game started updating the skeleton again
+    if (slot.lastPass == s_bonePass) {
+        s_bonePass++;
+        s_bonePassComputed = false;
 
-            // calculate target wrist world position
-            glm::mat4 controllerMat = glm::translate(glm::identity<glm::mat4>(), controllerPos) * glm::mat4_cast(controllerRot) * handCorrectionMtx;
-            glm::mat4 targetWorld = cameraMtx * controllerMat;
-
-            if (weapon) {
-                glm::vec3 weaponOffset = glm::vec3(weapon->localMatrix[3]);
-                targetWorld = targetWorld * glm::translate(glm::identity<glm::mat4>(), -weaponOffset);
-            }
-
-            // convert targetWorld to model space
-            glm::mat4 targetModel = glm::inverse(playerMtx4) * targetWorld;
-            glm::vec3 targetPos = glm::vec3(targetModel[3]);
-
-            // pole vector (elbow direction)
-            // left: left-down-back, right: right-down-back
-            glm::vec3 poleDir = isLeft ? glm::vec3(-1.0f, -1.0f, -0.5f) : glm::vec3(1.0f, -1.0f, -0.5f);
-
-            // rotate pole vector by body rotation (Skl_Root)
-            if (Bone* rootBone = s_skeleton.GetBone("Skl_Root")) {
-                glm::quat rootRot = glm::quat_cast(rootBone->localMatrix);
-                poleDir = rootRot * poleDir;
-            }
-
-            float forwardSign = isLeft ? 1.0f : -1.0f;
-
-            s_skeleton.SolveTwoBoneIK(arm1Index, arm2Index, wristIndex, targetPos, poleDir, forwardSign);
-
-            calculatedLocalMat = s_skeleton.GetBone(boneIndex)->localMatrix;
+        // the player model could've been freed and its memory reused for another model
+        if (!IsPlayerModel(gsysModelPtr)) {
+            s_playerModelPtr = 0;
+            s_boneSlots.clear();
+            return;
         }
     }
+    slot.lastPass = s_bonePass;
 
-    // align the wrist (and its weapon) with the controller pose.
-    if (boneName == "Wrist_L" || boneName == "Wrist_R") {
-        glm::mat4 handCorrectionMtx = isLeft ? s_handCorrectionRotationLeft : s_handCorrectionRotationRight;
-
-        // construct controller matrix in tracking space
-        glm::mat4 controllerMat = glm::translate(glm::identity<glm::mat4>(), controllerPos) * glm::mat4_cast(controllerRot) * handCorrectionMtx;
-
-        // transform to world space
-        // we treat the camera as the origin of the tracking space
-        glm::mat4 targetWorld = cameraMtx * controllerMat;
-
-        std::string weaponName = (boneName == "Wrist_L") ? "Weapon_L" : "Weapon_R";
-        if (Bone* weaponBone = s_skeleton.GetBone(weaponName)) {
-            glm::vec3 weaponOffset = glm::vec3(weaponBone->localMatrix[3]);
-            targetWorld = targetWorld * glm::translate(glm::identity<glm::mat4>(), -weaponOffset);
+    if (!s_bonePassComputed) {
+        // get vr controller position and rotation
+        const OpenXR::InputState inputs = VRManager::instance().XR->m_input.load();
+        for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+            s_bonePassSides[side] = inputs.inGame.in_game && inputs.inGame.pose[side].isActive;
         }
 
-        glm::mat4 targetModel = glm::inverse(playerMtx4) * targetWorld;
+        if (s_bonePassSides[OpenXR::EyeSide::LEFT] || s_bonePassSides[OpenXR::EyeSide::RIGHT]) {
+            // get player data
+            const glm::fmat4 playerMtx4 = glm::fmat4(getMemory<BEMatrix34>(s_playerMtxAddress).getLEMatrix());
 
-        // calculate local matrix to reach target model matrix
-        // note: this assumes the parent bones are in the pose defined by SKELETON_DATA
-        calculatedLocalMat = s_skeleton.CalculateLocalMatrixFromWorld(boneIndex, targetModel);
+            ComputeSkeletonPass(inputs, s_lastCameraMtx, playerMtx4);
+        }
+        s_bonePassComputed = true;
+    }
+
+    if (!s_bonePassSides[slot.side]) return;
+
+    if (slot.kind == BoneSlot::Kind::FACE) {
+        static const BEMatrix34 s_faceMatrix = [] {
+            BEMatrix34 mtx;
+            mtx.setPos(glm::fvec3());
+            mtx.setRotLE(glm::identity<glm::fquat>());
+            return mtx;
+        }();
+        static const BEVec3 s_faceScale = [] {
+            BEVec3 scale;
+            scale = glm::fvec3(0.05);
+            return scale;
+        }();
+        writeMemory(matrixPtr, &s_faceMatrix);
+        writeMemory(scalePtr, &s_faceScale);
+        return;
     }
 
-    glm::mat4x3 finalMtx = glm::mat4x3(calculatedLocalMat);
-    BEMatrix34 finalMatrix;
-    finalMatrix.setLEMatrix(finalMtx);
-    writeMemory(matrixPtr, &finalMatrix);
-
-    BEVec3 finalScale;
-    finalScale = boneScale;
-    writeMemory(scalePtr, &finalScale);
-}
\ No newline at end of file
+    // the scale is left as the game copied it, it used to be read and written back unchanged
+    writeMemory(matrixPtr, &s_boneMatrices[slot.boneIndex]);
+}
@@ -6,120 +6,7 @@
 std::array<WeaponMotionAnalyser, 2> CemuHooks::m_motionAnalyzers = {};
 std::array<uint32_t, 2> CemuHooks::m_heldWeapons = { 0, 0 };
 std::array<uint32_t, 2> CemuHooks::m_heldWeaponsLastUpdate = { 0, 0 };
-
-std::array s_cameraRotations = {
-    glm::identity<glm::fquat>(),
-    glm::identity<glm::fquat>()
-};
-std::array s_cameraPositions = {
-    glm::fvec3(0.0f),
-    glm::fvec3(0.0f)
-};
-
-static bool isDroppable(std::string actorName) {
-    static const std::string_view nonDroppableItems[] = {
-        "AncientArrow",
-        "Animal_Insect_A",
-        "Animal_Insect_B",
-        "Animal_Insect_F",
-        "Animal_Insect_H",
-        "Animal_Insect_M",
-        "Animal_Insect_S",
-        "Animal_Insect_X",
-        "Armor_Default_Extra_00",
-        "Armor_Default_Extra_01",
-        "bj_SupportApp_Wind",
-        "BombArrow_A",
-        "BrightArrow",
-        "BrightArrowTP",
-        "CarryBox",
-        "Dm_Npc_Gerudo_HeroSoul_Kago",
-        "Dm_Npc_Goron_HeroSoul_Kago",
-        "Dm_Npc_RevivalFairy",
-        "Dm_Npc_Rito_HeroSoul_Kago",
-        "Dm_Npc_Zora_HeroSoul_Kago",
-        "ElectricArrow",
-        "Explode",
-        "FireArrow",
-        "FireRodLv1Fire",
-        "FireRodLv2Fire",
-        "FireRodLv2FireChild",
-        "GameRomHorseReins_01",
-        "GameRomHorseReins_02",
-        "GameRomHorseReins_03",
-        "GameRomHorseReins_04",
-        "GameRomHorseReins_05",
-        "GameRomHorseReins_10",
-        "GameRomHorseSaddle_01",
-        "GameRomHorseSaddle_02",
-        "GameRomHorseSaddle_03",
-        "GameRomHorseSaddle_04",
-        "GameRomHorseSaddle_05",
-        "GameRomHorseSaddle_10",
-        "GameROMPlayer",
-        "Get_TwnObj_DLC_MemorialPicture_A_01",
-        "IceArrow",
-        "IceRodLv1Ice",
-        "IceRodLv2Ice",
-        "Item_Conductor",
-        "Item_CookSet",
-        "Item_Magnetglove",
-        "Item_Material_01",
-        "Item_Material_03",
-        "Item_Material_07",
-        "Item_Ore_F",
-        "KeySmall",
-        "NormalArrow",
-        "Obj_Armor_115_Head",
-        "Obj_DLC_HeroSeal_Gerudo",
-        "Obj_DLC_HeroSeal_Goron",
-        "Obj_DLC_HeroSeal_Rito",
-        "Obj_DLC_HeroSeal_Zora",
-        "Obj_DLC_HeroSoul_Gerudo",
-        "Obj_DLC_HeroSoul_Goron",
-        "Obj_DLC_HeroSoul_Rito",
-        "Obj_DLC_HeroSoul_Zora",
-        "Obj_DRStone_A_01",
-        "Obj_DRStone_Get",
-        "Obj_DungeonClearSeal",
-        "Obj_HeartUtuwa_A_01",
-        "Obj_HeroSoul_Gerudo",
-        "Obj_HeroSoul_Goron",
-        "Obj_HeroSoul_Rito",
-        "Obj_HeroSoul_Zora",
-        "Obj_IceMakerBlock",
-        "Obj_KorokNuts",
-        "Obj_Maracas",
-        "Obj_ProofBook",
-        "Obj_ProofGiantKiller",
-        "Obj_ProofGolemKiller",
-        "Obj_ProofKorok",
-        "Obj_ProofSandwormKiller",
-        "Obj_StaminaUtuwa_A_01",
-        "Obj_WarpDLC",
-        "PlayerStole2",
-        "PlayerStole2_Vagrant",
-        "Weapon_Bow_071",
-        "Weapon_Sword_056",
-        "Weapon_Sword_070",
-        "Weapon_Sword_080",
-        "Weapon_Sword_081",
-        "Weapon_Sword_502"
-    };
-
-    for (const auto& item : nonDroppableItems) {
-        if (actorName == item) {
-            return false;
-        }
-    }
-
-    // prevent dropping arrows
-    if (actorName.contains("Arrow")) {
-        return false;
-    }
-
-    return true;
-}
+HeldWeapons CemuHooks::m_heldWeaponInfo;
 
 void CemuHooks::hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
@@ -142,90 +29,61 @@ void CemuHooks::hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU) {
 
     uint32_t actorPtr = hCPU->gpr[3]; // holder of weapon
     uint32_t boneNamePtr = hCPU->gpr[4];
-    uint32_t weaponMtxPtr = hCPU->gpr[5];
-    uint32_t playerMtxPtr = hCPU->gpr[6];
-    uint32_t modelBindInfoMtxPtr = hCPU->gpr[7];
     uint32_t targetActorPtr = hCPU->gpr[8]; // weapon that's being held
-    uint32_t cameraPtr = hCPU->gpr[10];
-
-    sead::FixedSafeString40 actorName = getMemory<sead::FixedSafeString40>(actorPtr + offsetof(ActorWiiU, name));
-
-    // todo: remove this?
-    BESeadLookAtCamera camera = {};
-    readMemory(cameraPtr, &camera);
-    glm::fvec3 cameraPos = camera.pos.getLE();
-    glm::fvec3 cameraAt = camera.at.getLE();
-    glm::fquat lookAtQuat = glm::quatLookAtRH(glm::normalize(cameraAt - cameraPos), { 0.0, 1.0, 0.0 });
-    glm::fvec3 lookAtPos = cameraPos;
-    //lookAtPos.y += GetSettings().playerHeightSetting.getLE();
 
-    // read bone name
+    // this runs for every actor that has something attached to a bone, so bail out before reading anything else
     if (boneNamePtr == 0)
         return;
     char* boneName = (char*)s_memoryBaseAddress + boneNamePtr;
-
-    // real logic
-    bool isHeldByPlayer = actorName.getLE() == "GameROMPlayer";
     bool isLeftHandWeapon = strcmp(boneName, "Weapon_L") == 0;
     bool isRightHandWeapon = strcmp(boneName, "Weapon_R") == 0;
-    if (!actorName.getLE().empty() && boneName[0] != '\0' && isHeldByPlayer && (isLeftHandWeapon || isRightHandWeapon)) {
-        OpenXR::EyeSide side = isLeftHandWeapon ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
-
-        m_heldWeapons[side] = targetActorPtr;
-        m_heldWeaponsLastUpdate[side] = 0;
-
-        BEMatrix34 weaponMtx = {};
-        readMemory(weaponMtxPtr, &weaponMtx);
-
-        BEMatrix34 modelBindInfoMtx = {};
-        readMemory(modelBindInfoMtxPtr, &modelBindInfoMtx);
-
-        //ModifyWeaponMtxToVRPose(side, weaponMtx, lookAtQuat, lookAtPos);
-
-        s_cameraPositions[side] = lookAtPos;
-        s_cameraRotations[side] = lookAtQuat;
-
+    if (!isLeftHandWeapon && !isRightHandWeapon)
+        return;
 
-        //// prevent weapon transparency
-        //BEType<float> modelOpacity = 1.0f;
-        //BEType<float> negativeOpacity = 0.0f;
-        //writeMemory(targetActorPtr + offsetof(ActorWiiU, modelOpacity), &modelOpacity);
-        //writeMemory(targetActorPtr + offsetof(ActorWiiU, startModelOpacity), &modelOpacity);
-        //writeMemory(targetActorPtr + offsetof(ActorWiiU, modelOpacityRelated), &negativeOpacity);
-        //uint8_t opacityOrDoFlushOpacityToGPU = 1;
-        //writeMemory(targetActorPtr + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU), &opacityOrDoFlushOpacityToGPU);
+    GuestStringView actorName = getSafeStringView<sead::FixedSafeString40>(actorPtr + offsetof(ActorWiiU, name));
+    if (actorName != "GameROMPlayer")
+        return;
 
-        //writeMemory(weaponMtxPtr, &weaponMtx);
-        //writeMemory(modelBindInfoMtxPtr, &modelBindInfoMtx);
+    // the weapon matrices don't need to be touched here since the hand bones are already moved to the controller poses by hook_ModifyBoneMatrix
+    OpenXR::EyeSide side = isLeftHandWeapon ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
 
-        Weapon targetActor = {};
-        readMemory(targetActorPtr, &targetActor);
+    m_heldWeapons[side] = targetActorPtr;
+    m_heldWeaponsLastUpdate[side] = 0;
 
-        // check if weapon is held and if the grip button is held, drop it
-        auto input = VRManager::instance().XR->m_input.load();
-        auto dropSide = input.inGame.drop_weapon[side];
+    // only look up the weapon's type and whether it's droppable when the hand starts holding a different weapon
+    GuestStringView weaponName = getSafeStringView<sead::FixedSafeString40>(targetActorPtr + offsetof(ActorWiiU, name));
+    bool changed = m_heldWeaponInfo.Update(side, targetActorPtr, weaponName, [targetActorPtr] {
+        return (uint32_t)getMemory<BEType<WeaponType>>(targetActorPtr + offsetof(Weapon, type)).getLE();
+    });
+    const HeldWeapons::Info& info = m_heldWeaponInfo.Get(side);
+    if (changed) {
+        Log::print<CONTROLS>("{} hand is now holding {} with type of {}", side == OpenXR::EyeSide::LEFT ? "Left" : "Right", weaponName, info.type);
+    }
 
-        if (input.inGame.in_game && dropSide && isDroppable(targetActor.name.getLE())) {
-            Log::print<INFO>("Dropping weapon {} with type of {} due to double press on grab button", targetActor.name.getLE().c_str(), (uint32_t)targetActor.type.getLE());
-            hCPU->gpr[11] = 1;
-            hCPU->gpr[9] = 1;
-            hCPU->gpr[13] = isLeftHandWeapon ? 1 : 0; // set the hand index to 0 for left hand, 1 for right hand
-            return;
-        }
-        // Support for long press (placeholder)
-        //if (input.inGame.in_game && grabState.lastEvent == ButtonState::Event::LongPress) {
-        //    Log::print<CONTROLS>("Long press detected for {} (side {})", targetActor.name.getLE().c_str(), (int)side);
-        //    // TODO: Implement long press action (e.g., temporarily bind item)
-        //    //grabState.longPress = false;
-        //}
-        //// Support for short press (placeholder)
-        //if (input.inGame.in_game && grabState.lastEvent == ButtonState::Event::ShortPress) {
-        //    Log::print<CONTROLS>("Short press detected for {} (side {})", targetActor.name.getLE().c_str(), (int)side);
-        //    // TODO: Implement short press action (e.g., cycle weapon)
-        //}
+    // check if weapon is held and if the grip button is held, drop it
+    auto input = VRManager::instance().XR->m_input.load();
+    auto dropSide = input.inGame.drop_weapon[side];
 
+    if (input.inGame.in_game && dropSide && info.droppable) {
+        Log::print<INFO>("Dropping weapon {} with type of {} due to double press on grab button", weaponName, info.type);
+        hCPU->gpr[11] = 1;
         hCPU->gpr[9] = 1;
+        hCPU->gpr[13] = isLeftHandWeapon ? 1 : 0; // set the hand index to 0 for left hand, 1 for right hand
+        return;
     }
+    // Support for long press (placeholder)
+    //if (input.inGame.in_game && grabState.lastEvent == ButtonState::Event::LongPress) {
+    //    Log::print<CONTROLS>("Long press detected for {} (side {})", targetActor.name.getLE().c_str(), (int)side);
+    //    // TODO: Implement long press action (e.g., temporarily bind item)
+    //    //grabState.longPress = false;
+    //}
+    //// Support for short press (placeholder)
+    //if (input.inGame.in_game && grabState.lastEvent == ButtonState::Event::ShortPress) {
+    //    Log::print<CONTROLS>("Short press detected for {} (side {})", targetActor.name.getLE().c_str(), (int)side);
+    //    // TODO: Implement short press action (e.g., cycle weapon)
+    //}
+
+    hCPU->gpr[9] = 1;
 }
 
 // todo: this only runs when it's shown for the first time!
@@ -354,8 +212,19 @@ void CemuHooks::hook_EnableWeaponAttackSensor(PPCInterpreter_t* hCPU) {
         return;
     }
 
+    // analyse the pose at the display time of the frame that the weapon is updated for, the velocities stay the runtime's since the detection thresholds are tuned for them
+    XrSpaceLocation handLocation = state.inGame.poseLocation[heldIndex];
+    XrTime inputTime = state.inGame.inputTime;
+    PosePredictor& posePredictor = VRManager::instance().XR->GetPosePredictor();
+    const XrTime targetTime = posePredictor.GetTargetTime();
+    if (auto predicted = posePredictor.PoseAt(PosePredictor::HandDevice(heldIndex), targetTime)) {
+        handLocation.pose.position = ToXR(predicted->position);
+        handLocation.pose.orientation = ToXR(predicted->orientation);
+        inputTime = targetTime;
+    }
+
     m_motionAnalyzers[heldIndex].ResetIfWeaponTypeChanged(weaponType);
-    m_motionAnalyzers[heldIndex].Update(state.inGame.poseLocation[heldIndex], state.inGame.poseVelocity[heldIndex], headset.value(), state.inGame.inputTime);
+    m_motionAnalyzers[heldIndex].Update(handLocation, state.inGame.poseVelocity[heldIndex], headset.value(), inputTime);
 
     // Use the analysed motion to determine whether the weapon is swinging or stabbing, and whether the attackSensor should be active this frame
     bool CHEAT_alwaysEnableWeaponCollision = false;
@@ -489,4 +358,23 @@ void CemuHooks::DrawDebugOverlays() {
         }
     }
     ImGui::End();
+    if (ImGui::Begin("Input Journal")) {
+        static std::optional<InputJournal::ReplayResult> s_lastReplay;
+        if (ImGui::Button("Save Journal")) {
+            s_inputJournal.Save(InputJournal::GetDefaultPath(), s_inputMapping.GetProfileHash());
+        }
+        ImGui::SameLine();
+        if (ImGui::Button("Replay Journal")) {
+            s_lastReplay = InputJournal::ReplayFile(InputJournal::GetDefaultPath());
+        }
+        if (s_lastReplay.has_value()) {
+            ImGui::Text("Replayed %zu frames (%zu compared)", s_lastReplay->frames, s_lastReplay->comparedFrames);
+            ImGui::Text("Mapping divergences: %zu", s_lastReplay->mappingDivergences);
+            ImGui::Text("Stick divergences: %zu", s_lastReplay->stickDivergences);
+            if (!s_lastReplay->profileMatches) {
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.0f, 1.0f), "Recorded with a different input profile");
+            }
+        }
+    }
+    ImGui::End();
 }
@@ -20,6 +20,8 @@ public:
     void operator=(VRManager const&) = delete;
 
     void Init(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device) {
+        Handoffs = std::make_unique<HandoffTracker>();
+        Handoffs->StartWatchdog(std::chrono::seconds(5), std::chrono::seconds(1));
         D3D12 = std::make_unique<RND_D3D12>();
         VK = std::make_unique<RND_Vulkan>(instance, physicalDevice, device);
         Log::print<INFO>("Initialized VRManager instance...");
@@ -39,6 +41,7 @@ public:
     std::unique_ptr<RND_D3D12> D3D12;
     std::unique_ptr<RND_Vulkan> VK;
     std::unique_ptr<CemuHooks> Hooks;
+    std::unique_ptr<HandoffTracker> Handoffs;
 
     uint32_t vkVersion = 0;
 
@@ -52,6 +55,7 @@ private:
         // note: OpenXR gets to remove its swapchains first before D3D12 gets destroyed, so reverse that order
         VK.reset();
         XR.reset();
+        Handoffs.reset();
         D3D12.reset();
 
         m_logger.reset();
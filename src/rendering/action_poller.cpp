@@ -0,0 +1,63 @@
+#include "action_poller.h"
+
+std::string ActionPoller::Describe(const Action& action, uint8_t hand) {
+    if (action.subaction != Subaction::BOTH_HANDS) {
+        return action.id;
+    }
+    return std::format("{} ({} hand)", action.id, hand == 0 ? "left" : "right");
+}
+
+ActionPoller::Result ActionPoller::Poll(const Action& action, uint8_t hand, void* state, const void* prevState) const {
+    XrActionStateGetInfo getInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
+    getInfo.action = action.action;
+    if (action.subaction == Subaction::BOTH_HANDS) {
+        getInfo.subactionPath = m_handPaths[hand];
+    }
+    else if (action.subaction == Subaction::RIGHT_HAND) {
+        getInfo.subactionPath = m_handPaths[1];
+    }
+
+    XrResult result = XR_SUCCESS;
+    Result polled = {};
+    switch (action.type) {
+        case XR_ACTION_TYPE_BOOLEAN_INPUT: {
+            auto& actionState = *static_cast<XrActionStateBoolean*>(state);
+            actionState = { XR_TYPE_ACTION_STATE_BOOLEAN };
+            result = xrGetActionStateBoolean(m_session, &getInfo, &actionState);
+            polled.isActive = actionState.isActive == XR_TRUE;
+            polled.pressed = actionState.currentState == XR_TRUE;
+            polled.changed = actionState.currentState != static_cast<const XrActionStateBoolean*>(prevState)->currentState;
+            break;
+        }
+        case XR_ACTION_TYPE_FLOAT_INPUT: {
+            auto& actionState = *static_cast<XrActionStateFloat*>(state);
+            actionState = { XR_TYPE_ACTION_STATE_FLOAT };
+            result = xrGetActionStateFloat(m_session, &getInfo, &actionState);
+            polled.isActive = actionState.isActive == XR_TRUE;
+            polled.pressed = actionState.currentState > PRESS_THRESHOLD;
+            polled.changed = actionState.currentState != static_cast<const XrActionStateFloat*>(prevState)->currentState;
+            break;
+        }
+        case XR_ACTION_TYPE_VECTOR2F_INPUT: {
+            auto& actionState = *static_cast<XrActionStateVector2f*>(state);
+            actionState = { XR_TYPE_ACTION_STATE_VECTOR2F };
+            result = xrGetActionStateVector2f(m_session, &getInfo, &actionState);
+            polled.isActive = actionState.isActive == XR_TRUE;
+            const XrVector2f& prevValue = static_cast<const XrActionStateVector2f*>(prevState)->currentState;
+            polled.changed = actionState.currentState.x != prevValue.x || actionState.currentState.y != prevValue.y;
+            break;
+        }
+        case XR_ACTION_TYPE_POSE_INPUT: {
+            auto& actionState = *static_cast<XrActionStatePose*>(state);
+            actionState = { XR_TYPE_ACTION_STATE_POSE };
+            result = xrGetActionStatePose(m_session, &getInfo, &actionState);
+            polled.isActive = actionState.isActive == XR_TRUE;
+            polled.changed = actionState.isActive != static_cast<const XrActionStatePose*>(prevState)->isActive;
+            break;
+        }
+        default:
+            checkAssert(false, std::format("Action {} has a type that can't be polled!", action.id).c_str());
+    }
+    checkXRResult(result, std::format("Failed to get {} action value!", action.id).c_str());
+    return polled;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// reads the state of a single action for a hand and compares it against the state of the last poll, so that OpenXR::UpdateActions
+// can poll every action of its registry in one loop. it only talks to the runtime through the xr* functions, which the tests mock.
+class ActionPoller {
+public:
+    enum class Subaction : uint8_t {
+        NONE,       // queried without a subaction path
+        BOTH_HANDS, // queried once for each hand
+        RIGHT_HAND,
+    };
+
+    struct Action {
+        const char* id;
+        XrAction action;
+        XrActionType type;
+        Subaction subaction;
+    };
+
+    struct Result {
+        bool isActive = false;
+        bool pressed = false; // booleans that are down and floats that are past the press threshold
+        bool changed = false;
+    };
+
+    static constexpr float PRESS_THRESHOLD = 0.75f;
+
+    ActionPoller(XrSession session, std::array<XrPath, 2> handPaths): m_session(session), m_handPaths(handPaths) {}
+
+    static uint8_t GetHandCount(Subaction subaction) { return subaction == Subaction::BOTH_HANDS ? 2 : 1; }
+    // the action's id, together with the hand for the actions that are polled once for each hand
+    static std::string Describe(const Action& action, uint8_t hand);
+
+    // state and prevState point to the XrActionState struct that matches the action's type, prevState isn't modified
+    Result Poll(const Action& action, uint8_t hand, void* state, const void* prevState) const;
+
+private:
+    XrSession m_session;
+    std::array<XrPath, 2> m_handPaths;
+};
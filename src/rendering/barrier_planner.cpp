@@ -0,0 +1,153 @@
+#include "barrier_planner.h"
+
+void BarrierPlanner::Track(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout layout) {
+    Track(image, ImageState{
+        .aspectMask = aspectMask,
+        .layout = layout,
+        .writeStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        .writeAccess = VK_ACCESS_2_MEMORY_WRITE_BIT,
+        .visibleStages = VK_PIPELINE_STAGE_2_NONE,
+        .visibleAccess = VK_ACCESS_2_NONE,
+        .readStages = VK_PIPELINE_STAGE_2_NONE,
+        .external = true
+    });
+}
+
+void BarrierPlanner::Track(VkImage image, const ImageState& state) {
+    m_images.try_emplace(image, TrackedImage{ .state = state });
+}
+
+void BarrierPlanner::Use(VkImage image, const Access& access) {
+    auto it = m_images.find(image);
+    checkAssert(it != m_images.end(), "Image has to be tracked before it can be used!");
+    TrackedImage& tracked = it->second;
+    ImageState& state = tracked.state;
+
+    const bool writes = (access.access & WRITE_ACCESS_MASK) != 0;
+
+    // nothing has been recorded since the barrier was queued, so it only has to be widened to also cover this access
+    if (tracked.pendingBarrier >= 0) {
+        VkImageMemoryBarrier2& barrier = m_barriers[tracked.pendingBarrier];
+        checkAssert(barrier.newLayout == access.layout, "Accesses that are declared for the same operation need to use the same layout!");
+        barrier.dstStageMask |= access.stages;
+        barrier.dstAccessMask |= access.access;
+        if (writes) {
+            state.writeStages |= access.stages;
+            state.writeAccess |= access.access & WRITE_ACCESS_MASK;
+            state.visibleStages = VK_PIPELINE_STAGE_2_NONE;
+            state.visibleAccess = VK_ACCESS_2_NONE;
+            state.readStages = VK_PIPELINE_STAGE_2_NONE;
+        }
+        else {
+            state.visibleStages |= access.stages;
+            state.visibleAccess |= access.access;
+            state.readStages |= access.stages;
+        }
+        state.external = false;
+        return;
+    }
+
+    const bool transition = state.layout != access.layout;
+    VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 srcAccess = VK_ACCESS_2_NONE;
+    bool needsBarrier = false;
+    if (transition || writes) {
+        // layout transitions and writes have to wait for every earlier access, but only the last write has to be made available.
+        // once a barrier made it visible to a read it's available already, and waiting for the reads since then also waits for it.
+        const bool isWriteAvailable = state.visibleStages != VK_PIPELINE_STAGE_2_NONE;
+        srcStages = (isWriteAvailable ? VK_PIPELINE_STAGE_2_NONE : state.writeStages) | state.readStages;
+        srcAccess = isWriteAvailable ? VK_ACCESS_2_NONE : state.writeAccess;
+        needsBarrier = transition || srcStages != VK_PIPELINE_STAGE_2_NONE;
+    }
+    else if (state.writeAccess != VK_ACCESS_2_NONE) {
+        // reads only have to wait for the last write, and only if it wasn't already made visible to them
+        srcStages = state.writeStages;
+        srcAccess = state.writeAccess;
+        needsBarrier = (access.stages & ~state.visibleStages) != 0 || (access.access & ~state.visibleAccess) != 0;
+    }
+
+    if (needsBarrier) {
+        VkImageMemoryBarrier2 barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+        barrier.srcStageMask = srcStages;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstStageMask = access.stages;
+        barrier.dstAccessMask = access.access;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = access.layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {
+            .aspectMask = state.aspectMask,
+            .baseMipLevel = 0,
+            .levelCount = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount = VK_REMAINING_ARRAY_LAYERS
+        };
+        tracked.pendingBarrier = (int32_t)m_barriers.size();
+        m_barriers.emplace_back(barrier);
+    }
+
+    if (writes) {
+        state.writeStages = access.stages;
+        state.writeAccess = access.access & WRITE_ACCESS_MASK;
+        state.visibleStages = VK_PIPELINE_STAGE_2_NONE;
+        state.visibleAccess = VK_ACCESS_2_NONE;
+        state.readStages = VK_PIPELINE_STAGE_2_NONE;
+    }
+    else if (transition) {
+        // the transition already waited for the earlier reads
+        state.visibleStages = access.stages;
+        state.visibleAccess = access.access;
+        state.readStages = access.stages;
+    }
+    else {
+        if (needsBarrier) {
+            state.visibleStages |= access.stages;
+            state.visibleAccess |= access.access;
+        }
+        state.readStages |= access.stages;
+    }
+    state.layout = access.layout;
+    state.external = false;
+}
+
+void BarrierPlanner::Release(VkImage image, VkImageLayout layout) {
+    auto it = m_images.find(image);
+    checkAssert(it != m_images.end(), "Image has to be tracked before it can be released!");
+    if (it->second.state.external && it->second.state.layout == layout && it->second.pendingBarrier < 0) {
+        return;
+    }
+
+    Use(image, External(layout));
+    it->second.state.external = true;
+}
+
+VkImageLayout BarrierPlanner::GetLayout(VkImage image) const {
+    return GetState(image).layout;
+}
+
+const BarrierPlanner::ImageState& BarrierPlanner::GetState(VkImage image) const {
+    auto it = m_images.find(image);
+    checkAssert(it != m_images.end(), "Image isn't tracked!");
+    return it->second.state;
+}
+
+std::vector<VkImageMemoryBarrier2> BarrierPlanner::TakeBarriers() {
+    for (auto& tracked : m_images | std::views::values) {
+        tracked.pendingBarrier = -1;
+    }
+    return std::exchange(m_barriers, {});
+}
+
+void BarrierPlanner::Flush(VkCommandBuffer cmdBuffer) {
+    if (m_barriers.empty()) {
+        return;
+    }
+
+    const std::vector<VkImageMemoryBarrier2> barriers = TakeBarriers();
+    VkDependencyInfo dependencyInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dependencyInfo.imageMemoryBarrierCount = (uint32_t)barriers.size();
+    dependencyInfo.pImageMemoryBarriers = barriers.data();
+    vkroots::tables::CommandBufferDispatches.find(cmdBuffer)->CmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+// plans the image barriers for the copies and clears that get recorded into Cemu's command buffers.
+// it remembers the layout and the last accesses of every image it has seen and only queues the barriers that the next access needs,
+// which then all get recorded with a single vkCmdPipelineBarrier2 on Flush. since Cemu's own work isn't tracked, its images are assumed
+// to have been written by anything that came before them when they're first tracked or after they've been released back to Cemu.
+// BetterVR's own textures are only recorded into by the hooks, so they carry their state over to the next planner instead.
+class BarrierPlanner {
+public:
+    struct Access {
+        VkPipelineStageFlags2 stages;
+        VkAccessFlags2 access;
+        VkImageLayout layout;
+    };
+
+    static constexpr VkAccessFlags2 WRITE_ACCESS_MASK = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+    static constexpr Access TransferSrc(VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL) { return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, layout }; }
+    static constexpr Access TransferDst(VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL) { return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, layout }; }
+    static constexpr Access ColorAttachment() { return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL }; }
+    static constexpr Access FragmentShaderRead(VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL) { return { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, layout }; }
+    // whatever Cemu records after the image is handed back to it
+    static constexpr Access External(VkImageLayout layout) { return { VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT, layout }; }
+
+    // what has been done with an image so far, which is kept by BetterVR's own textures in between the planners of each hook
+    struct ImageState {
+        VkImageAspectFlags aspectMask;
+        VkImageLayout layout;
+        VkPipelineStageFlags2 writeStages;   // the last write, which has to be made visible before the image is read
+        VkAccessFlags2 writeAccess;
+        VkPipelineStageFlags2 visibleStages; // the stages and accesses that the last write has already been made visible to
+        VkAccessFlags2 visibleAccess;
+        VkPipelineStageFlags2 readStages;    // reads since the last write, which the next write or layout transition has to wait for
+        bool external;
+    };
+
+    // starts tracking an image that's currently in the given layout, does nothing if it's already tracked
+    void Track(VkImage image, VkImageAspectFlags aspectMask, VkImageLayout layout);
+    // starts tracking an image with what an earlier planner left it in, does nothing if it's already tracked
+    void Track(VkImage image, const ImageState& state);
+    // declares an access of the next recorded operation, all the accesses declared before a Flush have to be able to run at the same time
+    void Use(VkImage image, const Access& access);
+    // hands the image back to Cemu in the given layout, which doesn't need a barrier if it wasn't used since it was tracked
+    void Release(VkImage image, VkImageLayout layout);
+
+    VkImageLayout GetLayout(VkImage image) const;
+    // includes the accesses whose barriers are still queued, so it's only valid for the next planner once they're flushed
+    const ImageState& GetState(VkImage image) const;
+
+    // returns the queued barriers and clears them
+    std::vector<VkImageMemoryBarrier2> TakeBarriers();
+    // records the queued barriers, if there are any
+    void Flush(VkCommandBuffer cmdBuffer);
+
+private:
+    struct TrackedImage {
+        ImageState state;
+        int32_t pendingBarrier = -1; // index into m_barriers while a barrier for this image is queued
+    };
+
+    std::unordered_map<VkImage, TrackedImage> m_images;
+    std::vector<VkImageMemoryBarrier2> m_barriers;
+};
@@ -7,6 +7,13 @@
 
 #define ENABLE_VALIDATION_LAYER FALSE
 
+template <bool depth>
+static constexpr ShaderCache::ShaderKey PRESENT_VERTEX_SHADER = { ShaderBlobStore::Hash(depth ? presentDepthHLSL : presentHLSL), "VSMain", "vs_5_1" };
+template <bool depth>
+static constexpr ShaderCache::ShaderKey PRESENT_PIXEL_SHADER = { ShaderBlobStore::Hash(depth ? presentDepthHLSL : presentHLSL), "PSMain", "ps_5_1" };
+static constexpr ShaderCache::ShaderKey REPROJECT_VERTEX_SHADER = { ShaderBlobStore::Hash(reprojectHLSL), "VSMain", "vs_5_1" };
+static constexpr ShaderCache::ShaderKey REPROJECT_PIXEL_SHADER = { ShaderBlobStore::Hash(reprojectHLSL), "PSMain", "ps_5_1" };
+
 RND_D3D12::RND_D3D12() {
     UINT dxgiFactoryFlags = 0;
 #if ENABLE_VALIDATION_LAYER
@@ -66,16 +73,128 @@ RND_D3D12::RND_D3D12() {
         .Flags = D3D12_COMMAND_QUEUE_FLAG_NONE
     };
     checkHResult(m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_queue)), "Failed to create D3D12 command queue!");
+    m_queue->SetName(L"Direct Queue");
+
+    // the present pass draws into the swapchains, so it needs another direct queue instead of a compute or copy one
+    checkHResult(m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_presentQueue)), "Failed to create D3D12 present queue!");
+    m_presentQueue->SetName(L"Present Queue");
+
+    for (PresentGraph::Lane lane : { PresentGraph::Lane::DIRECT, PresentGraph::Lane::PRESENT }) {
+        checkHResult(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_laneFences[(size_t)lane])), "Failed to create fence for present lane!");
+    }
+    m_laneWaitEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+    checkAssert(m_laneWaitEvent != NULL, "Failed to create present lane event!");
+
+    for (FrameResources& frame : m_frames) {
+        checkHResult(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&frame.allocator)), "Failed to create frame allocator!");
+    }
+
+    m_descriptorArena = std::make_unique<DescriptorArena>(DescriptorArena::CreateD3D12Backend(m_device.Get()));
+
+    // compile the present shaders (or load them from the cache) now instead of when the first frame gets presented
+    m_shaderCache = std::make_unique<ShaderCache>(m_device.Get());
+    m_shaderCache->GetShader(PRESENT_VERTEX_SHADER<false>, presentHLSL);
+    m_shaderCache->GetShader(PRESENT_PIXEL_SHADER<false>, presentHLSL);
+    m_shaderCache->GetShader(PRESENT_VERTEX_SHADER<true>, presentDepthHLSL);
+    m_shaderCache->GetShader(PRESENT_PIXEL_SHADER<true>, presentDepthHLSL);
+    m_shaderCache->GetShader(REPROJECT_VERTEX_SHADER, reprojectHLSL);
+    m_shaderCache->GetShader(REPROJECT_PIXEL_SHADER, reprojectHLSL);
+    m_shaderCache->Save();
+    m_shaderCache->LogStats();
 }
 
 RND_D3D12::~RND_D3D12() {
+    WaitForIdle();
+    CloseHandle(m_laneWaitEvent);
+}
+
+ID3D12CommandQueue* RND_D3D12::GetLaneQueue(PresentGraph::Lane lane) {
+    switch (lane) {
+        case PresentGraph::Lane::DIRECT: return m_queue.Get();
+        case PresentGraph::Lane::PRESENT: return m_presentQueue.Get();
+        default: return nullptr;
+    }
+}
+
+void RND_D3D12::StartFrame() {
+    m_frameIdx = (m_frameIdx + 1) % FRAMES_IN_FLIGHT;
+    FrameResources& frame = m_frames[m_frameIdx];
+
+    // the frame that used this allocator last has usually finished long ago, so this rarely blocks
+    bool stalled = false;
+    for (PresentGraph::Lane lane : { PresentGraph::Lane::DIRECT, PresentGraph::Lane::PRESENT }) {
+        stalled |= WaitForLane(lane, frame.scheduled[(size_t)lane]);
+    }
+    if (stalled) {
+        m_stalledFrames++;
+    }
+
+    checkHResult(frame.allocator->Reset(), "Failed to reset frame allocator!");
+    frame.retired.clear();
+
+    m_descriptorArena->BeginFrame((uint32_t)m_frameIdx);
+    m_presentGraph.BeginFrame();
+}
+
+void RND_D3D12::EndFrame() {
+    FrameResources& frame = m_frames[m_frameIdx];
+    frame.scheduled = m_presentGraph.GetScheduled();
+    PollLanes();
+
+    if (++m_frameCount % 500 == 0) {
+        Log::print<RENDERING>("Present lanes: {} of the last 500 frames had to wait for an earlier frame, {} present and {} direct jobs are still in flight", m_stalledFrames, m_presentGraph.GetInFlight(PresentGraph::Lane::PRESENT), m_presentGraph.GetInFlight(PresentGraph::Lane::DIRECT));
+        m_stalledFrames = 0;
+    }
+}
+
+void RND_D3D12::BeginJob(PresentGraph::JobId id) {
+    const PresentGraph::Job& job = m_presentGraph.GetJob(id);
+    ID3D12CommandQueue* queue = GetLaneQueue(job.lane);
+    checkAssert(queue != nullptr, "Only jobs on the gpu lanes can be run by D3D12!");
+
+    for (const PresentGraph::Wait& wait : job.waits) {
+        checkAssert(m_laneFences[(size_t)wait.lane] != nullptr, "The gpu lanes can't wait for jobs that run on the cpu!");
+        checkHResult(queue->Wait(m_laneFences[(size_t)wait.lane].Get(), wait.value), "Failed to wait for present lane!");
+    }
+}
+
+void RND_D3D12::EndJob(PresentGraph::JobId id) {
+    const PresentGraph::Job& job = m_presentGraph.GetJob(id);
+    checkHResult(GetLaneQueue(job.lane)->Signal(m_laneFences[(size_t)job.lane].Get(), job.signalValue), "Failed to signal present lane!");
+}
+
+void RND_D3D12::PollLanes() {
+    for (PresentGraph::Lane lane : { PresentGraph::Lane::DIRECT, PresentGraph::Lane::PRESENT }) {
+        m_presentGraph.OnCompleted(lane, m_laneFences[(size_t)lane]->GetCompletedValue());
+    }
+}
+
+void RND_D3D12::WaitForIdle() {
+    for (PresentGraph::Lane lane : { PresentGraph::Lane::DIRECT, PresentGraph::Lane::PRESENT }) {
+        WaitForLane(lane, m_presentGraph.GetScheduled()[(size_t)lane]);
+    }
+}
+
+void RND_D3D12::Retire(ComPtr<ID3D12Resource> resource) {
+    m_frames[m_frameIdx].retired.emplace_back(std::move(resource));
+}
+
+bool RND_D3D12::WaitForLane(PresentGraph::Lane lane, uint64_t value) {
+    ID3D12Fence* fence = m_laneFences[(size_t)lane].Get();
+    const bool blocked = fence->GetCompletedValue() < value;
+    if (blocked) {
+        checkHResult(fence->SetEventOnCompletion(value, m_laneWaitEvent), "Failed to set event completion for present lane!");
+        WaitForSingleObject(m_laneWaitEvent, INFINITE);
+    }
+    m_presentGraph.OnCompleted(lane, fence->GetCompletedValue());
+    return blocked;
 }
 
 template <bool depth>
 RND_D3D12::PresentPipeline<depth>::PresentPipeline(RND_Renderer* pRenderer) {
     // This needs to know the format of the swapchain images, thus needs to wait until the swapchain images are created
-    m_vertexShader = D3D12Utils::CompileShader(depth ? presentDepthHLSL : presentHLSL, "VSMain", "vs_5_1");
-    m_pixelShader = D3D12Utils::CompileShader(depth ? presentDepthHLSL : presentHLSL, "PSMain", "ps_5_1");
+    m_vertexShader = VRManager::instance().D3D12->GetShaderCache()->GetShader(PRESENT_VERTEX_SHADER<depth>, depth ? presentDepthHLSL : presentHLSL);
+    m_pixelShader = VRManager::instance().D3D12->GetShaderCache()->GetShader(PRESENT_PIXEL_SHADER<depth>, depth ? presentDepthHLSL : presentHLSL);
 
     auto createSignature = [this]() {
         // clang-format off
@@ -83,7 +202,7 @@ RND_D3D12::PresentPipeline<depth>::PresentPipeline(RND_Renderer* pRenderer) {
             // Input textures
             {
                 .RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV,
-                .NumDescriptors = (UINT)this->m_attachmentHandles.size(),
+                .NumDescriptors = (UINT)this->m_attachmentViews.size(),
                 .BaseShaderRegister = 0,
                 .RegisterSpace = 0,
                 .OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND
@@ -145,27 +264,6 @@ RND_D3D12::PresentPipeline<depth>::PresentPipeline(RND_Renderer* pRenderer) {
         return rootSigBlob;
     };
 
-    m_attachmentHeap = D3D12Utils::CreateDescriptorHeap(VRManager::instance().D3D12->GetDevice(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, true, (UINT)m_attachmentHandles.size());
-    m_targetHeap = D3D12Utils::CreateDescriptorHeap(VRManager::instance().D3D12->GetDevice(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, false, (UINT)m_targetHandles.size());
-    if constexpr (depth) {
-        m_depthHeap = D3D12Utils::CreateDescriptorHeap(VRManager::instance().D3D12->GetDevice(), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, false, (UINT)m_depthTargetHandles.size());
-    }
-
-    for (uint32_t i = 0; i < m_attachmentHandles.size(); i++) {
-        m_attachmentHandles[i] = m_attachmentHeap->GetCPUDescriptorHandleForHeapStart();
-        m_attachmentHandles[i].ptr += (i * VRManager::instance().D3D12->GetDevice()->GetDescriptorHandleIncrementSize(m_attachmentHeap->GetDesc().Type));
-    }
-
-    for (uint32_t i = 0; i < m_targetHandles.size(); i++) {
-        m_targetHandles[i] = m_targetHeap->GetCPUDescriptorHandleForHeapStart();
-        m_targetHandles[i].ptr += (i * VRManager::instance().D3D12->GetDevice()->GetDescriptorHandleIncrementSize(m_targetHeap->GetDesc().Type));
-    }
-
-    for (uint32_t i = 0; i < m_depthTargetHandles.size(); i++) {
-        m_depthTargetHandles[i] = m_depthHeap->GetCPUDescriptorHandleForHeapStart();
-        m_depthTargetHandles[i].ptr += (i * VRManager::instance().D3D12->GetDevice()->GetDescriptorHandleIncrementSize(m_depthHeap->GetDesc().Type));
-    }
-
     m_signature = createSignature();
 
     // upload screen indices
@@ -196,71 +294,61 @@ RND_D3D12::PresentPipeline<depth>::PresentPipeline(RND_Renderer* pRenderer) {
 }
 
 
-// These change the CPU handles that'll later be used for binding the actual assets
+// These look up the views that'll later be used for binding the actual assets, they're only created the first time a texture and format is bound
 template <bool depth>
 void RND_D3D12::PresentPipeline<depth>::BindAttachment(uint32_t attachmentIdx, ID3D12Resource* srcTexture, DXGI_FORMAT overwriteFormat) {
-    D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-    srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-    srvDesc.Format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : srcTexture->GetDesc().Format;
-    srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = 1;
-    VRManager::instance().D3D12->GetDevice()->CreateShaderResourceView(srcTexture, &srvDesc, m_attachmentHandles[attachmentIdx]);
+    const DXGI_FORMAT format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : srcTexture->GetDesc().Format;
+    m_attachmentViews[attachmentIdx] = VRManager::instance().D3D12->GetDescriptorArena()->GetView(DescriptorArena::ViewType::SRV, srcTexture, format);
 }
 
 template <bool depth>
 void RND_D3D12::PresentPipeline<depth>::BindTarget(uint32_t targetIdx, ID3D12Resource* dstTexture, DXGI_FORMAT overwriteFormat) {
-    D3D12_RENDER_TARGET_VIEW_DESC rtvDesc = {};
-    rtvDesc.Format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : dstTexture->GetDesc().Format;
-    rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
-    VRManager::instance().D3D12->GetDevice()->CreateRenderTargetView(dstTexture, &rtvDesc, m_targetHandles[targetIdx]);
+    const DXGI_FORMAT format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : dstTexture->GetDesc().Format;
+    m_targetViews[targetIdx] = VRManager::instance().D3D12->GetDescriptorArena()->GetView(DescriptorArena::ViewType::RTV, dstTexture, format);
 
-    if (rtvDesc.Format != m_targetFormats[targetIdx]) {
-        m_targetFormats[targetIdx] = rtvDesc.Format;
+    if (format != m_targetFormats[targetIdx]) {
+        m_targetFormats[targetIdx] = format;
         RecreatePipeline();
     }
 }
 
 template <bool depth>
 void RND_D3D12::PresentPipeline<depth>::BindDepthTarget(ID3D12Resource* dstTexture, DXGI_FORMAT overwriteFormat) {
-    D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
-    dsvDesc.Format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : dstTexture->GetDesc().Format;
-    dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-    dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
-    VRManager::instance().D3D12->GetDevice()->CreateDepthStencilView(dstTexture, &dsvDesc, m_depthTargetHandles[0]);
-
-    if (dsvDesc.Format != m_targetFormats.back()) {
-        m_targetFormats.back() = dsvDesc.Format;
+    const DXGI_FORMAT format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : dstTexture->GetDesc().Format;
+    m_depthTargetViews[0] = VRManager::instance().D3D12->GetDescriptorArena()->GetView(DescriptorArena::ViewType::DSV, dstTexture, format);
+
+    if (format != m_targetFormats.back()) {
+        m_targetFormats.back() = format;
         RecreatePipeline();
     }
 }
 
 template <bool depth>
 void RND_D3D12::PresentPipeline<depth>::BindSettings(float screenWidth, float screenHeight) {
-    ComPtr<ID3D12Resource> newSettingsStaging;
-    ComPtr<ID3D12CommandAllocator> newSettingsAllocator;
-    {
-        ID3D12Device* device = VRManager::instance().D3D12->GetDevice();
-        ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetCommandQueue();
-        device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&newSettingsAllocator));
-        RND_D3D12::CommandContext<true> uploadBufferContext(device, queue, newSettingsAllocator.Get(), [this, device, &newSettingsStaging, screenWidth, screenHeight](RND_D3D12::CommandContext<true>* context) {
-            m_settingsBuffer = D3D12Utils::CreateConstantBuffer(device, D3D12_HEAP_TYPE_DEFAULT, sizeof(presentSettings));
+    ID3D12Device* device = VRManager::instance().D3D12->GetDevice();
 
-            newSettingsStaging = D3D12Utils::CreateConstantBuffer(device, D3D12_HEAP_TYPE_UPLOAD, sizeof(presentSettings));
-            void* data;
-            const D3D12_RANGE readRange = { .Begin = 0, .End = 0 };
-            checkHResult(newSettingsStaging->Map(0, &readRange, &data), "Failed to map memory for screen indices buffer!");
-            presentSettings settings = {
-                .renderWidth = screenWidth,
-                .renderHeight = screenHeight,
-                .swapchainWidth = screenWidth,
-                .swapchainHeight = screenHeight,
-            };
-            memcpy(data, &settings, sizeof(presentSettings));
-            newSettingsStaging->Unmap(0, nullptr);
-
-            context->GetRecordList()->CopyBufferRegion(m_settingsBuffer.Get(), 0, newSettingsStaging.Get(), 0, sizeof(presentSettings));
-        });
+    // the previous frame could still be reading the old settings on the present queue
+    if (m_settingsBuffer) {
+        VRManager::instance().D3D12->Retire(std::move(m_settingsBuffer));
+    }
+    if (m_settingsStaging) {
+        VRManager::instance().D3D12->Retire(std::move(m_settingsStaging));
     }
+    m_settingsBuffer = D3D12Utils::CreateConstantBuffer(device, D3D12_HEAP_TYPE_DEFAULT, sizeof(presentSettings));
+
+    // the copy is recorded by the next Render, so it runs on the present queue with the frame that first uses the settings
+    m_settingsStaging = D3D12Utils::CreateConstantBuffer(device, D3D12_HEAP_TYPE_UPLOAD, sizeof(presentSettings));
+    void* data;
+    const D3D12_RANGE readRange = { .Begin = 0, .End = 0 };
+    checkHResult(m_settingsStaging->Map(0, &readRange, &data), "Failed to map memory for present settings buffer!");
+    presentSettings settings = {
+        .renderWidth = screenWidth,
+        .renderHeight = screenHeight,
+        .swapchainWidth = screenWidth,
+        .swapchainHeight = screenHeight,
+    };
+    memcpy(data, &settings, sizeof(presentSettings));
+    m_settingsStaging->Unmap(0, nullptr);
 }
 
 template <bool depth>
@@ -328,7 +416,7 @@ void RND_D3D12::PresentPipeline<depth>::RecreatePipeline() {
     psoDesc.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_0xFFFF;
     psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
     psoDesc.NumRenderTargets = 1;
-    for (uint32_t i = 0; i < m_targetHandles.size(); i++) {
+    for (uint32_t i = 0; i < m_targetViews.size(); i++) {
         psoDesc.RTVFormats[i] = m_targetFormats[i];
     }
     psoDesc.DSVFormat = m_targetFormats.back();
@@ -337,7 +425,10 @@ void RND_D3D12::PresentPipeline<depth>::RecreatePipeline() {
     psoDesc.NodeMask = 0;
     psoDesc.CachedPSO = { nullptr, 0 };
     psoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
-    checkHResult(VRManager::instance().D3D12->GetDevice()->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pipelineState)), "Failed to create graphics pipeline state!");
+
+    // everything else in the description is fixed per depth variant, so switching back to a previously used format doesn't create a new pipeline
+    const uint64_t pipelineKey = ShaderBlobStore::HashValues(PRESENT_VERTEX_SHADER<depth>.Hash(), PRESENT_PIXEL_SHADER<depth>.Hash(), depth, m_targetFormats);
+    m_pipelineState = VRManager::instance().D3D12->GetShaderCache()->GetGraphicsPipeline(pipelineKey, psoDesc);
 }
 
 template <bool depth>
@@ -354,16 +445,35 @@ void RND_D3D12::PresentPipeline<depth>::Render(ID3D12GraphicsCommandList* cmdLis
 
     // set settings
     checkAssert(m_settingsBuffer != nullptr, "Failed to present texture since graphics pipeline hasn't bound some settings yet!");
+    if (m_settingsStaging) {
+        // the buffer is promoted from COMMON by the copy and decays back to it after this command list, like every buffer
+        cmdList->CopyBufferRegion(m_settingsBuffer.Get(), 0, m_settingsStaging.Get(), 0, sizeof(presentSettings));
+        D3D12_RESOURCE_BARRIER barrier = {
+            .Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+            .Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+            .Transition = {
+                .pResource = m_settingsBuffer.Get(),
+                .Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+                .StateBefore = D3D12_RESOURCE_STATE_COPY_DEST,
+                .StateAfter = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER
+            }
+        };
+        cmdList->ResourceBarrier(1, &barrier);
+
+        // kept alive until this frame has finished on the gpu
+        VRManager::instance().D3D12->Retire(std::move(m_settingsStaging));
+    }
     cmdList->SetGraphicsRootConstantBufferView(1, m_settingsBuffer->GetGPUVirtualAddress());
 
     // set shared texture
-    ID3D12DescriptorHeap* heaps[] = { m_attachmentHeap.Get() };
+    DescriptorArena* descriptorArena = VRManager::instance().D3D12->GetDescriptorArena();
+    ID3D12DescriptorHeap* heaps[] = { descriptorArena->GetShaderVisibleHeap() };
     cmdList->SetDescriptorHeaps((UINT)std::size(heaps), heaps);
 
-    cmdList->SetGraphicsRootDescriptorTable(0, m_attachmentHeap->GetGPUDescriptorHandleForHeapStart());
+    cmdList->SetGraphicsRootDescriptorTable(0, descriptorArena->AllocateTable(m_attachmentViews));
 
     // set render target
-    cmdList->OMSetRenderTargets(1, &m_targetHandles[0], true, depth ? &m_depthTargetHandles[0] : nullptr);
+    cmdList->OMSetRenderTargets(1, &m_targetViews[0].handle, true, depth ? &m_depthTargetViews[0].handle : nullptr);
 
     // draw
     //float clearColor[4] = { textureIdx == 0 ? 0.0f, 0.2f, 0.4f, 1.0f : 0.4f, 0.2f, 0.0f, 1.0f };
@@ -375,4 +485,175 @@ void RND_D3D12::PresentPipeline<depth>::Render(ID3D12GraphicsCommandList* cmdLis
 }
 
 template class RND_D3D12::PresentPipeline<false>;
-template class RND_D3D12::PresentPipeline<true>;
\ No newline at end of file
+template class RND_D3D12::PresentPipeline<true>;
+
+
+RND_D3D12::ReprojectPipeline::ReprojectPipeline() {
+    m_vertexShader = VRManager::instance().D3D12->GetShaderCache()->GetShader(REPROJECT_VERTEX_SHADER, reprojectHLSL);
+    m_pixelShader = VRManager::instance().D3D12->GetShaderCache()->GetShader(REPROJECT_PIXEL_SHADER, reprojectHLSL);
+
+    // clang-format off
+    D3D12_DESCRIPTOR_RANGE textureRange[] = {
+        // the color and depth of the last frame, the vertex shader loads the depth too
+        {
+            .RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV,
+            .NumDescriptors = (UINT)m_attachmentViews.size(),
+            .BaseShaderRegister = 0,
+            .RegisterSpace = 0,
+            .OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND
+        }
+    };
+    // clang-format on
+
+    // the parameters are assigned since the settings live in another member of the parameter's union than the table
+    D3D12_ROOT_PARAMETER rootParams[2] = {};
+    rootParams[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParams[0].DescriptorTable = { (UINT)std::size(textureRange), textureRange };
+    rootParams[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    rootParams[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    rootParams[1].Constants = { .ShaderRegister = 1, .RegisterSpace = 0, .Num32BitValues = sizeof(Reprojection::Settings) / sizeof(uint32_t) };
+    rootParams[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_ROOT_SIGNATURE_DESC rootSigDesc = {
+        .NumParameters = (UINT)std::size(rootParams),
+        .pParameters = rootParams,
+        .NumStaticSamplers = 0,
+        .pStaticSamplers = nullptr,
+        .Flags = D3D12_ROOT_SIGNATURE_FLAG_NONE
+    };
+
+    ComPtr<ID3DBlob> serializedBlob;
+    ComPtr<ID3DBlob> error;
+    if (HRESULT res = D3D12SerializeRootSignature(&rootSigDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &serializedBlob, &error); FAILED(res)) {
+        checkHResult(res, std::format("Failed to serialize reprojection root signature! {}", std::string((const char*)error->GetBufferPointer(), error->GetBufferSize())).c_str());
+    }
+    checkHResult(VRManager::instance().D3D12->GetDevice()->CreateRootSignature(0, serializedBlob->GetBufferPointer(), serializedBlob->GetBufferSize(), IID_PPV_ARGS(&m_signature)), "Failed to create reprojection root signature!");
+}
+
+void RND_D3D12::ReprojectPipeline::BindAttachment(uint32_t attachmentIdx, ID3D12Resource* srcTexture, DXGI_FORMAT overwriteFormat) {
+    const DXGI_FORMAT format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : srcTexture->GetDesc().Format;
+    m_attachmentViews[attachmentIdx] = VRManager::instance().D3D12->GetDescriptorArena()->GetView(DescriptorArena::ViewType::SRV, srcTexture, format);
+}
+
+void RND_D3D12::ReprojectPipeline::BindTarget(ID3D12Resource* dstTexture, DXGI_FORMAT overwriteFormat) {
+    const DXGI_FORMAT format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : dstTexture->GetDesc().Format;
+    m_targetView = VRManager::instance().D3D12->GetDescriptorArena()->GetView(DescriptorArena::ViewType::RTV, dstTexture, format);
+
+    if (format != m_targetFormats.front()) {
+        m_targetFormats.front() = format;
+        RecreatePipeline();
+    }
+}
+
+void RND_D3D12::ReprojectPipeline::BindDepthTarget(ID3D12Resource* dstTexture, DXGI_FORMAT overwriteFormat) {
+    const DXGI_FORMAT format = overwriteFormat != DXGI_FORMAT_UNKNOWN ? overwriteFormat : dstTexture->GetDesc().Format;
+    m_depthTargetView = VRManager::instance().D3D12->GetDescriptorArena()->GetView(DescriptorArena::ViewType::DSV, dstTexture, format);
+
+    if (format != m_targetFormats.back()) {
+        m_targetFormats.back() = format;
+        RecreatePipeline();
+    }
+}
+
+void RND_D3D12::ReprojectPipeline::RecreatePipeline() {
+    if (m_targetFormats.front() == DXGI_FORMAT_UNKNOWN) {
+        return;
+    }
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
+    psoDesc.InputLayout = { nullptr, 0 }; // the grid is generated from SV_VertexID
+    psoDesc.pRootSignature = m_signature.Get();
+    psoDesc.VS = { m_vertexShader->GetBufferPointer(), m_vertexShader->GetBufferSize() };
+    psoDesc.PS = { m_pixelShader->GetBufferPointer(), m_pixelShader->GetBufferSize() };
+    psoDesc.BlendState = {
+        .AlphaToCoverageEnable = false,
+        .IndependentBlendEnable = false
+    };
+    for (size_t i = 0; i < std::size(psoDesc.BlendState.RenderTarget); i++) {
+        psoDesc.BlendState.RenderTarget[i] = {
+            .BlendEnable = false,
+
+            .SrcBlend = D3D12_BLEND_ONE,
+            .DestBlend = D3D12_BLEND_ZERO,
+            .BlendOp = D3D12_BLEND_OP_ADD,
+
+            .SrcBlendAlpha = D3D12_BLEND_ONE,
+            .DestBlendAlpha = D3D12_BLEND_ZERO,
+            .BlendOpAlpha = D3D12_BLEND_OP_ADD,
+
+            .LogicOp = D3D12_LOGIC_OP_NOOP,
+            .RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL
+        };
+    }
+    psoDesc.SampleMask = UINT_MAX;
+    // the grid folds over itself behind edges, and the sky that ends up behind the far plane is clamped to it instead of being cut off
+    psoDesc.RasterizerState = {
+        .FillMode = D3D12_FILL_MODE_SOLID,
+        .CullMode = D3D12_CULL_MODE_NONE,
+        .FrontCounterClockwise = false,
+        .DepthBias = D3D12_DEFAULT_DEPTH_BIAS,
+        .DepthBiasClamp = D3D12_DEFAULT_DEPTH_BIAS_CLAMP,
+        .SlopeScaledDepthBias = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS,
+        .DepthClipEnable = false,
+        .MultisampleEnable = false,
+        .AntialiasedLineEnable = false,
+        .ForcedSampleCount = 0,
+        .ConservativeRaster = D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF
+    };
+    // clang-format off
+    psoDesc.DepthStencilState = {
+        .DepthEnable = true,
+        .DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL,
+        .DepthFunc = D3D12_COMPARISON_FUNC_LESS,
+        .StencilEnable = false,
+        .StencilReadMask = D3D12_DEFAULT_STENCIL_READ_MASK,
+        .StencilWriteMask = D3D12_DEFAULT_STENCIL_WRITE_MASK,
+        .FrontFace = {
+            .StencilFailOp = D3D12_STENCIL_OP_KEEP,
+            .StencilDepthFailOp = D3D12_STENCIL_OP_KEEP,
+            .StencilPassOp = D3D12_STENCIL_OP_KEEP,
+            .StencilFunc = D3D12_COMPARISON_FUNC_ALWAYS
+        }
+    };
+    // clang-format on
+    psoDesc.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED;
+    psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    psoDesc.NumRenderTargets = 1;
+    psoDesc.RTVFormats[0] = m_targetFormats.front();
+    psoDesc.DSVFormat = m_targetFormats.back();
+    psoDesc.SampleDesc.Count = 1;
+    psoDesc.SampleDesc.Quality = 0;
+    psoDesc.NodeMask = 0;
+    psoDesc.CachedPSO = { nullptr, 0 };
+    psoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+
+    const uint64_t pipelineKey = ShaderBlobStore::HashValues(REPROJECT_VERTEX_SHADER.Hash(), REPROJECT_PIXEL_SHADER.Hash(), m_targetFormats);
+    m_pipelineState = VRManager::instance().D3D12->GetShaderCache()->GetGraphicsPipeline(pipelineKey, psoDesc);
+}
+
+void RND_D3D12::ReprojectPipeline::Render(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* swapchain, const Reprojection::Settings& settings) {
+    checkAssert(m_pipelineState != nullptr, "Failed to reproject since no target has been bound yet!");
+    cmdList->SetPipelineState(m_pipelineState.Get());
+    cmdList->SetGraphicsRootSignature(m_signature.Get());
+
+    D3D12_VIEWPORT viewport = { 0.0f, 0.0f, (float)swapchain->GetDesc().Width, (float)swapchain->GetDesc().Height, 0.0f, 1.0f };
+    cmdList->RSSetViewports(1, &viewport);
+
+    D3D12_RECT scissorRect = { 0, 0, (LONG)swapchain->GetDesc().Width, (LONG)swapchain->GetDesc().Height };
+    cmdList->RSSetScissorRects(1, &scissorRect);
+
+    cmdList->SetGraphicsRoot32BitConstants(1, sizeof(Reprojection::Settings) / sizeof(uint32_t), &settings, 0);
+
+    DescriptorArena* descriptorArena = VRManager::instance().D3D12->GetDescriptorArena();
+    ID3D12DescriptorHeap* heaps[] = { descriptorArena->GetShaderVisibleHeap() };
+    cmdList->SetDescriptorHeaps((UINT)std::size(heaps), heaps);
+    cmdList->SetGraphicsRootDescriptorTable(0, descriptorArena->AllocateTable(m_attachmentViews));
+
+    cmdList->OMSetRenderTargets(1, &m_targetView.handle, true, &m_depthTargetView.handle);
+    const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    cmdList->ClearRenderTargetView(m_targetView.handle, clearColor, 0, nullptr);
+    cmdList->ClearDepthStencilView(m_depthTargetView.handle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+
+    cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    cmdList->DrawInstanced(Reprojection::GetVertexCount(settings), 1, 0, 0);
+}
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "openxr.h"
+#include "shader_cache.h"
+#include "descriptor_arena.h"
+#include "present_graph.h"
+#include "reprojection.h"
 
 class RND_D3D12 {
     friend class RND_Renderer;
@@ -12,25 +16,33 @@ public:
     ID3D12Device* GetDevice() { return m_device.Get(); };
 
     ID3D12CommandQueue* GetCommandQueue() { return m_queue.Get(); };
-
-    void StartFrame() {
-        checkHResult(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_allocator)), "Failed to created D3D12_CommandContext's allocator!");
-    }
-    void EndFrame() {
-        // Wait for GPU to finish queue
-        checkHResult(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)), "Failed to create fence for end-of-frame waiting!");
-        checkHResult(m_queue->Signal(m_fence.Get(), 1), "Failed to signal fence for end-of-frame waiting!");
-
-        HANDLE waitEvent = CreateEventA(nullptr, FALSE, FALSE, nullptr);
-        checkAssert(waitEvent != NULL, "Failed to create upload event!");
-        checkHResult(m_fence->SetEventOnCompletion(1, waitEvent), "Failed to set event completion for end-of-frame waiting!");
-        WaitForSingleObject(waitEvent, INFINITE);
-
-        // Reset allocator after queue is finished
-        m_allocator->Reset();
-    };
-
-    ID3D12CommandAllocator* GetFrameAllocator() { return m_allocator.Get(); };
+    // the eyes are composed on a second queue, so the queue that OpenXR submits its own work to is never stuck behind them
+    ID3D12CommandQueue* GetPresentQueue() { return m_presentQueue.Get(); };
+    ID3D12CommandQueue* GetLaneQueue(PresentGraph::Lane lane);
+
+    ShaderCache* GetShaderCache() { return m_shaderCache.get(); };
+    DescriptorArena* GetDescriptorArena() { return m_descriptorArena.get(); };
+    PresentGraph& GetPresentGraph() { return m_presentGraph; };
+
+    // a frame's allocator is only reused once the gpu has finished the work of the frame that used it last
+    static constexpr size_t FRAMES_IN_FLIGHT = 2;
+    static_assert(DescriptorArena::FRAME_SEGMENTS == FRAMES_IN_FLIGHT, "Every frame in flight needs its own descriptor segment!");
+
+    void StartFrame();
+    void EndFrame();
+
+    // waits on the job's queue for the lanes that it depends on
+    void BeginJob(PresentGraph::JobId id);
+    // advances the job's lane once the work that was submitted to its queue since BeginJob has finished
+    void EndJob(PresentGraph::JobId id);
+    // reads how far the gpu lanes got into the present graph without waiting for them
+    void PollLanes();
+    // blocks until the gpu lanes have finished everything that was scheduled on them
+    void WaitForIdle();
+    // keeps the resource alive until the frames that might still read it have finished on the gpu
+    void Retire(ComPtr<ID3D12Resource> resource);
+
+    ID3D12CommandAllocator* GetFrameAllocator() { return m_frames[m_frameIdx].allocator.Get(); };
 
     // todo: extract most to a base pipeline class if other pipelines are needed
     template <bool depth>
@@ -57,16 +69,44 @@ public:
         D3D12_INDEX_BUFFER_VIEW m_screenIndicesView = {};
 
         ComPtr<ID3D12Resource> m_settingsBuffer;
+        // holds settings that haven't been copied into m_settingsBuffer yet
+        ComPtr<ID3D12Resource> m_settingsStaging;
 
         ComPtr<ID3D12RootSignature> m_signature;
         ComPtr<ID3D12PipelineState> m_pipelineState;
 
-        std::array<D3D12_CPU_DESCRIPTOR_HANDLE, depth ? 2 : 1> m_attachmentHandles = {};
-        std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 1> m_targetHandles = {};
-        std::array<D3D12_CPU_DESCRIPTOR_HANDLE, depth ? 1 : 0> m_depthTargetHandles = {};
-        ComPtr<ID3D12DescriptorHeap> m_attachmentHeap;
-        ComPtr<ID3D12DescriptorHeap> m_targetHeap;
-        ComPtr<ID3D12DescriptorHeap> m_depthHeap;
+        // the views live in the shared descriptor arena, the attachments are copied into a table in Render
+        std::array<DescriptorArena::View, depth ? 2 : 1> m_attachmentViews = {};
+        std::array<DescriptorArena::View, 1> m_targetViews = {};
+        std::array<DescriptorArena::View, depth ? 1 : 0> m_depthTargetViews = {};
+        std::array<DXGI_FORMAT, 2> m_targetFormats = { DXGI_FORMAT_UNKNOWN, DXGI_FORMAT_D32_FLOAT };
+    };
+
+    // draws the last captured color and depth of an eye warped to another pose as a grid of triangles, see Reprojection
+    class ReprojectPipeline {
+    public:
+        ReprojectPipeline();
+        ~ReprojectPipeline() = default;
+
+        void BindAttachment(uint32_t attachmentIdx, ID3D12Resource* srcTexture, DXGI_FORMAT overwriteFormat = DXGI_FORMAT_UNKNOWN);
+        void BindTarget(ID3D12Resource* dstTexture, DXGI_FORMAT overwriteFormat = DXGI_FORMAT_UNKNOWN);
+        void BindDepthTarget(ID3D12Resource* dstTexture, DXGI_FORMAT overwriteFormat);
+        // the settings are passed as root constants since they change every frame, the parts of the viewport that the warped grid
+        // doesn't cover are left black and at the far plane
+        void Render(ID3D12GraphicsCommandList* commandList, ID3D12Resource* swapchain, const Reprojection::Settings& settings);
+
+    private:
+        void RecreatePipeline();
+
+        ComPtr<ID3DBlob> m_vertexShader;
+        ComPtr<ID3DBlob> m_pixelShader;
+
+        ComPtr<ID3D12RootSignature> m_signature;
+        ComPtr<ID3D12PipelineState> m_pipelineState;
+
+        std::array<DescriptorArena::View, 2> m_attachmentViews = {};
+        DescriptorArena::View m_targetView = {};
+        DescriptorArena::View m_depthTargetView = {};
         std::array<DXGI_FORMAT, 2> m_targetFormats = { DXGI_FORMAT_UNKNOWN, DXGI_FORMAT_D32_FLOAT };
     };
 
@@ -87,10 +127,10 @@ public:
             ID3D12CommandList* collectedList[] = { this->m_cmdList.Get() };
 
             for (auto& [texture, value] : this->m_waitFor)
-                texture->d3d12WaitForFence(value);
+                texture->d3d12WaitForFence(m_queue, value);
             m_queue->ExecuteCommandLists((UINT)std::size(collectedList), collectedList);
             for (auto& [texture, value] : this->m_signalTo)
-                texture->d3d12SignalFence(value);
+                texture->d3d12SignalFence(m_queue, value);
 
             // If enabled, wait until the command list and the fence signal has been executed
             if constexpr (blockTillExecuted) {
@@ -123,8 +163,25 @@ public:
     };
 
 private:
+    struct FrameResources {
+        ComPtr<ID3D12CommandAllocator> allocator;
+        PresentGraph::Timeline scheduled = {}; // what the lanes had been scheduled up to when the frame ended
+        std::vector<ComPtr<ID3D12Resource>> retired;
+    };
+
+    // returns whether it had to block
+    bool WaitForLane(PresentGraph::Lane lane, uint64_t value);
+
     ComPtr<ID3D12Device> m_device;
     ComPtr<ID3D12CommandQueue> m_queue;
-    ComPtr<ID3D12CommandAllocator> m_allocator;
-    ComPtr<ID3D12Fence> m_fence;
+    ComPtr<ID3D12CommandQueue> m_presentQueue;
+    std::array<ComPtr<ID3D12Fence>, PresentGraph::LANE_COUNT> m_laneFences;
+    HANDLE m_laneWaitEvent = NULL;
+    std::array<FrameResources, FRAMES_IN_FLIGHT> m_frames;
+    size_t m_frameIdx = 0;
+    PresentGraph m_presentGraph;
+    uint32_t m_frameCount = 0;
+    uint32_t m_stalledFrames = 0;
+    std::unique_ptr<ShaderCache> m_shaderCache;
+    std::unique_ptr<DescriptorArena> m_descriptorArena;
 };
\ No newline at end of file
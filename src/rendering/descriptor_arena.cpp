@@ -0,0 +1,61 @@
+#include "descriptor_arena.h"
+
+DescriptorArena::View DescriptorArena::GetView(ViewType type, ID3D12Resource* resource, DXGI_FORMAT format) {
+    std::lock_guard lock(m_mutex);
+    const ViewKey key = { resource, format, type };
+    if (auto it = m_views.find(key); it != m_views.end()) {
+        m_stats.viewsReused++;
+        return { m_backend->GetViewHandle(type, it->second), type, it->second };
+    }
+
+    // overwriting a slot would change the views that recorded command lists or earlier tables still point at, so a full heap is a bug
+    uint32_t& nextSlot = m_nextViewSlot[(size_t)type];
+    checkAssert(nextSlot < VIEW_CAPACITY[(size_t)type], std::format("Ran out of descriptor views of type {}!", (uint32_t)type).c_str());
+
+    const uint32_t slot = nextSlot++;
+    m_backend->CreateView(type, resource, format, slot);
+    m_views.emplace(key, slot);
+    m_stats.viewsCreated++;
+    return { m_backend->GetViewHandle(type, slot), type, slot };
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DescriptorArena::AllocateTable(std::span<const View> srvs) {
+    std::lock_guard lock(m_mutex);
+    const uint32_t count = (uint32_t)srvs.size();
+    // the other segments can still be read by frames that the gpu hasn't finished, so a table never spills into them
+    checkAssert(m_segmentUsed + count <= SEGMENT_CAPACITY, "Ran out of shader-visible descriptors for this frame!");
+
+    const uint32_t first = m_segmentStart + m_segmentUsed;
+    for (uint32_t i = 0; i < count; i++) {
+        checkAssert(srvs[i].type == ViewType::SRV, "Only shader resource views can be put into a descriptor table!");
+        m_backend->CopyToTransient(srvs[i].slot, first + i);
+    }
+    m_segmentUsed += count;
+    m_stats.transientDescriptors += count;
+    return m_backend->GetTransientHandle(first);
+}
+
+void DescriptorArena::BeginFrame(uint32_t frameSlot) {
+    std::lock_guard lock(m_mutex);
+    checkAssert(frameSlot < FRAME_SEGMENTS, "Frame slot doesn't have a descriptor segment!");
+    m_segmentStart = frameSlot * SEGMENT_CAPACITY;
+    m_segmentUsed = 0;
+    // the window is closed by the frame after it, so that the work of its last frame is counted
+    if (m_stats.frames == STATS_WINDOW) {
+        Log::print<INFO>("Descriptor arena: {:.2f} views created and {:.2f} reused per frame, {:.2f} transient descriptors per frame", (double)m_stats.viewsCreated / STATS_WINDOW, (double)m_stats.viewsReused / STATS_WINDOW, (double)m_stats.transientDescriptors / STATS_WINDOW);
+        m_lastStats = m_stats;
+        m_stats = {};
+    }
+    m_stats.frames++;
+}
+
+void DescriptorArena::ReleaseViews() {
+    std::lock_guard lock(m_mutex);
+    m_views.clear();
+    m_nextViewSlot = {};
+}
+
+DescriptorArena::Stats DescriptorArena::GetStats() const {
+    std::lock_guard lock(m_mutex);
+    return m_lastStats;
+}
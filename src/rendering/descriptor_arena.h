@@ -0,0 +1,90 @@
+#pragma once
+
+// shared descriptor storage for the present pipelines.
+// views are created once per resource and format in persistent cpu-only heaps, and the shader-visible tables are
+// copied out of them into the segment of the frame that's being recorded, so rebinding the same texture doesn't call Create*View again.
+class DescriptorArena {
+public:
+    enum class ViewType : uint8_t {
+        SRV,
+        RTV,
+        DSV,
+        COUNT
+    };
+
+    static constexpr std::array<uint32_t, (size_t)ViewType::COUNT> VIEW_CAPACITY = { 64, 32, 32 };
+    static constexpr uint32_t TRANSIENT_CAPACITY = 256;
+    // one segment of the shader-visible heap per frame in flight, like the frame allocators
+    static constexpr uint32_t FRAME_SEGMENTS = 2;
+    static constexpr uint32_t SEGMENT_CAPACITY = TRANSIENT_CAPACITY / FRAME_SEGMENTS;
+
+    // everything that touches the device goes through this, so the allocation and caching can be driven with a fake one
+    class Backend {
+    public:
+        virtual ~Backend() = default;
+        virtual void CreateView(ViewType type, ID3D12Resource* resource, DXGI_FORMAT format, uint32_t slot) = 0;
+        virtual void CopyToTransient(uint32_t srvSlot, uint32_t transientSlot) = 0;
+        virtual D3D12_CPU_DESCRIPTOR_HANDLE GetViewHandle(ViewType type, uint32_t slot) const = 0;
+        virtual D3D12_GPU_DESCRIPTOR_HANDLE GetTransientHandle(uint32_t transientSlot) const = 0;
+        virtual ID3D12DescriptorHeap* GetTransientHeap() const = 0;
+    };
+    static std::unique_ptr<Backend> CreateD3D12Backend(ID3D12Device* device);
+
+    struct View {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle;
+        ViewType type;
+        uint32_t slot;
+    };
+
+    struct Stats {
+        uint64_t viewsCreated;
+        uint64_t viewsReused;
+        uint64_t transientDescriptors;
+        uint64_t frames;
+    };
+    static constexpr uint32_t STATS_WINDOW = 500;
+
+    explicit DescriptorArena(std::unique_ptr<Backend> backend): m_backend(std::move(backend)) {}
+
+    // the view stays valid until ReleaseViews is called, running out of views of a type is an error since they can't be recycled safely
+    View GetView(ViewType type, ID3D12Resource* resource, DXGI_FORMAT format);
+
+    // copies the given shader resource views next to each other into this frame's segment and returns the table's start
+    D3D12_GPU_DESCRIPTOR_HANDLE AllocateTable(std::span<const View> srvs);
+    ID3D12DescriptorHeap* GetShaderVisibleHeap() const { return m_backend->GetTransientHeap(); }
+
+    // starts filling the segment of the given frame slot from the beginning. the caller has to have waited for the fences of the
+    // frame that used the slot last, which RND_D3D12::StartFrame does before it resets the slot's allocator.
+    void BeginFrame(uint32_t frameSlot);
+    // has to be called before resources that might have views in the cache are released, since their address could be reused
+    void ReleaseViews();
+
+    // the counts of the last full window of STATS_WINDOW frames
+    Stats GetStats() const;
+
+private:
+    struct ViewKey {
+        ID3D12Resource* resource;
+        DXGI_FORMAT format;
+        ViewType type;
+
+        bool operator==(const ViewKey& other) const = default;
+    };
+    struct ViewKeyHash {
+        size_t operator()(const ViewKey& key) const {
+            return std::hash<const void*>()(key.resource) ^ ((size_t)key.format << 8) ^ (size_t)key.type;
+        }
+    };
+
+    std::unique_ptr<Backend> m_backend;
+    mutable std::mutex m_mutex;
+
+    std::unordered_map<ViewKey, uint32_t, ViewKeyHash> m_views;
+    std::array<uint32_t, (size_t)ViewType::COUNT> m_nextViewSlot = {};
+
+    uint32_t m_segmentStart = 0;
+    uint32_t m_segmentUsed = 0;
+
+    Stats m_stats = {};
+    Stats m_lastStats = {};
+};
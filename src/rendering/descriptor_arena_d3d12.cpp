@@ -0,0 +1,82 @@
+#include "descriptor_arena.h"
+#include "utils/d3d12_utils.h"
+
+class D3D12DescriptorBackend : public DescriptorArena::Backend {
+public:
+    explicit D3D12DescriptorBackend(ID3D12Device* device): m_device(device) {
+        constexpr std::array<D3D12_DESCRIPTOR_HEAP_TYPE, (size_t)DescriptorArena::ViewType::COUNT> heapTypes = { D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, D3D12_DESCRIPTOR_HEAP_TYPE_DSV };
+        for (size_t i = 0; i < heapTypes.size(); i++) {
+            m_viewHeaps[i] = D3D12Utils::CreateDescriptorHeap(device, heapTypes[i], false, DescriptorArena::VIEW_CAPACITY[i]);
+            m_viewHeapStarts[i] = m_viewHeaps[i]->GetCPUDescriptorHandleForHeapStart();
+            m_viewIncrements[i] = device->GetDescriptorHandleIncrementSize(heapTypes[i]);
+        }
+        m_transientHeap = D3D12Utils::CreateDescriptorHeap(device, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, true, DescriptorArena::TRANSIENT_CAPACITY);
+        m_transientCPUStart = m_transientHeap->GetCPUDescriptorHandleForHeapStart();
+        m_transientGPUStart = m_transientHeap->GetGPUDescriptorHandleForHeapStart();
+    }
+
+    void CreateView(DescriptorArena::ViewType type, ID3D12Resource* resource, DXGI_FORMAT format, uint32_t slot) override {
+        const D3D12_CPU_DESCRIPTOR_HANDLE handle = GetViewHandle(type, slot);
+        switch (type) {
+            case DescriptorArena::ViewType::SRV: {
+                D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+                srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+                srvDesc.Format = format;
+                srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+                srvDesc.Texture2D.MipLevels = 1;
+                m_device->CreateShaderResourceView(resource, &srvDesc, handle);
+                break;
+            }
+            case DescriptorArena::ViewType::RTV: {
+                D3D12_RENDER_TARGET_VIEW_DESC rtvDesc = {};
+                rtvDesc.Format = format;
+                rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
+                m_device->CreateRenderTargetView(resource, &rtvDesc, handle);
+                break;
+            }
+            case DescriptorArena::ViewType::DSV: {
+                D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
+                dsvDesc.Format = format;
+                dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+                dsvDesc.Flags = D3D12_DSV_FLAG_NONE;
+                m_device->CreateDepthStencilView(resource, &dsvDesc, handle);
+                break;
+            }
+            default:
+                checkAssert(false, "Unknown descriptor view type!");
+        }
+    }
+
+    void CopyToTransient(uint32_t srvSlot, uint32_t transientSlot) override {
+        D3D12_CPU_DESCRIPTOR_HANDLE dst = m_transientCPUStart;
+        dst.ptr += (SIZE_T)transientSlot * m_viewIncrements[(size_t)DescriptorArena::ViewType::SRV];
+        m_device->CopyDescriptorsSimple(1, dst, GetViewHandle(DescriptorArena::ViewType::SRV, srvSlot), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    }
+
+    D3D12_CPU_DESCRIPTOR_HANDLE GetViewHandle(DescriptorArena::ViewType type, uint32_t slot) const override {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle = m_viewHeapStarts[(size_t)type];
+        handle.ptr += (SIZE_T)slot * m_viewIncrements[(size_t)type];
+        return handle;
+    }
+
+    D3D12_GPU_DESCRIPTOR_HANDLE GetTransientHandle(uint32_t transientSlot) const override {
+        D3D12_GPU_DESCRIPTOR_HANDLE handle = m_transientGPUStart;
+        handle.ptr += (UINT64)transientSlot * m_viewIncrements[(size_t)DescriptorArena::ViewType::SRV];
+        return handle;
+    }
+
+    ID3D12DescriptorHeap* GetTransientHeap() const override { return m_transientHeap.Get(); }
+
+private:
+    ID3D12Device* m_device;
+    std::array<ComPtr<ID3D12DescriptorHeap>, (size_t)DescriptorArena::ViewType::COUNT> m_viewHeaps;
+    std::array<D3D12_CPU_DESCRIPTOR_HANDLE, (size_t)DescriptorArena::ViewType::COUNT> m_viewHeapStarts = {};
+    std::array<UINT, (size_t)DescriptorArena::ViewType::COUNT> m_viewIncrements = {};
+    ComPtr<ID3D12DescriptorHeap> m_transientHeap;
+    D3D12_CPU_DESCRIPTOR_HANDLE m_transientCPUStart = {};
+    D3D12_GPU_DESCRIPTOR_HANDLE m_transientGPUStart = {};
+};
+
+std::unique_ptr<DescriptorArena::Backend> DescriptorArena::CreateD3D12Backend(ID3D12Device* device) {
+    return std::make_unique<D3D12DescriptorBackend>(device);
+}
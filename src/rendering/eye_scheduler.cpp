@@ -0,0 +1,85 @@
+#include "eye_scheduler.h"
+
+float EyeScheduler::GetPoseDelta(const Pose& from, const Pose& to) {
+    // q and -q are the same rotation, so the shorter way between them is taken
+    const float cosHalfAngle = std::min(std::abs(glm::dot(from.orientation, to.orientation)), 1.0f);
+    return 2.0f * std::acos(cosHalfAngle) + glm::distance(from.position, to.position) * POSITION_WEIGHT;
+}
+
+uint64_t EyeScheduler::GetLastRenderedFrame(uint8_t eyeIdx) const {
+    uint64_t lastFrame = m_eyes[eyeIdx].hasCapture ? m_eyes[eyeIdx].capturedFrame : 0;
+    for (const FrameSlot& slot : m_slots) {
+        if ((slot.eyes & ~slot.capturedEyes & ToMask(eyeIdx)) != 0) {
+            lastFrame = std::max(lastFrame, slot.frame);
+        }
+    }
+    return lastFrame;
+}
+
+uint32_t EyeScheduler::GetStaleFrames(uint8_t eyeIdx) const {
+    return (uint32_t)(m_frame - GetLastRenderedFrame(eyeIdx));
+}
+
+EyeScheduler::Plan EyeScheduler::Schedule(uint32_t frameIdx, bool allowSingleEye, const std::array<Pose, 2>& currentPoses) {
+    FrameSlot& slot = m_slots[frameIdx % FRAME_SLOTS];
+    // the slot gets reused, so any eye of it that Cemu didn't copy by now isn't coming anymore
+    if ((slot.eyes & ~slot.capturedEyes) != 0) {
+        m_stats.missedCaptures++;
+    }
+    slot = {};
+
+    // an eye can only be left out if its capture is recent enough to be reprojected, even with the frames in flight
+    bool canSkipEye = allowSingleEye;
+    for (uint8_t i = 0; i < 2; i++) {
+        canSkipEye &= m_eyes[i].hasCapture && m_frame - m_eyes[i].capturedFrame <= MAX_STALE_FRAMES + FRAME_SLOTS;
+    }
+
+    Plan plan;
+    if (!canSkipEye) {
+        m_stats.bothEyeFrames++;
+    }
+    else {
+        // it's the turn of the eye that was left out the longest, or of the one that wasn't rendered last when they're even
+        const std::array<uint32_t, 2> staleFrames = { GetStaleFrames(0), GetStaleFrames(1) };
+        uint8_t eye = staleFrames[0] == staleFrames[1] ? (uint8_t)(m_lastSingleEye ^ 1) : (staleFrames[0] > staleFrames[1] ? 0 : 1);
+        const uint8_t other = eye ^ 1;
+
+        // the other eye goes first if its capture is further off, as long as that doesn't leave this one out for too long
+        if (staleFrames[eye] + 1 <= MAX_STALE_FRAMES) {
+            const float eyeDelta = GetPoseDelta(m_eyes[eye].capturedPose, currentPoses[eye]);
+            const float otherDelta = GetPoseDelta(m_eyes[other].capturedPose, currentPoses[other]);
+            if (otherDelta > eyeDelta + POSE_DELTA_MARGIN) {
+                eye = other;
+                m_stats.outOfTurnFrames++;
+            }
+        }
+
+        plan = { .eyes = ToMask(eye), .firstEye = eye };
+        m_lastSingleEye = eye;
+        m_stats.singleEyeFrames++;
+    }
+
+    m_frame++;
+    slot = { .frame = m_frame, .eyes = plan.eyes, .capturedEyes = NO_EYES, .poses = currentPoses };
+
+    if (m_frame % STATS_WINDOW == 0) {
+        m_lastStats = m_stats;
+        m_stats = {};
+    }
+    return plan;
+}
+
+void EyeScheduler::OnCaptured(uint8_t eyeIdx, uint32_t frameIdx) {
+    FrameSlot& slot = m_slots[frameIdx % FRAME_SLOTS];
+    const uint8_t mask = ToMask(eyeIdx);
+    // Cemu copies the same eye more than once per frame sometimes, and only eyes that were scheduled into the slot count
+    if ((slot.eyes & mask) == 0 || (slot.capturedEyes & mask) != 0) {
+        return;
+    }
+    slot.capturedEyes |= mask;
+
+    EyeState& eye = m_eyes[eyeIdx];
+    if (!eye.hasCapture || slot.frame > eye.capturedFrame) {
+        eye = { .capturedPose = slot.poses[eyeIdx], .capturedFrame = slot.frame, .hasCapture = true };
+    }
+}
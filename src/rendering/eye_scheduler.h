@@ -0,0 +1,87 @@
+#pragma once
+
+// decides which eyes Cemu renders for a frame when it's allowed to render just one of them, which roughly halves the emulated gpu work.
+// the eye that isn't rendered is reprojected from its last capture, so the eye whose capture is the furthest off from where it's looking
+// now is rendered first, but neither eye is left out for more than MAX_STALE_FRAMES frames in a row. frames are scheduled from the
+// PPC thread but only count once Cemu's copy of the eye arrives, which can be a frame later or never. the scheduling doesn't touch
+// OpenXR or the game, so that it can be checked on its own.
+class EyeScheduler {
+public:
+    enum EyeMask : uint8_t {
+        NO_EYES = 0,
+        LEFT_EYE = 1 << 0,
+        RIGHT_EYE = 1 << 1,
+        BOTH_EYES = LEFT_EYE | RIGHT_EYE
+    };
+
+    struct Pose {
+        glm::fvec3 position = glm::fvec3(0.0f);
+        glm::fquat orientation = glm::identity<glm::fquat>();
+    };
+
+    struct Plan {
+        uint8_t eyes = BOTH_EYES;
+        // the eye that the game's first pass renders, the second pass always renders the right eye and is skipped for a single eye
+        uint8_t firstEye = 0;
+
+        bool IsSingleEye() const { return eyes != BOTH_EYES; }
+    };
+
+    // of the last STATS_WINDOW frames
+    struct Stats {
+        uint32_t bothEyeFrames = 0;
+        uint32_t singleEyeFrames = 0;
+        uint32_t outOfTurnFrames = 0;
+        uint32_t missedCaptures = 0;
+    };
+
+    // same as the game's currentFrameCounter, which alternates between two slots
+    static constexpr uint32_t FRAME_SLOTS = 2;
+    // an eye is reprojected from a capture that's at most this many frames old
+    static constexpr uint32_t MAX_STALE_FRAMES = 2;
+    // how much further an eye has to have moved than the one whose turn it is before it's rendered out of turn, in radians
+    static constexpr float POSE_DELTA_MARGIN = 0.01f;
+    // a meter of movement counts as much as the rotation it causes for something half a meter away
+    static constexpr float POSITION_WEIGHT = 2.0f;
+    static constexpr uint32_t STATS_WINDOW = 500;
+
+    static constexpr uint8_t ToMask(uint8_t eyeIdx) { return eyeIdx == 0 ? LEFT_EYE : RIGHT_EYE; }
+    // the rotation between both poses in radians plus their weighted distance
+    static float GetPoseDelta(const Pose& from, const Pose& to);
+
+    // schedules the next frame into a slot, allowSingleEye is whether the scene and the present path can reproject an eye at all
+    Plan Schedule(uint32_t frameIdx, bool allowSingleEye, const std::array<Pose, 2>& currentPoses);
+    // Cemu's copy of an eye that was scheduled into the slot arrived
+    void OnCaptured(uint8_t eyeIdx, uint32_t frameIdx);
+
+    // how many frames in a row the eye has been left out, counting the frames that are scheduled but not captured yet as rendered
+    uint32_t GetStaleFrames(uint8_t eyeIdx) const;
+    bool HasCapture(uint8_t eyeIdx) const { return m_eyes[eyeIdx].hasCapture; }
+    const Pose& GetCapturedPose(uint8_t eyeIdx) const { return m_eyes[eyeIdx].capturedPose; }
+    const Stats& GetStats() const { return m_lastStats; }
+
+private:
+    struct EyeState {
+        Pose capturedPose = {}; // where the eye was for the frame of its last capture
+        uint64_t capturedFrame = 0;
+        bool hasCapture = false;
+    };
+
+    struct FrameSlot {
+        uint64_t frame = 0;
+        uint8_t eyes = NO_EYES;
+        uint8_t capturedEyes = NO_EYES;
+        std::array<Pose, 2> poses = {};
+    };
+
+    // the last frame that the eye was rendered in, or is still being rendered in
+    uint64_t GetLastRenderedFrame(uint8_t eyeIdx) const;
+
+    std::array<EyeState, 2> m_eyes = {};
+    std::array<FrameSlot, FRAME_SLOTS> m_slots = {};
+    uint64_t m_frame = 0;
+    uint8_t m_lastSingleEye = 1;
+
+    Stats m_stats = {};
+    Stats m_lastStats = {};
+};
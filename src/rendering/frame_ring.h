@@ -0,0 +1,241 @@
+#pragma once
+
+// lifecycle of a capture slot, the vulkan clear hooks move it forward by capturing, EndFrame by submitting and presenting it and
+// the present queue by finishing its reads of the slot's shared textures
+enum class FrameSlotState : uint8_t {
+    ACQUIRED,       // free and accepting captures
+    CAPTURED_LEFT,  // left eye color and depth have been copied
+    CAPTURED_RIGHT, // both eyes have been copied, the 3D layer is complete
+    SUBMITTED,      // EndFrame is compositing the slot, captures are rejected
+    PRESENTED,      // the present queue is reading the shared textures, released once it's done
+    COUNT
+};
+
+inline const char* FrameSlotStateName(FrameSlotState state) {
+    switch (state) {
+        case FrameSlotState::ACQUIRED: return "acquired";
+        case FrameSlotState::CAPTURED_LEFT: return "captured-left";
+        case FrameSlotState::CAPTURED_RIGHT: return "captured-right";
+        case FrameSlotState::SUBMITTED: return "submitted";
+        case FrameSlotState::PRESENTED: return "presented";
+        default: return "unknown";
+    }
+}
+
+enum FrameCapture : uint8_t {
+    CAPTURE_COLOR_LEFT = 1 << 0,
+    CAPTURE_DEPTH_LEFT = 1 << 1,
+    CAPTURE_COLOR_RIGHT = 1 << 2,
+    CAPTURE_DEPTH_RIGHT = 1 << 3,
+    CAPTURE_HUD = 1 << 4,
+};
+
+constexpr FrameCapture ColorCapture(int side) { return side == 0 ? CAPTURE_COLOR_LEFT : CAPTURE_COLOR_RIGHT; }
+constexpr FrameCapture DepthCapture(int side) { return side == 0 ? CAPTURE_DEPTH_LEFT : CAPTURE_DEPTH_RIGHT; }
+
+// fixed ring of capture slots whose state is a single packed atomic per slot, so producers and the consumer never take a lock.
+// while the present queue still reads one slot, Cemu captures its next frame into another one.
+template <size_t Depth>
+class FrameRing {
+public:
+    static constexpr size_t DEPTH = Depth;
+    static_assert(DEPTH >= 2 && DEPTH <= 32, "ReleaseCompleted returns the released slots as a 32-bit mask");
+    // a slot that hasn't progressed for this many EndFrame calls is considered stalled
+    static constexpr uint32_t STALL_FRAME_THRESHOLD = 30;
+
+    struct Stats {
+        uint64_t submitted;
+        uint64_t starvedFrames;
+        uint64_t rejectedCaptures;
+        uint64_t illegalTransitions;
+        uint64_t stalls;
+    };
+
+    FrameSlotState GetState(long slot) const { return UnpackState(m_slots[slot].load(std::memory_order_acquire)); }
+    uint32_t GetGeneration(long slot) const { return UnpackGeneration(m_slots[slot].load(std::memory_order_acquire)); }
+    bool HasCaptured(long slot, FrameCapture capture) const { return (UnpackCaptures(m_slots[slot].load(std::memory_order_acquire)) & capture) != 0; }
+    bool Is3DComplete(long slot) const { return (UnpackCaptures(m_slots[slot].load(std::memory_order_acquire)) & CAPTURES_3D) == CAPTURES_3D; }
+    bool Is2DComplete(long slot) const { return HasCaptured(slot, CAPTURE_HUD); }
+    bool CanCapture(long slot, FrameCapture capture) const {
+        uint32_t packed = m_slots[slot].load(std::memory_order_acquire);
+        return AcceptsCaptures(UnpackState(packed)) && (UnpackCaptures(packed) & capture) == 0;
+    }
+
+    // returns false if the capture was already made for this slot or if the slot is currently being presented
+    bool MarkCaptured(long slot, FrameCapture capture) {
+        uint32_t packed = m_slots[slot].load(std::memory_order_acquire);
+        while (true) {
+            FrameSlotState state = UnpackState(packed);
+            uint8_t captures = UnpackCaptures(packed);
+            if (!AcceptsCaptures(state) || (captures & capture) != 0) {
+                m_rejectedCaptures.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            captures |= capture;
+            FrameSlotState newState = StateFromCaptures(captures);
+            if (m_slots[slot].compare_exchange_weak(packed, Pack(newState, captures, UnpackGeneration(packed)), std::memory_order_acq_rel, std::memory_order_acquire)) {
+                m_lastProgress[slot].store(m_endFrameCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    // picks the oldest slot that can be presented, preferring slots that have both the 3D and 2D layers, or -1 if there's none
+    long FindReadySlot() const {
+        long hudOnlySlot = -1;
+        for (size_t i = 1; i <= DEPTH; i++) {
+            long slot = (long)((m_lastPresentedSlot.load(std::memory_order_relaxed) + i) % DEPTH);
+            uint32_t packed = m_slots[slot].load(std::memory_order_acquire);
+            if (!AcceptsCaptures(UnpackState(packed)) || (UnpackCaptures(packed) & CAPTURE_HUD) == 0) {
+                continue;
+            }
+            if ((UnpackCaptures(packed) & CAPTURES_3D) == CAPTURES_3D) {
+                return slot;
+            }
+            if (hudOnlySlot == -1) {
+                hudOnlySlot = slot;
+            }
+        }
+        return hudOnlySlot;
+    }
+
+    // whether another slot already holds both eyes of a frame that hasn't been submitted yet, so the next EndFrame has a new frame
+    bool Has3DCaptureBesides(long slot) const {
+        for (size_t i = 0; i < DEPTH; i++) {
+            uint32_t packed = m_slots[i].load(std::memory_order_acquire);
+            if ((long)i != slot && AcceptsCaptures(UnpackState(packed)) && (UnpackCaptures(packed) & CAPTURES_3D) == CAPTURES_3D) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Submit(long slot) {
+        if (!Transition(slot, ACCEPTING_STATES, FrameSlotState::SUBMITTED, true)) {
+            return false;
+        }
+        m_submitted.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // readsDoneValue is the present lane's timeline value once it no longer reads the slot's shared textures
+    bool Present(long slot, uint64_t readsDoneValue) {
+        if (!Transition(slot, StateBit(FrameSlotState::SUBMITTED), FrameSlotState::PRESENTED, true)) {
+            return false;
+        }
+        m_readsDoneValues[slot] = readsDoneValue;
+        m_lastPresentedSlot.store((size_t)slot, std::memory_order_relaxed);
+        return true;
+    }
+
+    // clears the captures of the presented slots that the present lane is done with and hands them back to the producers.
+    // returns a mask of the released slots.
+    uint32_t ReleaseCompleted(uint64_t completedValue) {
+        uint32_t releasedSlots = 0;
+        for (size_t i = 0; i < DEPTH; i++) {
+            if (GetState((long)i) == FrameSlotState::PRESENTED && m_readsDoneValues[i] <= completedValue && Release((long)i)) {
+                releasedSlots |= 1u << i;
+            }
+        }
+        return releasedSlots;
+    }
+
+    // called once per EndFrame to detect slots that stopped progressing
+    void OnEndFrame(bool presentedSlot) {
+        uint32_t frame = m_endFrameCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (!presentedSlot) {
+            m_starvedFrames.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < DEPTH; i++) {
+            uint32_t packed = m_slots[i].load(std::memory_order_acquire);
+            bool idle = UnpackState(packed) == FrameSlotState::ACQUIRED && UnpackCaptures(packed) == 0;
+            if (idle || frame - m_lastProgress[i].load(std::memory_order_relaxed) < STALL_FRAME_THRESHOLD) {
+                m_stallReported[i] = false;
+                continue;
+            }
+            if (!m_stallReported[i]) {
+                m_stallReported[i] = true;
+                m_stalls.fetch_add(1, std::memory_order_relaxed);
+                Log::print<WARNING>("Frame ring slot {} is stalled in state {} with captures 0x{:02X} for {} frames", i, FrameSlotStateName(UnpackState(packed)), UnpackCaptures(packed), frame - m_lastProgress[i].load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    Stats GetStats() const {
+        return {
+            .submitted = m_submitted.load(),
+            .starvedFrames = m_starvedFrames.load(),
+            .rejectedCaptures = m_rejectedCaptures.load(),
+            .illegalTransitions = m_illegalTransitions.load(),
+            .stalls = m_stalls.load()
+        };
+    }
+
+    void LogStats() const {
+        Stats stats = GetStats();
+        Log::print<INFO>("Frame ring ({} slots): {} submitted, {} starved frames, {} rejected captures, {} illegal transitions, {} stalls", DEPTH, stats.submitted, stats.starvedFrames, stats.rejectedCaptures, stats.illegalTransitions, stats.stalls);
+    }
+
+private:
+    // packed as (generation << 16 | state << 8 | captures), the generation is bumped on every release
+    static constexpr uint8_t CAPTURES_LEFT = CAPTURE_COLOR_LEFT | CAPTURE_DEPTH_LEFT;
+    static constexpr uint8_t CAPTURES_3D = CAPTURE_COLOR_LEFT | CAPTURE_DEPTH_LEFT | CAPTURE_COLOR_RIGHT | CAPTURE_DEPTH_RIGHT;
+
+    static constexpr uint32_t Pack(FrameSlotState state, uint8_t captures, uint32_t generation) { return (generation << 16) | ((uint32_t)state << 8) | captures; }
+    static constexpr FrameSlotState UnpackState(uint32_t packed) { return (FrameSlotState)((packed >> 8) & 0xFF); }
+    static constexpr uint8_t UnpackCaptures(uint32_t packed) { return (uint8_t)(packed & 0xFF); }
+    static constexpr uint32_t UnpackGeneration(uint32_t packed) { return packed >> 16; }
+
+    static constexpr uint32_t StateBit(FrameSlotState state) { return 1u << (uint32_t)state; }
+    static constexpr uint32_t ACCEPTING_STATES = (1u << (uint32_t)FrameSlotState::ACQUIRED) | (1u << (uint32_t)FrameSlotState::CAPTURED_LEFT) | (1u << (uint32_t)FrameSlotState::CAPTURED_RIGHT);
+
+    static constexpr bool AcceptsCaptures(FrameSlotState state) { return (ACCEPTING_STATES & StateBit(state)) != 0; }
+
+    // the right eye is only considered captured once the left eye is too, since that's the order the game renders them in
+    static constexpr FrameSlotState StateFromCaptures(uint8_t captures) {
+        if ((captures & CAPTURES_3D) == CAPTURES_3D) return FrameSlotState::CAPTURED_RIGHT;
+        if ((captures & CAPTURES_LEFT) == CAPTURES_LEFT) return FrameSlotState::CAPTURED_LEFT;
+        return FrameSlotState::ACQUIRED;
+    }
+
+    bool Release(long slot) {
+        return Transition(slot, StateBit(FrameSlotState::PRESENTED), FrameSlotState::ACQUIRED, false);
+    }
+
+    bool Transition(long slot, uint32_t allowedFrom, FrameSlotState to, bool keepCaptures) {
+        uint32_t packed = m_slots[slot].load(std::memory_order_acquire);
+        while (true) {
+            FrameSlotState from = UnpackState(packed);
+            if ((allowedFrom & StateBit(from)) == 0) {
+                // only report the first few since a broken pipeline would otherwise flood the log every frame
+                if (m_illegalTransitions.fetch_add(1, std::memory_order_relaxed) < 16) {
+                    Log::print<WARNING>("Illegal frame ring transition for slot {}: {} -> {}", slot, FrameSlotStateName(from), FrameSlotStateName(to));
+                }
+                return false;
+            }
+
+            uint32_t generation = UnpackGeneration(packed);
+            uint32_t newPacked = keepCaptures ? Pack(to, UnpackCaptures(packed), generation) : Pack(to, 0, (generation + 1) & 0xFFFF);
+            if (m_slots[slot].compare_exchange_weak(packed, newPacked, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                m_lastProgress[slot].store(m_endFrameCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+
+    std::array<std::atomic_uint32_t, DEPTH> m_slots = {};
+    std::array<std::atomic_uint32_t, DEPTH> m_lastProgress = {};
+    std::array<bool, DEPTH> m_stallReported = {};
+    // only touched by EndFrame
+    std::array<uint64_t, DEPTH> m_readsDoneValues = {};
+    std::atomic_size_t m_lastPresentedSlot = DEPTH - 1;
+
+    std::atomic_uint32_t m_endFrameCount = 0;
+    std::atomic_uint64_t m_submitted = 0;
+    std::atomic_uint64_t m_starvedFrames = 0;
+    std::atomic_uint64_t m_rejectedCaptures = 0;
+    std::atomic_uint64_t m_illegalTransitions = 0;
+    std::atomic_uint64_t m_stalls = 0;
+};
@@ -0,0 +1,217 @@
+#include "handoff_tracker.h"
+
+const char* HandoffTracker::ApiName(Api api) {
+    switch (api) {
+        case Api::VULKAN: return "vulkan";
+        case Api::D3D12: return "d3d12";
+        default: return "unknown";
+    }
+}
+
+HandoffTracker::~HandoffTracker() {
+    StopWatchdog();
+}
+
+HandoffTracker::TimelineId HandoffTracker::AddTimeline(std::string name, std::function<uint64_t()> completedValue) {
+    std::scoped_lock lock(m_mutex);
+    const TimelineId id = m_nextTimelineId++;
+    m_timelines.emplace(id, Timeline{ .name = std::move(name), .completedValue = std::move(completedValue) });
+    return id;
+}
+
+void HandoffTracker::RemoveTimeline(TimelineId id) {
+    std::scoped_lock lock(m_mutex);
+    m_timelines.erase(id);
+    std::erase_if(m_pending, [id](const Event& event) { return event.timeline == id; });
+}
+
+HandoffTracker::Handoff HandoffTracker::Signal(TimelineId id, Api producer, Clock::time_point now) {
+    std::scoped_lock lock(m_mutex);
+    auto it = m_timelines.find(id);
+    checkAssert(it != m_timelines.end(), "Can't signal a timeline that isn't tracked!");
+    Timeline& timeline = it->second;
+
+    // an api can signal twice in a row if the other one skipped a frame, so skip a value to keep the parity
+    uint64_t value = timeline.lastValue + 1;
+    if (!HasParity(producer, value)) {
+        value++;
+    }
+    // the producer used the texture before it signals, which it may only do once it waited for the other api's last handoff
+    const uint64_t otherSignal = timeline.lastSignal[(size_t)Other(producer)];
+    if (timeline.lastWait[(size_t)producer] != otherSignal) {
+        Violation(std::format("{} signaled {} on {} without waiting for {} from {}", ApiName(producer), value, timeline.name, otherSignal, ApiName(Other(producer))));
+    }
+    timeline.lastValue = value;
+    timeline.lastSignal[(size_t)producer] = value;
+
+    Record({ .type = EventType::SIGNAL, .api = producer, .timeline = id, .value = value, .sequence = m_sequence[(size_t)producer]++, .issued = now });
+    return { producer, Other(producer), value };
+}
+
+uint64_t HandoffTracker::Wait(TimelineId id, Api consumer, Clock::time_point now) {
+    std::scoped_lock lock(m_mutex);
+    auto it = m_timelines.find(id);
+    checkAssert(it != m_timelines.end(), "Can't wait on a timeline that isn't tracked!");
+    Timeline& timeline = it->second;
+
+    const uint64_t value = timeline.lastSignal[(size_t)Other(consumer)];
+    if (value < timeline.lastWait[(size_t)consumer]) {
+        Violation(std::format("{} waits for {} on {} after it already waited for {}", ApiName(consumer), value, timeline.name, timeline.lastWait[(size_t)consumer]));
+    }
+    if (value != 0 && !HasParity(Other(consumer), value)) {
+        Violation(std::format("{} waits for {} on {}, which {} can't have signaled", ApiName(consumer), value, timeline.name, ApiName(Other(consumer))));
+    }
+    timeline.lastWait[(size_t)consumer] = value;
+
+    // the timeline starts at 0, so there's nothing to wait for before the first handoff
+    if (value != 0) {
+        Record({ .type = EventType::WAIT, .api = consumer, .timeline = id, .value = value, .sequence = m_sequence[(size_t)consumer]++, .issued = now });
+    }
+    return value;
+}
+
+std::optional<HandoffTracker::Api> HandoffTracker::GetLastProducer(TimelineId id) const {
+    std::scoped_lock lock(m_mutex);
+    auto it = m_timelines.find(id);
+    if (it == m_timelines.end() || it->second.lastValue == 0) {
+        return std::nullopt;
+    }
+    return HasParity(Api::VULKAN, it->second.lastValue) ? Api::VULKAN : Api::D3D12;
+}
+
+std::vector<HandoffTracker::Stall> HandoffTracker::Poll(Clock::time_point now, Clock::duration deadline) {
+    std::scoped_lock lock(m_mutex);
+    for (auto& timeline : m_timelines | std::views::values) {
+        if (timeline.faulted) {
+            continue;
+        }
+        const uint64_t completed = timeline.completedValue();
+        if (completed == UINT64_MAX) {
+            Violation(std::format("The fence of {} is in an error state, the device was probably removed", timeline.name));
+            timeline.faulted = true;
+        }
+        else if (completed < timeline.completed) {
+            Violation(std::format("{} went back from {} to {}", timeline.name, timeline.completed, completed));
+            timeline.faulted = true;
+        }
+        else if (completed > timeline.lastValue) {
+            Violation(std::format("{} reached {}, but only {} was signaled", timeline.name, completed, timeline.lastValue));
+            timeline.faulted = true;
+        }
+        else {
+            timeline.completed = completed;
+        }
+    }
+
+    std::erase_if(m_pending, [this](const Event& event) {
+        if (event.value > m_timelines.at(event.timeline).completed) {
+            return false;
+        }
+        if (event.type == EventType::SIGNAL) {
+            m_completedSequence[(size_t)event.api] = std::max(m_completedSequence[(size_t)event.api], event.sequence + 1);
+        }
+        return true;
+    });
+
+    std::vector<Stall> stalls;
+    for (const Event& event : m_pending) {
+        if (event.type == EventType::WAIT && now - event.issued >= deadline) {
+            stalls.push_back({ event, m_timelines.at(event.timeline).completed, IsDeadlocked(event) });
+        }
+    }
+    return stalls;
+}
+
+std::string HandoffTracker::DumpHistory() const {
+    std::scoped_lock lock(m_mutex);
+    const Clock::time_point now = Clock::now();
+
+    std::string dump = "Handoff timelines:\n";
+    for (const auto& [id, timeline] : m_timelines) {
+        dump += std::format("  [{}] {}: completed={}, last vulkan signal={}, last d3d12 signal={}, last vulkan wait={}, last d3d12 wait={}\n", id, timeline.name, timeline.completed, timeline.lastSignal[(size_t)Api::VULKAN], timeline.lastSignal[(size_t)Api::D3D12], timeline.lastWait[(size_t)Api::VULKAN], timeline.lastWait[(size_t)Api::D3D12]);
+    }
+
+    dump += std::format("Last {} handoff events, oldest first:\n", std::min(m_historyCount, HISTORY_SIZE));
+    const size_t first = m_historyCount > HISTORY_SIZE ? m_historyCount - HISTORY_SIZE : 0;
+    for (size_t i = first; i < m_historyCount; i++) {
+        const Event& event = m_history[i % HISTORY_SIZE];
+        auto timeline = m_timelines.find(event.timeline);
+        const double agoMs = std::chrono::duration<double, std::milli>(now - event.issued).count();
+        dump += std::format("  {:>9.1f}ms ago: {} #{} {} {} on [{}] {}\n", agoMs, ApiName(event.api), event.sequence, event.type == EventType::SIGNAL ? "signals" : "waits for", event.value, event.timeline, timeline != m_timelines.end() ? timeline->second.name : "(removed)");
+    }
+    return dump;
+}
+
+uint32_t HandoffTracker::GetViolations() const {
+    std::scoped_lock lock(m_mutex);
+    return m_violations;
+}
+
+void HandoffTracker::StartWatchdog(Clock::duration deadline, Clock::duration interval) {
+    checkAssert(!m_watchdogThread.joinable(), "The handoff watchdog is already running!");
+    m_stopWatchdog = false;
+    m_watchdogThread = std::thread(&HandoffTracker::WatchdogThread, this, deadline, interval);
+}
+
+void HandoffTracker::StopWatchdog() {
+    {
+        std::scoped_lock lock(m_mutex);
+        m_stopWatchdog = true;
+    }
+    m_watchdogCondition.notify_all();
+    if (m_watchdogThread.joinable()) {
+        m_watchdogThread.join();
+    }
+}
+
+void HandoffTracker::Record(const Event& event) {
+    m_history[m_historyCount++ % HISTORY_SIZE] = event;
+    m_pending.emplace_back(event);
+    if (m_pending.size() > MAX_PENDING_EVENTS) {
+        m_pending.pop_front();
+    }
+}
+
+void HandoffTracker::Violation(std::string message) {
+    m_violations++;
+    Log::print<ERROR>("Handoff violation: {}", message);
+}
+
+const HandoffTracker::Event* HandoffTracker::FindSignal(TimelineId id, uint64_t value) const {
+    auto it = std::ranges::find_if(m_pending, [id, value](const Event& event) { return event.type == EventType::SIGNAL && event.timeline == id && event.value == value; });
+    return it != m_pending.end() ? &*it : nullptr;
+}
+
+bool HandoffTracker::IsDeadlocked(const Event& wait) const {
+    // each api finishes its signals in the order that it issued them, so a signal that's still pending after a later one finished was never submitted
+    const Event* signal = FindSignal(wait.timeline, wait.value);
+    return signal != nullptr && signal->sequence < m_completedSequence[(size_t)signal->api];
+}
+
+void HandoffTracker::WatchdogThread(Clock::duration deadline, Clock::duration interval) {
+    // only the first report of every stalled wait is logged, the history wouldn't change while it's stuck anyway
+    std::unordered_map<TimelineId, uint64_t> reported;
+
+    std::unique_lock lock(m_mutex);
+    while (!m_watchdogCondition.wait_for(lock, interval, [this] { return m_stopWatchdog; })) {
+        lock.unlock();
+
+        bool newStall = false;
+        for (const Stall& stall : Poll(Clock::now(), deadline)) {
+            uint64_t& reportedValue = reported[stall.wait.timeline];
+            if (reportedValue == stall.wait.value) {
+                continue;
+            }
+            reportedValue = stall.wait.value;
+            newStall = true;
+
+            const double waitedMs = std::chrono::duration<double, std::milli>(Clock::now() - stall.wait.issued).count();
+            Log::print<ERROR>("Handoff watchdog: {} has been waiting for {} on timeline {} for {:.0f}ms, it only reached {}{}", ApiName(stall.wait.api), stall.wait.value, stall.wait.timeline, waitedMs, stall.completedValue, stall.deadlocked ? ", which is a deadlock" : "");
+        }
+        if (newStall) {
+            Log::print<ERROR>("{}", DumpHistory());
+        }
+
+        lock.lock();
+    }
+}
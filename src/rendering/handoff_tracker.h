@@ -0,0 +1,106 @@
+#pragma once
+
+// hands the shared textures back and forth between vulkan and D3D12.
+// every texture gets a timeline that both APIs signal and wait on, vulkan only ever signals odd values and D3D12 even ones, and an api
+// always waits for the last value that the other one signaled. the signals and waits are kept in a history, and the watchdog dumps it
+// once a wait is outstanding for too long, since a missed signal otherwise only shows up as a hang in xrWaitSwapchainImage or a fence wait.
+class HandoffTracker {
+public:
+    enum class Api : uint8_t {
+        VULKAN,
+        D3D12,
+        COUNT
+    };
+
+    using Clock = std::chrono::steady_clock;
+    using TimelineId = uint32_t;
+
+    struct Handoff {
+        Api producer;
+        Api consumer;
+        uint64_t value;
+    };
+
+    enum class EventType : uint8_t {
+        SIGNAL,
+        WAIT
+    };
+
+    struct Event {
+        EventType type;
+        Api api;
+        TimelineId timeline;
+        uint64_t value;
+        uint64_t sequence; // position in the api's stream, each api runs its signals and waits in order
+        Clock::time_point issued;
+    };
+
+    struct Stall {
+        Event wait;
+        uint64_t completedValue;
+        // the producer already finished signals that it issued after the one this waits for, so it skipped it and the wait never finishes
+        bool deadlocked;
+    };
+
+    static constexpr size_t HISTORY_SIZE = 64;
+    // events that are still pending once this many accumulated are dropped, which only happens if nothing polls the timelines
+    static constexpr size_t MAX_PENDING_EVENTS = 512;
+
+    static const char* ApiName(Api api);
+    static Api Other(Api api) { return api == Api::VULKAN ? Api::D3D12 : Api::VULKAN; }
+    static bool HasParity(Api producer, uint64_t value) { return value != 0 && (value % 2 == 1) == (producer == Api::VULKAN); }
+
+    HandoffTracker() = default;
+    ~HandoffTracker();
+
+    // completedValue reads how far the timeline's fence has gotten, the watchdog calls it from its own thread
+    TimelineId AddTimeline(std::string name, std::function<uint64_t()> completedValue);
+    void RemoveTimeline(TimelineId id);
+
+    // allocates the value that the producer signals once it's done with the texture
+    Handoff Signal(TimelineId id, Api producer, Clock::time_point now = Clock::now());
+    // returns the value that the consumer has to wait for before it uses the texture, 0 if the other api never signaled it
+    uint64_t Wait(TimelineId id, Api consumer, Clock::time_point now = Clock::now());
+    std::optional<Api> GetLastProducer(TimelineId id) const;
+
+    // reads the completed values and returns the waits that have been outstanding for longer than the deadline
+    std::vector<Stall> Poll(Clock::time_point now, Clock::duration deadline);
+    std::string DumpHistory() const;
+    uint32_t GetViolations() const;
+
+    // polls every interval and logs each stall once, together with the history
+    void StartWatchdog(Clock::duration deadline, Clock::duration interval);
+    void StopWatchdog();
+
+private:
+    struct Timeline {
+        std::string name;
+        std::function<uint64_t()> completedValue;
+        uint64_t lastValue = 0;                                // the last value that was allocated for a signal
+        std::array<uint64_t, (size_t)Api::COUNT> lastSignal = {};
+        std::array<uint64_t, (size_t)Api::COUNT> lastWait = {};
+        uint64_t completed = 0;
+        bool faulted = false; // its fence misbehaved, which is only reported once
+    };
+
+    void Record(const Event& event);
+    void Violation(std::string message);
+    bool IsDeadlocked(const Event& wait) const;
+    const Event* FindSignal(TimelineId id, uint64_t value) const;
+    void WatchdogThread(Clock::duration deadline, Clock::duration interval);
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<TimelineId, Timeline> m_timelines;
+    TimelineId m_nextTimelineId = 0;
+    std::array<uint64_t, (size_t)Api::COUNT> m_sequence = {};
+    std::array<uint64_t, (size_t)Api::COUNT> m_completedSequence = {}; // every signal before this has finished
+
+    std::array<Event, HISTORY_SIZE> m_history = {};
+    size_t m_historyCount = 0;
+    std::deque<Event> m_pending; // signals and waits whose value the timeline hasn't reached yet, in the order they were issued
+    uint32_t m_violations = 0;
+
+    std::thread m_watchdogThread;
+    std::condition_variable m_watchdogCondition;
+    bool m_stopWatchdog = false;
+};
@@ -194,6 +194,68 @@ void OpenXR::CreateSession(const XrGraphicsBindingD3D12KHR& d3d12Binding) {
     checkXRResult(xrCreateReferenceSpace(m_session, &headSpaceCreateInfo, &m_headSpace), "Failed to create reference space for head!");
 }
 
+template <auto Field>
+static void* InGameState(OpenXR::InputState& input, EyeSide) { return &(input.inGame.*Field); }
+template <auto Field>
+static void* InGameHandState(OpenXR::InputState& input, EyeSide side) { return &(input.inGame.*Field)[side]; }
+template <auto Field>
+static void* InMenuState(OpenXR::InputState& input, EyeSide) { return &(input.inMenu.*Field); }
+template <auto Field>
+static ButtonState* InGameButton(OpenXR::InputState& input, EyeSide) { return &(input.inGame.*Field); }
+template <auto Field>
+static ButtonState* InGameHandButton(OpenXR::InputState& input, EyeSide side) { return &(input.inGame.*Field)[side]; }
+
+std::span<const OpenXR::ActionDesc> OpenXR::GetActionRegistry() {
+    using InGame = InputState::InGame;
+    using InMenu = InputState::InMenu;
+    using Subaction = ActionPoller::Subaction;
+    constexpr auto GAMEPLAY = &OpenXR::m_gameplayActionSet;
+    constexpr auto MENU = &OpenXR::m_menuActionSet;
+
+    // clang-format off
+    static constexpr ActionDesc s_registry[] = {
+        // gameplay
+        { "pose", "Grip Pose", XR_ACTION_TYPE_POSE_INPUT, GAMEPLAY, &OpenXR::m_gripPoseAction, Subaction::BOTH_HANDS, &InGameHandState<&InGame::pose> },
+        { "aim_pose", "Aim Pose", XR_ACTION_TYPE_POSE_INPUT, GAMEPLAY, &OpenXR::m_aimPoseAction },
+        { "move", "Move (Left Thumbstick)", XR_ACTION_TYPE_VECTOR2F_INPUT, GAMEPLAY, &OpenXR::m_moveAction, Subaction::NONE, &InGameState<&InGame::move> },
+        { "camera", "Camera (Right Thumbstick)", XR_ACTION_TYPE_VECTOR2F_INPUT, GAMEPLAY, &OpenXR::m_cameraAction, Subaction::NONE, &InGameState<&InGame::camera> },
+
+        { "grab", "Grab", XR_ACTION_TYPE_FLOAT_INPUT, GAMEPLAY, &OpenXR::m_grabAction, Subaction::BOTH_HANDS, &InGameHandState<&InGame::grab>, &InGameHandButton<&InGame::grabState> },
+        { "interact", "Interact/Action (A Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_interactAction, Subaction::NONE, &InGameState<&InGame::interact> },
+        { "jump", "Jump (X Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_jumpAction, Subaction::NONE, &InGameState<&InGame::jump> },
+        { "crouch", "Crouch (Left Thumbstick Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_crouchAction, Subaction::NONE, &InGameState<&InGame::crouch> },
+        { "run", "Run (B Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_runAction, Subaction::NONE, &InGameState<&InGame::run>, &InGameButton<&InGame::runState> },
+        { "use_rune", "Use Rune (Left Bumper)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_useRuneAction, Subaction::NONE, &InGameState<&InGame::useRune> },
+        { "throw_weapon", "Throw Weapon (Right Bumper)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_throwWeaponAction, Subaction::NONE, &InGameState<&InGame::throwWeapon> },
+
+        { "attack", "Attack (Y Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_attackAction, Subaction::NONE, &InGameState<&InGame::attack> },
+        { "cancel", "Dash/Close (B Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_cancelAction, Subaction::NONE, &InGameState<&InGame::cancel> },
+
+        { "ingame_lefttrigger", "Left Trigger", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_inGame_leftTriggerAction, Subaction::NONE, &InGameState<&InGame::leftTrigger> },
+        { "ingame_righttrigger", "Right Trigger", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_inGame_rightTriggerAction, Subaction::NONE, &InGameState<&InGame::rightTrigger> },
+
+        { "ingame_mapandinventory", "Open/Close Map or Inventory (Select or Start Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, GAMEPLAY, &OpenXR::m_inGame_mapAndInventoryAction, Subaction::RIGHT_HAND, &InGameState<&InGame::mapAndInventory>, &InGameButton<&InGame::mapAndInventoryState> },
+
+        { "rumble", "Rumble", XR_ACTION_TYPE_VIBRATION_OUTPUT, GAMEPLAY, &OpenXR::m_rumbleAction },
+
+        // menu
+        { "scroll", "Scroll (Left Thumbstick)", XR_ACTION_TYPE_VECTOR2F_INPUT, MENU, &OpenXR::m_scrollAction, Subaction::NONE, &InMenuState<&InMenu::scroll> },
+        { "navigate", "Navigate (Right Thumbstick)", XR_ACTION_TYPE_VECTOR2F_INPUT, MENU, &OpenXR::m_navigateAction, Subaction::NONE, &InMenuState<&InMenu::navigate> },
+        { "select", "Select (A Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_selectAction, Subaction::NONE, &InMenuState<&InMenu::select> },
+        { "cancel", "Back/Cancel (B Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_backAction, Subaction::NONE, &InMenuState<&InMenu::back> },
+        { "sort", "Sort (Y Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_sortAction, Subaction::NONE, &InMenuState<&InMenu::sort> },
+        { "hold", "Hold (X Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_holdAction, Subaction::NONE, &InMenuState<&InMenu::hold> },
+        { "left_grip", "Switch To Left Tab (L Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_leftGripAction, Subaction::NONE, &InMenuState<&InMenu::leftGrip> },
+        { "right_grip", "Switch To Right Tab (R Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_rightGripAction, Subaction::NONE, &InMenuState<&InMenu::rightGrip> },
+        { "inmenu_lefttrigger", "Left Trigger", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_inMenu_leftTriggerAction, Subaction::NONE, &InMenuState<&InMenu::leftTrigger> },
+        { "inmenu_righttrigger", "Right Trigger", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_inMenu_rightTriggerAction, Subaction::NONE, &InMenuState<&InMenu::rightTrigger> },
+
+        { "inmenu_mapandinventory", "Open/Close Map (Select Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, MENU, &OpenXR::m_inMenu_mapAndInventoryAction, Subaction::NONE, &InMenuState<&InMenu::mapAndInventory> },
+    };
+    // clang-format on
+    return s_registry;
+}
+
 void OpenXR::CreateActions() {
     Log::print<INFO>("Creating the OpenXR actions...");
 
@@ -215,29 +277,6 @@ void OpenXR::CreateActions() {
         strcpy_s(actionSetInfo.localizedActionSetName, "Gameplay");
         actionSetInfo.priority = 0;
         checkXRResult(xrCreateActionSet(m_instance, &actionSetInfo, &m_gameplayActionSet), "Failed to create controller actions for gameplay_fps!");
-
-        createAction(m_gameplayActionSet, "pose", "Grip Pose", XR_ACTION_TYPE_POSE_INPUT, m_gripPoseAction);
-        createAction(m_gameplayActionSet, "aim_pose", "Aim Pose", XR_ACTION_TYPE_POSE_INPUT, m_aimPoseAction);
-        createAction(m_gameplayActionSet, "move", "Move (Left Thumbstick)", XR_ACTION_TYPE_VECTOR2F_INPUT, m_moveAction);
-        createAction(m_gameplayActionSet, "camera", "Camera (Right Thumbstick)", XR_ACTION_TYPE_VECTOR2F_INPUT, m_cameraAction);
-
-        createAction(m_gameplayActionSet, "grab", "Grab", XR_ACTION_TYPE_FLOAT_INPUT, m_grabAction);
-        createAction(m_gameplayActionSet, "interact", "Interact/Action (A Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_interactAction);
-        createAction(m_gameplayActionSet, "jump", "Jump (X Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_jumpAction);
-        createAction(m_gameplayActionSet, "crouch", "Crouch (Left Thumbstick Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_crouchAction);
-        createAction(m_gameplayActionSet, "run", "Run (B Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_runAction);
-        createAction(m_gameplayActionSet, "use_rune", "Use Rune (Left Bumper)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_useRuneAction);
-        createAction(m_gameplayActionSet, "throw_weapon", "Throw Weapon (Right Bumper)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_throwWeaponAction);
-
-        createAction(m_gameplayActionSet, "attack", "Attack (Y Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_attackAction);
-        createAction(m_gameplayActionSet, "cancel", "Dash/Close (B Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_cancelAction);
-        
-        createAction(m_gameplayActionSet, "ingame_lefttrigger", "Left Trigger", XR_ACTION_TYPE_BOOLEAN_INPUT, m_inGame_leftTriggerAction);
-        createAction(m_gameplayActionSet, "ingame_righttrigger", "Right Trigger", XR_ACTION_TYPE_BOOLEAN_INPUT, m_inGame_rightTriggerAction);
-
-        createAction(m_gameplayActionSet, "ingame_mapandinventory", "Open/Close Map or Inventory (Select or Start Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_inGame_mapAndInventoryAction);
-
-        createAction(m_gameplayActionSet, "rumble", "Rumble", XR_ACTION_TYPE_VIBRATION_OUTPUT, m_rumbleAction);
     }
 
     {
@@ -246,19 +285,10 @@ void OpenXR::CreateActions() {
         strcpy_s(actionSetInfo.localizedActionSetName, "Menu Navigation");
         actionSetInfo.priority = 0;
         checkXRResult(xrCreateActionSet(m_instance, &actionSetInfo, &m_menuActionSet), "Failed to create controller bindings for the menu!");
+    }
 
-        createAction(m_menuActionSet, "scroll", "Scroll (Left Thumbstick)", XR_ACTION_TYPE_VECTOR2F_INPUT, m_scrollAction);
-        createAction(m_menuActionSet, "navigate", "Navigate (Right Thumbstick)", XR_ACTION_TYPE_VECTOR2F_INPUT, m_navigateAction);
-        createAction(m_menuActionSet, "select", "Select (A Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_selectAction);
-        createAction(m_menuActionSet, "cancel", "Back/Cancel (B Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_backAction);
-        createAction(m_menuActionSet, "sort", "Sort (Y Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_sortAction);
-        createAction(m_menuActionSet, "hold", "Hold (X Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_holdAction);
-        createAction(m_menuActionSet, "left_grip", "Switch To Left Tab (L Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_leftGripAction);
-        createAction(m_menuActionSet, "right_grip", "Switch To Right Tab (R Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_rightGripAction);
-        createAction(m_menuActionSet, "inmenu_lefttrigger", "Left Trigger", XR_ACTION_TYPE_BOOLEAN_INPUT, m_inMenu_leftTriggerAction);
-        createAction(m_menuActionSet, "inmenu_righttrigger", "Right Trigger", XR_ACTION_TYPE_BOOLEAN_INPUT, m_inMenu_rightTriggerAction);
-
-        createAction(m_menuActionSet, "inmenu_mapandinventory", "Open/Close Map (Select Button)", XR_ACTION_TYPE_BOOLEAN_INPUT, m_inMenu_mapAndInventoryAction);
+    for (const ActionDesc& desc : GetActionRegistry()) {
+        createAction(this->*desc.actionSet, desc.id, desc.name, desc.type, this->*desc.action);
     }
 
     {
@@ -463,6 +493,8 @@ void CheckButtonState(bool buttonPressed, ButtonState& buttonState) {
 }
 
 std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTime, glm::fquat controllerRotation, bool inMenu) {
+    auto updateStart = std::chrono::high_resolution_clock::now();
+
     XrActiveActionSet activeActionSet = { (inMenu ? m_menuActionSet : m_gameplayActionSet), XR_NULL_PATH };
 
     XrActionsSyncInfo syncInfo = { XR_TYPE_ACTIONS_SYNC_INFO };
@@ -473,86 +505,54 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
     const float playerHeightOffsetMeters = CemuHooks::GetSettings().playerHeightSetting.getLE();
 
     InputState newState = m_input.load();
+    // previous values are only comparable if they were polled for the same action set since the input state is a union
+    InputState prevState = newState;
+    const bool canDiff = prevState.inGame.in_game == !inMenu;
     newState.inGame.in_game = !inMenu;
     newState.inGame.inputTime = predictedFrameTime;
     //newState.inGame.lastPickupSide = m_input.load().inGame.lastPickupSide;
     //newState.inGame.grabState = m_input.load().inGame.grabState;
     //newState.inGame.mapAndInventoryState = m_input.load().inGame.mapAndInventoryState;
 
-    if (inMenu) {
-        XrActionStateGetInfo getScrollInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getScrollInfo.action = m_scrollAction;
-        newState.inMenu.scroll = { XR_TYPE_ACTION_STATE_VECTOR2F };
-        checkXRResult(xrGetActionStateVector2f(m_session, &getScrollInfo, &newState.inMenu.scroll), "Failed to get navigate action value!");
-
-        XrActionStateGetInfo getNavigationInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getNavigationInfo.action = m_navigateAction;
-        newState.inMenu.navigate = { XR_TYPE_ACTION_STATE_VECTOR2F };
-        checkXRResult(xrGetActionStateVector2f(m_session, &getNavigationInfo, &newState.inMenu.navigate), "Failed to get select action value!");
-
-        XrActionStateGetInfo getSelectInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getSelectInfo.action = m_selectAction;
-        newState.inMenu.select = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getSelectInfo, &newState.inMenu.select), "Failed to get select action value!");
-
-        XrActionStateGetInfo getBackInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getBackInfo.action = m_backAction;
-        newState.inMenu.back = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getBackInfo, &newState.inMenu.back), "Failed to get back action value!");
-
-        XrActionStateGetInfo getSortInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getSortInfo.action = m_sortAction;
-        newState.inMenu.sort = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getSortInfo, &newState.inMenu.sort), "Failed to get sort action value!");
-
-        XrActionStateGetInfo getHoldInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getHoldInfo.action = m_holdAction;
-        newState.inMenu.hold = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getHoldInfo, &newState.inMenu.hold), "Failed to get hold action value!");
-
-        XrActionStateGetInfo getLeftGripInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getLeftGripInfo.action = m_leftGripAction;
-        newState.inMenu.leftGrip = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getLeftGripInfo, &newState.inMenu.leftGrip), "Failed to get left grip action value!");
+    uint32_t polledCount = 0;
+    uint32_t changedCount = 0;
 
-        if (newState.inMenu.leftGrip.currentState == XR_TRUE) {
-            newState.inMenu.lastPickupSide = OpenXR::EyeSide::LEFT;
+    const ActionPoller poller(m_session, m_handPaths);
+    for (const ActionDesc& desc : GetActionRegistry()) {
+        if (this->*desc.actionSet != activeActionSet.actionSet || desc.state == nullptr) {
+            continue;
         }
 
-        XrActionStateGetInfo getRightGripInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getRightGripInfo.action = m_rightGripAction;
-        newState.inMenu.rightGrip = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getRightGripInfo, &newState.inMenu.rightGrip), "Failed to get right grip action value!");
+        const ActionPoller::Action action = { desc.id, this->*desc.action, desc.type, desc.subaction };
+        for (uint8_t hand = 0; hand < ActionPoller::GetHandCount(desc.subaction); hand++) {
+            const EyeSide side = (EyeSide)hand;
+            const ActionPoller::Result polled = poller.Poll(action, hand, desc.state(newState, side), desc.state(prevState, side));
+            polledCount++;
+
+            if (desc.buttonState != nullptr && polled.isActive) {
+                CheckButtonState(polled.pressed, *desc.buttonState(newState, side));
+            }
+
+            if (canDiff && polled.changed) {
+                changedCount++;
+                // thumbsticks and grip values change nearly every frame, so only log the discrete changes
+                if (desc.type == XR_ACTION_TYPE_BOOLEAN_INPUT || desc.type == XR_ACTION_TYPE_POSE_INPUT) {
+                    Log::print<CONTROLS>("Action {} changed: active={}, pressed={}", ActionPoller::Describe(action, hand), polled.isActive, polled.pressed);
+                }
+            }
+        }
+    }
 
+    if (inMenu) {
+        if (newState.inMenu.leftGrip.currentState == XR_TRUE) {
+            newState.inMenu.lastPickupSide = OpenXR::EyeSide::LEFT;
+        }
         if (newState.inMenu.rightGrip.currentState == XR_TRUE) {
             newState.inMenu.lastPickupSide = OpenXR::EyeSide::RIGHT;
         }
-
-        XrActionStateGetInfo getMapAndInventoryInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getMapAndInventoryInfo.action = m_inMenu_mapAndInventoryAction;
-        newState.inMenu.mapAndInventory = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getMapAndInventoryInfo, &newState.inMenu.mapAndInventory), "Failed to get back action value!");
-
-        XrActionStateGetInfo getLeftTriggerInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getLeftTriggerInfo.action = m_inMenu_leftTriggerAction;
-        getLeftTriggerInfo.subactionPath = XR_NULL_PATH;
-        newState.inMenu.leftTrigger = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getLeftTriggerInfo, &newState.inMenu.leftTrigger), "Failed to get left trigger action value!");
-
-        XrActionStateGetInfo getRightTriggerInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getRightTriggerInfo.action = m_inMenu_rightTriggerAction;
-        getRightTriggerInfo.subactionPath = XR_NULL_PATH;
-        newState.inMenu.rightTrigger = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getRightTriggerInfo, &newState.inMenu.rightTrigger), "Failed to get right trigger action value!");
     }
     else {
         for (EyeSide side : { EyeSide::LEFT, EyeSide::RIGHT }) {
-            XrActionStateGetInfo getPoseInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-            getPoseInfo.action = m_gripPoseAction;
-            getPoseInfo.subactionPath = m_handPaths[side];
-            newState.inGame.pose[side] = { XR_TYPE_ACTION_STATE_POSE };
-            checkXRResult(xrGetActionStatePose(m_session, &getPoseInfo, &newState.inGame.pose[side]), "Failed to get pose of controller!");
-
             if (newState.inGame.pose[side].isActive) {
                 {
                     XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
@@ -579,6 +579,9 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
 
                             newState.inGame.poseVelocity[side] = spaceVelocity;
                         }
+
+                        const bool velocityValid = (spaceVelocity.velocityFlags & XR_SPACE_VELOCITY_LINEAR_VALID_BIT) != 0 && (spaceVelocity.velocityFlags & XR_SPACE_VELOCITY_ANGULAR_VALID_BIT) != 0;
+                        m_posePredictor.Record(PosePredictor::HandDevice(side), predictedFrameTime, spaceLocation.pose, velocityValid ? &spaceVelocity : nullptr);
                     }
                 }
                 {
@@ -590,116 +593,19 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
                     }
                 }
             }
-
-            XrActionStateGetInfo getGrabInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-            getGrabInfo.action = m_grabAction;
-            getGrabInfo.subactionPath = m_handPaths[side];
-            newState.inGame.grab[side] = { XR_TYPE_ACTION_STATE_FLOAT };
-            checkXRResult(xrGetActionStateFloat(m_session, &getGrabInfo, &newState.inGame.grab[side]), "Failed to get grab action value!");
-
-            auto& action = newState.inGame.grab[side];
-            auto& buttonState = newState.inGame.grabState[side];
-            if (action.isActive == XR_TRUE) {
-                auto buttonPressed = action.currentState > 0.75f;
-                CheckButtonState(buttonPressed, buttonState);
-            }
-        }
-
-        XrActionStateGetInfo getMapAndInventoryInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getMapAndInventoryInfo.action = m_inGame_mapAndInventoryAction;
-        getMapAndInventoryInfo.subactionPath = m_handPaths[1];
-        newState.inGame.mapAndInventory = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getMapAndInventoryInfo, &newState.inGame.mapAndInventory), "Failed to get mapAndInventory action value!");
-
-        auto& mapAndInventoryAction = newState.inGame.mapAndInventory;
-        auto& mapAndInventoryButtonState = newState.inGame.mapAndInventoryState;
-        if (mapAndInventoryAction.isActive == XR_TRUE) {
-            auto buttonPressed = mapAndInventoryAction.currentState == XR_TRUE;
-            CheckButtonState(buttonPressed, mapAndInventoryButtonState);
-        }
-
-        //XrActionStateGetInfo getInventory = { XR_TYPE_ACTION_STATE_GET_INFO };
-        //getInventory.action = m_inGame_inventoryAction;
-        //newState.inGame.inventory = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        //checkXRResult(xrGetActionStateBoolean(m_session, &getInventory, &newState.inGame.inventory), "Failed to get inventory action value!");
-
-        XrActionStateGetInfo getMoveInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getMoveInfo.action = m_moveAction;
-        newState.inGame.move = { XR_TYPE_ACTION_STATE_VECTOR2F };
-        checkXRResult(xrGetActionStateVector2f(m_session, &getMoveInfo, &newState.inGame.move), "Failed to get move action value!");
-
-        XrActionStateGetInfo getCameraInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getCameraInfo.action = m_cameraAction;
-        newState.inGame.camera = { XR_TYPE_ACTION_STATE_VECTOR2F };
-        checkXRResult(xrGetActionStateVector2f(m_session, &getCameraInfo, &newState.inGame.camera), "Failed to get camera action value!");
-
-        XrActionStateGetInfo getInteractInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getInteractInfo.action = m_interactAction;
-        getInteractInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.interact = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getInteractInfo, &newState.inGame.interact), "Failed to get interact action value!");
-
-        XrActionStateGetInfo getCancelInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getCancelInfo.action = m_cancelAction;
-        getCancelInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.cancel = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getCancelInfo, &newState.inGame.cancel), "Failed to get cancel action value!");
-
-        XrActionStateGetInfo getJumpInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getJumpInfo.action = m_jumpAction;
-        getJumpInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.jump = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getJumpInfo, &newState.inGame.jump), "Failed to get jump action value!");
-
-        XrActionStateGetInfo getCrouchInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getCrouchInfo.action = m_crouchAction;
-        getCrouchInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.crouch = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getCrouchInfo, &newState.inGame.crouch), "Failed to get crouch action value!");
-
-        XrActionStateGetInfo getRunInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getRunInfo.action = m_runAction;
-        getRunInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.run = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getRunInfo, &newState.inGame.run), "Failed to get run action value!");
-
-        auto& runAction = newState.inGame.run;
-        auto& runButtonState = newState.inGame.runState;
-        if (runAction.isActive == XR_TRUE) {
-            auto buttonPressed = runAction.currentState == XR_TRUE;
-            CheckButtonState(buttonPressed, runButtonState);
         }
+    }
 
-        XrActionStateGetInfo getAttackInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getAttackInfo.action = m_attackAction;
-        getAttackInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.attack = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getAttackInfo, &newState.inGame.attack), "Failed to get attack action value!");
-
-        XrActionStateGetInfo getUseRuneInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getUseRuneInfo.action = m_useRuneAction;
-        getUseRuneInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.useRune = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getUseRuneInfo, &newState.inGame.useRune), "Failed to get useRune action value!");
-
-        XrActionStateGetInfo getThrowWeaponInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getThrowWeaponInfo.action = m_throwWeaponAction;
-        getThrowWeaponInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.throwWeapon = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getThrowWeaponInfo, &newState.inGame.throwWeapon), "Failed to get throwWeapon action value!");
-
-        XrActionStateGetInfo getLeftTriggerInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getLeftTriggerInfo.action = m_inGame_leftTriggerAction;
-        getLeftTriggerInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.leftTrigger = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getLeftTriggerInfo, &newState.inGame.leftTrigger), "Failed to get left trigger action value!");
-
-        XrActionStateGetInfo getRightTriggerInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-        getRightTriggerInfo.action = m_inGame_rightTriggerAction;
-        getRightTriggerInfo.subactionPath = XR_NULL_PATH;
-        newState.inGame.rightTrigger = { XR_TYPE_ACTION_STATE_BOOLEAN };
-        checkXRResult(xrGetActionStateBoolean(m_session, &getRightTriggerInfo, &newState.inGame.rightTrigger), "Failed to get right trigger action value!");
+    static uint32_t s_updateCount = 0;
+    static double s_updateTimeMs = 0.0;
+    s_updateCount++;
+    s_updateTimeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - updateStart).count();
+    if (s_updateCount % 500 == 0) {
+        Log::print<CONTROLS>("UpdateActions #{}: {:.3f}ms per call, {} states polled, {} changed", s_updateCount, s_updateTimeMs / 500.0, polledCount, changedCount);
+        m_posePredictor.LogStats();
+        s_updateTimeMs = 0.0;
     }
+
     this->m_input.store(newState);
     return newState;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "hooking/rumble.h"
+#include "action_poller.h"
+#include "pose_predictor.h"
 
 class OpenXR {
     friend class RND_Renderer;
@@ -133,8 +135,24 @@ public:
     XrSession GetSession() const { return m_session; }
     RND_Renderer* GetRenderer() const { return m_renderer.get(); }
     RumbleManager* GetRumbleManager() const { return m_rumbleManager.get(); }
+    PosePredictor& GetPosePredictor() { return m_posePredictor; }
 
 private:
+    // describes an action once, CreateActions and UpdateActions both iterate over the registry
+    struct ActionDesc {
+        const char* id;
+        const char* name;
+        XrActionType type;
+        XrActionSet OpenXR::* actionSet;
+        XrAction OpenXR::* action;
+        ActionPoller::Subaction subaction = ActionPoller::Subaction::NONE;
+        // where the polled state is written to in the input state, nullptr for actions that aren't polled
+        void* (*state)(InputState& input, EyeSide side) = nullptr;
+        // optional press tracking for short, long and double presses
+        InputState::InGame::ButtonState* (*buttonState)(InputState& input, EyeSide side) = nullptr;
+    };
+    static std::span<const ActionDesc> GetActionRegistry();
+
     XrPath GetXRPath(const char* str) const {
         XrPath path;
         checkXRResult(xrStringToPath(m_instance, str, &path), std::format("Failed to get path for {}", str).c_str());
@@ -191,6 +209,7 @@ private:
 
     std::unique_ptr<RND_Renderer> m_renderer;
     std::unique_ptr<RumbleManager> m_rumbleManager;
+    PosePredictor m_posePredictor;
 
     constexpr static XrPosef s_xrIdentityPose = { .orientation = { .x = 0, .y = 0, .z = 0, .w = 1 }, .position = { .x = 0, .y = 0, .z = 0 } };
 
@@ -0,0 +1,232 @@
+#include "overlay_cache.h"
+
+namespace {
+    // fnv-1a over whole words, the vertex buffers of the debug plots are too big to hash them byte by byte every frame
+    uint64_t HashBytes(const void* data, size_t size, uint64_t hash) {
+        constexpr uint64_t PRIME = 0x100000001B3;
+        const uint8_t* bytes = (const uint8_t*)data;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(word));
+            hash ^= word;
+            hash *= PRIME;
+            hash ^= hash >> 32;
+        }
+        for (; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= PRIME;
+        }
+        // terminate every field so that neighbouring fields can't shift into each other
+        hash ^= 0xFF;
+        hash *= PRIME;
+        return hash;
+    }
+
+    template <typename... Ts>
+    uint64_t HashValues(uint64_t hash, const Ts&... values) {
+        static_assert((std::is_trivially_copyable_v<Ts> && ...), "Only plain values can be hashed by their bytes");
+        ((hash = HashBytes(&values, sizeof(Ts), hash)), ...);
+        return hash;
+    }
+
+    constexpr uint64_t HASH_SEED = 0xCBF29CE484222325;
+}
+
+OverlayDrawCache::Rect OverlayDrawCache::Rect::Union(const Rect& other) const {
+    if (IsEmpty()) {
+        return other;
+    }
+    if (other.IsEmpty()) {
+        return *this;
+    }
+    return { std::min(minX, other.minX), std::min(minY, other.minY), std::max(maxX, other.maxX), std::max(maxY, other.maxY) };
+}
+
+OverlayDrawCache::Rect OverlayDrawCache::Plan::GetBounds() const {
+    Rect bounds;
+    for (const Rect& rect : dirtyRects) {
+        bounds = bounds.Union(rect);
+    }
+    return bounds;
+}
+
+std::optional<OverlayDrawCache::Rect> OverlayDrawCache::GetScissor(const ImDrawData* drawData, const ImDrawCmd& cmd) {
+    // mirrors ImGui_ImplVulkan_RenderDrawData, a scissor that's off by a pixel would leave a seam that's never cleared or drawn twice
+    const int fbWidth = (int)(drawData->DisplaySize.x * drawData->FramebufferScale.x);
+    const int fbHeight = (int)(drawData->DisplaySize.y * drawData->FramebufferScale.y);
+    const ImVec2 clipOff = drawData->DisplayPos;
+    const ImVec2 clipScale = drawData->FramebufferScale;
+
+    ImVec2 clipMin((cmd.ClipRect.x - clipOff.x) * clipScale.x, (cmd.ClipRect.y - clipOff.y) * clipScale.y);
+    ImVec2 clipMax((cmd.ClipRect.z - clipOff.x) * clipScale.x, (cmd.ClipRect.w - clipOff.y) * clipScale.y);
+    clipMin.x = std::max(clipMin.x, 0.0f);
+    clipMin.y = std::max(clipMin.y, 0.0f);
+    clipMax.x = std::min(clipMax.x, (float)fbWidth);
+    clipMax.y = std::min(clipMax.y, (float)fbHeight);
+    if (clipMax.x <= clipMin.x || clipMax.y <= clipMin.y) {
+        return std::nullopt;
+    }
+
+    const int32_t x = (int32_t)clipMin.x;
+    const int32_t y = (int32_t)clipMin.y;
+    return Rect{ x, y, x + (int32_t)(uint32_t)(clipMax.x - clipMin.x), y + (int32_t)(uint32_t)(clipMax.y - clipMin.y) };
+}
+
+OverlayDrawCache::FrameSnapshot OverlayDrawCache::Snapshot(const ImDrawData* drawData, const TextureVersionFn& textureVersion) {
+    FrameSnapshot snapshot;
+    snapshot.framebuffer = { 0, 0, (int32_t)(drawData->DisplaySize.x * drawData->FramebufferScale.x), (int32_t)(drawData->DisplaySize.y * drawData->FramebufferScale.y) };
+    snapshot.displayHash = HashValues(HASH_SEED, drawData->DisplayPos, drawData->DisplaySize, drawData->FramebufferScale);
+    snapshot.hash = snapshot.displayHash;
+
+    for (const ImDrawList* list : drawData->CmdLists) {
+        ListSnapshot listSnapshot = { .hash = HASH_SEED, .bounds = {} };
+        listSnapshot.hash = HashBytes(list->VtxBuffer.Data, (size_t)list->VtxBuffer.size_in_bytes(), listSnapshot.hash);
+        listSnapshot.hash = HashBytes(list->IdxBuffer.Data, (size_t)list->IdxBuffer.size_in_bytes(), listSnapshot.hash);
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            const ImTextureID textureId = cmd.GetTexID();
+            listSnapshot.hash = HashValues(listSnapshot.hash, cmd.ClipRect, textureId, textureVersion(textureId), cmd.VtxOffset, cmd.IdxOffset, cmd.ElemCount, cmd.UserCallback, cmd.UserCallbackData);
+            if (cmd.UserCallback == nullptr) {
+                if (auto scissor = GetScissor(drawData, cmd)) {
+                    listSnapshot.bounds = listSnapshot.bounds.Union(*scissor);
+                }
+            }
+        }
+        snapshot.hash = HashValues(snapshot.hash, listSnapshot.hash);
+        snapshot.lists.emplace_back(listSnapshot);
+    }
+    return snapshot;
+}
+
+void OverlayDrawCache::MergeRects(std::vector<Rect>& rects, size_t maxRects) {
+    std::erase_if(rects, [](const Rect& rect) { return rect.IsEmpty(); });
+
+    while (true) {
+        // a union can overlap rects that the two parts didn't, so this starts over after every merge
+        std::optional<std::pair<size_t, size_t>> merge;
+        for (size_t i = 0; i < rects.size() && !merge; i++) {
+            for (size_t j = i + 1; j < rects.size() && !merge; j++) {
+                const bool wastesNothing = rects[i].Union(rects[j]).GetArea() == rects[i].GetArea() + rects[j].GetArea();
+                if (rects[i].Overlaps(rects[j]) || wastesNothing) {
+                    merge = { i, j };
+                }
+            }
+        }
+
+        if (!merge && rects.size() > std::max<size_t>(maxRects, 1)) {
+            int64_t leastWaste = std::numeric_limits<int64_t>::max();
+            for (size_t i = 0; i < rects.size(); i++) {
+                for (size_t j = i + 1; j < rects.size(); j++) {
+                    const int64_t waste = rects[i].Union(rects[j]).GetArea() - rects[i].GetArea() - rects[j].GetArea();
+                    if (waste < leastWaste) {
+                        leastWaste = waste;
+                        merge = { i, j };
+                    }
+                }
+            }
+        }
+
+        if (!merge) {
+            return;
+        }
+        rects[merge->first] = rects[merge->first].Union(rects[merge->second]);
+        rects.erase(rects.begin() + (ptrdiff_t)merge->second);
+    }
+}
+
+OverlayDrawCache::Plan OverlayDrawCache::Prepare(size_t target, ImDrawData* drawData, const TextureVersionFn& textureVersion) {
+    checkAssert(target < m_targets.size(), "The overlay draw cache doesn't know this framebuffer!");
+
+    // the window is closed by the frame after it, so that the last frame of it is counted
+    if (m_stats.frames == STATS_WINDOW) {
+        Log::print<INFO>("Overlay draw cache: of the last {} overlay frames {} were skipped, {} were redrawn partially (covering {:.0f}% on average) and {} fully", STATS_WINDOW, m_stats.skippedFrames, m_stats.partialFrames, m_stats.partialFrames != 0 ? m_stats.partialCoverage / m_stats.partialFrames * 100.0 : 0.0, m_stats.fullFrames);
+        std::lock_guard lock(m_statsMutex);
+        m_lastStats = m_stats;
+        m_stats = {};
+    }
+    m_stats.frames++;
+
+    FrameSnapshot snapshot = Snapshot(drawData, textureVersion);
+    const std::optional<FrameSnapshot>& previous = m_targets[target];
+
+    Plan plan;
+    if (!previous.has_value() || previous->hash != snapshot.hash) {
+        if (!previous.has_value() || previous->displayHash != snapshot.displayHash) {
+            plan.dirtyRects.emplace_back(snapshot.framebuffer);
+        }
+        else {
+            // a list that changed has to be cleared where it was drawn before, and drawn where it's now
+            for (size_t i = 0; i < std::max(previous->lists.size(), snapshot.lists.size()); i++) {
+                const ListSnapshot* before = i < previous->lists.size() ? &previous->lists[i] : nullptr;
+                const ListSnapshot* after = i < snapshot.lists.size() ? &snapshot.lists[i] : nullptr;
+                if (before != nullptr && after != nullptr && before->hash == after->hash) {
+                    continue;
+                }
+                if (before != nullptr) {
+                    plan.dirtyRects.emplace_back(before->bounds);
+                }
+                if (after != nullptr) {
+                    plan.dirtyRects.emplace_back(after->bounds);
+                }
+            }
+        }
+
+        // every command that's partially inside a rect grows it, since the pixels that it covers outside the rect would otherwise be
+        // blended over what's already there. the rects only grow, so this ends once they contain or avoid every command.
+        for (bool grown = true; grown;) {
+            grown = false;
+            MergeRects(plan.dirtyRects, MAX_DIRTY_RECTS);
+            for (const ImDrawList* list : drawData->CmdLists) {
+                for (const ImDrawCmd& cmd : list->CmdBuffer) {
+                    auto scissor = cmd.UserCallback == nullptr ? GetScissor(drawData, cmd) : std::nullopt;
+                    if (!scissor) {
+                        continue;
+                    }
+                    for (Rect& rect : plan.dirtyRects) {
+                        if (rect.Overlaps(*scissor) && !rect.Contains(*scissor)) {
+                            rect = rect.Union(*scissor);
+                            grown = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        // the backend skips commands with an empty scissor, which is what the commands outside of the rects get
+        for (ImDrawList* list : drawData->CmdLists) {
+            for (ImDrawCmd& cmd : list->CmdBuffer) {
+                auto scissor = cmd.UserCallback == nullptr ? GetScissor(drawData, cmd) : std::nullopt;
+                if (scissor && std::ranges::none_of(plan.dirtyRects, [&](const Rect& rect) { return rect.Contains(*scissor); })) {
+                    cmd.ClipRect = ImVec4(drawData->DisplayPos.x, drawData->DisplayPos.y, drawData->DisplayPos.x, drawData->DisplayPos.y);
+                }
+            }
+        }
+
+        int64_t dirtyArea = 0;
+        for (const Rect& rect : plan.dirtyRects) {
+            dirtyArea += rect.GetArea();
+        }
+        // lists that changed without drawing anything visible, before or after, don't need a redraw either
+        plan.redraw = dirtyArea != 0;
+        if (!plan.redraw) {
+            m_stats.skippedFrames++;
+        }
+        else if (dirtyArea < snapshot.framebuffer.GetArea()) {
+            m_stats.partialFrames++;
+            m_stats.partialCoverage += (double)dirtyArea / (double)std::max<int64_t>(snapshot.framebuffer.GetArea(), 1);
+        }
+        else {
+            m_stats.fullFrames++;
+        }
+        m_targets[target] = std::move(snapshot);
+    }
+    else {
+        m_stats.skippedFrames++;
+    }
+    return plan;
+}
+
+OverlayDrawCache::Stats OverlayDrawCache::GetStats() const {
+    std::lock_guard lock(m_statsMutex);
+    return m_lastStats;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// remembers what the overlay last drew into each of its framebuffers, so that a framebuffer is only cleared and redrawn where its draw lists
+// changed, or not at all. the lists are compared by a hash of their vertices, indices and commands, which also covers a version of every
+// texture that they sample, since Cemu's frames are drawn through textures whose contents change while their ids stay the same.
+class OverlayDrawCache {
+public:
+    // in framebuffer pixels, the max is exclusive
+    struct Rect {
+        int32_t minX = 0;
+        int32_t minY = 0;
+        int32_t maxX = 0;
+        int32_t maxY = 0;
+
+        bool IsEmpty() const { return maxX <= minX || maxY <= minY; }
+        int64_t GetArea() const { return IsEmpty() ? 0 : (int64_t)(maxX - minX) * (int64_t)(maxY - minY); }
+        bool Overlaps(const Rect& other) const { return minX < other.maxX && other.minX < maxX && minY < other.maxY && other.minY < maxY; }
+        bool Contains(const Rect& other) const { return minX <= other.minX && minY <= other.minY && other.maxX <= maxX && other.maxY <= maxY; }
+        Rect Union(const Rect& other) const;
+
+        bool operator==(const Rect& other) const = default;
+    };
+
+    struct ListSnapshot {
+        uint64_t hash;
+        Rect bounds; // the union of the scissors of its commands
+    };
+
+    struct FrameSnapshot {
+        uint64_t hash = 0;        // of the display and all of the lists
+        uint64_t displayHash = 0; // moving or scaling the display moves every scissor, even if no list changed
+        Rect framebuffer;
+        std::vector<ListSnapshot> lists;
+    };
+
+    struct Plan {
+        bool redraw = false;
+        // disjoint, and every command that's still drawn lies entirely inside one of them, so nothing is blended twice
+        std::vector<Rect> dirtyRects;
+
+        Rect GetBounds() const;
+    };
+
+    struct Stats {
+        uint32_t frames;
+        uint32_t skippedFrames;
+        uint32_t partialFrames;
+        uint32_t fullFrames;
+        double partialCoverage; // the fraction of the framebuffer that was redrawn, summed over the partial frames
+    };
+    static constexpr uint32_t STATS_WINDOW = 500;
+
+    using TextureVersionFn = std::function<uint64_t(ImTextureID)>;
+
+    static constexpr size_t MAX_DIRTY_RECTS = 8;
+
+    // the scissor that the vulkan backend sets for the command, calculated the exact same way
+    static std::optional<Rect> GetScissor(const ImDrawData* drawData, const ImDrawCmd& cmd);
+    static FrameSnapshot Snapshot(const ImDrawData* drawData, const TextureVersionFn& textureVersion);
+    // merges overlapping rects and neighbours whose union covers nothing else until they're disjoint, and then the ones that waste the
+    // least area once there are more than maxRects
+    static void MergeRects(std::vector<Rect>& rects, size_t maxRects);
+
+    explicit OverlayDrawCache(size_t targetCount): m_targets(targetCount) {}
+
+    // compares the draw data with what the target holds, and empties the clip rects of the commands that don't have to be drawn again
+    Plan Prepare(size_t target, ImDrawData* drawData, const TextureVersionFn& textureVersion);
+
+    // the counts of the last full window of STATS_WINDOW frames
+    Stats GetStats() const;
+
+private:
+    std::vector<std::optional<FrameSnapshot>> m_targets;
+
+    Stats m_stats = {};
+    Stats m_lastStats = {};
+    mutable std::mutex m_statsMutex;
+};
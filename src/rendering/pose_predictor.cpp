@@ -0,0 +1,165 @@
+#include "pose_predictor.h"
+
+static float SmoothingFactor(float cutoff, float dt) {
+    const float r = 2.0f * glm::pi<float>() * cutoff * dt;
+    return r / (r + 1.0f);
+}
+
+// shortest rotation between two orientations, in radians
+static float AngleBetween(const glm::fquat& a, const glm::fquat& b) {
+    glm::fquat delta = glm::normalize(a * glm::inverse(b));
+    return glm::angle(delta.w < 0.0f ? -delta : delta);
+}
+
+glm::fvec3 PosePredictor::OneEuroFilter::Apply(const glm::fvec3& raw, float dt, const Config& config) {
+    if (!initialized || dt <= 0.0f) {
+        initialized = true;
+        value = raw;
+        derivative = glm::fvec3();
+        return value;
+    }
+
+    derivative = glm::mix(derivative, (raw - value) / dt, SmoothingFactor(config.derivativeCutoff, dt));
+    const float cutoff = config.minCutoff + config.beta * glm::length(derivative);
+    value = glm::mix(value, raw, SmoothingFactor(cutoff, dt));
+    return value;
+}
+
+void PosePredictor::SetConfig(const Config& config) {
+    std::lock_guard lock(m_mutex);
+    m_config = config;
+}
+
+void PosePredictor::Record(Device device, XrTime time, const XrPosef& pose, const XrSpaceVelocity* velocity) {
+    std::lock_guard lock(m_mutex);
+    History& history = m_history[(size_t)device];
+
+    Sample sample = {
+        .time = time,
+        .position = ToGLM(pose.position),
+        .orientation = ToGLM(pose.orientation),
+    };
+
+    float dt = 0.0f;
+    if (history.count > 0) {
+        const Sample& prev = history.Newest();
+        if (time <= prev.time) {
+            // the runtime can hand out the same predicted time twice when a frame is skipped, keep the first one
+            return;
+        }
+        dt = (float)(time - prev.time) / 1e9f;
+
+        // compare what would've been predicted against what the runtime reports now
+        const Sample predicted = Extrapolate(prev, time - prev.time);
+        history.positionErrorSum += glm::distance(predicted.position, sample.position);
+        history.angleErrorSum += AngleBetween(predicted.orientation, sample.orientation);
+        history.errorCount++;
+    }
+
+    glm::fvec3 linearVelocity = glm::fvec3();
+    glm::fvec3 angularVelocity = glm::fvec3();
+    if (velocity != nullptr) {
+        linearVelocity = ToGLM(velocity->linearVelocity);
+        angularVelocity = ToGLM(velocity->angularVelocity);
+    }
+    else if (history.count > 0 && dt > 0.0f) {
+        // derive the velocities from the previous sample
+        const Sample& prev = history.Newest();
+        linearVelocity = (sample.position - prev.position) / dt;
+        glm::fquat delta = glm::normalize(sample.orientation * glm::inverse(prev.orientation));
+        if (delta.w < 0.0f) {
+            delta = -delta;
+        }
+        const float angle = glm::angle(delta);
+        if (angle > 1e-6f) {
+            angularVelocity = glm::axis(delta) * (angle / dt);
+        }
+    }
+
+    if (m_config.filter == Filter::ONE_EURO) {
+        linearVelocity = history.linearFilter.Apply(linearVelocity, dt, m_config);
+        angularVelocity = history.angularFilter.Apply(angularVelocity, dt, m_config);
+    }
+    sample.linearVelocity = linearVelocity;
+    sample.angularVelocity = angularVelocity;
+
+    history.newest = (history.newest + 1) % HISTORY_SIZE;
+    history.samples[history.newest] = sample;
+    history.count = std::min(history.count + 1, HISTORY_SIZE);
+}
+
+void PosePredictor::Reset(Device device) {
+    std::lock_guard lock(m_mutex);
+    m_history[(size_t)device] = {};
+}
+
+PosePredictor::Sample PosePredictor::Extrapolate(const Sample& sample, XrDuration duration) {
+    const float dt = (float)duration / 1e9f;
+
+    Sample result = sample;
+    result.time = sample.time + duration;
+    result.position += sample.linearVelocity * dt;
+
+    const float angularSpeed = glm::length(sample.angularVelocity);
+    if (angularSpeed > 1e-6f) {
+        result.orientation = glm::normalize(glm::angleAxis(angularSpeed * dt, sample.angularVelocity / angularSpeed) * sample.orientation);
+    }
+    return result;
+}
+
+std::optional<PosePredictor::Sample> PosePredictor::PoseAtLocked(const History& history, XrTime time) const {
+    if (history.count == 0) {
+        return std::nullopt;
+    }
+
+    const Sample& newest = history.Newest();
+    if (time >= newest.time) {
+        return Extrapolate(newest, std::min(time - newest.time, m_config.maxExtrapolation));
+    }
+
+    // walk back to the two samples surrounding the requested time
+    for (size_t age = 1; age < history.count; age++) {
+        const Sample& older = history.At(age);
+        if (older.time > time) {
+            continue;
+        }
+
+        const Sample& newer = history.At(age - 1);
+        const float t = (float)(time - older.time) / (float)(newer.time - older.time);
+        return Sample{
+            .time = time,
+            .position = glm::mix(older.position, newer.position, t),
+            .orientation = glm::slerp(older.orientation, newer.orientation, t),
+            .linearVelocity = glm::mix(older.linearVelocity, newer.linearVelocity, t),
+            .angularVelocity = glm::mix(older.angularVelocity, newer.angularVelocity, t)
+        };
+    }
+    return history.At(history.count - 1);
+}
+
+std::optional<PosePredictor::Sample> PosePredictor::PoseAt(Device device, XrTime time) const {
+    std::lock_guard lock(m_mutex);
+    return PoseAtLocked(m_history[(size_t)device], time);
+}
+
+void PosePredictor::SetFrameTiming(XrTime predictedDisplayTime) {
+    std::lock_guard lock(m_mutex);
+    m_targetTime = std::max(m_targetTime, predictedDisplayTime);
+}
+
+XrTime PosePredictor::GetTargetTime() const {
+    std::lock_guard lock(m_mutex);
+    return m_targetTime;
+}
+
+void PosePredictor::LogStats() const {
+    std::lock_guard lock(m_mutex);
+    constexpr std::array deviceNames = { "left hand", "right hand" };
+    for (size_t i = 0; i < m_history.size(); i++) {
+        const History& history = m_history[i];
+        if (history.errorCount == 0) {
+            continue;
+        }
+        Log::print<CONTROLS>("Pose prediction error for {}: {:.2f}mm, {:.3f}deg on average over {} samples", deviceNames[i], history.positionErrorSum / (double)history.errorCount * 1000.0, glm::degrees(history.angleErrorSum / (double)history.errorCount), history.errorCount);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+// keeps a short timestamped history of the controller poses so that the hooks can ask for a pose at the display time of the frame
+// they run for, which is extrapolated when they run before that frame's poses have been located
+class PosePredictor {
+public:
+    enum class Device : uint8_t {
+        LEFT_HAND,
+        RIGHT_HAND,
+        COUNT
+    };
+
+    enum class Filter : uint8_t {
+        NONE,     // extrapolate with the raw velocities
+        ONE_EURO, // smooth the velocities with a one euro filter before extrapolating
+    };
+
+    struct Config {
+        Filter filter;
+        float minCutoff;        // hz, lower values smooth slow movements more
+        float beta;             // how quickly the cutoff rises with speed, higher values reduce lag on fast swings
+        float derivativeCutoff; // hz
+        XrDuration maxExtrapolation;
+    };
+    // the filter runs on the velocities, so its lag is added to every extrapolation. a 1hz cutoff took about 160ms to follow a slow hand
+    // that starts moving, 10hz keeps that within a frame or two while still halving the jitter between samples
+    static constexpr Config DEFAULT_CONFIG = {
+        .filter = Filter::ONE_EURO,
+        .minCutoff = 10.0f,
+        .beta = 0.5f,
+        .derivativeCutoff = 1.0f,
+        .maxExtrapolation = 50'000'000 // 50ms
+    };
+
+    struct Sample {
+        XrTime time = 0;
+        glm::fvec3 position = glm::fvec3();
+        glm::fquat orientation = glm::identity<glm::fquat>();
+        glm::fvec3 linearVelocity = glm::fvec3();
+        glm::fvec3 angularVelocity = glm::fvec3(); // in stage space
+    };
+
+    static Device HandDevice(uint8_t side) { return side == 0 ? Device::LEFT_HAND : Device::RIGHT_HAND; }
+
+    void SetConfig(const Config& config);
+
+    // velocity can be nullptr if the runtime didn't provide a valid one, in which case it's derived from the history
+    void Record(Device device, XrTime time, const XrPosef& pose, const XrSpaceVelocity* velocity);
+    void Reset(Device device);
+
+    // interpolates within the history and extrapolates past the newest sample, up to maxExtrapolation
+    std::optional<Sample> PoseAt(Device device, XrTime time) const;
+
+    // the display time that xrWaitFrame predicted for the frame that the hooks are running for
+    void SetFrameTiming(XrTime predictedDisplayTime);
+    // the hooks predict for the display time of the current frame and never past it, since that's when their results are shown.
+    // never goes backwards, even if the runtime's prediction does.
+    XrTime GetTargetTime() const;
+
+    void LogStats() const;
+
+private:
+    static constexpr size_t HISTORY_SIZE = 16;
+
+    struct OneEuroFilter {
+        bool initialized = false;
+        glm::fvec3 value = glm::fvec3();
+        glm::fvec3 derivative = glm::fvec3();
+
+        glm::fvec3 Apply(const glm::fvec3& raw, float dt, const Config& config);
+    };
+
+    struct History {
+        std::array<Sample, HISTORY_SIZE> samples = {};
+        size_t newest = 0;
+        size_t count = 0;
+
+        OneEuroFilter linearFilter;
+        OneEuroFilter angularFilter;
+
+        // error of the prediction for each new sample made from the samples before it
+        double positionErrorSum = 0.0;
+        double angleErrorSum = 0.0;
+        uint64_t errorCount = 0;
+
+        const Sample& Newest() const { return samples[newest]; }
+        const Sample& At(size_t age) const { return samples[(newest + HISTORY_SIZE - age) % HISTORY_SIZE]; }
+    };
+
+    std::optional<Sample> PoseAtLocked(const History& history, XrTime time) const;
+    static Sample Extrapolate(const Sample& sample, XrDuration duration);
+
+    mutable std::mutex m_mutex;
+    Config m_config = DEFAULT_CONFIG;
+    std::array<History, (size_t)Device::COUNT> m_history;
+
+    XrTime m_targetTime = 0;
+};
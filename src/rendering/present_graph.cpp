@@ -0,0 +1,68 @@
+#include "present_graph.h"
+
+const char* PresentGraph::LaneName(Lane lane) {
+    switch (lane) {
+        case Lane::DIRECT: return "direct";
+        case Lane::PRESENT: return "present";
+        case Lane::SUBMIT: return "submit";
+        default: return "unknown";
+    }
+}
+
+void PresentGraph::BeginFrame() {
+    m_jobs.clear();
+}
+
+PresentGraph::JobId PresentGraph::Add(const char* name, Lane lane, std::initializer_list<JobId> dependencies) {
+    const size_t laneIdx = (size_t)lane;
+    Timeline& reached = m_reached[laneIdx];
+
+    // a lane runs its jobs in order, so only the latest dependency on every other lane has to be waited for
+    std::array<const Job*, LANE_COUNT> latest = {};
+    for (JobId dependency : dependencies) {
+        checkAssert(dependency < m_jobs.size(), "Jobs can only depend on jobs that were added before them!");
+        const Job& job = m_jobs[dependency];
+        const Job*& current = latest[(size_t)job.lane];
+        if (current == nullptr || job.signalValue > current->signalValue) {
+            current = &job;
+        }
+    }
+
+    // a dependency is already covered if an earlier job on this lane or another dependency waited for it
+    auto isImplied = [&](size_t other) {
+        const uint64_t value = latest[other]->signalValue;
+        if (value <= reached[other]) {
+            return true;
+        }
+        for (const Job* dependency : latest) {
+            if (dependency != nullptr && dependency != latest[other] && dependency->reached[other] >= value) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    Job job = { .name = name, .lane = lane, .signalValue = ++m_scheduled[laneIdx] };
+    for (size_t other = 0; other < LANE_COUNT; other++) {
+        const Job* dependency = latest[other];
+        if (other == laneIdx || dependency == nullptr || isImplied(other)) {
+            continue;
+        }
+        job.waits.push_back({ (Lane)other, dependency->signalValue });
+
+        // waiting for a job also means waiting for everything that it waited for
+        for (size_t i = 0; i < LANE_COUNT; i++) {
+            reached[i] = std::max(reached[i], dependency->reached[i]);
+        }
+    }
+    reached[laneIdx] = job.signalValue;
+    job.reached = reached;
+
+    m_jobs.emplace_back(std::move(job));
+    return (JobId)(m_jobs.size() - 1);
+}
+
+void PresentGraph::OnCompleted(Lane lane, uint64_t value) {
+    checkAssert(value <= m_scheduled[(size_t)lane], "A lane can't complete jobs that haven't been scheduled yet!");
+    m_completed[(size_t)lane] = std::max(m_completed[(size_t)lane], value);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// dependencies between the work that presents a frame.
+// jobs run on lanes that finish their work in order, like a gpu queue or a thread, and every lane has a timeline whose value is how
+// many of its jobs have finished. a job only waits for the other lanes it depends on, and skips any wait that an earlier job on its
+// lane already implies. nothing in here touches a device, the renderer maps the lanes to its queues, fences and submission thread.
+class PresentGraph {
+public:
+    enum class Lane : uint8_t {
+        DIRECT,  // the queue that OpenXR was given, the swapchain images are released once the work on it has been submitted
+        PRESENT, // the queue that composes the eyes into the swapchains
+        SUBMIT,  // the thread that calls xrEndFrame
+        COUNT
+    };
+    static constexpr size_t LANE_COUNT = (size_t)Lane::COUNT;
+
+    using JobId = uint32_t;
+    using Timeline = std::array<uint64_t, LANE_COUNT>;
+
+    struct Wait {
+        Lane lane;
+        uint64_t value;
+    };
+
+    struct Job {
+        const char* name;
+        Lane lane;
+        uint64_t signalValue;    // what the lane's timeline reaches once the job has finished
+        std::vector<Wait> waits; // at most one per other lane
+        Timeline reached;        // the values of all lanes that are known to be reached once the job has finished
+    };
+
+    static const char* LaneName(Lane lane);
+
+    // forgets the jobs of the previous frame, the timelines keep counting
+    void BeginFrame();
+    JobId Add(const char* name, Lane lane, std::initializer_list<JobId> dependencies = {});
+
+    const Job& GetJob(JobId id) const { return m_jobs[id]; }
+    std::span<const Job> GetJobs() const { return m_jobs; }
+    // the values that every lane reaches once all the jobs that were added so far have finished
+    const Timeline& GetScheduled() const { return m_scheduled; }
+
+    // whatever runs a lane reports how far it got, e.g. from a fence
+    void OnCompleted(Lane lane, uint64_t value);
+    uint64_t GetCompleted(Lane lane) const { return m_completed[(size_t)lane]; }
+    bool IsCompleted(JobId id) const { return GetCompleted(m_jobs[id].lane) >= m_jobs[id].signalValue; }
+    // how many jobs of the lane have been scheduled but haven't finished yet
+    uint64_t GetInFlight(Lane lane) const { return m_scheduled[(size_t)lane] - m_completed[(size_t)lane]; }
+
+private:
+    std::vector<Job> m_jobs;
+    Timeline m_scheduled = {};
+    Timeline m_completed = {};
+    // per lane, the values of the other lanes that its next job can already rely on
+    std::array<Timeline, LANE_COUNT> m_reached = {};
+};
@@ -0,0 +1,44 @@
+#include "quad_compositor.h"
+
+float QuadCompositor::GetFollowFactor(double deltaSeconds) {
+    if (deltaSeconds <= 0.0) {
+        return 0.0f;
+    }
+    // lerping by f once per reference frame leaves (1 - f)^frames of the way, which also holds for fractions of a frame
+    return (float)(1.0 - std::pow(1.0 - (double)FOLLOW_LERP_AT_90HZ, deltaSeconds * FOLLOW_REFERENCE_RATE));
+}
+
+glm::quat QuadCompositor::Follow(const glm::quat& current, const glm::quat& target, double deltaSeconds) {
+    return glm::slerp(current, target, GetFollowFactor(deltaSeconds));
+}
+
+XrPosef QuadCompositor::PlaceInFront(const glm::vec3& headPosition, const glm::quat& lookOrientation, float distance) {
+    const glm::vec3 forwardDirection = lookOrientation * glm::vec3(0.0f, 0.0f, -1.0f);
+    const glm::vec3 targetPosition = headPosition + (distance * forwardDirection);
+
+    // looking straight up or down leaves no horizontal direction to keep the quad upright with, so it's just turned towards the head
+    const glm::vec3 rightDirection = glm::cross(forwardDirection, glm::vec3(0.0f, 1.0f, 0.0f));
+    if (glm::length(rightDirection) < 1e-4f) {
+        return { .orientation = ToXR(lookOrientation), .position = ToXR(targetPosition) };
+    }
+
+    // recalculate up direction using right and forward direction
+    const glm::vec3 upDirection = glm::cross(glm::normalize(rightDirection), forwardDirection);
+    return { .orientation = ToXR(glm::quatLookAt(forwardDirection, upDirection)), .position = ToXR(targetPosition) };
+}
+
+XrExtent2Df QuadCompositor::GetQuadSize(float aspectRatio, float scale) {
+    const float width = aspectRatio > 1.0f ? aspectRatio : 1.0f;
+    const float height = aspectRatio <= 1.0f ? 1.0f / aspectRatio : 1.0f;
+    return { width * scale, height * scale };
+}
+
+QuadCompositor::Layers QuadCompositor::GetLayers() const {
+    Layers layers;
+    for (const auto& quad : m_quads) {
+        if (quad.has_value()) {
+            layers.quads[layers.count++] = *quad;
+        }
+    }
+    return layers;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// the quads that the 2D layer submits. every quad has a fixed slot, so that the layers of a frame are built without allocating, and the
+// version of the content that was last rendered into its swapchain, so that a quad whose content didn't change is submitted as is.
+// the pose math doesn't touch OpenXR or D3D12, so that it can be checked on its own.
+class QuadCompositor {
+public:
+    enum class Slot : uint8_t {
+        HUD,
+        LEFT_HAND, // debug quads that show where the controllers are
+        RIGHT_HAND,
+        COUNT
+    };
+    static constexpr size_t MAX_QUADS = (size_t)Slot::COUNT;
+
+    struct Layers {
+        std::array<XrCompositionLayerQuad, MAX_QUADS> quads = {};
+        uint32_t count = 0;
+
+        std::span<const XrCompositionLayerQuad> Get() const { return { quads.data(), count }; }
+    };
+
+    // the ui used to be slerped by a fixed amount every frame, which is kept as the speed at 90Hz
+    static constexpr float FOLLOW_LERP_AT_90HZ = 0.05f;
+    static constexpr double FOLLOW_REFERENCE_RATE = 90.0;
+
+    // how much of the remaining way to its target the ui moves in the given time
+    static float GetFollowFactor(double deltaSeconds);
+    static glm::quat Follow(const glm::quat& current, const glm::quat& target, double deltaSeconds);
+    // distance meters in front of the head along the looking direction, upright and facing back at the head
+    static XrPosef PlaceInFront(const glm::vec3& headPosition, const glm::quat& lookOrientation, float distance);
+    // the shorter side of the quad is scale meters long
+    static XrExtent2Df GetQuadSize(float aspectRatio, float scale);
+
+    void Show(Slot slot, const XrCompositionLayerQuad& quad) { m_quads[(size_t)slot] = quad; }
+    void Hide(Slot slot) { m_quads[(size_t)slot].reset(); }
+    // the visible quads in slot order, which is also the order in which they're blended
+    Layers GetLayers() const;
+
+    bool IsRendered(Slot slot, uint64_t contentVersion) const { return m_renderedVersions[(size_t)slot] == contentVersion; }
+    void OnRendered(Slot slot, uint64_t contentVersion) { m_renderedVersions[(size_t)slot] = contentVersion; }
+
+private:
+    std::array<std::optional<XrCompositionLayerQuad>, MAX_QUADS> m_quads = {};
+    std::array<uint64_t, MAX_QUADS> m_renderedVersions = {};
+};
@@ -8,9 +8,22 @@ RND_Renderer::RND_Renderer(XrSession xrSession): m_session(xrSession) {
     XrSessionBeginInfo m_sessionCreateInfo = { XR_TYPE_SESSION_BEGIN_INFO };
     m_sessionCreateInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
     checkXRResult(xrBeginSession(m_session, &m_sessionCreateInfo), "Failed to begin OpenXR session!");
+
+    m_submitThread = std::thread(&RND_Renderer::SubmitThread, this);
 }
 
 RND_Renderer::~RND_Renderer() {
+    {
+        std::scoped_lock lock(m_submitMutex);
+        m_stopSubmitThread = true;
+    }
+    m_submitCondition.notify_all();
+    if (m_submitThread.joinable()) {
+        m_submitThread.join();
+    }
+    // the layers' swapchains and textures could still be used by the present queue
+    VRManager::instance().D3D12->WaitForIdle();
+
     xrRequestExitSession(m_session);
     if (m_session != XR_NULL_HANDLE) {
         checkXRResult(xrEndSession(m_session), "Failed to end OpenXR session!");
@@ -32,6 +45,7 @@ void RND_Renderer::StartFrame() {
     auto waitStart = std::chrono::high_resolution_clock::now();
     checkXRResult(xrWaitFrame(m_session, &waitFrameInfo, &m_frameState), "Failed to wait for next frame!");
     m_lastWaitTimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - waitStart).count();
+    VRManager::instance().XR->GetPosePredictor().SetFrameTiming(m_frameState.predictedDisplayTime);
 
     // Runtime predicted cadence
     m_predictedDisplayPeriodMs = (double)m_frameState.predictedDisplayPeriod / 1e6;
@@ -49,6 +63,9 @@ void RND_Renderer::StartFrame() {
 
     m_frameStartTime = std::chrono::high_resolution_clock::now();
 
+    // xrWaitFrame can overlap with the previous xrEndFrame, but xrBeginFrame would discard that frame if it hasn't been submitted yet
+    WaitForSubmission();
+
     XrFrameBeginInfo beginFrameInfo = { XR_TYPE_FRAME_BEGIN_INFO };
     checkXRResult(xrBeginFrame(m_session, &beginFrameInfo), "Couldn't begin OpenXR frame!");
 
@@ -71,85 +88,199 @@ void RND_Renderer::EndFrame() {
     static uint32_t s_endFrameCount = 0;
     s_endFrameCount++;
 
-    std::vector<XrCompositionLayerBaseHeader*> compositionLayers;
+    const bool pipelined = !m_layer3D || m_layer3D->GetPresentOptions().pipelined;
+
+    // the submission thread is idle since StartFrame, so the previous frame's layers can be overwritten
+    FrameSubmission& submission = m_submission;
+    submission.displayTime = m_frameState.predictedDisplayTime;
+    submission.endFrameCount = s_endFrameCount;
+    submission.layer3D = { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
+    submission.layer2DQuads = {};
+    submission.layers.clear();
 
     m_presented2DLastFrame = false;
 
-    XrCompositionLayerProjection layer3D = { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
-    std::array<XrCompositionLayerProjectionView, 2> layer3DViews = {};
-    std::vector<XrCompositionLayerQuad> layer2DQuads;
+    // the eyes are composed on the present queue, and OpenXR's queue only waits for them before the swapchain images are released
+    RND_D3D12* d3d12 = VRManager::instance().D3D12.get();
+    PresentGraph& presentGraph = d3d12->GetPresentGraph();
+    const PresentGraph::JobId composeJob = presentGraph.Add("compose", PresentGraph::Lane::PRESENT);
+    const PresentGraph::JobId releaseJob = presentGraph.Add("release", PresentGraph::Lane::DIRECT, { composeJob });
+    const PresentGraph::JobId submitJob = presentGraph.Add("xrEndFrame", PresentGraph::Lane::SUBMIT, { releaseJob });
 
-    long frameIdx = -1;
-    if (m_renderFrames[0].Is3DComplete() && m_renderFrames[0].Is2DComplete()) {
-        frameIdx = 0;
+    // slots that the present queue has finished reading from can be captured into again
+    d3d12->PollLanes();
+    ReleaseCompletedFrames();
+
+    long frameIdx = m_frameRing.FindReadySlot();
+    if (frameIdx != -1 && !m_frameRing.Submit(frameIdx)) {
+        frameIdx = -1;
     }
-    else if (m_renderFrames[1].Is3DComplete() && m_renderFrames[1].Is2DComplete()) {
-        frameIdx = 1;
+
+    const bool render3D = frameIdx != -1 && m_layer3D && m_frameRing.Is3DComplete(frameIdx) && m_layer3D->CanCompose(m_renderFrames[frameIdx].renderedEyes);
+    const bool render2D = frameIdx != -1 && m_layer2D;
+
+    // without a new frame from Cemu, the last one is warped to where the head is now instead of leaving the world stuck to the head
+    const bool inGame = CemuHooks::IsInGame();
+    const Reprojection::Action action3D = m_layer3D ? m_layer3D->SelectAction(render3D, inGame && m_currViews.has_value()) : Reprojection::Action::SKIP;
+    const bool reproject3D = action3D == Reprojection::Action::REPROJECT;
+
+    // a swapchain that the runtime doesn't hand back in time skips its layer for this frame instead of stalling Cemu, and the layer
+    // is then submitted with the image that was last released, or left out if there isn't one yet
+    const SwapchainDeadline swapchainDeadline = SwapchainDeadline::FromDisplayPeriod(m_frameState.predictedDisplayPeriod);
+    // a reprojected frame is submitted with the views it was warped to, and there are none before the first tracked frame
+    const std::optional<std::array<XrView, 2>> views = render3D ? GetPoses(frameIdx) : m_currViews;
+    const bool rendered3D = (render3D || reproject3D) && views.has_value() && m_layer3D->StartRendering(swapchainDeadline);
+    // the HUD is only rendered again once a new one has been captured into the slot
+    const bool rendered2D = render2D && m_layer2D->NeedsRender(frameIdx) && m_layer2D->StartRendering(swapchainDeadline);
+
+    d3d12->BeginJob(composeJob);
+    if (rendered3D && render3D) {
+        // the history is only reprojected once Cemu misses a frame, which a slot that's already captured rules out for the next one,
+        // or for the eye that Cemu skips when the eyes alternate
+        const bool keepHistory = m_layer3D->GetPresentOptions().alternateEyes || !m_frameRing.Has3DCaptureBesides(frameIdx);
+        // an eye that Cemu didn't render for this slot is reprojected to the views that the other eye was rendered with
+        for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+            if ((m_renderFrames[frameIdx].renderedEyes & EyeScheduler::ToMask(side)) != 0) {
+                m_layer3D->Render(side, frameIdx, keepHistory);
+            }
+            else {
+                m_layer3D->Reproject(side, views.value());
+            }
+        }
     }
-    else if (m_renderFrames[0].Is2DComplete()) {
-        frameIdx = 0;
+    else if (rendered3D) {
+        m_layer3D->Reproject(OpenXR::EyeSide::LEFT, views.value());
+        m_layer3D->Reproject(OpenXR::EyeSide::RIGHT, views.value());
     }
-    else if (m_renderFrames[1].Is2DComplete()) {
-        frameIdx = 1;
+    if (rendered2D) {
+        m_layer2D->Render(frameIdx);
     }
+    d3d12->EndJob(composeJob);
+    d3d12->BeginJob(releaseJob);
+    d3d12->EndJob(releaseJob);
 
-    if (frameIdx != -1) {
-        if (m_layer3D) {
-            if (m_renderFrames[frameIdx].Is3DComplete()) {
-                m_layer3D->StartRendering();
-                m_layer3D->Render(OpenXR::EyeSide::LEFT, frameIdx);
-                m_layer3D->Render(OpenXR::EyeSide::RIGHT, frameIdx);
-                layer3DViews = m_layer3D->FinishRendering(frameIdx);
-                layer3D.layerFlags = 0;
-                layer3D.space = VRManager::instance().XR->m_stageSpace;
-                layer3D.viewCount = (uint32_t)layer3DViews.size();
-                layer3D.views = layer3DViews.data();
-                if (CemuHooks::IsInGame()) {
-                    m_renderFrames[frameIdx].presented3D = true;
-                    compositionLayers.emplace_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&layer3D));
-                }
-                else {
-                    m_renderFrames[frameIdx].presented3D = false;
-                }
-            } else {
-                m_renderFrames[frameIdx].presented3D = false;
-            }
+    std::optional<std::array<XrCompositionLayerProjectionView, 2>> views3D;
+    if (rendered3D) {
+        views3D = m_layer3D->FinishRendering(views.value());
+    }
+    else if (render3D || reproject3D) {
+        views3D = m_layer3D->GetLastProjectionViews();
+    }
+
+    const bool presented3D = views3D.has_value() && inGame;
+    if (presented3D) {
+        submission.layer3DViews = views3D.value();
+        submission.layer3D.layerFlags = 0;
+        submission.layer3D.space = VRManager::instance().XR->m_stageSpace;
+        submission.layer3D.viewCount = (uint32_t)submission.layer3DViews.size();
+        submission.layer3D.views = submission.layer3DViews.data();
+        submission.layers.emplace_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&submission.layer3D));
+    }
+
+    auto submit2D = [&](long quadFrameIdx, bool rendered) {
+        submission.layer2DQuads = m_layer2D->FinishRendering(m_frameState.predictedDisplayTime, quadFrameIdx, rendered);
+        m_presented2DLastFrame = true;
+        for (uint32_t i = 0; i < submission.layer2DQuads.count; i++) {
+            submission.layers.emplace_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&submission.layer2DQuads.quads[i]));
         }
+    };
 
-        if (m_layer2D) {
-            m_layer2D->StartRendering();
-            m_layer2D->Render(frameIdx);
-            layer2DQuads = m_layer2D->FinishRendering(m_frameState.predictedDisplayTime, frameIdx);
-            m_presented2DLastFrame = true;
-            for (auto& layer : layer2DQuads) {
-                compositionLayers.emplace_back(reinterpret_cast<XrCompositionLayerBaseHeader*>(&layer));
-            }
+    if (frameIdx != -1) {
+        m_renderFrames[frameIdx].presented3D = presented3D;
+
+        if (rendered2D || (render2D && m_layer2D->HasReleasedImage())) {
+            submit2D(frameIdx, rendered2D);
         }
 
-        m_renderFrames[frameIdx].Reset();
+        // the copies into the swapchains have only been recorded, so Cemu can't capture into the slot until the compose job has finished
+        m_frameRing.Present(frameIdx, presentGraph.GetJob(composeJob).signalValue);
+    }
+    else if (presented3D && m_layer2D && m_layer2D->HasReleasedImage()) {
+        // the HUD stays up with a reprojected frame instead of flickering whenever Cemu misses one
+        submit2D(m_layer2D->GetCurrentFrameIdx(), false);
     }
+    m_frameRing.OnEndFrame(frameIdx != -1);
 
     m_lastFrameWorkTimeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - m_frameStartTime).count();
 
-    XrFrameEndInfo frameEndInfo = { XR_TYPE_FRAME_END_INFO };
-    frameEndInfo.displayTime = m_frameState.predictedDisplayTime;
-    frameEndInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
-    frameEndInfo.layerCount = (uint32_t)compositionLayers.size();
-    frameEndInfo.layers = compositionLayers.data();
-
     if (s_endFrameCount % 500 == 0) {
-        Log::print<INTEROP>("EndFrame #{}: frameIdx={}, layers={}, 3D={}, 2D={}",
-            s_endFrameCount, frameIdx, compositionLayers.size(),
-            (frameIdx != -1 && m_renderFrames[frameIdx].presented3D) ? "yes" : "no",
-            m_presented2DLastFrame ? "yes" : "no");
+        Log::print<INTEROP>("EndFrame #{}: frameIdx={}, layers={}, 3D={}, 2D={}, pipelined={}",
+            s_endFrameCount, frameIdx, submission.layers.size(),
+            presented3D ? (render3D ? "yes" : "reprojected") : "no",
+            m_presented2DLastFrame ? "yes" : "no",
+            pipelined ? "yes" : "no");
+        m_frameRing.LogStats();
+    }
+
+    // xrEndFrame only needs the release job to have been submitted to OpenXR's queue, which it has been by now
+    m_submitValue = presentGraph.GetJob(submitJob).signalValue;
+    if (pipelined) {
+        QueueSubmission();
+        d3d12->EndFrame();
+    }
+    else {
+        SubmitFrame(submission);
+        presentGraph.OnCompleted(PresentGraph::Lane::SUBMIT, m_submitValue);
+        d3d12->EndFrame();
+        d3d12->WaitForIdle();
+        ReleaseCompletedFrames();
     }
+}
+
+void RND_Renderer::ReleaseCompletedFrames() {
+    const uint32_t releasedSlots = m_frameRing.ReleaseCompleted(VRManager::instance().D3D12->GetPresentGraph().GetCompleted(PresentGraph::Lane::PRESENT));
+    for (long i = 0; i < FRAME_RING_DEPTH; i++) {
+        if ((releasedSlots & (1u << i)) != 0) {
+            m_renderFrames[i].Reset();
+        }
+    }
+}
+
+void RND_Renderer::SubmitFrame(const FrameSubmission& submission) {
+    XrFrameEndInfo frameEndInfo = { XR_TYPE_FRAME_END_INFO };
+    frameEndInfo.displayTime = submission.displayTime;
+    frameEndInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+    frameEndInfo.layerCount = (uint32_t)submission.layers.size();
+    frameEndInfo.layers = submission.layers.data();
 
     XrResult xrResult = xrEndFrame(m_session, &frameEndInfo);
     if (XR_FAILED(xrResult)) {
-        Log::print<ERROR>("xrEndFrame #{} FAILED with result {}", s_endFrameCount, (int)xrResult);
+        Log::print<ERROR>("xrEndFrame #{} FAILED with result {}", submission.endFrameCount, (int)xrResult);
     }
+}
 
-    VRManager::instance().D3D12->EndFrame();
+void RND_Renderer::SubmitThread() {
+    std::unique_lock lock(m_submitMutex);
+    while (true) {
+        m_submitCondition.wait(lock, [this] { return m_submitQueued || m_stopSubmitThread; });
+        if (!m_submitQueued) {
+            break;
+        }
+
+        lock.unlock();
+        SubmitFrame(m_submission);
+        lock.lock();
+
+        m_submitQueued = false;
+        m_submitCondition.notify_all();
+    }
+}
+
+void RND_Renderer::QueueSubmission() {
+    {
+        std::scoped_lock lock(m_submitMutex);
+        checkAssert(!m_submitQueued, "The previous frame has to be submitted before the next one is queued!");
+        m_submitQueued = true;
+    }
+    m_submitCondition.notify_all();
+}
+
+void RND_Renderer::WaitForSubmission() {
+    std::unique_lock lock(m_submitMutex);
+    m_submitCondition.wait(lock, [this] { return !m_submitQueued; });
+    lock.unlock();
+
+    VRManager::instance().D3D12->GetPresentGraph().OnCompleted(PresentGraph::Lane::SUBMIT, m_submitValue);
 }
 
 RND_Renderer::Layer3D::Layer3D(VkExtent2D inputRes, VkExtent2D outputRes) {
@@ -160,17 +291,19 @@ RND_Renderer::Layer3D::Layer3D(VkExtent2D inputRes, VkExtent2D outputRes) {
 
     this->m_presentPipelines[OpenXR::EyeSide::LEFT] = std::make_unique<RND_D3D12::PresentPipeline<true>>(VRManager::instance().XR->GetRenderer());
     this->m_presentPipelines[OpenXR::EyeSide::RIGHT] = std::make_unique<RND_D3D12::PresentPipeline<true>>(VRManager::instance().XR->GetRenderer());
+    this->m_reprojectPipelines[OpenXR::EyeSide::LEFT] = std::make_unique<RND_D3D12::ReprojectPipeline>();
+    this->m_reprojectPipelines[OpenXR::EyeSide::RIGHT] = std::make_unique<RND_D3D12::ReprojectPipeline>();
 
-    this->m_swapchains[OpenXR::EyeSide::LEFT] = std::make_unique<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>(outputRes.width, outputRes.height, viewConfs[0].recommendedSwapchainSampleCount);
-    this->m_swapchains[OpenXR::EyeSide::RIGHT] = std::make_unique<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>(outputRes.width, outputRes.height, viewConfs[1].recommendedSwapchainSampleCount);
-    this->m_depthSwapchains[OpenXR::EyeSide::LEFT] = std::make_unique<Swapchain<DXGI_FORMAT_D32_FLOAT>>(outputRes.width, outputRes.height, viewConfs[0].recommendedSwapchainSampleCount);
-    this->m_depthSwapchains[OpenXR::EyeSide::RIGHT] = std::make_unique<Swapchain<DXGI_FORMAT_D32_FLOAT>>(outputRes.width, outputRes.height, viewConfs[1].recommendedSwapchainSampleCount);
+    this->m_swapchains[OpenXR::EyeSide::LEFT] = std::make_unique<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>("Layer3D Left Color", outputRes.width, outputRes.height, viewConfs[0].recommendedSwapchainSampleCount);
+    this->m_swapchains[OpenXR::EyeSide::RIGHT] = std::make_unique<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>("Layer3D Right Color", outputRes.width, outputRes.height, viewConfs[1].recommendedSwapchainSampleCount);
+    this->m_depthSwapchains[OpenXR::EyeSide::LEFT] = std::make_unique<Swapchain<DXGI_FORMAT_D32_FLOAT>>("Layer3D Left Depth", outputRes.width, outputRes.height, viewConfs[0].recommendedSwapchainSampleCount);
+    this->m_depthSwapchains[OpenXR::EyeSide::RIGHT] = std::make_unique<Swapchain<DXGI_FORMAT_D32_FLOAT>>("Layer3D Right Depth", outputRes.width, outputRes.height, viewConfs[1].recommendedSwapchainSampleCount);
 
     this->m_presentPipelines[OpenXR::EyeSide::LEFT]->BindSettings((float)outputRes.width, (float)outputRes.height);
     this->m_presentPipelines[OpenXR::EyeSide::RIGHT]->BindSettings((float)outputRes.width, (float)outputRes.height);
 
     // initialize textures
-    for (int i = 0; i < 2; ++i) {
+    for (int i = 0; i < FRAME_RING_DEPTH; ++i) {
         this->m_textures[OpenXR::EyeSide::LEFT][i] = std::make_unique<SharedTexture>(inputRes.width, inputRes.height, VK_FORMAT_B10G11R11_UFLOAT_PACK32, D3D12Utils::ToDXGIFormat(VK_FORMAT_B10G11R11_UFLOAT_PACK32));
         this->m_textures[OpenXR::EyeSide::RIGHT][i] = std::make_unique<SharedTexture>(inputRes.width, inputRes.height, VK_FORMAT_B10G11R11_UFLOAT_PACK32, D3D12Utils::ToDXGIFormat(VK_FORMAT_B10G11R11_UFLOAT_PACK32));
         this->m_depthTextures[OpenXR::EyeSide::LEFT][i] = std::make_unique<SharedTexture>(inputRes.width, inputRes.height, VK_FORMAT_D32_SFLOAT, D3D12Utils::ToDXGIFormat(VK_FORMAT_D32_SFLOAT));
@@ -190,7 +323,7 @@ RND_Renderer::Layer3D::Layer3D(VkExtent2D inputRes, VkExtent2D outputRes) {
 
         RND_D3D12::CommandContext<true> transitionInitialTextures(d3d12Device, d3d12Queue, cmdAllocator.Get(), [this](RND_D3D12::CommandContext<true>* context) {
             context->GetRecordList()->SetName(L"transitionInitialTextures");
-            for (int i = 0; i < 2; ++i) {
+            for (int i = 0; i < FRAME_RING_DEPTH; ++i) {
                 this->m_textures[OpenXR::EyeSide::LEFT][i]->d3d12TransitionLayout(context->GetRecordList(), D3D12_RESOURCE_STATE_COMMON);
                 this->m_textures[OpenXR::EyeSide::RIGHT][i]->d3d12TransitionLayout(context->GetRecordList(), D3D12_RESOURCE_STATE_COMMON);
                 this->m_depthTextures[OpenXR::EyeSide::LEFT][i]->d3d12TransitionLayout(context->GetRecordList(), D3D12_RESOURCE_STATE_COMMON);
@@ -201,6 +334,8 @@ RND_Renderer::Layer3D::Layer3D(VkExtent2D inputRes, VkExtent2D outputRes) {
 }
 
 RND_Renderer::Layer3D::~Layer3D() {
+    // the swapchain images and shared textures could be reallocated at the same addresses, so don't keep views of them around
+    VRManager::instance().D3D12->GetDescriptorArena()->ReleaseViews();
     for (auto& swapchain : m_swapchains) {
         swapchain.reset();
     }
@@ -209,7 +344,7 @@ RND_Renderer::Layer3D::~Layer3D() {
     }
 }
 
-SharedTexture* RND_Renderer::Layer3D::CopyColorToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx) {
+SharedTexture* RND_Renderer::Layer3D::CopyColorToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, BarrierPlanner& barriers, VkImage image, long frameIdx) {
     static uint32_t s_copyCount = 0;
     static VkImage s_lastSrcImage = VK_NULL_HANDLE;
     s_copyCount++;
@@ -224,12 +359,12 @@ SharedTexture* RND_Renderer::Layer3D::CopyColorToLayer(OpenXR::EyeSide side, VkC
     }
 
     m_currentFrameIdx = frameIdx;
-    m_textures[side][frameIdx]->CopyFromVkImage(copyCmdBuffer, image);
+    m_textures[side][frameIdx]->CopyFromVkImage(copyCmdBuffer, barriers, image);
     return m_textures[side][frameIdx].get();
 }
 
-SharedTexture* RND_Renderer::Layer3D::CopyDepthToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx) {
-    m_depthTextures[side][frameIdx]->CopyFromVkImage(copyCmdBuffer, image);
+SharedTexture* RND_Renderer::Layer3D::CopyDepthToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, BarrierPlanner& barriers, VkImage image, long frameIdx) {
+    m_depthTextures[side][frameIdx]->CopyFromVkImage(copyCmdBuffer, barriers, image);
     return m_depthTextures[side][frameIdx].get();
 }
 
@@ -260,34 +395,54 @@ std::optional<std::array<XrView, 2>> RND_Renderer::UpdateViews(XrTime predictedD
     return m_currViews;
 }
 
-void RND_Renderer::Layer3D::StartRendering() {
+EyeScheduler::Plan RND_Renderer::ScheduleEyes(long frameIdx, bool allowSingleEye) {
+    // the eye that's left out is reprojected from the history, which only exists once both eyes have been rendered with reprojection on
+    const bool canReproject = m_layer3D && m_layer3D->GetPresentOptions().alternateEyes && m_layer3D->GetPresentOptions().reprojection != Reprojection::Quality::OFF && m_layer3D->HasHistory();
+    const std::optional<std::array<XrView, 2>> views = m_currViews;
+
+    std::array<EyeScheduler::Pose, 2> poses = {};
+    if (views.has_value()) {
+        for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+            poses[side] = { ToGLM((*views)[side].pose.position), ToGLM((*views)[side].pose.orientation) };
+        }
+    }
+
+    std::scoped_lock lock(m_eyeSchedulerMutex);
+    m_eyePlan = m_eyeScheduler.Schedule((uint32_t)frameIdx, allowSingleEye && canReproject && views.has_value(), poses);
+    m_scheduledEyes[frameIdx].store(m_eyePlan.eyes, std::memory_order_release);
+    return m_eyePlan;
+}
+
+bool RND_Renderer::Layer3D::StartRendering(const SwapchainDeadline& deadline) {
     // checkAssert((this->m_textures[OpenXR::EyeSide::LEFT] == nullptr && this->m_textures[OpenXR::EyeSide::RIGHT] == nullptr) || (this->m_textures[OpenXR::EyeSide::LEFT] != nullptr && this->m_textures[OpenXR::EyeSide::RIGHT] != nullptr), "Both textures must be either null or not null");
     // checkAssert((this->m_depthTextures[OpenXR::EyeSide::LEFT] == nullptr && this->m_depthTextures[OpenXR::EyeSide::RIGHT] == nullptr) || (this->m_depthTextures[OpenXR::EyeSide::LEFT] != nullptr && this->m_depthTextures[OpenXR::EyeSide::RIGHT] != nullptr), "Both depth textures must be either null or not null");
     // checkAssert((this->m_textures[OpenXR::EyeSide::LEFT][0] == nullptr && this->m_textures[OpenXR::EyeSide::RIGHT][0] == nullptr) || (this->m_textures[OpenXR::EyeSide::LEFT][0] != nullptr && this->m_textures[OpenXR::EyeSide::RIGHT][0] != nullptr), "Both textures must be either null or not null");
     // checkAssert((this->m_depthTextures[OpenXR::EyeSide::LEFT][0] == nullptr && this->m_depthTextures[OpenXR::EyeSide::RIGHT][0] == nullptr) || (this->m_depthTextures[OpenXR::EyeSide::LEFT][0] != nullptr && this->m_depthTextures[OpenXR::EyeSide::RIGHT][0] != nullptr), "Both depth textures must be either null or not null");
 
-    this->m_swapchains[OpenXR::EyeSide::LEFT]->PrepareRendering();
-    this->m_swapchains[OpenXR::EyeSide::LEFT]->StartRendering();
-    this->m_depthSwapchains[OpenXR::EyeSide::LEFT]->PrepareRendering();
-    this->m_depthSwapchains[OpenXR::EyeSide::LEFT]->StartRendering();
-    this->m_swapchains[OpenXR::EyeSide::RIGHT]->PrepareRendering();
-    this->m_swapchains[OpenXR::EyeSide::RIGHT]->StartRendering();
-    this->m_depthSwapchains[OpenXR::EyeSide::RIGHT]->PrepareRendering();
-    this->m_depthSwapchains[OpenXR::EyeSide::RIGHT]->StartRendering();
+    // every swapchain is waited for even if an earlier one timed out, so that the ones that are ready don't have to be waited for next frame
+    bool isReady = this->m_swapchains[OpenXR::EyeSide::LEFT]->StartRendering(deadline);
+    isReady &= this->m_depthSwapchains[OpenXR::EyeSide::LEFT]->StartRendering(deadline);
+    isReady &= this->m_swapchains[OpenXR::EyeSide::RIGHT]->StartRendering(deadline);
+    isReady &= this->m_depthSwapchains[OpenXR::EyeSide::RIGHT]->StartRendering(deadline);
+    if (!isReady) {
+        return false;
+    }
+
+    return true;
 }
 
-void RND_Renderer::Layer3D::Render(OpenXR::EyeSide side, long frameIdx) {
+void RND_Renderer::Layer3D::Render(OpenXR::EyeSide side, long frameIdx, bool keepHistory) {
     ID3D12Device* device = VRManager::instance().D3D12->GetDevice();
-    ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetCommandQueue();
+    ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetPresentQueue();
     ID3D12CommandAllocator* allocator = VRManager::instance().D3D12->GetFrameAllocator();
 
-    RND_D3D12::CommandContext<false> renderSharedTexture(device, queue, allocator, [this, side, frameIdx](RND_D3D12::CommandContext<false>* context) {
+    RND_D3D12::CommandContext<false> renderSharedTexture(device, queue, allocator, [this, side, frameIdx, keepHistory](RND_D3D12::CommandContext<false>* context) {
         context->GetRecordList()->SetName(L"RenderSharedTexture");
         auto& texture = m_textures[side][frameIdx];
         auto& depthTexture = m_depthTextures[side][frameIdx];
 
-        context->WaitFor(texture.get(), texture->GetD3D12WaitValue());
-        context->WaitFor(depthTexture.get(), depthTexture->GetD3D12WaitValue());
+        context->WaitFor(texture.get(), texture->WaitForHandoff(HandoffTracker::Api::D3D12));
+        context->WaitFor(depthTexture.get(), depthTexture->WaitForHandoff(HandoffTracker::Api::D3D12));
 
         // swapchains are already in D3D12_RESOURCE_STATE_RENDER_TARGET and depth in D3D12_RESOURCE_STATE_DEPTH_WRITE according to OpenXR spec
 
@@ -299,13 +454,82 @@ void RND_Renderer::Layer3D::Render(OpenXR::EyeSide side, long frameIdx) {
 
         // no transition needed here as OpenXR requires the swapchain to be returned in RENDER_TARGET/DEPTH_WRITE too
 
-        context->Signal(texture.get(), texture->GetD3D12SignalValue());
-        context->Signal(depthTexture.get(), depthTexture->GetD3D12SignalValue());
+        // a history that isn't kept up to date is dropped, warping an older frame would move the world back in time
+        if (m_presentOptions.reprojection != Reprojection::Quality::OFF && keepHistory) {
+            CopyToHistory(context->GetRecordList(), side, frameIdx);
+        }
+        else {
+            m_history.isValid[side] = false;
+        }
+
+        context->Signal(texture.get(), texture->SignalHandoff(HandoffTracker::Api::D3D12));
+        context->Signal(depthTexture.get(), depthTexture->SignalHandoff(HandoffTracker::Api::D3D12));
     });
     // Log::print("[D3D12 - 3D Layer] Rendering finished");
 }
 
-const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::FinishRendering(long frameIdx) {
+void RND_Renderer::Layer3D::CopyToHistory(ID3D12GraphicsCommandList* cmdList, OpenXR::EyeSide side, long frameIdx) {
+    // without the views that the frame was rendered with it can't be warped anywhere
+    const std::optional<std::array<XrView, 2>> views = VRManager::instance().XR->GetRenderer()->GetPoses(frameIdx);
+    if (!views.has_value()) {
+        m_history.isValid[side] = false;
+        return;
+    }
+
+    ID3D12Resource* texture = m_textures[side][frameIdx]->d3d12GetTexture();
+    ID3D12Resource* depthTexture = m_depthTextures[side][frameIdx]->d3d12GetTexture();
+
+    // the copies decay back to COMMON after every use like the shared textures, so they don't need any state tracking
+    auto createCopy = [](ID3D12Resource* source, DXGI_FORMAT format, const wchar_t* name) {
+        D3D12_RESOURCE_DESC desc = source->GetDesc();
+        desc.Format = format;
+        desc.Flags = D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS;
+        D3D12_HEAP_PROPERTIES heapProperties = { .Type = D3D12_HEAP_TYPE_DEFAULT };
+
+        ComPtr<ID3D12Resource> copy;
+        checkHResult(VRManager::instance().D3D12->GetDevice()->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&copy)), "Failed to create reprojection history texture!");
+        copy->SetName(name);
+        return copy;
+    };
+    if (!m_history.colors[side]) {
+        m_history.colors[side] = createCopy(texture, texture->GetDesc().Format, side == OpenXR::EyeSide::LEFT ? L"Layer3D - Left Color History" : L"Layer3D - Right Color History");
+        m_history.depths[side] = createCopy(depthTexture, DXGI_FORMAT_R32_FLOAT, side == OpenXR::EyeSide::LEFT ? L"Layer3D - Left Depth History" : L"Layer3D - Right Depth History");
+    }
+
+    cmdList->CopyResource(m_history.colors[side].Get(), texture);
+    cmdList->CopyResource(m_history.depths[side].Get(), depthTexture);
+    m_history.views[side] = views.value()[side];
+    m_history.isValid[side] = true;
+}
+
+void RND_Renderer::Layer3D::Reproject(OpenXR::EyeSide side, const std::array<XrView, 2>& views) {
+    if (!m_history.isValid[side]) {
+        return;
+    }
+
+    ID3D12Device* device = VRManager::instance().D3D12->GetDevice();
+    ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetPresentQueue();
+    ID3D12CommandAllocator* allocator = VRManager::instance().D3D12->GetFrameAllocator();
+
+    const D3D12_RESOURCE_DESC historyDesc = m_history.colors[side]->GetDesc();
+    const Reprojection::Settings settings = Reprojection::GetSettings(
+        m_presentOptions.reprojection, Reprojection::ToEye(m_history.views[side]), Reprojection::ToEye(views[side]),
+        (uint32_t)historyDesc.Width, historyDesc.Height, m_swapchains[side]->GetWidth(), m_swapchains[side]->GetHeight(),
+        CemuHooks::GetSettings().GetZNear(), CemuHooks::GetSettings().GetZFar()
+    );
+
+    RND_D3D12::CommandContext<false> reprojectHistory(device, queue, allocator, [this, side, &settings](RND_D3D12::CommandContext<false>* context) {
+        context->GetRecordList()->SetName(L"ReprojectHistory");
+
+        m_reprojectPipelines[side]->BindAttachment(0, m_history.colors[side].Get());
+        m_reprojectPipelines[side]->BindAttachment(1, m_history.depths[side].Get());
+        m_reprojectPipelines[side]->BindTarget(m_swapchains[side]->GetTexture(), m_swapchains[side]->GetFormat());
+        m_reprojectPipelines[side]->BindDepthTarget(m_depthSwapchains[side]->GetTexture(), m_depthSwapchains[side]->GetFormat());
+        m_reprojectPipelines[side]->Render(context->GetRecordList(), m_swapchains[side]->GetTexture(), settings);
+    });
+}
+
+const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::FinishRendering(const std::array<XrView, 2>& views) {
     this->m_swapchains[OpenXR::EyeSide::LEFT]->FinishRendering();
     this->m_depthSwapchains[OpenXR::EyeSide::LEFT]->FinishRendering();
     this->m_swapchains[OpenXR::EyeSide::RIGHT]->FinishRendering();
@@ -315,8 +539,8 @@ const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::Fi
     m_projectionViews[OpenXR::EyeSide::LEFT] = {
         .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW,
         .next = &m_projectionViewsDepthInfo[OpenXR::EyeSide::LEFT],
-        .pose = VRManager::instance().XR->GetRenderer()->GetPose(OpenXR::EyeSide::LEFT, frameIdx).value(),
-        .fov = VRManager::instance().XR->GetRenderer()->GetFOV(OpenXR::EyeSide::LEFT, frameIdx).value(),
+        .pose = views[OpenXR::EyeSide::LEFT].pose,
+        .fov = views[OpenXR::EyeSide::LEFT].fov,
         .subImage = {
             .swapchain = this->m_swapchains[OpenXR::EyeSide::LEFT]->GetHandle(),
             .imageRect = {
@@ -348,8 +572,8 @@ const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::Fi
     m_projectionViews[OpenXR::EyeSide::RIGHT] = {
         .type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW,
         .next = &m_projectionViewsDepthInfo[OpenXR::EyeSide::RIGHT],
-        .pose = VRManager::instance().XR->GetRenderer()->GetPose(OpenXR::EyeSide::RIGHT, frameIdx).value(),
-        .fov = VRManager::instance().XR->GetRenderer()->GetFOV(OpenXR::EyeSide::RIGHT, frameIdx).value(),
+        .pose = views[OpenXR::EyeSide::RIGHT].pose,
+        .fov = views[OpenXR::EyeSide::RIGHT].fov,
         .subImage = {
             .swapchain = this->m_swapchains[OpenXR::EyeSide::RIGHT]->GetHandle(),
             .imageRect = {
@@ -382,18 +606,27 @@ const std::array<XrCompositionLayerProjectionView, 2>& RND_Renderer::Layer3D::Fi
     return m_projectionViews;
 }
 
+std::optional<std::array<XrCompositionLayerProjectionView, 2>> RND_Renderer::Layer3D::GetLastProjectionViews() const {
+    for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        if (!m_swapchains[side]->HasReleasedImage() || !m_depthSwapchains[side]->HasReleasedImage()) {
+            return std::nullopt;
+        }
+    }
+    return m_projectionViews;
+}
+
 
 RND_Renderer::Layer2D::Layer2D(VkExtent2D inputRes, VkExtent2D outputRes) {
     auto viewConfs = VRManager::instance().XR->GetViewConfigurations();
 
     this->m_presentPipeline = std::make_unique<RND_D3D12::PresentPipeline<false>>(VRManager::instance().XR->GetRenderer());
 
-    this->m_swapchain = std::make_unique<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>(inputRes.width, inputRes.height, viewConfs[0].recommendedSwapchainSampleCount);
+    this->m_swapchain = std::make_unique<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>("Layer2D", inputRes.width, inputRes.height, viewConfs[0].recommendedSwapchainSampleCount);
 
     this->m_presentPipeline->BindSettings(outputRes.width, outputRes.height);
 
     // initialize textures
-    for (int i = 0; i < 2; ++i) {
+    for (int i = 0; i < FRAME_RING_DEPTH; ++i) {
         this->m_textures[i] = std::make_unique<SharedTexture>(inputRes.width, inputRes.height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, D3D12Utils::ToDXGIFormat(VK_FORMAT_A2B10G10R10_UNORM_PACK32));
         this->m_textures[i]->d3d12GetTexture()->SetName(L"Layer2D - Color Texture");
     }
@@ -406,7 +639,7 @@ RND_Renderer::Layer2D::Layer2D(VkExtent2D inputRes, VkExtent2D outputRes) {
 
         RND_D3D12::CommandContext<true> transitionInitialTextures(d3d12Device, d3d12Queue, cmdAllocator.Get(), [this](RND_D3D12::CommandContext<true>* context) {
             context->GetRecordList()->SetName(L"transitionInitialTextures");
-            for (int i = 0; i < 2; ++i) {
+            for (int i = 0; i < FRAME_RING_DEPTH; ++i) {
                 this->m_textures[i]->d3d12TransitionLayout(context->GetRecordList(), D3D12_RESOURCE_STATE_COMMON);
             }
         });
@@ -414,10 +647,11 @@ RND_Renderer::Layer2D::Layer2D(VkExtent2D inputRes, VkExtent2D outputRes) {
 }
 
 RND_Renderer::Layer2D::~Layer2D() {
+    VRManager::instance().D3D12->GetDescriptorArena()->ReleaseViews();
     m_swapchain.reset();
 }
 
-SharedTexture* RND_Renderer::Layer2D::CopyColorToLayer(VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx) {
+SharedTexture* RND_Renderer::Layer2D::CopyColorToLayer(VkCommandBuffer copyCmdBuffer, BarrierPlanner& barriers, VkImage image, long frameIdx) {
     static uint32_t s_copyCount = 0;
     s_copyCount++;
     if (s_copyCount % 100 == 0) {
@@ -425,18 +659,18 @@ SharedTexture* RND_Renderer::Layer2D::CopyColorToLayer(VkCommandBuffer copyCmdBu
     }
 
     m_currentFrameIdx = frameIdx;
-    m_textures[frameIdx]->CopyFromVkImage(copyCmdBuffer, image);
+    m_contentVersions[frameIdx].store(++m_captureCount, std::memory_order_release);
+    m_textures[frameIdx]->CopyFromVkImage(copyCmdBuffer, barriers, image);
     return m_textures[frameIdx].get();
 }
 
-void RND_Renderer::Layer2D::StartRendering() const {
-    m_swapchain->PrepareRendering();
-    m_swapchain->StartRendering();
+bool RND_Renderer::Layer2D::StartRendering(const SwapchainDeadline& deadline) {
+    return m_swapchain->StartRendering(deadline);
 }
 
 void RND_Renderer::Layer2D::Render(long frameIdx) {
     ID3D12Device* device = VRManager::instance().D3D12->GetDevice();
-    ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetCommandQueue();
+    ID3D12CommandQueue* queue = VRManager::instance().D3D12->GetPresentQueue();
     ID3D12CommandAllocator* allocator = VRManager::instance().D3D12->GetFrameAllocator();
 
     RND_D3D12::CommandContext<false> renderSharedTexture(device, queue, allocator, [this, frameIdx](RND_D3D12::CommandContext<false>* context) {
@@ -445,148 +679,100 @@ void RND_Renderer::Layer2D::Render(long frameIdx) {
         // wait for both since we only have one 2D swap buffer to render to
         // fixme: Why do we signal to the global command list instead of the local one?!
         auto& texture = m_textures[frameIdx];
-        context->WaitFor(texture.get(), texture->GetD3D12WaitValue());
+        context->WaitFor(texture.get(), texture->WaitForHandoff(HandoffTracker::Api::D3D12));
 
         m_presentPipeline->BindAttachment(0, texture->d3d12GetTexture());
         m_presentPipeline->BindTarget(0, m_swapchain->GetTexture(), m_swapchain->GetFormat());
         m_presentPipeline->Render(context->GetRecordList(), m_swapchain->GetTexture());
 
-        context->Signal(texture.get(), texture->GetD3D12SignalValue());
+        context->Signal(texture.get(), texture->SignalHandoff(HandoffTracker::Api::D3D12));
     });
+    m_compositor.OnRendered(QuadCompositor::Slot::HUD, m_contentVersions[frameIdx].load(std::memory_order_acquire));
 }
 
-std::vector<XrCompositionLayerQuad> RND_Renderer::Layer2D::FinishRendering(XrTime predictedDisplayTime, long frameIdx) {
-    this->m_swapchain->FinishRendering();
+QuadCompositor::Layers RND_Renderer::Layer2D::FinishRendering(XrTime predictedDisplayTime, long frameIdx, bool rendered) {
+    if (rendered) {
+        this->m_swapchain->FinishRendering();
+    }
 
     XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
     xrLocateSpace(VRManager::instance().XR->m_headSpace, VRManager::instance().XR->m_stageSpace, predictedDisplayTime, &spaceLocation);
     glm::quat headOrientation = ToGLM(spaceLocation.pose.orientation);
     glm::vec3 headPosition = ToGLM(spaceLocation.pose.position);
 
+    // the ui catches up with the head by the time between frames instead of once per frame, so it follows equally fast at any refresh rate
+    if (m_lastDisplayTime != 0 && predictedDisplayTime > m_lastDisplayTime) {
+        m_currentOrientation = QuadCompositor::Follow(m_currentOrientation, headOrientation, (double)(predictedDisplayTime - m_lastDisplayTime) / 1e9);
+    }
+    else if (m_lastDisplayTime == 0) {
+        m_currentOrientation = headOrientation;
+    }
+    m_lastDisplayTime = predictedDisplayTime;
+
     constexpr float DISTANCE = 1.5f;
-    constexpr float LERP_SPEED = 0.05f;
+    // todo: change space to head space if we want to follow the head
+    constexpr float MENU_SIZE = 0.8f;
 
+    XrPosef hudPose;
     if (CemuHooks::GetSettings().UIFollowsLookingDirection()) {
-        m_currentOrientation = glm::slerp(m_currentOrientation, headOrientation, LERP_SPEED);
-        glm::vec3 forwardDirection = headOrientation * glm::vec3(0.0f, 0.0f, -1.0f);
-
-        // calculate new position forwards
-        glm::vec3 targetPosition = headPosition + (DISTANCE * forwardDirection);
-
-        // calculate rightward direction
-        glm::vec3 rightDirection = glm::normalize(glm::cross(forwardDirection, glm::vec3(0.0f, 1.0f, 0.0f)));
-
-        // recalculate up direction using right and forward direction
-        glm::vec3 upDirection = glm::cross(rightDirection, forwardDirection);
-        glm::quat userFacingOrientation = glm::quatLookAt(forwardDirection, upDirection);
-
-        spaceLocation.pose.orientation = ToXR(userFacingOrientation);
-        spaceLocation.pose.position = ToXR(targetPosition);
+        hudPose = QuadCompositor::PlaceInFront(headPosition, m_currentOrientation, DISTANCE);
     }
     else {
-        spaceLocation.pose.position.z -= DISTANCE;
-        spaceLocation.pose.orientation = { 0.0f, 0.0f, 0.0f, 1.0f };
+        hudPose = spaceLocation.pose;
+        hudPose.position.z -= DISTANCE;
+        hudPose.orientation = { 0.0f, 0.0f, 0.0f, 1.0f };
     }
 
     const float aspectRatio = (float)this->m_textures[frameIdx]->d3d12GetTexture()->GetDesc().Width / (float)this->m_textures[frameIdx]->d3d12GetTexture()->GetDesc().Height;
 
-    const float width = aspectRatio > 1.0f ? aspectRatio : 1.0f;
-    const float height = aspectRatio <= 1.0f ? 1.0f / aspectRatio : 1.0f;
-
-    // todo: change space to head space if we want to follow the head
-    constexpr float MENU_SIZE = 0.8f;
-
-    std::vector<XrCompositionLayerQuad> layers;
-
     // clang-format off
-    layers.push_back({
+    const XrSwapchainSubImage subImage = {
+        .swapchain = this->m_swapchain->GetHandle(),
+        .imageRect = {
+            .offset = { 0, 0 },
+            .extent = {
+                .width = (int32_t)this->m_swapchain->GetWidth(),
+                .height = (int32_t)this->m_swapchain->GetHeight()
+            }
+        }
+    };
+    m_compositor.Show(QuadCompositor::Slot::HUD, {
         .type = XR_TYPE_COMPOSITION_LAYER_QUAD,
         .layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT,
         .space = VRManager::instance().XR->m_stageSpace,
         .eyeVisibility = XR_EYE_VISIBILITY_BOTH,
-        .subImage = {
-            .swapchain = this->m_swapchain->GetHandle(),
-            .imageRect = {
-                .offset = { 0, 0 },
-                .extent = {
-                    .width = (int32_t)this->m_swapchain->GetWidth(),
-                    .height = (int32_t)this->m_swapchain->GetHeight()
-                }
-            }
-        },
-        .pose = spaceLocation.pose,
-        .size = { width * MENU_SIZE, height * MENU_SIZE }
+        .subImage = subImage,
+        .pose = hudPose,
+        .size = QuadCompositor::GetQuadSize(aspectRatio, MENU_SIZE)
     });
     // clang-format on
 
-    // render layer twice to visualize the controller positions in debug mode
+    // show the HUD on the controllers as well to visualize their positions in debug mode
     auto inputs = VRManager::instance().XR->m_input.load();
+    for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        const QuadCompositor::Slot slot = side == OpenXR::EyeSide::LEFT ? QuadCompositor::Slot::LEFT_HAND : QuadCompositor::Slot::RIGHT_HAND;
+        const XrSpaceLocation& location = inputs.inGame.poseLocation[side];
+        constexpr XrSpaceLocationFlags validFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+        if (!m_quadOptions.showControllerQuads || !inputs.inGame.in_game || !inputs.inGame.pose[side].isActive || (location.locationFlags & validFlags) != validFlags) {
+            m_compositor.Hide(slot);
+            continue;
+        }
 
-    if (!(inputs.inGame.in_game && inputs.inGame.pose[OpenXR::EyeSide::LEFT].isActive && inputs.inGame.pose[OpenXR::EyeSide::RIGHT].isActive)) {
-        return layers;
-    }
-
-    return layers;
-
-    auto movePoseToHandPosition = [](XrPosef& inputPose) {
-        glm::fquat modifiedRotation = ToGLM(inputPose.orientation);
-        glm::fvec3 modifiedPosition = ToGLM(inputPose.position);
-
-        modifiedRotation *= glm::angleAxis(glm::radians(-45.0f), glm::fvec3(1, 0, 0));
-
-
-        inputPose.orientation = ToXR(modifiedRotation);
-        inputPose.position = ToXR(modifiedPosition);
-    };
-
-    if ((inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) == 1 || (inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) == 1) {
-        movePoseToHandPosition(inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].pose);
-        // clang-format off
-        layers.push_back({
-            .type = XR_TYPE_COMPOSITION_LAYER_QUAD,
-            .layerFlags = 0,
-            .space = VRManager::instance().XR->m_stageSpace,
-            .eyeVisibility = XR_EYE_VISIBILITY_BOTH,
-            .subImage = {
-                .swapchain = this->m_swapchain->GetHandle(),
-                .imageRect = {
-                    .offset = { 0, 0 },
-                    .extent = {
-                        .width = (int32_t)this->m_swapchain->GetWidth(),
-                        .height = (int32_t)this->m_swapchain->GetHeight()
-                    }
-                }
-            },
-            .pose = inputs.inGame.poseLocation[OpenXR::EyeSide::LEFT].pose,
-            .size = { 0.15f, 0.15f }
-        });
-        // clang-format on
-    }
-
-    if ((inputs.inGame.poseLocation[OpenXR::EyeSide::RIGHT].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) == 1 || (inputs.inGame.poseLocation[OpenXR::EyeSide::RIGHT].locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) == 1) {
-        movePoseToHandPosition(inputs.inGame.poseLocation[OpenXR::EyeSide::RIGHT].pose);
+        XrPosef handPose = location.pose;
+        handPose.orientation = ToXR(ToGLM(handPose.orientation) * glm::angleAxis(glm::radians(-45.0f), glm::fvec3(1, 0, 0)));
 
         // clang-format off
-        layers.push_back({
+        m_compositor.Show(slot, {
             .type = XR_TYPE_COMPOSITION_LAYER_QUAD,
             .layerFlags = 0,
             .space = VRManager::instance().XR->m_stageSpace,
             .eyeVisibility = XR_EYE_VISIBILITY_BOTH,
-            .subImage = {
-                .swapchain = this->m_swapchain->GetHandle(),
-                .imageRect = {
-                    .offset = { 0, 0 },
-                    .extent = {
-                        .width = (int32_t)this->m_swapchain->GetWidth(),
-                        .height = (int32_t)this->m_swapchain->GetHeight()
-                    }
-                }
-            },
-            .pose = inputs.inGame.poseLocation[OpenXR::EyeSide::RIGHT].pose,
+            .subImage = subImage,
+            .pose = handPose,
             .size = { 0.15f, 0.15f }
         });
         // clang-format on
     }
 
-    return layers;
+    return m_compositor.GetLayers();
 }
\ No newline at end of file
@@ -5,6 +5,10 @@
 #include "openxr.h"
 #include "swapchain.h"
 #include "texture.h"
+#include "eye_scheduler.h"
+#include "frame_ring.h"
+#include "overlay_cache.h"
+#include "quad_compositor.h"
 
 class SharedTexture;
 
@@ -13,34 +17,33 @@ public:
     explicit RND_Renderer(XrSession xrSession);
     ~RND_Renderer();
 
+    // the graphic pack encodes the slot in the clear values as a parity bit, so there can't be more slots than that
+    static constexpr long FRAME_RING_DEPTH = 2;
+    static_assert(FRAME_RING_DEPTH == EyeScheduler::FRAME_SLOTS);
+
+    // resources and per-frame data of a slot, its capture state lives in m_frameRing
     struct RenderFrame {
         std::optional<std::array<XrView, 2>> views;
-        std::atomic_bool copiedColor[2] = { false, false };
-        std::atomic_bool copiedDepth[2] = { false, false };
-        std::atomic_bool copied2D = false;
         std::atomic_bool presented3D = false;
 
         std::unique_ptr<VulkanTexture> mainFramebuffer;
         std::unique_ptr<VulkanTexture> hudFramebuffer;
-        std::unique_ptr<VulkanTexture> hudWithoutAlphaFramebuffer;
         std::unique_ptr<VulkanFramebuffer> imguiFramebuffer;
         VkDescriptorSet mainFramebufferDS = VK_NULL_HANDLE;
         VkDescriptorSet hudFramebufferDS = VK_NULL_HANDLE;
         VkDescriptorSet hudWithoutAlphaFramebufferDS = VK_NULL_HANDLE;
         float mainFramebufferAspectRatio = 1.0f;
+        // bumped whenever Cemu's frame is copied into the background framebuffers, which the overlay can't tell from their descriptor sets
+        uint64_t mainFramebufferVersion = 0;
+        uint64_t hudFramebufferVersion = 0;
 
         bool ranMotionAnalysis[2] = { false, false };
-
-        bool Is3DComplete() const { return copiedColor[0] && copiedColor[1] && copiedDepth[0] && copiedDepth[1]; }
-        bool Is2DComplete() const { return copied2D; }
+        // the eyes that Cemu rendered into the slot, the others are reprojected from their last capture
+        uint8_t renderedEyes = EyeScheduler::BOTH_EYES;
 
         void Reset() {
             views = std::nullopt;
-            copiedColor[0] = false;
-            copiedColor[1] = false;
-            copiedDepth[0] = false;
-            copiedDepth[1] = false;
-            copied2D = false;
+            renderedEyes = EyeScheduler::BOTH_EYES;
 
             ranMotionAnalysis[0] = false;
             ranMotionAnalysis[1] = false;
@@ -91,18 +94,42 @@ public:
     double GetPredictedDisplayPeriodMs() const { return m_predictedDisplayPeriodMs; }
     double GetLastOverheadMs() const { return m_lastOverheadMs; }
 
+    bool CanCapture3DColor(OpenXR::EyeSide side, long frameIdx) const { return m_frameRing.CanCapture(frameIdx, ColorCapture(side)); }
+    bool CanCapture3DDepth(OpenXR::EyeSide side, long frameIdx) const { return m_frameRing.CanCapture(frameIdx, DepthCapture(side)); }
+    bool CanCapture2D(long frameIdx) const { return m_frameRing.CanCapture(frameIdx, CAPTURE_HUD); }
+
     void On3DColorCopied(OpenXR::EyeSide side, long frameIdx) {
-        m_renderFrames[frameIdx].copiedColor[side] = true;
-        if (!m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = m_currViews;
+        if (m_frameRing.MarkCaptured(frameIdx, ColorCapture(side)) && !m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = m_currViews;
+        {
+            std::scoped_lock lock(m_eyeSchedulerMutex);
+            m_eyeScheduler.OnCaptured(side, (uint32_t)frameIdx);
+        }
+        MarkReprojectedEye(frameIdx);
     }
 
     void On3DDepthCopied(OpenXR::EyeSide side, long frameIdx) {
-        m_renderFrames[frameIdx].copiedDepth[side] = true;
-        if (!m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = m_currViews;
+        if (m_frameRing.MarkCaptured(frameIdx, DepthCapture(side)) && !m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = m_currViews;
+        MarkReprojectedEye(frameIdx);
     }
 
     void On2DCopied(long frameIdx) {
-        m_renderFrames[frameIdx].copied2D = true;
+        m_frameRing.MarkCaptured(frameIdx, CAPTURE_HUD);
+    }
+
+    // picks the eyes that Cemu renders into the capture slot, which the game's first pass starts with
+    EyeScheduler::Plan ScheduleEyes(long frameIdx, bool allowSingleEye);
+    EyeScheduler::Stats GetEyeSchedulerStats() {
+        std::scoped_lock lock(m_eyeSchedulerMutex);
+        return m_eyeScheduler.GetStats();
+    }
+    bool IsSingleEyeFrame(long frameIdx) const { return m_scheduledEyes[frameIdx].load(std::memory_order_acquire) != EyeScheduler::BOTH_EYES; }
+    // whether the game's current frame skips its second pass, only valid on the PPC thread
+    bool IsSingleEyePass() const { return m_eyePlan.IsSingleEye(); }
+    // the eye that the game's pass renders, the first pass renders the scheduled eye if it's the only one
+    OpenXR::EyeSide GetRenderSide(OpenXR::EyeSide passSide) const { return passSide == OpenXR::EyeSide::LEFT ? (OpenXR::EyeSide)m_eyePlan.firstEye : passSide; }
+    // the eye that a capture of the game's pass belongs to, for the slot that the pass was scheduled for
+    OpenXR::EyeSide GetCaptureSide(OpenXR::EyeSide passSide, long frameIdx) const {
+        return passSide == OpenXR::EyeSide::LEFT && m_scheduledEyes[frameIdx].load(std::memory_order_acquire) == EyeScheduler::RIGHT_EYE ? OpenXR::EyeSide::RIGHT : passSide;
     }
 
     RenderFrame& GetFrame(long frameIdx) { return m_renderFrames[frameIdx]; }
@@ -110,56 +137,123 @@ public:
 
     class Layer3D {
     public:
+        // changed from the debug overlay
+        struct PresentOptions {
+            // compose on the present queue and call xrEndFrame from the submission thread instead of waiting for both every frame
+            bool pipelined = true;
+            // how the last frame is warped to the current pose when Cemu misses one
+            Reprojection::Quality reprojection = Reprojection::Quality::MEDIUM;
+            // let Cemu render a single eye per frame where the scene allows it and reproject the other one, see EyeScheduler
+            bool alternateEyes = false;
+        };
+
         explicit Layer3D(VkExtent2D inputRes, VkExtent2D outputRes);
         ~Layer3D();
 
-        SharedTexture* CopyColorToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx);
-        SharedTexture* CopyDepthToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx);
+        SharedTexture* CopyColorToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, BarrierPlanner& barriers, VkImage image, long frameIdx);
+        SharedTexture* CopyDepthToLayer(OpenXR::EyeSide side, VkCommandBuffer copyCmdBuffer, BarrierPlanner& barriers, VkImage image, long frameIdx);
         void PrepareRendering(OpenXR::EyeSide side);
-        void StartRendering();
-        void Render(OpenXR::EyeSide side, long frameIdx);
-        const std::array<XrCompositionLayerProjectionView, 2>& FinishRendering(long frameIdx);
+        // returns false if any of the swapchain images wasn't ready before the deadline, the layer isn't rendered this frame then
+        bool StartRendering(const SwapchainDeadline& deadline);
+        // keepHistory copies the eye into the history that later frames are reprojected from, which can be left out if none will be
+        void Render(OpenXR::EyeSide side, long frameIdx, bool keepHistory);
+        // warps the eye's last rendered frame to the given views instead of rendering a new one, does nothing if there isn't one yet
+        void Reproject(OpenXR::EyeSide side, const std::array<XrView, 2>& views);
+        const std::array<XrCompositionLayerProjectionView, 2>& FinishRendering(const std::array<XrView, 2>& views);
+        // the views that were last submitted with the images that the swapchains still hold, unless nothing has been released yet
+        std::optional<std::array<XrCompositionLayerProjectionView, 2>> GetLastProjectionViews() const;
 
         float GetAspectRatio(OpenXR::EyeSide side) const { return m_recommendedAspectRatios[side]; }
         long GetCurrentFrameIdx() const { return m_currentFrameIdx; }
+        // whether this frame presents a new frame, reprojects the last one or leaves the 3D layer out
+        Reprojection::Action SelectAction(bool hasNewFrame, bool canReproject) { return m_reprojection.Select(hasNewFrame, canReproject && HasHistory(), m_presentOptions.reprojection); }
+        bool HasHistory() const { return m_history.isValid[OpenXR::EyeSide::LEFT] && m_history.isValid[OpenXR::EyeSide::RIGHT]; }
+        // an eye that Cemu didn't render for the slot can only be reprojected if it has been rendered before
+        bool CanCompose(uint8_t renderedEyes) const {
+            return ((renderedEyes & EyeScheduler::LEFT_EYE) != 0 || m_history.isValid[OpenXR::EyeSide::LEFT]) && ((renderedEyes & EyeScheduler::RIGHT_EYE) != 0 || m_history.isValid[OpenXR::EyeSide::RIGHT]);
+        }
+
+        PresentOptions& GetPresentOptions() { return m_presentOptions; }
+        // the color and then the depth swapchain of each eye
+        std::array<std::pair<const char*, SwapchainStats>, 4> GetSwapchainStats() const {
+            return { {
+                { m_swapchains[OpenXR::EyeSide::LEFT]->GetName(), m_swapchains[OpenXR::EyeSide::LEFT]->GetStats() },
+                { m_depthSwapchains[OpenXR::EyeSide::LEFT]->GetName(), m_depthSwapchains[OpenXR::EyeSide::LEFT]->GetStats() },
+                { m_swapchains[OpenXR::EyeSide::RIGHT]->GetName(), m_swapchains[OpenXR::EyeSide::RIGHT]->GetStats() },
+                { m_depthSwapchains[OpenXR::EyeSide::RIGHT]->GetName(), m_depthSwapchains[OpenXR::EyeSide::RIGHT]->GetStats() }
+            } };
+        }
 
     private:
+        // copies of the last rendered frame, since the shared textures are captured into again once their slot is released
+        struct History {
+            std::array<ComPtr<ID3D12Resource>, 2> colors;
+            std::array<ComPtr<ID3D12Resource>, 2> depths;
+            std::array<XrView, 2> views = {};
+            std::array<bool, 2> isValid = { false, false };
+        };
+
+        void CopyToHistory(ID3D12GraphicsCommandList* cmdList, OpenXR::EyeSide side, long frameIdx);
+
         std::array<std::unique_ptr<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>>, 2> m_swapchains;
         std::array<std::unique_ptr<Swapchain<DXGI_FORMAT_D32_FLOAT>>, 2> m_depthSwapchains;
         std::array<std::unique_ptr<RND_D3D12::PresentPipeline<true>>, 2> m_presentPipelines;
-        std::array<std::array<std::unique_ptr<SharedTexture>, 2>, 2> m_textures;
-        std::array<std::array<std::unique_ptr<SharedTexture>, 2>, 2> m_depthTextures;
+        std::array<std::unique_ptr<RND_D3D12::ReprojectPipeline>, 2> m_reprojectPipelines;
+        std::array<std::array<std::unique_ptr<SharedTexture>, FRAME_RING_DEPTH>, 2> m_textures;
+        std::array<std::array<std::unique_ptr<SharedTexture>, FRAME_RING_DEPTH>, 2> m_depthTextures;
         std::array<float, 2> m_recommendedAspectRatios = { 1.0f, 1.0f };
 
         std::array<XrCompositionLayerProjectionView, 2> m_projectionViews = {};
         std::array<XrCompositionLayerDepthInfoKHR, 2> m_projectionViewsDepthInfo = {};
 
+        PresentOptions m_presentOptions;
+
+        History m_history;
+        Reprojection m_reprojection;
+
         long m_currentFrameIdx = 0;
     };
 
     class Layer2D {
     public:
+        // changed from the debug overlay
+        struct QuadOptions {
+            bool showControllerQuads = false;
+        };
+
         explicit Layer2D(VkExtent2D inputRes, VkExtent2D outputRes);
         ~Layer2D();
 
-        SharedTexture* CopyColorToLayer(VkCommandBuffer copyCmdBuffer, VkImage image, long frameIdx);
-        // AMD GPU FIX: With incrementing values, Vulkan signals odd values (1,3,5...), D3D12 signals even values (2,4,6...)
-        // Texture is ready for D3D12 when Vulkan has signaled (odd value > 0)
+        SharedTexture* CopyColorToLayer(VkCommandBuffer copyCmdBuffer, BarrierPlanner& barriers, VkImage image, long frameIdx);
+        // the texture is ready for D3D12 when vulkan was the last one to signal it
         bool IsTextureReady(long frameIdx) const {
-            uint64_t lastSignal = m_textures[frameIdx]->GetLastSignalledValue();
-            return lastSignal > 0 && (lastSignal % 2 == 1);
+            return m_textures[frameIdx]->GetLastProducer() == HandoffTracker::Api::VULKAN;
         };
-        void StartRendering() const;
+        // whether the slot holds a capture that hasn't been rendered into the swapchain yet
+        bool NeedsRender(long frameIdx) const { return !m_compositor.IsRendered(QuadCompositor::Slot::HUD, m_contentVersions[frameIdx].load(std::memory_order_acquire)); }
+        // returns false if the swapchain image wasn't ready before the deadline, the layer isn't rendered this frame then
+        bool StartRendering(const SwapchainDeadline& deadline);
         void Render(long frameIdx);
-        std::vector<XrCompositionLayerQuad> FinishRendering(XrTime predictedDisplayTime, long frameIdx);
+        // the swapchain image is only released if it was rendered to, otherwise the quads show the last image that was released
+        QuadCompositor::Layers FinishRendering(XrTime predictedDisplayTime, long frameIdx, bool rendered);
+        bool HasReleasedImage() const { return m_swapchain->HasReleasedImage(); }
+        std::pair<const char*, SwapchainStats> GetSwapchainStats() const { return { m_swapchain->GetName(), m_swapchain->GetStats() }; }
+
+        QuadOptions& GetQuadOptions() { return m_quadOptions; }
         long GetCurrentFrameIdx() const { return m_currentFrameIdx; }
 
     private:
         std::unique_ptr<Swapchain<DXGI_FORMAT_R8G8B8A8_UNORM_SRGB>> m_swapchain;
         std::unique_ptr<RND_D3D12::PresentPipeline<false>> m_presentPipeline;
-        std::array<std::unique_ptr<SharedTexture>, 2> m_textures;
+        std::array<std::unique_ptr<SharedTexture>, FRAME_RING_DEPTH> m_textures;
+        // bumped by every capture on Cemu's vulkan thread, so that a slot that's presented again without a new capture isn't rendered twice
+        std::array<std::atomic_uint64_t, FRAME_RING_DEPTH> m_contentVersions = {};
+        uint64_t m_captureCount = 0; // only used from the vulkan thread
 
+        QuadCompositor m_compositor;
+        QuadOptions m_quadOptions;
         glm::quat m_currentOrientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        XrTime m_lastDisplayTime = 0;
 
         long m_currentFrameIdx = 0;
     };
@@ -172,11 +266,13 @@ public:
         bool ShouldBlockGameInput() { return ImGui::GetIO().WantCaptureKeyboard; }
 
         void BeginFrame(long frameIdx, bool renderBackground);
-        static void Draw3DLayerAsBackground(VkCommandBuffer cb, VkImage srcImage, float aspectRatio, long frameIdx);
-        static void DrawHUDLayerAsBackground(VkCommandBuffer cb, VkImage srcImage, long frameIdx);
+        static void Draw3DLayerAsBackground(VkCommandBuffer cb, BarrierPlanner& barriers, VkImage srcImage, float aspectRatio, long frameIdx);
+        static void DrawHUDLayerAsBackground(VkCommandBuffer cb, BarrierPlanner& barriers, VkImage srcImage, long frameIdx);
         void Update();
         void Render();
-        void DrawAndCopyToImage(VkCommandBuffer cb, VkImage destImage, long frameIdx);
+        void DrawAndCopyToImage(VkCommandBuffer cb, BarrierPlanner& barriers, VkImage destImage, long frameIdx);
+
+        OverlayDrawCache::Stats GetDrawCacheStats() const { return m_drawCache.GetStats(); }
 
     private:
         VkDescriptorPool m_descriptorPool;
@@ -186,6 +282,8 @@ public:
         HWND m_cemuRenderWindow = nullptr;
 
         VkSampler m_sampler = VK_NULL_HANDLE;
+        // every frame slot has its own imgui framebuffer
+        OverlayDrawCache m_drawCache = OverlayDrawCache(FRAME_RING_DEPTH);
 
         uint8_t m_showAppMS = 0;
         bool m_wasF3Pressed = false;
@@ -206,10 +304,57 @@ public:
     }
 
 protected:
+    // the eye that Cemu doesn't render for a slot counts as captured, since it's reprojected when the slot is presented
+    void MarkReprojectedEye(long frameIdx) {
+        const uint8_t eyes = m_scheduledEyes[frameIdx].load(std::memory_order_acquire);
+        if (eyes == EyeScheduler::BOTH_EYES) {
+            return;
+        }
+        m_renderFrames[frameIdx].renderedEyes = eyes;
+        const OpenXR::EyeSide reprojectedSide = eyes == EyeScheduler::LEFT_EYE ? OpenXR::EyeSide::RIGHT : OpenXR::EyeSide::LEFT;
+        for (FrameCapture capture : { ColorCapture(reprojectedSide), DepthCapture(reprojectedSide) }) {
+            if (m_frameRing.CanCapture(frameIdx, capture)) {
+                m_frameRing.MarkCaptured(frameIdx, capture);
+            }
+        }
+    }
+
+    // the layers that are handed to the submission thread, they're kept alive until its xrEndFrame has returned
+    struct FrameSubmission {
+        XrTime displayTime = 0;
+        uint32_t endFrameCount = 0;
+        XrCompositionLayerProjection layer3D = { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
+        std::array<XrCompositionLayerProjectionView, 2> layer3DViews = {};
+        QuadCompositor::Layers layer2DQuads;
+        std::vector<XrCompositionLayerBaseHeader*> layers;
+    };
+
+    void SubmitFrame(const FrameSubmission& submission);
+    void SubmitThread();
+    void QueueSubmission();
+    void WaitForSubmission();
+    // hands the slots that the present queue has finished reading back to the capture hooks
+    void ReleaseCompletedFrames();
+
     XrSession m_session;
     XrFrameState m_frameState = { XR_TYPE_FRAME_STATE };
     std::optional<std::array<XrView, 2>> m_currViews;
-    std::array<RenderFrame, 2> m_renderFrames;
+    std::array<RenderFrame, FRAME_RING_DEPTH> m_renderFrames;
+    FrameRing<FRAME_RING_DEPTH> m_frameRing;
+
+    // scheduled from the PPC thread, but captures are reported from Cemu's vulkan thread
+    std::mutex m_eyeSchedulerMutex;
+    EyeScheduler m_eyeScheduler;
+    EyeScheduler::Plan m_eyePlan;
+    std::array<std::atomic_uint8_t, FRAME_RING_DEPTH> m_scheduledEyes = { EyeScheduler::BOTH_EYES, EyeScheduler::BOTH_EYES };
+
+    FrameSubmission m_submission;
+    std::thread m_submitThread;
+    std::mutex m_submitMutex;
+    std::condition_variable m_submitCondition;
+    bool m_submitQueued = false;
+    bool m_stopSubmitThread = false;
+    uint64_t m_submitValue = 0; // the submit lane's value once the last queued xrEndFrame has returned
 
     std::atomic_bool m_isInitialized = false;
     std::atomic_bool m_presented2DLastFrame = false;
@@ -0,0 +1,194 @@
+#include "reprojection.h"
+
+namespace {
+    // the same corner order as cellCorners in reprojectHLSL
+    const std::array<glm::ivec2, 6> CELL_CORNERS = { glm::ivec2(0, 0), glm::ivec2(1, 0), glm::ivec2(0, 1), glm::ivec2(0, 1), glm::ivec2(1, 0), glm::ivec2(1, 1) };
+}
+
+uint32_t Reprojection::GetCellSize(Quality quality) {
+    switch (quality) {
+        case Quality::LOW: return 32;
+        case Quality::MEDIUM: return 8;
+        case Quality::HIGH: return 4;
+        default: return 0;
+    }
+}
+
+glm::fmat4 Reprojection::GetProjection(const XrFovf& fov, float nearZ, float farZ) {
+    const float tanLeft = std::tan(fov.angleLeft);
+    const float tanRight = std::tan(fov.angleRight);
+    const float tanUp = std::tan(fov.angleUp);
+    const float tanDown = std::tan(fov.angleDown);
+
+    glm::fmat4 projection(0.0f);
+    projection[0][0] = 2.0f / (tanRight - tanLeft);
+    projection[2][0] = (tanRight + tanLeft) / (tanRight - tanLeft);
+    projection[1][1] = 2.0f / (tanUp - tanDown);
+    projection[2][1] = (tanUp + tanDown) / (tanUp - tanDown);
+    projection[2][2] = -farZ / (farZ - nearZ);
+    projection[3][2] = -(farZ * nearZ) / (farZ - nearZ);
+    projection[2][3] = -1.0f;
+    return projection;
+}
+
+glm::fmat4 Reprojection::GetReprojection(const Eye& from, const Eye& to, float nearZ, float farZ, bool positional) {
+    const glm::fvec3 fromPosition = positional ? from.position : glm::fvec3(0.0f);
+    const glm::fvec3 toPosition = positional ? to.position : glm::fvec3(0.0f);
+    const glm::fmat4 fromViewToWorld = ToMat4(fromPosition, from.orientation);
+    const glm::fmat4 toViewToWorld = ToMat4(toPosition, to.orientation);
+    return GetProjection(to.fov, nearZ, farZ) * glm::inverse(toViewToWorld) * fromViewToWorld * glm::inverse(GetProjection(from.fov, nearZ, farZ));
+}
+
+Reprojection::Settings Reprojection::GetSettings(Quality quality, const Eye& from, const Eye& to, uint32_t textureWidth, uint32_t textureHeight, uint32_t targetWidth, uint32_t targetHeight, float nearZ, float farZ) {
+    const uint32_t cellSize = std::max<uint32_t>(GetCellSize(quality), 1);
+    const bool positional = quality != Quality::LOW;
+    return {
+        .reprojection = GetReprojection(from, to, nearZ, farZ, positional),
+        .cellsX = (textureWidth + cellSize - 1) / cellSize,
+        .cellsY = (textureHeight + cellSize - 1) / cellSize,
+        .cellSize = (float)cellSize,
+        .holeTolerance = positional ? HOLE_TOLERANCE : 0.0f,
+        .textureWidth = (float)textureWidth,
+        .textureHeight = (float)textureHeight,
+        .targetWidth = (float)targetWidth,
+        .targetHeight = (float)targetHeight,
+    };
+}
+
+Reprojection::Vertex Reprojection::GetVertex(const Settings& settings, uint32_t vertexId, const DepthFn& depthAt) {
+    const glm::ivec2 textureSize = glm::ivec2((int32_t)settings.textureWidth, (int32_t)settings.textureHeight);
+
+    const uint32_t cell = vertexId / 6;
+    const glm::ivec2 gridPosition = glm::ivec2((int32_t)(cell % settings.cellsX), (int32_t)(cell / settings.cellsX)) + CELL_CORNERS[vertexId % 6];
+    const glm::fvec2 position = glm::min(glm::fvec2(gridPosition) * settings.cellSize, glm::fvec2(textureSize));
+    const glm::ivec2 texel = glm::clamp(glm::ivec2(position), glm::ivec2(0), textureSize - 1);
+    const glm::fvec2 uv = position / glm::fvec2(textureSize);
+
+    return {
+        .position = settings.reprojection * glm::fvec4(uv.x * 2.0f - 1.0f, 1.0f - uv.y * 2.0f, depthAt(texel.x, texel.y), 1.0f),
+        .uv = uv
+    };
+}
+
+glm::ivec2 Reprojection::GetSampleTexel(const Settings& settings, glm::fvec2 pixelCenter, glm::fvec2 uv, const DepthFn& depthAt) {
+    const glm::fvec2 textureSize = glm::fvec2(settings.textureWidth, settings.textureHeight);
+    const glm::fvec2 targetSize = glm::fvec2(settings.targetWidth, settings.targetHeight);
+    const glm::ivec2 maxTexel = glm::ivec2(textureSize) - 1;
+    const glm::ivec2 texel = glm::clamp(glm::ivec2(glm::floor(uv * textureSize)), glm::ivec2(0), maxTexel);
+    if (settings.holeTolerance <= 0.0f) {
+        return texel;
+    }
+
+    // a triangle that's stretched across the hole behind an edge interpolates between the texels of both sides, which each belong
+    // somewhere else. a texel that's reprojected close to the pixel belongs there, like every texel of a triangle that isn't stretched.
+    const glm::fvec2 texelUV = (glm::fvec2(texel) + 0.5f) / textureSize;
+    const glm::fvec4 clip = settings.reprojection * glm::fvec4(texelUV.x * 2.0f - 1.0f, 1.0f - texelUV.y * 2.0f, depthAt(texel.x, texel.y), 1.0f);
+    if (clip.w > 1e-6f) {
+        const glm::fvec2 reprojectedPixel = glm::fvec2(clip.x / clip.w * 0.5f + 0.5f, 0.5f - clip.y / clip.w * 0.5f) * targetSize;
+        if (glm::length(reprojectedPixel - pixelCenter) <= settings.holeTolerance) {
+            return texel;
+        }
+    }
+
+    // the hole shows what was behind the edge, which is best guessed by the farthest texel within a cell
+    const int32_t step = (int32_t)settings.cellSize;
+    const std::array<glm::ivec2, 5> offsets = { glm::ivec2(0, 0), glm::ivec2(-step, 0), glm::ivec2(step, 0), glm::ivec2(0, -step), glm::ivec2(0, step) };
+    glm::ivec2 farthestTexel = texel;
+    float farthestDepth = -1.0f;
+    for (const glm::ivec2& offset : offsets) {
+        const glm::ivec2 candidate = glm::clamp(texel + offset, glm::ivec2(0), maxTexel);
+        const float depth = depthAt(candidate.x, candidate.y);
+        if (depth > farthestDepth) {
+            farthestDepth = depth;
+            farthestTexel = candidate;
+        }
+    }
+    return farthestTexel;
+}
+
+void Reprojection::Warp(const Settings& settings, const Image& source, Image& target) {
+    checkAssert(source.width == (uint32_t)settings.textureWidth && source.height == (uint32_t)settings.textureHeight, "The settings weren't made for this source image!");
+    checkAssert(target.width == (uint32_t)settings.targetWidth && target.height == (uint32_t)settings.targetHeight, "The settings weren't made for this target image!");
+
+    const DepthFn depthAt = [&source](int32_t x, int32_t y) { return source.DepthAt(x, y); };
+    const glm::fvec2 targetSize = glm::fvec2((float)target.width, (float)target.height);
+
+    const uint32_t vertexCount = GetVertexCount(settings);
+    for (uint32_t first = 0; first < vertexCount; first += 3) {
+        std::array<Vertex, 3> vertices;
+        std::array<glm::fvec3, 3> screen; // pixel coordinates and device depth
+        bool isBehind = false;
+        for (uint32_t i = 0; i < 3; i++) {
+            vertices[i] = GetVertex(settings, first + i, depthAt);
+            const glm::fvec4& clip = vertices[i].position;
+            isBehind |= clip.w <= 1e-6f;
+            screen[i] = glm::fvec3((clip.x / clip.w * 0.5f + 0.5f) * targetSize.x, (0.5f - clip.y / clip.w * 0.5f) * targetSize.y, clip.z / clip.w);
+        }
+        if (isBehind) {
+            continue;
+        }
+
+        auto edge = [](const glm::fvec3& a, const glm::fvec3& b, glm::fvec2 p) { return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x); };
+        const float area = edge(screen[0], screen[1], glm::fvec2(screen[2]));
+        if (area == 0.0f) {
+            continue;
+        }
+        auto getWeights = [&](glm::fvec2 p) { return glm::fvec3(edge(screen[1], screen[2], p), edge(screen[2], screen[0], p), edge(screen[0], screen[1], p)) / area; };
+        // perspective correct, like the interpolation of the uv between the vertex and pixel shader
+        auto getUV = [&](glm::fvec2 p) {
+            const glm::fvec3 weights = getWeights(p) / glm::fvec3(vertices[0].position.w, vertices[1].position.w, vertices[2].position.w);
+            return (weights.x * vertices[0].uv + weights.y * vertices[1].uv + weights.z * vertices[2].uv) / (weights.x + weights.y + weights.z);
+        };
+
+        // the grid folds over itself where the pose moved behind an edge, so both windings are drawn like with culling disabled
+        const int32_t minX = std::max((int32_t)std::floor(std::min({ screen[0].x, screen[1].x, screen[2].x })), 0);
+        const int32_t maxX = std::min((int32_t)std::ceil(std::max({ screen[0].x, screen[1].x, screen[2].x })), (int32_t)target.width - 1);
+        const int32_t minY = std::max((int32_t)std::floor(std::min({ screen[0].y, screen[1].y, screen[2].y })), 0);
+        const int32_t maxY = std::min((int32_t)std::ceil(std::max({ screen[0].y, screen[1].y, screen[2].y })), (int32_t)target.height - 1);
+        for (int32_t y = minY; y <= maxY; y++) {
+            for (int32_t x = minX; x <= maxX; x++) {
+                const glm::fvec2 pixelCenter = glm::fvec2((float)x + 0.5f, (float)y + 0.5f);
+                const glm::fvec3 weights = getWeights(pixelCenter);
+                if (weights.x < 0.0f || weights.y < 0.0f || weights.z < 0.0f) {
+                    continue;
+                }
+
+                // the depth clip is disabled on the gpu, so the sky that's moved past the far plane is clamped instead of cut off
+                const float depth = std::clamp(weights.x * screen[0].z + weights.y * screen[1].z + weights.z * screen[2].z, 0.0f, 1.0f);
+                const size_t index = target.Index(x, y);
+                if (depth >= target.depth[index]) {
+                    continue;
+                }
+
+                const glm::ivec2 texel = GetSampleTexel(settings, pixelCenter, getUV(pixelCenter), depthAt);
+                target.depth[index] = depth;
+                target.color[index] = source.ColorAt(texel.x, texel.y);
+            }
+        }
+    }
+}
+
+Reprojection::Action Reprojection::Select(bool hasNewFrame, bool canReproject, Quality quality) {
+    Action action;
+    if (hasNewFrame) {
+        m_missedFrames = 0;
+        m_presentedFrames++;
+        action = Action::PRESENT;
+    }
+    else if (++m_missedFrames <= MAX_REPROJECTED_FRAMES && canReproject && quality != Quality::OFF) {
+        m_reprojectedFrames++;
+        action = Action::REPROJECT;
+    }
+    else {
+        m_skippedFrames++;
+        action = Action::SKIP;
+    }
+
+    if (++m_frames % 500 == 0) {
+        Log::print<RENDERING>("Reprojection ({}): of the last 500 frames {} had a new frame, {} were reprojected and {} skipped the 3D layer", ReprojectionQualityName(quality), m_presentedFrames, m_reprojectedFrames, m_skippedFrames);
+        m_presentedFrames = 0;
+        m_reprojectedFrames = 0;
+        m_skippedFrames = 0;
+    }
+    return action;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// warps the last captured eye images to the current head pose when Cemu didn't deliver a new frame in time, so that the world doesn't
+// stick to the head until the next frame arrives. every eye is drawn as a grid of triangles whose vertices are moved by the depth they
+// were captured at. the triangles that get stretched across the holes which open up behind edges are filled with the background.
+// the reference warp does the same math as reprojectHLSL without touching D3D12, so that it can be checked on its own.
+class Reprojection {
+public:
+    enum class Quality : uint8_t {
+        OFF,
+        LOW,    // rotation only, the depth is ignored
+        MEDIUM, // positional, with a coarse grid
+        HIGH,   // positional, with a fine grid
+        COUNT
+    };
+
+    enum class Action : uint8_t {
+        PRESENT,   // a new frame is ready
+        REPROJECT, // the last frame is warped to the current pose
+        SKIP,      // the 3D layer is left out, like before there was any reprojection
+    };
+
+    // the emulator stops delivering frames during loading screens and pauses, stretching the last frame that long shows more holes than image
+    static constexpr uint32_t MAX_REPROJECTED_FRAMES = 6;
+    // how many pixels away from where it's drawn a texel may have been reprojected to before the pixel is considered part of a hole
+    static constexpr float HOLE_TOLERANCE = 2.0f;
+
+    struct Eye {
+        glm::fvec3 position;
+        glm::fquat orientation;
+        XrFovf fov;
+    };
+
+    // laid out like the shader's constants, see reprojectHLSL
+    struct Settings {
+        glm::fmat4 reprojection; // from the source's device coordinates to the target's clip space
+        uint32_t cellsX;
+        uint32_t cellsY;
+        float cellSize;    // in source texels
+        float holeTolerance; // in target pixels, 0 disables the hole filling
+        float textureWidth;
+        float textureHeight;
+        float targetWidth;
+        float targetHeight;
+    };
+    static_assert(sizeof(Settings) % sizeof(uint32_t) == 0 && sizeof(Settings) / sizeof(uint32_t) <= 32, "The settings are passed as root constants");
+
+    struct Vertex {
+        glm::fvec4 position; // in the target's clip space
+        glm::fvec2 uv;       // where the color is sampled from in the source
+    };
+
+    // the device depth is in [0, 1] from near to far, like the depth info that's submitted with the 3D layer
+    struct Image {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<glm::fvec4> color;
+        std::vector<float> depth;
+
+        Image(uint32_t width, uint32_t height, glm::fvec4 clearColor = glm::fvec4(0.0f, 0.0f, 0.0f, 1.0f), float clearDepth = 1.0f): width(width), height(height), color((size_t)width * height, clearColor), depth((size_t)width * height, clearDepth) {}
+
+        const glm::fvec4& ColorAt(int32_t x, int32_t y) const { return color[Index(x, y)]; }
+        float DepthAt(int32_t x, int32_t y) const { return depth[Index(x, y)]; }
+        // coordinates outside of the image are clamped to its border, like the shader's loads
+        size_t Index(int32_t x, int32_t y) const { return (size_t)std::clamp<int32_t>(y, 0, (int32_t)height - 1) * width + (size_t)std::clamp<int32_t>(x, 0, (int32_t)width - 1); }
+    };
+
+    using DepthFn = std::function<float(int32_t x, int32_t y)>;
+
+    static Eye ToEye(const XrView& view) { return { ToGLM(view.pose.position), ToGLM(view.pose.orientation), view.fov }; }
+
+    static uint32_t GetCellSize(Quality quality);
+    // a projection whose depth matches the depth info, nearZ maps to 0 and farZ to 1
+    static glm::fmat4 GetProjection(const XrFovf& fov, float nearZ, float farZ);
+    // without the positional part, both eyes are moved to the origin so that only their orientation and fov are reprojected
+    static glm::fmat4 GetReprojection(const Eye& from, const Eye& to, float nearZ, float farZ, bool positional);
+    static Settings GetSettings(Quality quality, const Eye& from, const Eye& to, uint32_t textureWidth, uint32_t textureHeight, uint32_t targetWidth, uint32_t targetHeight, float nearZ, float farZ);
+
+    // every cell is drawn as two triangles without any vertex or index buffer
+    static uint32_t GetVertexCount(const Settings& settings) { return settings.cellsX * settings.cellsY * 6; }
+    // what the vertex shader calculates for the vertex, the depth is loaded from source texels
+    static Vertex GetVertex(const Settings& settings, uint32_t vertexId, const DepthFn& depthAt);
+    // what the pixel shader samples for the pixel, given the uv that was interpolated for it
+    static glm::ivec2 GetSampleTexel(const Settings& settings, glm::fvec2 pixelCenter, glm::fvec2 uv, const DepthFn& depthAt);
+    // rasterizes the grid into target, which has to be cleared beforehand. the gpu clips the triangles that cross the eye's plane while
+    // they're dropped here, which only differs for geometry that's right at the eye.
+    static void Warp(const Settings& settings, const Image& source, Image& target);
+
+    // decides what EndFrame does with the 3D layer, canReproject is whether the last frame is kept and the current pose is known
+    Action Select(bool hasNewFrame, bool canReproject, Quality quality);
+    uint32_t GetMissedFrames() const { return m_missedFrames; }
+
+private:
+    uint32_t m_missedFrames = 0;
+
+    uint32_t m_frames = 0;
+    uint32_t m_presentedFrames = 0;
+    uint32_t m_reprojectedFrames = 0;
+    uint32_t m_skippedFrames = 0;
+};
+
+inline const char* ReprojectionQualityName(Reprojection::Quality quality) {
+    switch (quality) {
+        case Reprojection::Quality::OFF: return "Off";
+        case Reprojection::Quality::LOW: return "Low (rotation only)";
+        case Reprojection::Quality::MEDIUM: return "Medium";
+        case Reprojection::Quality::HIGH: return "High";
+        default: return "Unknown";
+    }
+}
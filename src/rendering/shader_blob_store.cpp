@@ -0,0 +1,74 @@
+#include "shader_blob_store.h"
+
+// file layout: magic, version, compiler version and entry count as uint32, followed by each entry's uint64 key, uint32 size,
+// uint64 hash of the bytes and the bytes
+template <typename T>
+static void AppendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static bool ReadRaw(std::string_view& in, T& value) {
+    if (in.size() < sizeof(T)) {
+        return false;
+    }
+    memcpy(&value, in.data(), sizeof(T));
+    in.remove_prefix(sizeof(T));
+    return true;
+}
+
+const std::vector<uint8_t>* ShaderBlobStore::Find(uint64_t key) const {
+    auto it = m_blobs.find(key);
+    return it != m_blobs.end() ? &it->second : nullptr;
+}
+
+void ShaderBlobStore::Insert(uint64_t key, const void* data, size_t size) {
+    m_blobs[key].assign((const uint8_t*)data, (const uint8_t*)data + size);
+}
+
+std::string ShaderBlobStore::Serialize() const {
+    std::string out;
+    AppendRaw(out, FILE_MAGIC);
+    AppendRaw(out, FILE_VERSION);
+    AppendRaw(out, m_compilerVersion);
+    AppendRaw(out, (uint32_t)m_blobs.size());
+    for (const auto& [key, blob] : m_blobs) {
+        AppendRaw(out, key);
+        AppendRaw(out, (uint32_t)blob.size());
+        AppendRaw(out, Hash(std::string_view((const char*)blob.data(), blob.size())));
+        out.append((const char*)blob.data(), blob.size());
+    }
+    return out;
+}
+
+bool ShaderBlobStore::Deserialize(std::string_view in) {
+    m_blobs.clear();
+    m_rejected = 0;
+
+    uint32_t magic = 0, version = 0, compilerVersion = 0, count = 0;
+    if (!ReadRaw(in, magic) || !ReadRaw(in, version) || !ReadRaw(in, compilerVersion) || !ReadRaw(in, count)) {
+        return false;
+    }
+    if (magic != FILE_MAGIC || version != FILE_VERSION || compilerVersion != m_compilerVersion) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t key = 0, hash = 0;
+        uint32_t size = 0;
+        if (!ReadRaw(in, key) || !ReadRaw(in, size) || !ReadRaw(in, hash) || in.size() < size) {
+            m_blobs.clear();
+            return false;
+        }
+        const std::string_view bytes = in.substr(0, size);
+        in.remove_prefix(size);
+
+        // a damaged entry is compiled again instead of being handed to the driver
+        if (Hash(bytes) != hash) {
+            m_rejected++;
+            continue;
+        }
+        Insert(key, bytes.data(), bytes.size());
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+// compiled shader bytecode by key, kept separate from the device so that loading, saving and looking up shaders doesn't depend on D3D12
+class ShaderBlobStore {
+public:
+    static constexpr uint32_t FILE_MAGIC = 0x42565343; // "CSVB" as it's written to the file
+    static constexpr uint32_t FILE_VERSION = 2;
+
+    // fnv-1a, constexpr so that the hashes of the built-in shader sources are calculated at build time
+    static constexpr uint64_t Hash(std::string_view data, uint64_t hash = 0xCBF29CE484222325) {
+        for (char c : data) {
+            hash ^= (uint8_t)c;
+            hash *= 0x100000001B3;
+        }
+        // terminate every field so that "ab" + "c" and "a" + "bc" don't collide
+        hash ^= 0xFF;
+        hash *= 0x100000001B3;
+        return hash;
+    }
+
+    template <typename... Ts>
+    static uint64_t HashValues(uint64_t hash, const Ts&... values) {
+        static_assert((std::is_trivially_copyable_v<Ts> && ...), "Only plain values can be hashed by their bytes");
+        ((hash = Hash(std::string_view((const char*)&values, sizeof(Ts)), hash)), ...);
+        return hash;
+    }
+
+    struct ShaderKey {
+        uint64_t sourceHash;
+        std::string_view entryPoint;
+        std::string_view profile;
+
+        constexpr uint64_t Hash() const { return ShaderBlobStore::Hash(profile, ShaderBlobStore::Hash(entryPoint, sourceHash)); }
+    };
+
+    // the same shader compiled with other flags or in another build configuration has other bytecode, so it's stored under another key
+    static uint64_t GetCacheKey(const ShaderKey& key, uint32_t compileFlags, uint32_t buildConfig) { return HashValues(key.Hash(), compileFlags, buildConfig); }
+
+    explicit ShaderBlobStore(uint32_t compilerVersion): m_compilerVersion(compilerVersion) {}
+
+    const std::vector<uint8_t>* Find(uint64_t key) const;
+    void Insert(uint64_t key, const void* data, size_t size);
+    size_t GetCount() const { return m_blobs.size(); }
+    // entries of the last Deserialize whose bytes didn't match the hash that was saved with them
+    uint32_t GetRejectedCount() const { return m_rejected; }
+
+    // compile is only called on a miss and returns a span of the new bytecode, which is copied into the store
+    template <typename Compile>
+    const std::vector<uint8_t>& FindOrCompile(uint64_t key, Compile&& compile) {
+        if (const std::vector<uint8_t>* blob = Find(key)) {
+            m_hits++;
+            return *blob;
+        }
+        std::span<const uint8_t> bytes = compile();
+        Insert(key, bytes.data(), bytes.size());
+        m_misses++;
+        return m_blobs[key];
+    }
+    uint32_t GetHits() const { return m_hits; }
+    uint32_t GetMisses() const { return m_misses; }
+
+    std::string Serialize() const;
+    // returns false and leaves the store empty if the data is truncated, from another file version or from another compiler.
+    // entries that were corrupted are left out.
+    bool Deserialize(std::string_view data);
+
+private:
+    uint32_t m_compilerVersion;
+    std::unordered_map<uint64_t, std::vector<uint8_t>> m_blobs;
+    uint32_t m_rejected = 0;
+    uint32_t m_hits = 0;
+    uint32_t m_misses = 0;
+};
@@ -0,0 +1,164 @@
+#include "shader_cache.h"
+#include "utils/d3d12_utils.h"
+#include <fstream>
+
+static std::optional<std::string> ReadFile(const std::string& path) {
+    std::ifstream f(path, std::ios::in | std::ios::binary);
+    if (!f.is_open()) {
+        return std::nullopt;
+    }
+    return std::string((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+}
+
+static bool WriteFile(const std::string& path, const void* data, size_t size) {
+    std::ofstream f(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) {
+        Log::print<WARNING>("Failed to open {} to save the shader cache", path);
+        return false;
+    }
+    f.write((const char*)data, (std::streamsize)size);
+    return true;
+}
+
+ShaderCache::ShaderCache(ID3D12Device* device): m_device(device) {
+    const std::string shaderPath = GetCachePath("BetterVR_shader_cache.bin");
+    if (auto data = ReadFile(shaderPath)) {
+        if (m_shaders.Deserialize(*data)) {
+            Log::print<RENDERING>("Loaded {} cached shaders from {}", m_shaders.GetCount(), shaderPath);
+            if (m_shaders.GetRejectedCount() > 0) {
+                Log::print<WARNING>("Ignoring {} cached shaders from {} since they're corrupted", m_shaders.GetRejectedCount(), shaderPath);
+                m_shadersDirty = true;
+            }
+        }
+        else {
+            Log::print<WARNING>("Ignoring the shader cache at {} since it's outdated or corrupted", shaderPath);
+        }
+    }
+
+    if (auto data = ReadFile(GetCachePath("BetterVR_pipeline_cache.bin"))) {
+        m_libraryData.assign(data->begin(), data->end());
+    }
+    CreatePipelineLibrary();
+}
+
+ShaderCache::~ShaderCache() {
+    Save();
+}
+
+void ShaderCache::CreatePipelineLibrary() {
+    ComPtr<ID3D12Device1> device1;
+    if (FAILED(m_device->QueryInterface(IID_PPV_ARGS(&device1)))) {
+        Log::print<WARNING>("D3D12 device doesn't support pipeline libraries, pipelines will only be cached for this session");
+        return;
+    }
+
+    if (!m_libraryData.empty()) {
+        HRESULT res = device1->CreatePipelineLibrary(m_libraryData.data(), m_libraryData.size(), IID_PPV_ARGS(&m_library));
+        if (SUCCEEDED(res)) {
+            return;
+        }
+
+        // a driver update or a different GPU invalidates the whole library
+        if (res == D3D12_ERROR_DRIVER_VERSION_MISMATCH || res == D3D12_ERROR_ADAPTER_NOT_FOUND) {
+            Log::print<RENDERING>("Discarding the pipeline cache since the GPU or its driver changed");
+        }
+        else {
+            Log::print<WARNING>("Discarding the pipeline cache since it's corrupted (0x{:08X})", (uint32_t)res);
+        }
+        m_libraryData.clear();
+    }
+
+    if (FAILED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_library)))) {
+        Log::print<WARNING>("Failed to create a pipeline library, pipelines will only be cached for this session");
+        m_library = nullptr;
+    }
+}
+
+ComPtr<ID3DBlob> ShaderCache::GetShader(const ShaderKey& key, const char* sourceHLSL, const CompileCallback& compile) {
+    const uint64_t cacheKey = BlobStore::GetCacheKey(key, D3D12Utils::SHADER_COMPILE_FLAGS, BUILD_CONFIG);
+
+    std::lock_guard lock(m_mutex);
+    ComPtr<ID3DBlob> compiledBytes;
+    const std::vector<uint8_t>& blob = m_shaders.FindOrCompile(cacheKey, [&] {
+        const std::string entryPoint(key.entryPoint);
+        const std::string profile(key.profile);
+        compiledBytes = compile ? compile(sourceHLSL, entryPoint.c_str(), profile.c_str()) : D3D12Utils::CompileShader(sourceHLSL, entryPoint.c_str(), profile.c_str());
+        return std::span((const uint8_t*)compiledBytes->GetBufferPointer(), compiledBytes->GetBufferSize());
+    });
+    if (compiledBytes) {
+        m_shadersDirty = true;
+        return compiledBytes;
+    }
+
+    ComPtr<ID3DBlob> shaderBytes;
+    checkHResult(D3DCreateBlob(blob.size(), &shaderBytes), "Failed to create blob for cached shader!");
+    memcpy(shaderBytes->GetBufferPointer(), blob.data(), blob.size());
+    return shaderBytes;
+}
+
+ComPtr<ID3D12PipelineState> ShaderCache::GetGraphicsPipeline(uint64_t pipelineKey, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) {
+    // the same key with other compile flags has other bytecode, which the library would refuse to load under that name
+    const uint64_t cacheKey = BlobStore::HashValues(pipelineKey, D3D12Utils::SHADER_COMPILE_FLAGS, BUILD_CONFIG);
+
+    std::lock_guard lock(m_mutex);
+    if (auto it = m_pipelines.find(cacheKey); it != m_pipelines.end()) {
+        m_pipelineHits++;
+        return it->second;
+    }
+
+    const std::wstring name = std::format(L"{:016X}", cacheKey);
+    ComPtr<ID3D12PipelineState> pipelineState;
+    if (m_library && SUCCEEDED(m_library->LoadGraphicsPipeline(name.c_str(), &desc, IID_PPV_ARGS(&pipelineState)))) {
+        m_pipelineLibraryHits++;
+    }
+    else {
+        checkHResult(m_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineState)), "Failed to create graphics pipeline state!");
+        m_pipelineMisses++;
+
+        // storing fails if a pipeline with the same name but a different description is already in the library, which only costs a recompile
+        if (m_library) {
+            if (HRESULT res = m_library->StorePipeline(name.c_str(), pipelineState.Get()); SUCCEEDED(res)) {
+                m_libraryDirty = true;
+            }
+            else {
+                Log::print<WARNING>("Failed to store pipeline {:016X} in the pipeline cache (0x{:08X})", cacheKey, (uint32_t)res);
+            }
+        }
+    }
+
+    m_pipelines.emplace(cacheKey, pipelineState);
+    return pipelineState;
+}
+
+void ShaderCache::Save() {
+    std::lock_guard lock(m_mutex);
+    if (m_shadersDirty) {
+        const std::string data = m_shaders.Serialize();
+        if (WriteFile(GetCachePath("BetterVR_shader_cache.bin"), data.data(), data.size())) {
+            m_shadersDirty = false;
+        }
+    }
+
+    if (m_libraryDirty && m_library) {
+        std::vector<uint8_t> data(m_library->GetSerializedSize());
+        if (SUCCEEDED(m_library->Serialize(data.data(), data.size())) && WriteFile(GetCachePath("BetterVR_pipeline_cache.bin"), data.data(), data.size())) {
+            m_libraryDirty = false;
+        }
+    }
+}
+
+void ShaderCache::LogStats() const {
+    std::lock_guard lock(m_mutex);
+    Log::print<RENDERING>("Shader cache: {} shaders cached, {} hits, {} compiled. Pipelines: {} reused, {} loaded from the library, {} created", m_shaders.GetCount(), m_shaders.GetHits(), m_shaders.GetMisses(), m_pipelineHits, m_pipelineLibraryHits, m_pipelineMisses);
+}
+
+std::string ShaderCache::GetCachePath(const char* fileName) {
+    char path[MAX_PATH];
+    if (GetModuleFileNameA(nullptr, path, MAX_PATH) == 0) {
+        return fileName;
+    }
+    std::string exePath(path);
+    const size_t lastSlash = exePath.find_last_of("\\/");
+    const std::string dir = (lastSlash == std::string::npos) ? std::string() : exePath.substr(0, lastSlash + 1);
+    return dir + fileName;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "shader_blob_store.h"
+
+// keeps compiled shader bytecode and pipeline states next to Cemu's executable, so that starting the game doesn't call D3DCompile again
+// and swapping between swapchain formats reuses the pipeline that was already created for that format
+class ShaderCache {
+public:
+    // bytecode from another compiler or build configuration is never reused, even if its key matches
+    static constexpr uint32_t COMPILER_VERSION = D3D_COMPILER_VERSION;
+#ifdef _DEBUG
+    static constexpr uint32_t BUILD_CONFIG = 1;
+#else
+    static constexpr uint32_t BUILD_CONFIG = 0;
+#endif
+
+    using BlobStore = ShaderBlobStore;
+    using ShaderKey = ShaderBlobStore::ShaderKey;
+
+    explicit ShaderCache(ID3D12Device* device);
+    ~ShaderCache();
+
+    // compile is only called on a miss, so tools or tests can swap out D3DCompile
+    using CompileCallback = std::function<ComPtr<ID3DBlob>(const char* sourceHLSL, const char* entryPoint, const char* profile)>;
+    ComPtr<ID3DBlob> GetShader(const ShaderKey& key, const char* sourceHLSL, const CompileCallback& compile = nullptr);
+
+    // the key should cover everything in desc that can change, e.g. the shaders and the target formats. the compile flags and the
+    // build configuration are added to it here.
+    ComPtr<ID3D12PipelineState> GetGraphicsPipeline(uint64_t pipelineKey, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+    void Save();
+    void LogStats() const;
+
+private:
+    static std::string GetCachePath(const char* fileName);
+    void CreatePipelineLibrary();
+
+    ID3D12Device* m_device;
+    mutable std::mutex m_mutex;
+
+    BlobStore m_shaders = BlobStore(COMPILER_VERSION);
+    bool m_shadersDirty = false;
+
+    // format permutations that were already created this session
+    std::unordered_map<uint64_t, ComPtr<ID3D12PipelineState>> m_pipelines;
+    ComPtr<ID3D12PipelineLibrary> m_library;
+    // the library reads from this for as long as it exists
+    std::vector<uint8_t> m_libraryData;
+    bool m_libraryDirty = false;
+
+    uint32_t m_pipelineHits = 0;
+    uint32_t m_pipelineLibraryHits = 0;
+    uint32_t m_pipelineMisses = 0;
+};
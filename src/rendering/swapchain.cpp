@@ -3,7 +3,7 @@
 #include "instance.h"
 
 template <DXGI_FORMAT T>
-Swapchain<T>::Swapchain(uint32_t width, uint32_t height, uint32_t sampleCount): m_width(width), m_height(height) {
+Swapchain<T>::Swapchain(const char* name, uint32_t width, uint32_t height, uint32_t sampleCount): m_images(name), m_width(width), m_height(height) {
     auto getBestSwapchainFormat = [](const std::vector<DXGI_FORMAT>& applicationSupportedFormats) -> DXGI_FORMAT {
         // Finds the first matching DXGI_FORMAT (int) that matches the int64 from OpenXR
         uint32_t swapchainCount = 0;
@@ -34,12 +34,14 @@ Swapchain<T>::Swapchain(uint32_t width, uint32_t height, uint32_t sampleCount):
     swapchainCreateInfo.faceCount = 1;
     swapchainCreateInfo.usageFlags = (D3D12Utils::IsDepthFormat(T) ? XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT) | XR_SWAPCHAIN_USAGE_SAMPLED_BIT;
     swapchainCreateInfo.createFlags = 0;
-    checkXRResult(xrCreateSwapchain(VRManager::instance().XR->GetSession(), &swapchainCreateInfo, &m_swapchain), "Failed to create OpenXR swapchain images!");
+    XrSwapchain swapchain = XR_NULL_HANDLE;
+    checkXRResult(xrCreateSwapchain(VRManager::instance().XR->GetSession(), &swapchainCreateInfo, &swapchain), "Failed to create OpenXR swapchain images!");
+    m_images.SetHandle(swapchain);
 
     uint32_t swapchainImagesCount = 0;
-    checkXRResult(xrEnumerateSwapchainImages(m_swapchain, 0, &swapchainImagesCount, NULL), "Failed to enumerate swapchain images!");
+    checkXRResult(xrEnumerateSwapchainImages(swapchain, 0, &swapchainImagesCount, NULL), "Failed to enumerate swapchain images!");
     std::vector<XrSwapchainImageD3D12KHR> swapchainImages(swapchainImagesCount, { XR_TYPE_SWAPCHAIN_IMAGE_D3D12_KHR });
-    checkXRResult(xrEnumerateSwapchainImages(m_swapchain, swapchainImagesCount, &swapchainImagesCount, reinterpret_cast<XrSwapchainImageBaseHeader*>(swapchainImages.data())), "Failed to enumerate swapchain images!");
+    checkXRResult(xrEnumerateSwapchainImages(swapchain, swapchainImagesCount, &swapchainImagesCount, reinterpret_cast<XrSwapchainImageBaseHeader*>(swapchainImages.data())), "Failed to enumerate swapchain images!");
 
     for (size_t i = 0; i < swapchainImages.size(); i++) {
         // D3D12Utils::CreateConstantBuffer(D3D12_HEAP_TYPE_DEFAULT);
@@ -48,32 +50,10 @@ Swapchain<T>::Swapchain(uint32_t width, uint32_t height, uint32_t sampleCount):
     }
 }
 
-template <DXGI_FORMAT T>
-void Swapchain<T>::PrepareRendering() {
-    checkXRResult(xrAcquireSwapchainImage(m_swapchain, NULL, &m_swapchainImageIdx), "Can't acquire OpenXR swapchain image!");
-}
-
-template <DXGI_FORMAT T>
-ID3D12Resource* Swapchain<T>::StartRendering() {
-    XrSwapchainImageWaitInfo waitSwapchainInfo = { XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
-    waitSwapchainInfo.timeout = XR_INFINITE_DURATION;
-    if (XrResult waitResult = xrWaitSwapchainImage(m_swapchain, &waitSwapchainInfo); waitResult == XR_TIMEOUT_EXPIRED || XR_FAILED(waitResult)) {
-        checkXRResult(waitResult, "Failed to wait for swapchain image!");
-    }
-
-    return m_swapchainTextures[m_swapchainImageIdx].Get();
-}
-
-template <DXGI_FORMAT T>
-void Swapchain<T>::FinishRendering() {
-    XrSwapchainImageReleaseInfo releaseSwapchainInfo = { XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
-    checkXRResult(xrReleaseSwapchainImage(m_swapchain, &releaseSwapchainInfo), "Failed to release swapchain image!");
-}
-
 template <DXGI_FORMAT T>
 Swapchain<T>::~Swapchain() {
-    if (m_swapchain != XR_NULL_HANDLE) {
-        xrDestroySwapchain(m_swapchain);
+    if (m_images.GetHandle() != XR_NULL_HANDLE) {
+        xrDestroySwapchain(m_images.GetHandle());
     }
 }
 
@@ -1,28 +1,33 @@
 #pragma once
+#include "swapchain_images.h"
 
 template <DXGI_FORMAT T>
 class Swapchain {
 public:
-    Swapchain(uint32_t width, uint32_t height, uint32_t sampleCount);
+    Swapchain(const char* name, uint32_t width, uint32_t height, uint32_t sampleCount);
     ~Swapchain();
 
-    void PrepareRendering();
-    ID3D12Resource* StartRendering();
-    void FinishRendering();
+    void PrepareRendering() { m_images.PrepareRendering(); }
+    bool StartRendering(const SwapchainDeadline& deadline) { return m_images.StartRendering(deadline); }
+    void FinishRendering() { m_images.FinishRendering(); }
 
-    XrSwapchain GetHandle() const { return m_swapchain; };
-    ID3D12Resource* GetTexture() const { return m_swapchainTextures[m_swapchainImageIdx].Get(); };
+    bool HasReleasedImage() const { return m_images.HasReleasedImage(); }
+
+    SwapchainStats GetStats() const { return m_images.GetStats(); }
+    const char* GetName() const { return m_images.GetName(); }
+
+    XrSwapchain GetHandle() const { return m_images.GetHandle(); };
+    ID3D12Resource* GetTexture() const { return m_swapchainTextures[m_images.GetImageIndex()].Get(); };
 
     DXGI_FORMAT GetFormat() const { return m_format; };
     [[nodiscard]] uint32_t GetWidth() const { return m_width; };
     [[nodiscard]] uint32_t GetHeight() const { return m_height; };
 
 private:
-    XrSwapchain m_swapchain = XR_NULL_HANDLE;
+    SwapchainImages m_images;
     uint32_t m_width;
     uint32_t m_height;
     DXGI_FORMAT m_format;
 
     std::vector<ComPtr<ID3D12Resource>> m_swapchainTextures;
-    uint32_t m_swapchainImageIdx = 0;
-};
\ No newline at end of file
+};
@@ -0,0 +1,97 @@
+#include "swapchain_images.h"
+
+void LatencyHistogram::Record(std::chrono::duration<double, std::milli> latency) {
+    size_t bucket = 0;
+    for (double bound = FIRST_BUCKET_MS; bucket < BUCKET_COUNT - 1 && latency.count() >= bound; bound *= 2.0) {
+        bucket++;
+    }
+    m_buckets[bucket]++;
+    m_count++;
+    m_maxMs = std::max(m_maxMs, latency.count());
+}
+
+std::string LatencyHistogram::ToString() const {
+    std::string result;
+    double bound = FIRST_BUCKET_MS;
+    for (size_t i = 0; i < BUCKET_COUNT; i++, bound *= 2.0) {
+        if (m_buckets[i] == 0) {
+            continue;
+        }
+        if (!result.empty()) {
+            result += ", ";
+        }
+        result += i < BUCKET_COUNT - 1 ? std::format("<{}ms: {}", bound, m_buckets[i]) : std::format(">={}ms: {}", bound / 2.0, m_buckets[i]);
+    }
+    return std::format("{} (max {:.2f}ms)", result.empty() ? "none" : result, m_maxMs);
+}
+
+bool SwapchainImages::PrepareRendering() {
+    if (m_isAcquired) {
+        return true;
+    }
+
+    // runtimes that block the acquire until an image is free can give up instead, the acquire is then tried again next frame
+    auto acquireStart = std::chrono::high_resolution_clock::now();
+    XrSwapchainImageAcquireInfo acquireSwapchainInfo = { XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO };
+    XrResult acquireResult = xrAcquireSwapchainImage(m_swapchain, &acquireSwapchainInfo, &m_imageIdx);
+    m_stats.acquireLatency.Record(std::chrono::high_resolution_clock::now() - acquireStart);
+
+    if (acquireResult == XR_TIMEOUT_EXPIRED) {
+        m_stats.timeouts++;
+        if (!m_timedOut) {
+            Log::print<WARNING>("Swapchain {} had no image to acquire, {}", m_name, m_hasReleasedImage ? "reusing its last image" : "dropping its layer");
+        }
+        m_timedOut = true;
+        return false;
+    }
+    checkXRResult(acquireResult, "Can't acquire OpenXR swapchain image!");
+    m_isAcquired = true;
+    return true;
+}
+
+bool SwapchainImages::StartRendering(const SwapchainDeadline& deadline) {
+    if (!PrepareRendering()) {
+        return false;
+    }
+    if (m_isWaited) {
+        return true;
+    }
+
+    // a timed out wait is retried for the same image, so the next frame picks up where this one stopped
+    XrSwapchainImageWaitInfo waitSwapchainInfo = { XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
+    waitSwapchainInfo.timeout = deadline.GetRemaining();
+    auto waitStart = std::chrono::high_resolution_clock::now();
+    XrResult waitResult = xrWaitSwapchainImage(m_swapchain, &waitSwapchainInfo);
+    m_stats.waitLatency.Record(std::chrono::high_resolution_clock::now() - waitStart);
+
+    if (waitResult == XR_TIMEOUT_EXPIRED) {
+        m_stats.timeouts++;
+        if (!m_timedOut) {
+            Log::print<WARNING>("Swapchain {} image {} wasn't ready within {:.2f}ms, {}", m_name, m_imageIdx, (double)waitSwapchainInfo.timeout / 1e6, m_hasReleasedImage ? "reusing its last image" : "dropping its layer");
+        }
+        m_timedOut = true;
+        return false;
+    }
+    checkXRResult(waitResult, "Failed to wait for swapchain image!");
+    m_timedOut = false;
+    m_isWaited = true;
+    return true;
+}
+
+void SwapchainImages::FinishRendering() {
+    checkAssert(m_isWaited, "Swapchain images can only be released after they've been waited for!");
+    XrSwapchainImageReleaseInfo releaseSwapchainInfo = { XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
+    checkXRResult(xrReleaseSwapchainImage(m_swapchain, &releaseSwapchainInfo), "Failed to release swapchain image!");
+    m_isAcquired = false;
+    m_isWaited = false;
+    m_hasReleasedImage = true;
+
+    if (++m_releaseCount % SwapchainStats::WINDOW == 0) {
+        Log::print<RENDERING>("Swapchain {}: acquire {}, wait {}, {} acquires or waits timed out", m_name, m_stats.acquireLatency.ToString(), m_stats.waitLatency.ToString(), m_stats.timeouts);
+        std::scoped_lock lock(m_statsMutex);
+        m_lastStats = std::exchange(m_stats, {});
+    }
+
+    // the runtime only blocks the acquire when every image is still in use, which is better found out now than during the next frame
+    PrepareRendering();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+// counts how long the swapchain calls took, in buckets that double from under 0.125ms up to 16ms and more
+class LatencyHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 9;
+    static constexpr double FIRST_BUCKET_MS = 0.125;
+
+    void Record(std::chrono::duration<double, std::milli> latency);
+    std::string ToString() const;
+
+    uint32_t GetCount() const { return m_count; }
+    double GetMaxMs() const { return m_maxMs; }
+    const std::array<uint32_t, BUCKET_COUNT>& GetBuckets() const { return m_buckets; }
+    // the latency that the bucket goes up to, the last one holds everything from the bound of the one before
+    static double GetBucketBoundMs(size_t bucket) { return FIRST_BUCKET_MS * (double)(1u << bucket); }
+
+private:
+    std::array<uint32_t, BUCKET_COUNT> m_buckets = {};
+    uint32_t m_count = 0;
+    double m_maxMs = 0.0;
+};
+
+// of the last WINDOW released images
+struct SwapchainStats {
+    static constexpr uint32_t WINDOW = 500;
+
+    LatencyHistogram acquireLatency;
+    LatencyHistogram waitLatency;
+    uint32_t timeouts = 0;
+};
+
+// the time that all the swapchain waits of a frame share, so that a slow image leaves less time for the next ones instead of adding up
+class SwapchainDeadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // the runtime should hand the images back well within a display period, a frame that waits any longer would miss it anyway
+    static SwapchainDeadline FromDisplayPeriod(XrDuration predictedDisplayPeriod) {
+        constexpr XrDuration FALLBACK_PERIOD = 1'000'000'000 / 90;
+        return SwapchainDeadline(Clock::now() + std::chrono::nanoseconds((predictedDisplayPeriod > 0 ? predictedDisplayPeriod : FALLBACK_PERIOD) / 2));
+    }
+
+    explicit SwapchainDeadline(Clock::time_point end): m_end(end) {}
+
+    XrDuration GetRemaining() const { return std::max<XrDuration>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(m_end - Clock::now()).count()); }
+
+private:
+    Clock::time_point m_end;
+};
+
+// acquires, waits for and releases the images of an OpenXR swapchain, apart from its textures so that it only depends on the runtime
+class SwapchainImages {
+public:
+    explicit SwapchainImages(const char* name): m_name(name) {}
+
+    void SetHandle(XrSwapchain swapchain) { m_swapchain = swapchain; }
+
+    // acquires the next image ahead of time, does nothing if one is already acquired. returns whether one is
+    bool PrepareRendering();
+    // waits until the deadline at most, the image stays acquired if it isn't ready yet and is waited for again next frame
+    bool StartRendering(const SwapchainDeadline& deadline);
+    // releases the image and already acquires the next one for the next frame
+    void FinishRendering();
+
+    bool IsAcquired() const { return m_isAcquired; }
+    // whether an image was released before, the runtime keeps showing it when a layer is submitted without rendering to the swapchain
+    bool HasReleasedImage() const { return m_hasReleasedImage; }
+    uint32_t GetImageIndex() const { return m_imageIdx; }
+
+    // can be read from other threads, like the one that draws the debug overlay
+    SwapchainStats GetStats() const {
+        std::scoped_lock lock(m_statsMutex);
+        return m_lastStats;
+    }
+    const char* GetName() const { return m_name; }
+    XrSwapchain GetHandle() const { return m_swapchain; }
+
+private:
+    const char* m_name;
+    XrSwapchain m_swapchain = XR_NULL_HANDLE;
+    uint32_t m_imageIdx = 0;
+
+    bool m_isAcquired = false;
+    bool m_isWaited = false;
+    bool m_hasReleasedImage = false;
+    bool m_timedOut = false; // the last acquire or wait timed out, so the next timeout isn't logged again
+
+    SwapchainStats m_stats;
+    SwapchainStats m_lastStats;
+    mutable std::mutex m_statsMutex;
+    uint32_t m_releaseCount = 0;
+};
@@ -15,22 +15,23 @@ BaseVulkanTexture::~BaseVulkanTexture() {
     }
 }
 
-void BaseVulkanTexture::vkPipelineBarrier(VkCommandBuffer cmdBuffer) {
-    return VulkanUtils::DebugPipelineBarrier(cmdBuffer);
-}
-
 VkImageAspectFlags BaseVulkanTexture::GetAspectMask() const {
     return VulkanUtils::GetAspectMaskForFormat(m_vkFormat);
 }
 
-void BaseVulkanTexture::vkTransitionLayout(VkCommandBuffer cmdBuffer, VkImageLayout newLayout) {
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
-    VulkanUtils::TransitionLayout(cmdBuffer, m_vkImage, m_vkCurrLayout, newLayout, GetAspectMask());
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
-    m_vkCurrLayout = newLayout;
+void BaseVulkanTexture::vkUse(BarrierPlanner& barriers, const BarrierPlanner::Access& access) {
+    if (m_vkBarrierState.has_value()) {
+        barriers.Track(m_vkImage, m_vkBarrierState.value());
+    }
+    else {
+        barriers.Track(m_vkImage, GetAspectMask(), m_vkCurrLayout);
+    }
+    barriers.Use(m_vkImage, access);
+    m_vkBarrierState = barriers.GetState(m_vkImage);
+    m_vkCurrLayout = access.layout;
 }
 
-void BaseVulkanTexture::vkCopyToImage(VkCommandBuffer cmdBuffer, VkImage dstImage) {
+void BaseVulkanTexture::vkCopyToImage(VkCommandBuffer cmdBuffer, BarrierPlanner& barriers, VkImage dstImage) {
     auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
     VkImageAspectFlags aspectMask = GetAspectMask();
 
@@ -46,22 +47,13 @@ void BaseVulkanTexture::vkCopyToImage(VkCommandBuffer cmdBuffer, VkImage dstImag
         }
     };
 
-    dispatch->CmdCopyImage(cmdBuffer, m_vkImage, m_vkCurrLayout, dstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    // AMD GPU FIX: Add memory barrier after copy to ensure data is visible
-    VkMemoryBarrier2 postCopyBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
-    postCopyBarrier.srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
-    postCopyBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
-    postCopyBarrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
-    postCopyBarrier.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
-
-    VkDependencyInfo depInfo = { VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-    depInfo.memoryBarrierCount = 1;
-    depInfo.pMemoryBarriers = &postCopyBarrier;
-    dispatch->CmdPipelineBarrier2(cmdBuffer, &depInfo);
+    vkUse(barriers, BarrierPlanner::TransferSrc());
+    barriers.Use(dstImage, BarrierPlanner::TransferDst());
+    barriers.Flush(cmdBuffer);
+    dispatch->CmdCopyImage(cmdBuffer, m_vkImage, m_vkCurrLayout, dstImage, barriers.GetLayout(dstImage), 1, &region);
 }
 
-void BaseVulkanTexture::vkClear(VkCommandBuffer cmdBuffer, VkClearColorValue color) {
+void BaseVulkanTexture::vkClear(VkCommandBuffer cmdBuffer, BarrierPlanner& barriers, VkClearColorValue color) {
     auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
 
     // Only use CmdClearColorImage for color images
@@ -70,11 +62,6 @@ void BaseVulkanTexture::vkClear(VkCommandBuffer cmdBuffer, VkClearColorValue col
         return;
     }
 
-    if (m_vkCurrLayout != VK_IMAGE_LAYOUT_GENERAL && m_vkCurrLayout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        VulkanUtils::TransitionLayout(cmdBuffer, m_vkImage, m_vkCurrLayout, VK_IMAGE_LAYOUT_GENERAL);
-        m_vkCurrLayout = VK_IMAGE_LAYOUT_GENERAL;
-    }
-
     const VkImageSubresourceRange range = {
         .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
         .baseMipLevel = 0,
@@ -83,12 +70,12 @@ void BaseVulkanTexture::vkClear(VkCommandBuffer cmdBuffer, VkClearColorValue col
         .layerCount = VK_REMAINING_ARRAY_LAYERS
     };
 
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
+    vkUse(barriers, BarrierPlanner::TransferDst());
+    barriers.Flush(cmdBuffer);
     dispatch->CmdClearColorImage(cmdBuffer, m_vkImage, m_vkCurrLayout, &color, 1, &range);
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
 }
 
-void BaseVulkanTexture::vkClearDepth(VkCommandBuffer cmdBuffer, float depth, uint32_t stencil) {
+void BaseVulkanTexture::vkClearDepth(VkCommandBuffer cmdBuffer, BarrierPlanner& barriers, float depth, uint32_t stencil) {
     auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
 
     if (!VulkanUtils::IsDepthFormat(m_vkFormat)) {
@@ -96,13 +83,6 @@ void BaseVulkanTexture::vkClearDepth(VkCommandBuffer cmdBuffer, float depth, uin
         return;
     }
 
-    // AMD GPU FIX: Transition to GENERAL if not already in a valid clear layout
-    // CmdClearDepthStencilImage requires GENERAL or TRANSFER_DST_OPTIMAL
-    if (m_vkCurrLayout != VK_IMAGE_LAYOUT_GENERAL && m_vkCurrLayout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        VulkanUtils::TransitionLayout(cmdBuffer, m_vkImage, m_vkCurrLayout, VK_IMAGE_LAYOUT_GENERAL, GetAspectMask());
-        m_vkCurrLayout = VK_IMAGE_LAYOUT_GENERAL;
-    }
-
     VkClearDepthStencilValue clearValue = {
         .depth = depth,
         .stencil = stencil
@@ -116,10 +96,13 @@ void BaseVulkanTexture::vkClearDepth(VkCommandBuffer cmdBuffer, float depth, uin
         .layerCount = VK_REMAINING_ARRAY_LAYERS
     };
 
+    // CmdClearDepthStencilImage requires GENERAL or TRANSFER_DST_OPTIMAL
+    vkUse(barriers, BarrierPlanner::TransferDst());
+    barriers.Flush(cmdBuffer);
     dispatch->CmdClearDepthStencilImage(cmdBuffer, m_vkImage, m_vkCurrLayout, &clearValue, 1, &range);
 }
 
-void BaseVulkanTexture::vkCopyFromImage(VkCommandBuffer cmdBuffer, VkImage srcImage) {
+void BaseVulkanTexture::vkCopyFromImage(VkCommandBuffer cmdBuffer, BarrierPlanner& barriers, VkImage srcImage) {
     auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
 
     VkImageAspectFlags aspectMask = GetAspectMask();
@@ -135,12 +118,13 @@ void BaseVulkanTexture::vkCopyFromImage(VkCommandBuffer cmdBuffer, VkImage srcIm
         }
     };
 
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
-    dispatch->CmdCopyImage(cmdBuffer, srcImage, VK_IMAGE_LAYOUT_GENERAL, m_vkImage, VK_IMAGE_LAYOUT_GENERAL, 1, &region);
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
+    barriers.Use(srcImage, BarrierPlanner::TransferSrc());
+    vkUse(barriers, BarrierPlanner::TransferDst());
+    barriers.Flush(cmdBuffer);
+    dispatch->CmdCopyImage(cmdBuffer, srcImage, barriers.GetLayout(srcImage), m_vkImage, m_vkCurrLayout, 1, &region);
 }
 
-VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, bool disableAlphaThroughSwizzling): BaseVulkanTexture(width, height, format) {
+VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, bool createOpaqueView): BaseVulkanTexture(width, height, format) {
     const auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
 
     VkImageCreateInfo imageCreateInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
@@ -183,7 +167,7 @@ VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, V
         .r = VK_COMPONENT_SWIZZLE_IDENTITY,
         .g = VK_COMPONENT_SWIZZLE_IDENTITY,
         .b = VK_COMPONENT_SWIZZLE_IDENTITY,
-        .a = disableAlphaThroughSwizzling ? VK_COMPONENT_SWIZZLE_ONE : VK_COMPONENT_SWIZZLE_IDENTITY
+        .a = VK_COMPONENT_SWIZZLE_IDENTITY
     };
     imageViewCreateInfo.subresourceRange = {
         .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
@@ -193,6 +177,12 @@ VulkanTexture::VulkanTexture(uint32_t width, uint32_t height, VkFormat format, V
         .layerCount = 1
     };
     checkVkResult(dispatch->CreateImageView(VRManager::instance().VK->GetDevice(), &imageViewCreateInfo, nullptr, &m_vkImageView), "Failed to create image view!");
+
+    // the same image viewed with its alpha swizzled to one, so that it doesn't need to be copied into a second texture to be drawn opaque
+    if (createOpaqueView) {
+        imageViewCreateInfo.components.a = VK_COMPONENT_SWIZZLE_ONE;
+        checkVkResult(dispatch->CreateImageView(VRManager::instance().VK->GetDevice(), &imageViewCreateInfo, nullptr, &m_vkOpaqueImageView), "Failed to create opaque image view!");
+    }
 }
 
 VulkanTexture::~VulkanTexture() {
@@ -200,6 +190,10 @@ VulkanTexture::~VulkanTexture() {
         VRManager::instance().VK->GetDeviceDispatch()->DestroyImageView(VRManager::instance().VK->GetDevice(), m_vkImageView, nullptr);
         m_vkImageView = VK_NULL_HANDLE;
     }
+    if (m_vkOpaqueImageView != VK_NULL_HANDLE) {
+        VRManager::instance().VK->GetDeviceDispatch()->DestroyImageView(VRManager::instance().VK->GetDevice(), m_vkOpaqueImageView, nullptr);
+        m_vkOpaqueImageView = VK_NULL_HANDLE;
+    }
 }
 
 VulkanFramebuffer::VulkanFramebuffer(uint32_t width, uint32_t height, VkFormat format, VkRenderPass renderPass): VulkanTexture(width, height, format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT) {
@@ -259,7 +253,7 @@ Texture::Texture(uint32_t width, uint32_t height, DXGI_FORMAT format): m_d3d12Fo
     checkHResult(VRManager::instance().D3D12->GetDevice()->CreateSharedHandle(m_d3d12Fence.Get(), nullptr, GENERIC_ALL, nullptr, &m_d3d12FenceHandle), "Failed to create shared handle to fence!");
 }
 
-void Texture::d3d12SignalFence(uint64_t value) {
+void Texture::d3d12SignalFence(ID3D12CommandQueue* queue, uint64_t value) {
     // Check current fence value before signaling
     uint64_t currentValue = m_d3d12Fence->GetCompletedValue();
 
@@ -269,11 +263,10 @@ void Texture::d3d12SignalFence(uint64_t value) {
         Log::print<INTEROP>("D3D12 Signal #{}: texture={}, current={}, signaling to {}", s_d3d12SignalCount, (void*)this, currentValue, value);
     }
 
-    SetLastSignalledValue(value);
-    checkHResult(VRManager::instance().D3D12->GetCommandQueue()->Signal(m_d3d12Fence.Get(), value), "D3D12 Signal FAILED!");
+    checkHResult(queue->Signal(m_d3d12Fence.Get(), value), "D3D12 Signal FAILED!");
 }
 
-void Texture::d3d12WaitForFence(uint64_t value) {
+void Texture::d3d12WaitForFence(ID3D12CommandQueue* queue, uint64_t value) {
     uint64_t currentValue = m_d3d12Fence->GetCompletedValue();
 
     static uint32_t s_d3d12WaitCount = 0;
@@ -285,8 +278,7 @@ void Texture::d3d12WaitForFence(uint64_t value) {
         Log::print<ERROR>("D3D12 fence in ERROR state! texture={}", (void*)this);
     }
 
-    SetLastAwaitedValue(value);
-    checkHResult(VRManager::instance().D3D12->GetCommandQueue()->Wait(m_d3d12Fence.Get(), value), "D3D12 Wait FAILED!");
+    checkHResult(queue->Wait(m_d3d12Fence.Get(), value), "D3D12 Wait FAILED!");
 }
 
 Texture::~Texture() {
@@ -390,14 +382,31 @@ SharedTexture::SharedTexture(uint32_t width, uint32_t height, VkFormat vkFormat,
     importSemaphoreInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_D3D12_FENCE_BIT;
     importSemaphoreInfo.handle = m_d3d12FenceHandle;
     checkVkResult(dispatch->ImportSemaphoreWin32HandleKHR(VRManager::instance().VK->GetDevice(), &importSemaphoreInfo), "Failed to import semaphore for shared texture!");
+
+    m_handoffTimeline = VRManager::instance().Handoffs->AddTimeline(std::format("{}x{} {} texture {}", width, height, vkFormat, (void*)this), [fence = m_d3d12Fence.Get()] {
+        return fence->GetCompletedValue();
+    });
 }
 
 SharedTexture::~SharedTexture() {
+    VRManager::instance().Handoffs->RemoveTimeline(m_handoffTimeline);
     if (m_vkSemaphore != VK_NULL_HANDLE)
         VRManager::instance().VK->GetDeviceDispatch()->DestroySemaphore(VRManager::instance().VK->GetDevice(), m_vkSemaphore, nullptr);
 }
 
-void SharedTexture::CopyFromVkImage(VkCommandBuffer cmdBuffer, VkImage srcImage) {
+uint64_t SharedTexture::WaitForHandoff(HandoffTracker::Api consumer) {
+    return VRManager::instance().Handoffs->Wait(m_handoffTimeline, consumer);
+}
+
+uint64_t SharedTexture::SignalHandoff(HandoffTracker::Api producer) {
+    return VRManager::instance().Handoffs->Signal(m_handoffTimeline, producer).value;
+}
+
+std::optional<HandoffTracker::Api> SharedTexture::GetLastProducer() const {
+    return VRManager::instance().Handoffs->GetLastProducer(m_handoffTimeline);
+}
+
+void SharedTexture::CopyFromVkImage(VkCommandBuffer cmdBuffer, BarrierPlanner& barriers, VkImage srcImage) {
     static uint32_t s_copyCount = 0;
     s_copyCount++;
 
@@ -426,8 +435,9 @@ void SharedTexture::CopyFromVkImage(VkCommandBuffer cmdBuffer, VkImage srcImage)
         .extent = { (uint32_t)this->m_d3d12Texture->GetDesc().Width, (uint32_t)this->m_d3d12Texture->GetDesc().Height, 1 }
     };
 
-    // Copy using the correct layouts
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
-    dispatch->CmdCopyImage(cmdBuffer, srcImage, VK_IMAGE_LAYOUT_GENERAL, this->m_vkImage, VK_IMAGE_LAYOUT_GENERAL, 1, &copyRegion);
-    VulkanUtils::DebugPipelineBarrier(cmdBuffer);
+    // the whole texture gets overwritten, and D3D12 only reads it after the semaphore that's signalled once the command buffer is done
+    barriers.Use(srcImage, BarrierPlanner::TransferSrc());
+    vkUse(barriers, BarrierPlanner::TransferDst());
+    barriers.Flush(cmdBuffer);
+    dispatch->CmdCopyImage(cmdBuffer, srcImage, barriers.GetLayout(srcImage), this->m_vkImage, m_vkCurrLayout, 1, &copyRegion);
 }
\ No newline at end of file
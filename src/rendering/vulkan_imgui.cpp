@@ -1,6 +1,7 @@
 #include "instance.h"
 #include "vulkan.h"
 #include "hooking/entity_debugger.h"
+#include "hooking/framebuffer.h"
 #include "utils/vulkan_utils.h"
 
 RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uint32_t height, VkFormat format) {
@@ -121,7 +122,7 @@ RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uin
     checkAssert(ImGui_ImplVulkan_Init(&init_info), "Failed to initialize ImGui");
 
     auto* renderer = VRManager::instance().XR->GetRenderer();
-    for (int i = 0; i < 2; ++i) {
+    for (int i = 0; i < FRAME_RING_DEPTH; ++i) {
         renderer->GetFrame(i).imguiFramebuffer = std::make_unique<VulkanFramebuffer>(width, height, format, m_renderPass);
     }
 
@@ -162,20 +163,14 @@ RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uin
     }
     m_cemuRenderWindow = iteratedHwnd;
 
-    for (int i = 0; i < 2; ++i) {
+    BarrierPlanner barriers;
+    for (int i = 0; i < FRAME_RING_DEPTH; ++i) {
         auto& frame = renderer->GetFrame(i);
         frame.mainFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_B10G11R11_UFLOAT_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, false);
-        frame.hudFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, false);
-        frame.hudWithoutAlphaFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, true);
+        frame.hudFramebuffer = std::make_unique<VulkanTexture>(width, height, VK_FORMAT_A2B10G10R10_UNORM_PACK32, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, true);
 
-        frame.mainFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
-        frame.mainFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
-
-        frame.hudFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
-        frame.hudFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
-
-        frame.hudWithoutAlphaFramebuffer->vkTransitionLayout(cb, VK_IMAGE_LAYOUT_GENERAL);
-        frame.hudWithoutAlphaFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
+        frame.mainFramebuffer->vkClear(cb, barriers, { 0.0f, 0.0f, 0.0f, 0.0f });
+        frame.hudFramebuffer->vkClear(cb, barriers, { 0.0f, 0.0f, 0.0f, 0.0f });
     }
 
     // create sampler
@@ -200,7 +195,8 @@ RND_Renderer::ImGuiOverlay::ImGuiOverlay(VkCommandBuffer cb, uint32_t width, uin
 
 RND_Renderer::ImGuiOverlay::~ImGuiOverlay() {
     auto* renderer = VRManager::instance().XR->GetRenderer();
-    for (int i = 0; i < 2; ++i) {
+    BarrierPlanner barriers;
+    for (int i = 0; i < FRAME_RING_DEPTH; ++i) {
         auto& frame = renderer->GetFrame(i);
         if (frame.mainFramebufferDS != VK_NULL_HANDLE)
             ImGui_ImplVulkan_RemoveTexture(frame.mainFramebufferDS);
@@ -212,8 +208,6 @@ RND_Renderer::ImGuiOverlay::~ImGuiOverlay() {
             frame.hudFramebuffer.reset();
         if (frame.hudWithoutAlphaFramebufferDS != VK_NULL_HANDLE)
             ImGui_ImplVulkan_RemoveTexture(frame.hudWithoutAlphaFramebufferDS);
-        if (frame.hudWithoutAlphaFramebuffer != nullptr)
-            frame.hudWithoutAlphaFramebuffer.reset();
         if (frame.imguiFramebuffer != nullptr)
             frame.imguiFramebuffer.reset();
     }
@@ -233,6 +227,83 @@ RND_Renderer::ImGuiOverlay::~ImGuiOverlay() {
 
 constexpr ImGuiWindowFlags FULLSCREEN_WINDOW_FLAGS = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoBringToFrontOnFocus;
 
+void DrawSwapchainStats(const char* name, const SwapchainStats& stats) {
+    if (!ImGui::TreeNode(name)) {
+        return;
+    }
+
+    ImGui::Text("Last %u images: %u acquires or waits timed out", SwapchainStats::WINDOW, stats.timeouts);
+    auto drawLatency = [](const char* label, const LatencyHistogram& histogram) {
+        std::array<float, LatencyHistogram::BUCKET_COUNT> buckets;
+        std::ranges::transform(histogram.GetBuckets(), buckets.begin(), [](uint32_t count) { return (float)count; });
+        const std::string overlay = std::format("max {:.2f}ms", histogram.GetMaxMs());
+        ImGui::PlotHistogram(label, buckets.data(), (int)buckets.size(), 0, overlay.c_str(), 0.0f, FLT_MAX, ImVec2(0.0f, 50.0f));
+        ImGui::TextUnformatted(histogram.ToString().c_str());
+    };
+    drawLatency("Acquire", stats.acquireLatency);
+    drawLatency("Wait", stats.waitLatency);
+    ImGui::TreePop();
+}
+
+void DrawPresentOptions(RND_Renderer* renderer) {
+    if (!renderer->m_layer3D) {
+        return;
+    }
+
+    if (ImGui::Begin("Present Options")) {
+        auto& options = renderer->m_layer3D->GetPresentOptions();
+
+        ImGui::Checkbox("Pipelined Present", &options.pipelined);
+
+        if (ImGui::BeginCombo("Reprojection", ReprojectionQualityName(options.reprojection))) {
+            for (uint8_t i = 0; i < (uint8_t)Reprojection::Quality::COUNT; i++) {
+                const Reprojection::Quality quality = (Reprojection::Quality)i;
+                if (ImGui::Selectable(ReprojectionQualityName(quality), options.reprojection == quality)) {
+                    options.reprojection = quality;
+                }
+            }
+            ImGui::EndCombo();
+        }
+
+        ImGui::Checkbox("Alternate Eyes", &options.alternateEyes);
+        if (options.alternateEyes && options.reprojection == Reprojection::Quality::OFF) {
+            ImGui::Text("Needs reprojection to render a single eye per frame");
+        }
+        else if (options.alternateEyes) {
+            const EyeScheduler::Stats stats = renderer->GetEyeSchedulerStats();
+            ImGui::Text("Last %u frames: %u single eye (%u out of turn), %u both eyes, %u missed captures", EyeScheduler::STATS_WINDOW, stats.singleEyeFrames, stats.outOfTurnFrames, stats.bothEyeFrames, stats.missedCaptures);
+        }
+
+        const ClearDetector::Stats clearStats = GetClearDetectorStats();
+        ImGui::Text("Last %u frames: %u missing a clear, %u clears out of order", ClearDetector::STATS_WINDOW, clearStats.incompleteFrames, clearStats.outOfOrderClears);
+
+        const DescriptorArena::Stats descriptorStats = VRManager::instance().D3D12->GetDescriptorArena()->GetStats();
+        ImGui::Text("Last %u frames: %.2f views created and %.2f reused per frame, %.2f table descriptors per frame", DescriptorArena::STATS_WINDOW, (double)descriptorStats.viewsCreated / DescriptorArena::STATS_WINDOW, (double)descriptorStats.viewsReused / DescriptorArena::STATS_WINDOW, (double)descriptorStats.transientDescriptors / DescriptorArena::STATS_WINDOW);
+
+        if (renderer->m_imguiOverlay) {
+            const OverlayDrawCache::Stats overlayStats = renderer->m_imguiOverlay->GetDrawCacheStats();
+            ImGui::Text("Last %u overlay frames: %u skipped, %u redrawn partially (%.0f%% on average), %u redrawn fully", OverlayDrawCache::STATS_WINDOW, overlayStats.skippedFrames, overlayStats.partialFrames, overlayStats.partialFrames != 0 ? overlayStats.partialCoverage / overlayStats.partialFrames * 100.0 : 0.0, overlayStats.fullFrames);
+        }
+
+        if (renderer->m_layer2D) {
+            ImGui::Checkbox("Controller Debug Quads", &renderer->m_layer2D->GetQuadOptions().showControllerQuads);
+        }
+
+        // the buckets double from the first bound, the last one holds everything that took longer than the one before it
+        const std::string latencyHeader = std::format("Swapchain Latency (<{}ms to >={}ms)", LatencyHistogram::GetBucketBoundMs(0), LatencyHistogram::GetBucketBoundMs(LatencyHistogram::BUCKET_COUNT - 2));
+        if (ImGui::CollapsingHeader(latencyHeader.c_str())) {
+            for (const auto& [name, stats] : renderer->m_layer3D->GetSwapchainStats()) {
+                DrawSwapchainStats(name, stats);
+            }
+            if (renderer->m_layer2D) {
+                const auto [name, stats] = renderer->m_layer2D->GetSwapchainStats();
+                DrawSwapchainStats(name, stats);
+            }
+        }
+    }
+    ImGui::End();
+}
+
 void DrawFPSOverlay(RND_Renderer* renderer) {
     ImGui::SetNextWindowBgAlpha(0.6f);
 
@@ -384,7 +455,7 @@ void RND_Renderer::ImGuiOverlay::BeginFrame(long frameIdx, bool renderBackground
         frame.hudFramebufferDS = ImGui_ImplVulkan_AddTexture(m_sampler, frame.hudFramebuffer->GetImageView(), VK_IMAGE_LAYOUT_GENERAL);
     }
     if (frame.hudWithoutAlphaFramebufferDS == VK_NULL_HANDLE) {
-        frame.hudWithoutAlphaFramebufferDS = ImGui_ImplVulkan_AddTexture(m_sampler, frame.hudWithoutAlphaFramebuffer->GetImageView(), VK_IMAGE_LAYOUT_GENERAL);
+        frame.hudWithoutAlphaFramebufferDS = ImGui_ImplVulkan_AddTexture(m_sampler, frame.hudFramebuffer->GetOpaqueImageView(), VK_IMAGE_LAYOUT_GENERAL);
     }
 
     if (renderBackground || CemuHooks::UseBlackBarsDuringEvents()) {
@@ -481,6 +552,7 @@ void RND_Renderer::ImGuiOverlay::BeginFrame(long frameIdx, bool renderBackground
     if (VRManager::instance().Hooks->m_entityDebugger) {
         VRManager::instance().Hooks->m_entityDebugger->DrawEntityInspector();
         VRManager::instance().Hooks->DrawDebugOverlays();
+        DrawPresentOptions(renderer);
     }
 
     if ((renderBackground && m_showAppMS == 1) || (m_showAppMS == 2)) {
@@ -488,18 +560,19 @@ void RND_Renderer::ImGuiOverlay::BeginFrame(long frameIdx, bool renderBackground
     }
 }
 
-void RND_Renderer::ImGuiOverlay::Draw3DLayerAsBackground(VkCommandBuffer cb, VkImage srcImage, float aspectRatio, long frameIdx) {
+void RND_Renderer::ImGuiOverlay::Draw3DLayerAsBackground(VkCommandBuffer cb, BarrierPlanner& barriers, VkImage srcImage, float aspectRatio, long frameIdx) {
     auto& frame = VRManager::instance().XR->GetRenderer()->GetFrame(frameIdx);
 
-    frame.mainFramebuffer->vkCopyFromImage(cb, srcImage);
+    frame.mainFramebuffer->vkCopyFromImage(cb, barriers, srcImage);
     frame.mainFramebufferAspectRatio = aspectRatio;
+    frame.mainFramebufferVersion++;
 }
 
-void RND_Renderer::ImGuiOverlay::DrawHUDLayerAsBackground(VkCommandBuffer cb, VkImage srcImage, long frameIdx) {
+void RND_Renderer::ImGuiOverlay::DrawHUDLayerAsBackground(VkCommandBuffer cb, BarrierPlanner& barriers, VkImage srcImage, long frameIdx) {
     auto& frame = VRManager::instance().XR->GetRenderer()->GetFrame(frameIdx);
 
-    frame.hudFramebuffer->vkCopyFromImage(cb, srcImage);
-    frame.hudWithoutAlphaFramebuffer->vkCopyFromImage(cb, srcImage);
+    frame.hudFramebuffer->vkCopyFromImage(cb, barriers, srcImage);
+    frame.hudFramebufferVersion++;
 }
 
 void RND_Renderer::ImGuiOverlay::Render() {
@@ -564,36 +637,75 @@ void RND_Renderer::ImGuiOverlay::Update() {
     }
 }
 
-void RND_Renderer::ImGuiOverlay::DrawAndCopyToImage(VkCommandBuffer cb, VkImage destImage, long frameIdx) {
+void RND_Renderer::ImGuiOverlay::DrawAndCopyToImage(VkCommandBuffer cb, BarrierPlanner& barriers, VkImage destImage, long frameIdx) {
     auto* dispatch = VRManager::instance().VK->GetDeviceDispatch();
     auto* renderer = VRManager::instance().XR->GetRenderer();
     auto& frame = renderer->GetFrame(frameIdx);
 
-    // transition framebuffer to color attachment
-    frame.imguiFramebuffer->vkClear(cb, { 0.0f, 0.0f, 0.0f, 0.0f });
-
-    // start render pass
-    VkClearValue clearValue = { .color = { 0.0f, 0.0f, 0.0f, 0.0f } };
-    VkRenderPassBeginInfo renderPassInfo = {
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .renderPass = m_renderPass,
-        .framebuffer = frame.imguiFramebuffer->GetFramebuffer(),
-        .renderArea = {
-            .offset = { 0, 0 },
-            .extent = { (uint32_t)ImGui::GetIO().DisplaySize.x, (uint32_t)ImGui::GetIO().DisplaySize.y } },
-        .clearValueCount = 0,
-        .pClearValues = &clearValue
+    // the framebuffer still holds what was last drawn into it, so only the parts where the overlay changed are cleared and drawn again
+    auto textureVersion = [renderer](ImTextureID textureId) -> uint64_t {
+        for (long i = 0; i < FRAME_RING_DEPTH; ++i) {
+            const auto& slot = renderer->GetFrame(i);
+            if (textureId == (ImTextureID)slot.mainFramebufferDS) {
+                return slot.mainFramebufferVersion;
+            }
+            if (textureId == (ImTextureID)slot.hudFramebufferDS || textureId == (ImTextureID)slot.hudWithoutAlphaFramebufferDS) {
+                return slot.hudFramebufferVersion;
+            }
+        }
+        return 0;
     };
-    dispatch->CmdBeginRenderPass(cb, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    const OverlayDrawCache::Plan plan = m_drawCache.Prepare((size_t)frameIdx, ImGui::GetDrawData(), textureVersion);
+
+    if (plan.redraw) {
+        // transition framebuffer to color attachment, and make the copied backgrounds visible to the overlay's fragment shader
+        frame.mainFramebuffer->vkUse(barriers, BarrierPlanner::FragmentShaderRead());
+        frame.hudFramebuffer->vkUse(barriers, BarrierPlanner::FragmentShaderRead());
+        frame.imguiFramebuffer->vkUse(barriers, BarrierPlanner::ColorAttachment());
+        barriers.Flush(cb);
+
+        auto toVkRect = [&frame](const OverlayDrawCache::Rect& rect) -> VkRect2D {
+            const int32_t minX = std::clamp(rect.minX, 0, (int32_t)frame.imguiFramebuffer->GetWidth());
+            const int32_t minY = std::clamp(rect.minY, 0, (int32_t)frame.imguiFramebuffer->GetHeight());
+            const int32_t maxX = std::clamp(rect.maxX, minX, (int32_t)frame.imguiFramebuffer->GetWidth());
+            const int32_t maxY = std::clamp(rect.maxY, minY, (int32_t)frame.imguiFramebuffer->GetHeight());
+            return { .offset = { minX, minY }, .extent = { (uint32_t)(maxX - minX), (uint32_t)(maxY - minY) } };
+        };
+
+        // start render pass
+        VkRenderPassBeginInfo renderPassInfo = {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = m_renderPass,
+            .framebuffer = frame.imguiFramebuffer->GetFramebuffer(),
+            .renderArea = toVkRect(plan.GetBounds()),
+            .clearValueCount = 0,
+            .pClearValues = nullptr
+        };
+        dispatch->CmdBeginRenderPass(cb, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+        VkClearAttachment clearAttachment = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .colorAttachment = 0,
+            .clearValue = { .color = { 0.0f, 0.0f, 0.0f, 0.0f } }
+        };
+        std::vector<VkClearRect> clearRects;
+        for (const OverlayDrawCache::Rect& rect : plan.dirtyRects) {
+            VkClearRect clearRect = { .rect = toVkRect(rect), .baseArrayLayer = 0, .layerCount = 1 };
+            if (clearRect.rect.extent.width != 0 && clearRect.rect.extent.height != 0) {
+                clearRects.emplace_back(clearRect);
+            }
+        }
+        if (!clearRects.empty()) {
+            dispatch->CmdClearAttachments(cb, 1, &clearAttachment, (uint32_t)clearRects.size(), clearRects.data());
+        }
 
-    // render imgui
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cb);
+        // render imgui
+        ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cb);
 
-    // end render pass
-    dispatch->CmdEndRenderPass(cb);
+        // end render pass
+        dispatch->CmdEndRenderPass(cb);
+    }
 
     // copy rendered imgui to destination image
-    frame.imguiFramebuffer->vkPipelineBarrier(cb);
-    frame.imguiFramebuffer->vkCopyToImage(cb, destImage);
-    frame.imguiFramebuffer->vkPipelineBarrier(cb);
+    frame.imguiFramebuffer->vkCopyToImage(cb, barriers, destImage);
 }
\ No newline at end of file
@@ -98,6 +98,91 @@ PSOutput PSMain(PSInput input) {
 )hlsl";
 
 
+// mirrors Reprojection::GetVertex and Reprojection::GetSampleTexel, the grid is drawn without any vertex or index buffer
+constexpr char reprojectHLSL[] = R"hlsl(
+struct VSInput {
+    uint vertexId : SV_VertexID;
+};
+
+struct PSInput {
+    float4 position : SV_POSITION;
+    float2 uv : TEXCOORD;
+};
+
+struct PSOutput {
+    float4 Color : SV_TARGET;
+};
+
+cbuffer g_settings : register(b1) {
+    float4x4 reprojection;
+    uint cellsX;
+    uint cellsY;
+    float cellSize;
+    float holeTolerance;
+    float textureWidth;
+    float textureHeight;
+    float targetWidth;
+    float targetHeight;
+};
+
+Texture2D g_colorTexture : register(t0);
+Texture2D<float> g_depthTexture : register(t1);
+
+static const int2 cellCorners[6] = { int2(0, 0), int2(1, 0), int2(0, 1), int2(0, 1), int2(1, 0), int2(1, 1) };
+
+int2 ClampTexel(int2 texel) {
+    return clamp(texel, int2(0, 0), int2(textureWidth, textureHeight) - 1);
+}
+
+float4 Reproject(float2 uv, float depth) {
+    return mul(reprojection, float4(uv.x * 2.0 - 1.0, 1.0 - uv.y * 2.0, depth, 1.0));
+}
+
+PSInput VSMain(VSInput input) {
+    uint cell = input.vertexId / 6;
+    int2 gridPosition = int2(cell % cellsX, cell / cellsX) + cellCorners[input.vertexId % 6];
+    float2 position = min(float2(gridPosition) * cellSize, float2(textureWidth, textureHeight));
+    int2 texel = ClampTexel(int2(position));
+
+    PSInput output;
+    output.uv = position / float2(textureWidth, textureHeight);
+    output.position = Reproject(output.uv, g_depthTexture.Load(int3(texel, 0)));
+    return output;
+}
+
+PSOutput PSMain(PSInput input) {
+    float2 textureSize = float2(textureWidth, textureHeight);
+    int2 texel = ClampTexel(int2(floor(input.uv * textureSize)));
+
+    // a texel that isn't reprojected close to this pixel was interpolated across the hole behind an edge, which is filled with the farthest texel within a cell
+    if (holeTolerance > 0.0) {
+        float4 clip = Reproject((float2(texel) + 0.5) / textureSize, g_depthTexture.Load(int3(texel, 0)));
+        float2 reprojectedPixel = float2(clip.x / clip.w * 0.5 + 0.5, 0.5 - clip.y / clip.w * 0.5) * float2(targetWidth, targetHeight);
+        if (clip.w <= 1e-6 || length(reprojectedPixel - input.position.xy) > holeTolerance) {
+            int step = int(cellSize);
+            int2 offsets[5] = { int2(0, 0), int2(-step, 0), int2(step, 0), int2(0, -step), int2(0, step) };
+            int2 farthestTexel = texel;
+            float farthestDepth = -1.0;
+            [unroll]
+            for (int i = 0; i < 5; i++) {
+                int2 candidate = ClampTexel(texel + offsets[i]);
+                float depth = g_depthTexture.Load(int3(candidate, 0));
+                if (depth > farthestDepth) {
+                    farthestDepth = depth;
+                    farthestTexel = candidate;
+                }
+            }
+            texel = farthestTexel;
+        }
+    }
+
+    PSOutput output;
+    output.Color = g_colorTexture.Load(int3(texel, 0));
+    return output;
+}
+)hlsl";
+
+
 struct presentSettings {
     float renderWidth;
     float renderHeight;
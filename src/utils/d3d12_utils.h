@@ -1,17 +1,17 @@
 #pragma once
 
 namespace D3D12Utils {
-    static ComPtr<ID3DBlob> CompileShader(const char* sourceHLSL, const char* entryPoint, const char* version) {
-        DWORD shaderCompileFlags = D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR | D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_WARNINGS_ARE_ERRORS;
+    // part of the shader cache's keys, so debug and release builds don't share bytecode
 #ifdef _DEBUG
-        shaderCompileFlags |= D3DCOMPILE_SKIP_OPTIMIZATION;
-        shaderCompileFlags |= D3DCOMPILE_DEBUG;
+    constexpr DWORD SHADER_COMPILE_FLAGS = D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR | D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_WARNINGS_ARE_ERRORS | D3DCOMPILE_SKIP_OPTIMIZATION | D3DCOMPILE_DEBUG;
 #else
-        shaderCompileFlags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
+    constexpr DWORD SHADER_COMPILE_FLAGS = D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR | D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_WARNINGS_ARE_ERRORS | D3DCOMPILE_OPTIMIZATION_LEVEL3;
 #endif
+
+    static ComPtr<ID3DBlob> CompileShader(const char* sourceHLSL, const char* entryPoint, const char* version) {
         ComPtr<ID3DBlob> shaderBytes;
         ID3DBlob* hlslCompilationErrors;
-        if (FAILED(D3DCompile(sourceHLSL, strlen(sourceHLSL), nullptr, nullptr, nullptr, entryPoint, version, shaderCompileFlags, 0, &shaderBytes, &hlslCompilationErrors))) {
+        if (FAILED(D3DCompile(sourceHLSL, strlen(sourceHLSL), nullptr, nullptr, nullptr, entryPoint, version, SHADER_COMPILE_FLAGS, 0, &shaderBytes, &hlslCompilationErrors))) {
             std::string errorMessage((const char*)hlslCompilationErrors->GetBufferPointer(), hlslCompilationErrors->GetBufferSize());
             Log::print<ERROR>("Vertex Shader Compilation Error:");
             Log::print<ERROR>(errorMessage.c_str());
@@ -0,0 +1,151 @@
+#include "test.h"
+#include "rendering/action_poller.h"
+
+// a runtime that hands out the states that the test set for each action and subaction path, and remembers what was asked for
+struct MockRuntime {
+    struct Value {
+        bool isActive = true;
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    std::map<std::pair<XrAction, XrPath>, Value> values;
+    std::vector<XrActionStateGetInfo> queries;
+    XrResult result = XR_SUCCESS;
+
+    const Value& Query(const XrActionStateGetInfo* getInfo) {
+        queries.push_back(*getInfo);
+        return values[{ getInfo->action, getInfo->subactionPath }];
+    }
+};
+static MockRuntime s_runtime;
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state) {
+    const MockRuntime::Value& value = s_runtime.Query(getInfo);
+    state->isActive = value.isActive;
+    state->currentState = value.x != 0.0f;
+    return s_runtime.result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateFloat(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state) {
+    const MockRuntime::Value& value = s_runtime.Query(getInfo);
+    state->isActive = value.isActive;
+    state->currentState = value.x;
+    return s_runtime.result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateVector2f(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state) {
+    const MockRuntime::Value& value = s_runtime.Query(getInfo);
+    state->isActive = value.isActive;
+    state->currentState = { value.x, value.y };
+    return s_runtime.result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStatePose(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStatePose* state) {
+    state->isActive = s_runtime.Query(getInfo).isActive;
+    return s_runtime.result;
+}
+
+static const XrSession SESSION = (XrSession)0x1;
+static const XrPath LEFT_PATH = 0x10;
+static const XrPath RIGHT_PATH = 0x20;
+
+static ActionPoller::Action MakeAction(const char* id, uintptr_t handle, XrActionType type, ActionPoller::Subaction subaction = ActionPoller::Subaction::NONE) {
+    return { id, (XrAction)handle, type, subaction };
+}
+
+static void ResetRuntime() {
+    s_runtime = {};
+}
+
+TEST_CASE(SubactionPathsFollowTheAction) {
+    ResetRuntime();
+    const ActionPoller poller(SESSION, { LEFT_PATH, RIGHT_PATH });
+    XrActionStateBoolean state = {};
+    const XrActionStateBoolean prevState = {};
+
+    poller.Poll(MakeAction("jump", 1, XR_ACTION_TYPE_BOOLEAN_INPUT), 0, &state, &prevState);
+    const ActionPoller::Action grab = MakeAction("grab", 2, XR_ACTION_TYPE_BOOLEAN_INPUT, ActionPoller::Subaction::BOTH_HANDS);
+    for (uint8_t hand = 0; hand < ActionPoller::GetHandCount(grab.subaction); hand++) {
+        poller.Poll(grab, hand, &state, &prevState);
+    }
+    poller.Poll(MakeAction("map", 3, XR_ACTION_TYPE_BOOLEAN_INPUT, ActionPoller::Subaction::RIGHT_HAND), 0, &state, &prevState);
+
+    CHECK_EQ(s_runtime.queries.size(), 4u);
+    CHECK(s_runtime.queries[0].action == (XrAction)1);
+    CHECK_EQ(s_runtime.queries[0].subactionPath, XR_NULL_PATH);
+    CHECK_EQ(s_runtime.queries[1].subactionPath, LEFT_PATH);
+    CHECK_EQ(s_runtime.queries[2].subactionPath, RIGHT_PATH);
+    CHECK(s_runtime.queries[3].action == (XrAction)3);
+    CHECK_EQ(s_runtime.queries[3].subactionPath, RIGHT_PATH);
+    CHECK_EQ(ActionPoller::GetHandCount(ActionPoller::Subaction::RIGHT_HAND), 1);
+}
+
+TEST_CASE(StatesAreReadAndComparedWithThePreviousPoll) {
+    ResetRuntime();
+    const ActionPoller poller(SESSION, { LEFT_PATH, RIGHT_PATH });
+
+    const ActionPoller::Action jump = MakeAction("jump", 1, XR_ACTION_TYPE_BOOLEAN_INPUT);
+    XrActionStateBoolean jumpState = {};
+    XrActionStateBoolean prevJumpState = {};
+    s_runtime.values[{ jump.action, XR_NULL_PATH }] = { .x = 1.0f };
+    ActionPoller::Result polled = poller.Poll(jump, 0, &jumpState, &prevJumpState);
+    CHECK(polled.isActive && polled.pressed && polled.changed);
+    CHECK_EQ(jumpState.type, XR_TYPE_ACTION_STATE_BOOLEAN);
+    CHECK_EQ(jumpState.currentState, XR_TRUE);
+    prevJumpState = jumpState;
+    polled = poller.Poll(jump, 0, &jumpState, &prevJumpState);
+    CHECK(polled.pressed && !polled.changed);
+
+    // the grab is a float that only counts as pressed past the threshold, each hand is compared with its own previous value
+    const ActionPoller::Action grab = MakeAction("grab", 2, XR_ACTION_TYPE_FLOAT_INPUT, ActionPoller::Subaction::BOTH_HANDS);
+    std::array<XrActionStateFloat, 2> grabStates = {};
+    std::array<XrActionStateFloat, 2> prevGrabStates = {};
+    prevGrabStates[1].currentState = 0.9f;
+    s_runtime.values[{ grab.action, LEFT_PATH }] = { .x = 0.5f };
+    s_runtime.values[{ grab.action, RIGHT_PATH }] = { .x = 0.9f };
+    polled = poller.Poll(grab, 0, &grabStates[0], &prevGrabStates[0]);
+    CHECK(polled.isActive && !polled.pressed && polled.changed);
+    polled = poller.Poll(grab, 1, &grabStates[1], &prevGrabStates[1]);
+    CHECK(polled.pressed && !polled.changed);
+
+    const ActionPoller::Action move = MakeAction("move", 3, XR_ACTION_TYPE_VECTOR2F_INPUT);
+    XrActionStateVector2f moveState = {};
+    XrActionStateVector2f prevMoveState = {};
+    prevMoveState.currentState = { 0.25f, 0.0f };
+    s_runtime.values[{ move.action, XR_NULL_PATH }] = { .x = 0.25f, .y = -0.5f };
+    polled = poller.Poll(move, 0, &moveState, &prevMoveState);
+    CHECK(polled.changed && !polled.pressed);
+    CHECK_EQ(moveState.currentState.y, -0.5f);
+
+    // poses only change when the runtime starts or stops tracking them
+    const ActionPoller::Action pose = MakeAction("pose", 4, XR_ACTION_TYPE_POSE_INPUT, ActionPoller::Subaction::BOTH_HANDS);
+    XrActionStatePose poseState = {};
+    XrActionStatePose prevPoseState = {};
+    prevPoseState.isActive = XR_TRUE;
+    s_runtime.values[{ pose.action, RIGHT_PATH }] = { .isActive = false };
+    polled = poller.Poll(pose, 1, &poseState, &prevPoseState);
+    CHECK(!polled.isActive && polled.changed);
+}
+
+TEST_CASE(FailuresThrow) {
+    ResetRuntime();
+    const ActionPoller poller(SESSION, { LEFT_PATH, RIGHT_PATH });
+    XrActionStateBoolean state = {};
+    const XrActionStateBoolean prevState = {};
+
+    s_runtime.result = XR_ERROR_SESSION_LOST;
+    CHECK_THROWS(poller.Poll(MakeAction("jump", 1, XR_ACTION_TYPE_BOOLEAN_INPUT), 0, &state, &prevState));
+
+    // outputs like the rumble are in the registry too, but can't be polled
+    s_runtime.result = XR_SUCCESS;
+    CHECK_THROWS(poller.Poll(MakeAction("rumble", 2, XR_ACTION_TYPE_VIBRATION_OUTPUT), 0, &state, &prevState));
+    CHECK_EQ(s_runtime.queries.size(), 1u);
+}
+
+TEST_CASE(OnlyPerHandActionsAreDescribedWithTheirHand) {
+    CHECK_EQ(ActionPoller::Describe(MakeAction("jump", 1, XR_ACTION_TYPE_BOOLEAN_INPUT), 0), std::string("jump"));
+    CHECK_EQ(ActionPoller::Describe(MakeAction("map", 2, XR_ACTION_TYPE_BOOLEAN_INPUT, ActionPoller::Subaction::RIGHT_HAND), 0), std::string("map"));
+    CHECK_EQ(ActionPoller::Describe(MakeAction("grab", 3, XR_ACTION_TYPE_FLOAT_INPUT, ActionPoller::Subaction::BOTH_HANDS), 0), std::string("grab (left hand)"));
+    CHECK_EQ(ActionPoller::Describe(MakeAction("grab", 3, XR_ACTION_TYPE_FLOAT_INPUT, ActionPoller::Subaction::BOTH_HANDS), 1), std::string("grab (right hand)"));
+}
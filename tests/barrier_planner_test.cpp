@@ -0,0 +1,170 @@
+#include "test.h"
+#include "rendering/barrier_planner.h"
+
+static const VkImage CEMU_IMAGE = reinterpret_cast<VkImage>(0x1000);
+static const VkImage LAYER_TEXTURE = reinterpret_cast<VkImage>(0x2000);
+static const VkCommandBuffer COMMAND_BUFFER = reinterpret_cast<VkCommandBuffer>(0x3000);
+
+struct ExpectedBarrier {
+    VkPipelineStageFlags2 srcStages;
+    VkAccessFlags2 srcAccess;
+    VkPipelineStageFlags2 dstStages;
+    VkAccessFlags2 dstAccess;
+    VkImageLayout oldLayout;
+    VkImageLayout newLayout;
+};
+
+static void CheckBarriers(const std::vector<VkImageMemoryBarrier2>& barriers, VkImage image, std::initializer_list<ExpectedBarrier> expected, const char* file, int line) {
+    if (barriers.size() != expected.size()) {
+        Test::Fail(file, line, std::format("expected {} barriers, got {}", expected.size(), barriers.size()));
+        return;
+    }
+    for (size_t i = 0; i < barriers.size(); i++) {
+        const VkImageMemoryBarrier2& barrier = barriers[i];
+        const ExpectedBarrier& expectedBarrier = expected.begin()[i];
+        if (barrier.image != image || barrier.srcStageMask != expectedBarrier.srcStages || barrier.srcAccessMask != expectedBarrier.srcAccess || barrier.dstStageMask != expectedBarrier.dstStages || barrier.dstAccessMask != expectedBarrier.dstAccess || barrier.oldLayout != expectedBarrier.oldLayout || barrier.newLayout != expectedBarrier.newLayout) {
+            Test::Fail(file, line, std::format(
+                "barrier {} is src 0x{:X}/0x{:X} dst 0x{:X}/0x{:X} layout {} -> {}, expected src 0x{:X}/0x{:X} dst 0x{:X}/0x{:X} layout {} -> {}", i,
+                barrier.srcStageMask, barrier.srcAccessMask, barrier.dstStageMask, barrier.dstAccessMask, (int)barrier.oldLayout, (int)barrier.newLayout,
+                expectedBarrier.srcStages, expectedBarrier.srcAccess, expectedBarrier.dstStages, expectedBarrier.dstAccess, (int)expectedBarrier.oldLayout, (int)expectedBarrier.newLayout
+            ));
+        }
+        if (barrier.subresourceRange.aspectMask == 0 || barrier.subresourceRange.levelCount != VK_REMAINING_MIP_LEVELS || barrier.subresourceRange.layerCount != VK_REMAINING_ARRAY_LAYERS) {
+            Test::Fail(file, line, std::format("barrier {} doesn't cover the whole image", i));
+        }
+    }
+}
+
+#define CHECK_BARRIERS(barriers, image, ...) CheckBarriers(barriers, image, __VA_ARGS__, __FILE__, __LINE__)
+
+constexpr VkPipelineStageFlags2 ALL_COMMANDS = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+constexpr VkPipelineStageFlags2 TRANSFER = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+constexpr VkPipelineStageFlags2 FRAGMENT_SHADER = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+constexpr VkImageLayout CEMU_LAYOUT = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+TEST_CASE(CemusImageIsCopiedAndHandedBack) {
+    BarrierPlanner barriers;
+    barriers.Track(CEMU_IMAGE, VK_IMAGE_ASPECT_COLOR_BIT, CEMU_LAYOUT);
+
+    // anything that Cemu recorded before could've written it
+    barriers.Use(CEMU_IMAGE, BarrierPlanner::TransferSrc());
+    CHECK_BARRIERS(barriers.TakeBarriers(), CEMU_IMAGE, {
+        { ALL_COMMANDS, VK_ACCESS_2_MEMORY_WRITE_BIT, TRANSFER, VK_ACCESS_2_TRANSFER_READ_BIT, CEMU_LAYOUT, VK_IMAGE_LAYOUT_GENERAL }
+    });
+
+    // the copy only read it, so Cemu's commands only have to wait for the copy and nothing has to be made available
+    barriers.Release(CEMU_IMAGE, CEMU_LAYOUT);
+    CHECK_BARRIERS(barriers.TakeBarriers(), CEMU_IMAGE, {
+        { TRANSFER, VK_ACCESS_2_NONE, ALL_COMMANDS, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, CEMU_LAYOUT }
+    });
+}
+
+TEST_CASE(UnusedImageIsReleasedWithoutABarrier) {
+    BarrierPlanner barriers;
+    barriers.Track(CEMU_IMAGE, VK_IMAGE_ASPECT_COLOR_BIT, CEMU_LAYOUT);
+    barriers.Release(CEMU_IMAGE, CEMU_LAYOUT);
+    CHECK(barriers.TakeBarriers().empty());
+}
+
+TEST_CASE(ReadsOnlyWaitForWritesThatArentVisibleYet) {
+    BarrierPlanner barriers;
+    barriers.Track(LAYER_TEXTURE, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_GENERAL);
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferDst());
+    CHECK_BARRIERS(barriers.TakeBarriers(), LAYER_TEXTURE, {
+        { ALL_COMMANDS, VK_ACCESS_2_MEMORY_WRITE_BIT, TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL }
+    });
+
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::FragmentShaderRead());
+    CHECK_BARRIERS(barriers.TakeBarriers(), LAYER_TEXTURE, {
+        { TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, FRAGMENT_SHADER, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL }
+    });
+
+    // the copy was already made visible to the fragment shader, but not to a transfer
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::FragmentShaderRead());
+    CHECK(barriers.TakeBarriers().empty());
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferSrc());
+    CHECK_BARRIERS(barriers.TakeBarriers(), LAYER_TEXTURE, {
+        { TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, TRANSFER, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL }
+    });
+
+    // the next write has to wait for both reads, which already waited for the copy
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferDst());
+    CHECK_BARRIERS(barriers.TakeBarriers(), LAYER_TEXTURE, {
+        { TRANSFER | FRAGMENT_SHADER, VK_ACCESS_2_NONE, TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL }
+    });
+
+    // a write that nothing read yet still has to be made available
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferDst());
+    CHECK_BARRIERS(barriers.TakeBarriers(), LAYER_TEXTURE, {
+        { TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL }
+    });
+}
+
+TEST_CASE(AccessesOfTheSameOperationShareABarrier) {
+    BarrierPlanner barriers;
+    barriers.Track(LAYER_TEXTURE, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::FragmentShaderRead());
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferSrc());
+    CHECK_BARRIERS(barriers.TakeBarriers(), LAYER_TEXTURE, {
+        { ALL_COMMANDS, VK_ACCESS_2_MEMORY_WRITE_BIT, FRAGMENT_SHADER | TRANSFER, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL }
+    });
+
+    // a draw can't sample the texture in another layout than it renders to it in
+    BarrierPlanner otherBarriers;
+    otherBarriers.Track(LAYER_TEXTURE, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+    otherBarriers.Use(LAYER_TEXTURE, BarrierPlanner::FragmentShaderRead());
+    CHECK_THROWS(otherBarriers.Use(LAYER_TEXTURE, BarrierPlanner::ColorAttachment()));
+}
+
+TEST_CASE(CarriedStateSkipsTheConservativeBarrier) {
+    // the first hook copies into the layer's texture, the next one draws the overlay from it
+    BarrierPlanner::ImageState state;
+    {
+        BarrierPlanner barriers;
+        barriers.Track(LAYER_TEXTURE, VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED);
+        barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferDst());
+        barriers.TakeBarriers();
+        barriers.Use(LAYER_TEXTURE, BarrierPlanner::FragmentShaderRead());
+        barriers.TakeBarriers();
+        state = barriers.GetState(LAYER_TEXTURE);
+    }
+
+    BarrierPlanner barriers;
+    barriers.Track(LAYER_TEXTURE, state);
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::FragmentShaderRead());
+    CHECK(barriers.TakeBarriers().empty());
+
+    // the copy of the next frame only waits for the overlay's reads instead of everything that came before
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferDst());
+    CHECK_BARRIERS(barriers.TakeBarriers(), LAYER_TEXTURE, {
+        { FRAGMENT_SHADER, VK_ACCESS_2_NONE, TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL }
+    });
+}
+
+TEST_CASE(FlushRecordsEveryQueuedBarrierAtOnce) {
+    auto& recorded = vkroots::tables::CommandBufferDispatches.dispatch.pipelineBarriers;
+    recorded.clear();
+
+    BarrierPlanner barriers;
+    barriers.Flush(COMMAND_BUFFER);
+    CHECK(recorded.empty());
+
+    barriers.Track(CEMU_IMAGE, VK_IMAGE_ASPECT_COLOR_BIT, CEMU_LAYOUT);
+    barriers.Track(LAYER_TEXTURE, VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_GENERAL);
+    barriers.Use(CEMU_IMAGE, BarrierPlanner::TransferSrc());
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferDst());
+    barriers.Flush(COMMAND_BUFFER);
+    CHECK_EQ(recorded.size(), 1u);
+    CHECK_EQ(recorded.back().size(), 2u);
+    CHECK(recorded.back()[0].image == CEMU_IMAGE);
+    CHECK(recorded.back()[1].image == LAYER_TEXTURE);
+    CHECK_EQ(recorded.back()[1].subresourceRange.aspectMask, (VkImageAspectFlags)VK_IMAGE_ASPECT_DEPTH_BIT);
+
+    // a flushed barrier isn't widened by the accesses of the next operation
+    barriers.Use(LAYER_TEXTURE, BarrierPlanner::TransferDst());
+    barriers.Flush(COMMAND_BUFFER);
+    CHECK_EQ(recorded.size(), 2u);
+    CHECK_BARRIERS(recorded.back(), LAYER_TEXTURE, {
+        { TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, TRANSFER, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL }
+    });
+}
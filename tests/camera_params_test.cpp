@@ -0,0 +1,109 @@
+#include "test.h"
+#include "hooking/camera_params.h"
+
+using Profile = CameraParamOverrides::Profile;
+
+TEST_CASE(ResolvesListedParamsAndTheFallback) {
+    const uint32_t jumpFirstPerson = CameraParamOverrides::Resolve(0x10000000, "JumpHeight", Profile::FIRST_PERSON, false);
+    CHECK(jumpFirstPerson != CameraParamOverrides::NO_OVERRIDE);
+    CHECK_EQ(CameraParamOverrides::Resolve(0x10000000, "JumpHeight", Profile::THIRD_PERSON, false), jumpFirstPerson);
+    // the cutscene profile doesn't list the jump height, so it falls through to the gameplay one
+    CHECK_EQ(CameraParamOverrides::Resolve(0x10000000, "JumpHeight", Profile::FIRST_PERSON, true), jumpFirstPerson);
+
+    CHECK(CameraParamOverrides::Resolve(0x10000040, "Distance", Profile::FIRST_PERSON, false) != CameraParamOverrides::NO_OVERRIDE);
+    CHECK_EQ(CameraParamOverrides::Resolve(0x10000040, "Distance", Profile::THIRD_PERSON, false), CameraParamOverrides::NO_OVERRIDE);
+}
+
+TEST_CASE(StaysCorrectOnceTheCacheIsFull) {
+    // far more name pointers than the cache holds, so entries keep replacing each other
+    const uint32_t jumpHeight = CameraParamOverrides::Resolve(0x10000000, "JumpHeight", Profile::THIRD_PERSON, false);
+    for (uint32_t round = 0; round < 3; round++) {
+        for (uint32_t i = 0; i < 1000; i++) {
+            const bool isJump = i % 7 == 0;
+            const uint32_t value = CameraParamOverrides::Resolve(0x10100000 + i * 0x20, isJump ? "JumpHeight" : "Distance", Profile::THIRD_PERSON, false);
+            CHECK_EQ(value, isJump ? jumpHeight : CameraParamOverrides::NO_OVERRIDE);
+        }
+    }
+    CHECK_EQ(CameraParamOverrides::Resolve(0x10000000, "JumpHeight", Profile::THIRD_PERSON, false), jumpHeight);
+}
+
+// counts every allocation of the test, so that the old and the new lookup can be compared
+static std::atomic_uint64_t s_allocations = 0;
+
+void* operator new(size_t size) {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// what hook_OverwriteCameraParam did before, copying the name into a std::string on every call
+static uint32_t ResolveByString(const char* paramNameHostPtr, bool firstPerson) {
+    const std::string paramName = paramNameHostPtr;
+    if (paramName == "JumpHeight") {
+        return 0x100C50D0;
+    }
+    return firstPerson ? 0x102B3150 : CameraParamOverrides::NO_OVERRIDE;
+}
+
+// a synthetic stream in the shape of the game's getStaticParam calls, a handful of names that each have a static string in the executable
+struct ParamStream {
+    static constexpr uint32_t BASE_ADDRESS = 0x10200000;
+    static constexpr std::array NAMES = { "JumpHeight", "Distance", "LookAtOffsetY", "FovyMax", "CollisionRadius", "ChaseInterpolateSpeed", "PlayerToCameraDistanceMin", "ZoomRate" };
+
+    std::vector<uint32_t> calls;
+
+    explicit ParamStream(uint32_t length) {
+        // some params are asked for every frame and others only now and then
+        for (uint32_t i = 0; i < length; i++) {
+            calls.push_back((i * 7 + i / 3) % (i % 5 == 0 ? NAMES.size() : 3));
+        }
+    }
+
+    static uint32_t Address(uint32_t name) { return BASE_ADDRESS + name * 0x40; }
+};
+
+TEST_CASE(MatchesTheStringLookupWithoutAllocating) {
+    constexpr uint32_t CALLS = 100'000;
+    const ParamStream stream(CALLS);
+
+    for (const char* name : ParamStream::NAMES) {
+        for (bool firstPerson : { true, false }) {
+            const uint32_t index = (uint32_t)(std::ranges::find(ParamStream::NAMES, name) - ParamStream::NAMES.begin());
+            CHECK_EQ(CameraParamOverrides::Resolve(ParamStream::Address(index), name, firstPerson ? Profile::FIRST_PERSON : Profile::THIRD_PERSON, false), ResolveByString(name, firstPerson));
+        }
+    }
+
+    uint64_t checksum = 0;
+    const uint64_t stringAllocationsBefore = s_allocations.load();
+    const auto stringStart = std::chrono::steady_clock::now();
+    for (uint32_t name : stream.calls) {
+        checksum += ResolveByString(ParamStream::NAMES[name], true);
+    }
+    const auto stringTime = std::chrono::steady_clock::now() - stringStart;
+    const uint64_t stringAllocations = s_allocations.load() - stringAllocationsBefore;
+
+    const uint64_t resolveAllocationsBefore = s_allocations.load();
+    const auto resolveStart = std::chrono::steady_clock::now();
+    for (uint32_t name : stream.calls) {
+        checksum -= CameraParamOverrides::Resolve(ParamStream::Address(name), ParamStream::NAMES[name], Profile::FIRST_PERSON, false);
+    }
+    const auto resolveTime = std::chrono::steady_clock::now() - resolveStart;
+    const uint64_t resolveAllocations = s_allocations.load() - resolveAllocationsBefore;
+
+    CHECK_EQ(checksum, 0u);
+    CHECK_EQ(resolveAllocations, 0u);
+    CHECK(stringAllocations > 0u);
+
+    std::printf("%u calls: the string lookup allocated %llu times at %.1fns per call, the override table allocated %llu times at %.1fns per call\n", CALLS,
+        (unsigned long long)stringAllocations, std::chrono::duration<double, std::nano>(stringTime).count() / CALLS, (unsigned long long)resolveAllocations, std::chrono::duration<double, std::nano>(resolveTime).count() / CALLS);
+}
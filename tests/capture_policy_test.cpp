@@ -0,0 +1,59 @@
+#include "test.h"
+#include "hooking/capture_policy.h"
+
+using ImageKind = CapturePolicy::ImageKind;
+
+static CapturePolicy::ImageInfo Image(uint32_t width, uint32_t height, VkFormat format) {
+    return { .extent = { width, height }, .format = format };
+}
+
+static VkImage FakeImage(uint64_t id) {
+    return (VkImage)(0x1000 + id);
+}
+
+TEST_CASE(SceneColorAndDepthAreClassifiedFrom720p) {
+    CHECK(CapturePolicy::Classify(Image(1280, 720, VK_FORMAT_B10G11R11_UFLOAT_PACK32)) == ImageKind::COLOR);
+    CHECK(CapturePolicy::Classify(Image(1280, 720, VK_FORMAT_D32_SFLOAT)) == ImageKind::DEPTH);
+    CHECK(CapturePolicy::Classify(Image(3840, 2160, VK_FORMAT_B10G11R11_UFLOAT_PACK32)) == ImageKind::COLOR);
+    CHECK(CapturePolicy::Classify(Image(3840, 2160, VK_FORMAT_D32_SFLOAT)) == ImageKind::DEPTH);
+
+    // the reflection, shadow and bloom targets are smaller in at least one direction
+    CHECK(CapturePolicy::Classify(Image(1279, 720, VK_FORMAT_B10G11R11_UFLOAT_PACK32)) == ImageKind::OTHER);
+    CHECK(CapturePolicy::Classify(Image(1280, 719, VK_FORMAT_D32_SFLOAT)) == ImageKind::OTHER);
+    CHECK(CapturePolicy::Classify(Image(640, 360, VK_FORMAT_B10G11R11_UFLOAT_PACK32)) == ImageKind::OTHER);
+    CHECK(CapturePolicy::Classify(Image(4096, 512, VK_FORMAT_D32_SFLOAT)) == ImageKind::OTHER);
+
+    // big images in other color and depth formats
+    CHECK(CapturePolicy::Classify(Image(1920, 1080, VK_FORMAT_R8G8B8A8_UNORM)) == ImageKind::OTHER);
+    CHECK(CapturePolicy::Classify(Image(1920, 1080, VK_FORMAT_D24_UNORM_S8_UINT)) == ImageKind::OTHER);
+    CHECK(CapturePolicy::Classify(Image(1920, 1080, VK_FORMAT_R16G16B16A16_SFLOAT)) == ImageKind::OTHER);
+}
+
+TEST_CASE(OnlyImagesFrom720pAreTracked) {
+    CapturePolicy policy;
+    VkImageCreateInfo createInfo = { .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO, .format = VK_FORMAT_B10G11R11_UFLOAT_PACK32, .extent = { 1920, 1080, 1 } };
+    policy.OnImageCreated(FakeImage(1), CapturePolicy::ImageInfo::FromCreateInfo(createInfo));
+    policy.OnImageCreated(FakeImage(2), Image(1920, 1080, VK_FORMAT_R8G8B8A8_UNORM));
+    policy.OnImageCreated(FakeImage(3), Image(960, 540, VK_FORMAT_B10G11R11_UFLOAT_PACK32));
+
+    const CapturePolicy::ImageInfo* color = policy.FindImage(FakeImage(1));
+    CHECK(color != nullptr);
+    CHECK_EQ(color->extent.width, 1920u);
+    CHECK_EQ(color->extent.height, 1080u);
+    CHECK(color->format == VK_FORMAT_B10G11R11_UFLOAT_PACK32);
+
+    // the clear hooks still look up big images in other formats, they're classified when they're cleared
+    CHECK(policy.FindImage(FakeImage(2)) != nullptr);
+    CHECK(policy.FindImage(FakeImage(3)) == nullptr);
+
+    // Cemu recreates its targets when the resolution changes, and vulkan can hand out the same handle again
+    policy.OnImageDestroyed(FakeImage(1));
+    CHECK(policy.FindImage(FakeImage(1)) == nullptr);
+    policy.OnImageCreated(FakeImage(1), Image(2560, 1440, VK_FORMAT_D32_SFLOAT));
+    CHECK(CapturePolicy::Classify(*policy.FindImage(FakeImage(1))) == ImageKind::DEPTH);
+
+    // a handle that's still alive can't be created again
+    CHECK_THROWS(policy.OnImageCreated(FakeImage(1), Image(2560, 1440, VK_FORMAT_D32_SFLOAT)));
+    // untracked images are ignored when they're destroyed
+    policy.OnImageDestroyed(FakeImage(3));
+}
@@ -0,0 +1,191 @@
+#include "test.h"
+#include "hooking/clear_detector.h"
+
+// the values that the graphic pack clears with, see ClearDetector::MatchColor and ClearDetector::MatchDepth
+static VkClearColorValue ColorClear(uint8_t side, bool is2D, uint8_t frameIdx) {
+    const float first = 0.125f;
+    const float second = 0.98f;
+    return { .float32 = { is2D ? 2.0f / 32.0f : 0.0f, side == 0 ? first : second, side == 0 ? second : first, frameIdx == 0 ? 0.0f : 1.0f } };
+}
+
+static VkClearDepthStencilValue DepthClear(uint8_t side, uint8_t frameIdx) {
+    return { .depth = side == 0 ? 0.0123456789f : 0.163987654f, .stencil = frameIdx };
+}
+
+static VkImage ImageHandle(uintptr_t handle) {
+    return (VkImage)handle;
+}
+
+// the clears of one frame in the order that the game renders them, the 3D layer's depth and color and then its 2D layer for each pass
+struct FrameClears {
+    uint8_t frameIdx;
+    bool secondPass = true;
+    bool has3D = true;
+
+    std::vector<ClearDetector::Match> Get() const {
+        std::vector<ClearDetector::Match> matches;
+        const std::array<uint8_t, 2> sides = { 0, 1 };
+        for (uint8_t pass = 0; pass < (secondPass ? 2 : 1); pass++) {
+            if (has3D) {
+                matches.push_back(ClearDetector::MatchDepth(DepthClear(sides[pass], frameIdx)));
+                matches.push_back(ClearDetector::MatchColor(ColorClear(sides[pass], false, frameIdx)));
+            }
+            // the first pass clears the 2D layer with the right side's values
+            matches.push_back(ClearDetector::MatchColor(ColorClear(sides[1 - pass], true, frameIdx)));
+        }
+        return matches;
+    }
+};
+
+// returns how many of the clears were out of order
+static uint32_t Feed(ClearDetector& detector, const std::vector<ClearDetector::Match>& matches, bool singlePass) {
+    uint32_t outOfOrder = 0;
+    for (const ClearDetector::Match& match : matches) {
+        outOfOrder += detector.Observe(match, singlePass) ? 0 : 1;
+    }
+    return outOfOrder;
+}
+
+TEST_CASE(MagicValuesAreMatched) {
+    const ClearDetector::Match leftColor = ClearDetector::MatchColor(ColorClear(0, false, 1));
+    CHECK(leftColor.kind == ClearDetector::Kind::COLOR_3D);
+    CHECK_EQ(leftColor.side, 0);
+    CHECK_EQ(leftColor.frameIdx, 1);
+    CHECK(ClearDetector::ToStep(leftColor) == ClearDetector::FIRST_PASS_3D);
+
+    const ClearDetector::Match rightHud = ClearDetector::MatchColor(ColorClear(1, true, 0));
+    CHECK(rightHud.kind == ClearDetector::Kind::COLOR_2D);
+    CHECK_EQ(rightHud.side, 1);
+    CHECK_EQ(rightHud.frameIdx, 0);
+    CHECK(ClearDetector::ToStep(rightHud) == ClearDetector::FIRST_PASS_2D);
+
+    const ClearDetector::Match rightDepth = ClearDetector::MatchDepth(DepthClear(1, 1));
+    CHECK(rightDepth.kind == ClearDetector::Kind::DEPTH_3D);
+    CHECK_EQ(rightDepth.frameIdx, 1);
+    CHECK(ClearDetector::ToStep(rightDepth) == ClearDetector::SECOND_PASS_3D);
+    CHECK(ClearDetector::ToStep(ClearDetector::MatchColor(ColorClear(0, true, 0))) == ClearDetector::SECOND_PASS_2D);
+
+    // the clears that the game does on its own
+    CHECK(ClearDetector::MatchColor({ .float32 = { 0.0f, 0.0f, 0.0f, 1.0f } }).kind == ClearDetector::Kind::NONE);
+    CHECK(ClearDetector::MatchColor({ .float32 = { 0.0f, 0.125f, 0.125f, 1.0f } }).kind == ClearDetector::Kind::NONE);
+    CHECK(ClearDetector::MatchDepth({ .depth = 1.0f, .stencil = 0 }).kind == ClearDetector::Kind::NONE);
+    CHECK(ClearDetector::ToStep(ClearDetector::MatchDepth({ .depth = 0.0f, .stencil = 0 })) == ClearDetector::NO_STEP);
+}
+
+TEST_CASE(FramesInOrderAreClean) {
+    ClearDetector detector;
+    for (uint8_t i = 0; i < 10; i++) {
+        CHECK_EQ(Feed(detector, FrameClears{ .frameIdx = (uint8_t)(i % 2) }.Get(), false), 0u);
+    }
+    CHECK_EQ(detector.GetCurrentStats().frames, 10u);
+    CHECK_EQ(detector.GetCurrentStats().outOfOrderClears, 0u);
+    CHECK_EQ(detector.GetCurrentStats().incompleteFrames, 0u);
+}
+
+TEST_CASE(ClearAfterALaterStepIsOutOfOrder) {
+    ClearDetector detector;
+    std::vector<ClearDetector::Match> matches = FrameClears{ .frameIdx = 0 }.Get();
+    // the second pass' 3D clears came before the first pass' 2D clear, which is the only one out of order then
+    std::swap(matches[2], matches[4]);
+    CHECK_EQ(Feed(detector, matches, false), 1u);
+    CHECK_EQ(detector.GetCurrentStats().outOfOrderClears, 1u);
+
+    // repeating the step that came last is fine, Cemu clears the 2D layer twice
+    ClearDetector repeated;
+    matches = FrameClears{ .frameIdx = 0 }.Get();
+    matches.push_back(matches.back());
+    CHECK_EQ(Feed(repeated, matches, false), 0u);
+}
+
+TEST_CASE(MissingStepIsCountedOnceTheSlotIsReused) {
+    ClearDetector detector;
+    std::vector<ClearDetector::Match> matches = FrameClears{ .frameIdx = 0 }.Get();
+    // the second pass never cleared its 3D layer
+    matches.erase(matches.begin() + 3, matches.begin() + 5);
+    CHECK_EQ(Feed(detector, matches, false), 0u);
+    CHECK_EQ(Feed(detector, FrameClears{ .frameIdx = 1 }.Get(), false), 0u);
+    CHECK_EQ(detector.GetCurrentStats().incompleteFrames, 0u);
+
+    CHECK_EQ(Feed(detector, FrameClears{ .frameIdx = 0 }.Get(), false), 0u);
+    CHECK_EQ(detector.GetCurrentStats().incompleteFrames, 1u);
+}
+
+TEST_CASE(SinglePassFramesOnlyExpectTheFirstPass) {
+    ClearDetector detector;
+    for (uint8_t i = 0; i < 4; i++) {
+        CHECK_EQ(Feed(detector, FrameClears{ .frameIdx = (uint8_t)(i % 2), .secondPass = false }.Get(), true), 0u);
+    }
+    CHECK_EQ(detector.GetCurrentStats().incompleteFrames, 0u);
+
+    // a second pass in a frame that was scheduled with a single eye
+    CHECK_EQ(Feed(detector, FrameClears{ .frameIdx = 0 }.Get(), true), 3u);
+    CHECK_EQ(detector.GetCurrentStats().outOfOrderClears, 3u);
+}
+
+TEST_CASE(FramesWithoutThe3DLayerAreNotIncomplete) {
+    // the title screen only clears the 2D layer
+    ClearDetector detector;
+    for (uint8_t i = 0; i < 6; i++) {
+        CHECK_EQ(Feed(detector, FrameClears{ .frameIdx = (uint8_t)(i % 2), .has3D = false }.Get(), false), 0u);
+    }
+    CHECK_EQ(detector.GetCurrentStats().frames, 6u);
+    CHECK_EQ(detector.GetCurrentStats().incompleteFrames, 0u);
+}
+
+TEST_CASE(StatsAreSnapshottedEveryWindow) {
+    ClearDetector detector;
+    std::vector<ClearDetector::Match> outOfOrder = FrameClears{ .frameIdx = 0 }.Get();
+    std::swap(outOfOrder[2], outOfOrder[4]);
+
+    for (uint32_t i = 0; i < ClearDetector::STATS_WINDOW; i++) {
+        const uint8_t frameIdx = (uint8_t)(i % 2);
+        Feed(detector, i == 0 ? outOfOrder : FrameClears{ .frameIdx = frameIdx }.Get(), false);
+    }
+    // the window ends once the frame after it starts
+    CHECK_EQ(detector.GetStats().frames, 0u);
+    CHECK_EQ(detector.GetCurrentStats().frames, ClearDetector::STATS_WINDOW);
+    Feed(detector, FrameClears{ .frameIdx = 0 }.Get(), false);
+
+    const ClearDetector::Stats stats = detector.GetStats();
+    CHECK_EQ(stats.frames, ClearDetector::STATS_WINDOW);
+    CHECK_EQ(stats.outOfOrderClears, 1u);
+    CHECK_EQ(stats.incompleteFrames, 0u);
+    CHECK_EQ(detector.GetCurrentStats().frames, 1u);
+    CHECK_EQ(detector.GetCurrentStats().outOfOrderClears, 0u);
+}
+
+TEST_CASE(CandidatesAreAddedAndRemoved) {
+    ClearDetector detector;
+    CHECK(!detector.IsCandidate(ImageHandle(0x1000)));
+    detector.OnImageCreated(ImageHandle(0x1000));
+    detector.OnImageCreated(ImageHandle(0x2000));
+    CHECK(detector.IsCandidate(ImageHandle(0x1000)));
+    CHECK(detector.IsCandidate(ImageHandle(0x2000)));
+    CHECK(!detector.IsCandidate(ImageHandle(0x3000)));
+
+    detector.OnImageDestroyed(ImageHandle(0x1000));
+    CHECK(!detector.IsCandidate(ImageHandle(0x1000)));
+    CHECK(detector.IsCandidate(ImageHandle(0x2000)));
+
+    // removed slots are reused, and a handle that Vulkan hands out again is a candidate again
+    for (uintptr_t i = 1; i <= 200; i++) {
+        detector.OnImageCreated(ImageHandle(i * 0x10));
+        detector.OnImageDestroyed(ImageHandle(i * 0x10));
+    }
+    detector.OnImageCreated(ImageHandle(0x1000));
+    CHECK(detector.IsCandidate(ImageHandle(0x1000)));
+    CHECK(!detector.IsCandidate(ImageHandle(0x10)));
+}
+
+TEST_CASE(FullTableMakesEveryImageACandidate) {
+    ClearDetector detector;
+    for (uintptr_t i = 1; i <= ClearDetector::MAX_CANDIDATES * 3 / 4; i++) {
+        detector.OnImageCreated(ImageHandle(i * 0x10));
+    }
+    CHECK(detector.IsCandidate(ImageHandle(0x10)));
+    CHECK(!detector.IsCandidate(ImageHandle(0x5)));
+
+    detector.OnImageCreated(ImageHandle(0x5));
+    CHECK(detector.IsCandidate(ImageHandle(0x5)));
+    CHECK(detector.IsCandidate(ImageHandle(0x7)));
+}
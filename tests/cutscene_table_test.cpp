@@ -0,0 +1,67 @@
+#include "test.h"
+#include "hooking/cutscene_table.h"
+
+#include <fstream>
+
+// lays out the .string entries of the patch like the guest table that initCutsceneDefaultSettings reads, ending at the first empty string
+static std::string ReadGuestTable() {
+    std::ifstream file(CUTSCENE_PATCH);
+    checkAssert(file.is_open(), "Couldn't open " CUTSCENE_PATCH);
+
+    std::string table;
+    std::string line;
+    while (std::getline(file, line)) {
+        const size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 9, ".string \"") != 0) {
+            continue;
+        }
+        const size_t end = line.find('"', start + 9);
+        const std::string entry = line.substr(start + 9, end - start - 9);
+        if (entry.empty()) {
+            break;
+        }
+        table += entry;
+        table += '\0';
+    }
+    table += '\0';
+    return table;
+}
+
+TEST_CASE(GeneratedTableMatchesTheGraphicPack) {
+    const std::string table = ReadGuestTable();
+    CHECK(CutsceneTable::MatchesGuestTable(table.data()));
+}
+
+TEST_CASE(GeneratedFlagsMatchTheParsedEntries) {
+    const std::string table = ReadGuestTable();
+
+    // parsed the same way as when the graphic pack was edited without rebuilding the layer
+    std::unordered_map<std::string, uint8_t> parsed;
+    for (const char* entryPtr = table.data(); *entryPtr != '\0';) {
+        std::string_view entry(entryPtr);
+        entryPtr += entry.size() + 1;
+
+        std::string_view eventName;
+        uint8_t flags = 0;
+        if (CutsceneTable::ParseEntry(entry, eventName, flags)) {
+            parsed.insert_or_assign(std::string(eventName), flags);
+        }
+    }
+
+    CHECK_EQ(parsed.size(), CutsceneTable::GetEventCount());
+    for (const auto& [eventName, flags] : parsed) {
+        std::optional<uint8_t> compiled = CutsceneTable::Find(eventName);
+        if (!compiled.has_value() || *compiled != flags) {
+            Test::Fail(__FILE__, __LINE__, std::format("compiled flags of {} differ from the graphic pack", eventName));
+        }
+    }
+}
+
+TEST_CASE(EditedTableIsRejected) {
+    std::string table = ReadGuestTable();
+    const size_t pos = table.find("FP_ON");
+    CHECK(pos != std::string::npos);
+    table.replace(pos, 5, "FP_NO");
+    CHECK(!CutsceneTable::MatchesGuestTable(table.data()));
+    CHECK(!CutsceneTable::Find("ThisEventDoesNotExist").has_value());
+}
@@ -0,0 +1,167 @@
+#include "test.h"
+#include "rendering/descriptor_arena.h"
+
+using ViewType = DescriptorArena::ViewType;
+
+// records what the arena asks of the device, handles are made up from the slots so they can be checked
+class FakeBackend : public DescriptorArena::Backend {
+public:
+    static constexpr size_t VIEW_HANDLE_BASE = 0x1000;
+    static constexpr uint64_t TRANSIENT_HANDLE_BASE = 0x100000;
+
+    struct CreatedView {
+        ViewType type;
+        ID3D12Resource* resource;
+        DXGI_FORMAT format;
+        uint32_t slot;
+    };
+
+    std::vector<CreatedView> createdViews;
+    // the srv slot that each transient slot was last copied from
+    std::array<uint32_t, DescriptorArena::TRANSIENT_CAPACITY> transientSources = {};
+    std::array<uint32_t, DescriptorArena::TRANSIENT_CAPACITY> transientWrites = {};
+
+    void CreateView(ViewType type, ID3D12Resource* resource, DXGI_FORMAT format, uint32_t slot) override {
+        createdViews.emplace_back(CreatedView{ type, resource, format, slot });
+    }
+    void CopyToTransient(uint32_t srvSlot, uint32_t transientSlot) override {
+        transientSources[transientSlot] = srvSlot;
+        transientWrites[transientSlot]++;
+    }
+    D3D12_CPU_DESCRIPTOR_HANDLE GetViewHandle(ViewType type, uint32_t slot) const override { return { VIEW_HANDLE_BASE * ((size_t)type + 1) + slot }; }
+    D3D12_GPU_DESCRIPTOR_HANDLE GetTransientHandle(uint32_t transientSlot) const override { return { TRANSIENT_HANDLE_BASE + transientSlot }; }
+    ID3D12DescriptorHeap* GetTransientHeap() const override { return nullptr; }
+};
+
+// the arena never dereferences the resources, they're only used as keys
+static ID3D12Resource* FakeResource(uintptr_t id) {
+    return reinterpret_cast<ID3D12Resource*>(0x10000 + id * 0x100);
+}
+
+static std::pair<std::unique_ptr<DescriptorArena>, FakeBackend*> CreateArena() {
+    auto backend = std::make_unique<FakeBackend>();
+    FakeBackend* fake = backend.get();
+    return { std::make_unique<DescriptorArena>(std::move(backend)), fake };
+}
+
+TEST_CASE(ViewsAreReusedByResourceFormatAndType) {
+    auto [arena, backend] = CreateArena();
+    arena->BeginFrame(0);
+
+    const DescriptorArena::View srv = arena->GetView(ViewType::SRV, FakeResource(1), DXGI_FORMAT_R8G8B8A8_UNORM);
+    CHECK_EQ(srv.slot, 0u);
+    CHECK_EQ(srv.handle.ptr, backend->GetViewHandle(ViewType::SRV, 0).ptr);
+
+    // rebinding the same texture every frame doesn't create the view again
+    for (int i = 0; i < 10; i++) {
+        const DescriptorArena::View again = arena->GetView(ViewType::SRV, FakeResource(1), DXGI_FORMAT_R8G8B8A8_UNORM);
+        CHECK_EQ(again.slot, srv.slot);
+        CHECK_EQ(again.handle.ptr, srv.handle.ptr);
+    }
+    CHECK_EQ(backend->createdViews.size(), 1u);
+
+    // another format, another type or another resource each need their own view
+    CHECK_EQ(arena->GetView(ViewType::SRV, FakeResource(1), DXGI_FORMAT_R8G8B8A8_UNORM_SRGB).slot, 1u);
+    CHECK_EQ(arena->GetView(ViewType::SRV, FakeResource(2), DXGI_FORMAT_R8G8B8A8_UNORM).slot, 2u);
+    const DescriptorArena::View rtv = arena->GetView(ViewType::RTV, FakeResource(1), DXGI_FORMAT_R8G8B8A8_UNORM);
+    CHECK_EQ(rtv.slot, 0u);
+    CHECK(rtv.type == ViewType::RTV);
+    CHECK_EQ(rtv.handle.ptr, backend->GetViewHandle(ViewType::RTV, 0).ptr);
+    CHECK_EQ(arena->GetView(ViewType::DSV, FakeResource(3), DXGI_FORMAT_D32_FLOAT).slot, 0u);
+    CHECK_EQ(backend->createdViews.size(), 5u);
+    CHECK(backend->createdViews[1].format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+    CHECK(backend->createdViews[2].resource == FakeResource(2));
+}
+
+TEST_CASE(TablesStayInTheSegmentOfTheirFrame) {
+    auto [arena, backend] = CreateArena();
+    const std::array<DescriptorArena::View, 2> views = {
+        arena->GetView(ViewType::SRV, FakeResource(1), DXGI_FORMAT_R8G8B8A8_UNORM),
+        arena->GetView(ViewType::SRV, FakeResource(2), DXGI_FORMAT_R32_FLOAT),
+    };
+
+    arena->BeginFrame(0);
+    const D3D12_GPU_DESCRIPTOR_HANDLE first = arena->AllocateTable(views);
+    const D3D12_GPU_DESCRIPTOR_HANDLE second = arena->AllocateTable(views);
+    CHECK_EQ(first.ptr, FakeBackend::TRANSIENT_HANDLE_BASE);
+    CHECK_EQ(second.ptr, FakeBackend::TRANSIENT_HANDLE_BASE + 2);
+    CHECK_EQ(backend->transientSources[0], views[0].slot);
+    CHECK_EQ(backend->transientSources[1], views[1].slot);
+
+    // the next frame fills the other segment, so the gpu can still read the tables of the frame before
+    arena->BeginFrame(1);
+    const D3D12_GPU_DESCRIPTOR_HANDLE otherFrame = arena->AllocateTable(views);
+    CHECK_EQ(otherFrame.ptr, FakeBackend::TRANSIENT_HANDLE_BASE + DescriptorArena::SEGMENT_CAPACITY);
+    CHECK_EQ(backend->transientWrites[0], 1u);
+    CHECK_EQ(backend->transientWrites[2], 1u);
+
+    // once the first slot comes around again its segment is filled from the start
+    arena->BeginFrame(0);
+    CHECK_EQ(arena->AllocateTable(views).ptr, FakeBackend::TRANSIENT_HANDLE_BASE);
+    CHECK_EQ(backend->transientWrites[0], 2u);
+    CHECK_EQ(backend->transientWrites[DescriptorArena::SEGMENT_CAPACITY], 1u);
+}
+
+TEST_CASE(RunningOutOfDescriptorsIsAnError) {
+    auto [arena, backend] = CreateArena();
+    arena->BeginFrame(0);
+
+    for (uint32_t i = 0; i < DescriptorArena::VIEW_CAPACITY[(size_t)ViewType::RTV]; i++) {
+        arena->GetView(ViewType::RTV, FakeResource(i), DXGI_FORMAT_R8G8B8A8_UNORM);
+    }
+    CHECK_THROWS(arena->GetView(ViewType::RTV, FakeResource(1000), DXGI_FORMAT_R8G8B8A8_UNORM));
+    // views that already exist can still be looked up
+    CHECK_EQ(arena->GetView(ViewType::RTV, FakeResource(0), DXGI_FORMAT_R8G8B8A8_UNORM).slot, 0u);
+
+    // a frame can't spill into the segment of the other frame
+    const DescriptorArena::View srv = arena->GetView(ViewType::SRV, FakeResource(1), DXGI_FORMAT_R8G8B8A8_UNORM);
+    for (uint32_t i = 0; i < DescriptorArena::SEGMENT_CAPACITY; i++) {
+        arena->AllocateTable(std::span(&srv, 1));
+    }
+    CHECK_THROWS(arena->AllocateTable(std::span(&srv, 1)));
+    CHECK_EQ(backend->transientWrites[DescriptorArena::SEGMENT_CAPACITY], 0u);
+
+    // only shader resource views go into tables, and only existing frame slots have a segment
+    arena->BeginFrame(1);
+    const DescriptorArena::View rtv = arena->GetView(ViewType::RTV, FakeResource(0), DXGI_FORMAT_R8G8B8A8_UNORM);
+    CHECK_THROWS(arena->AllocateTable(std::span(&rtv, 1)));
+    CHECK_THROWS(arena->BeginFrame(DescriptorArena::FRAME_SEGMENTS));
+}
+
+TEST_CASE(ReleasedViewsAreCreatedAgain) {
+    auto [arena, backend] = CreateArena();
+    arena->BeginFrame(0);
+    arena->GetView(ViewType::SRV, FakeResource(1), DXGI_FORMAT_R8G8B8A8_UNORM);
+    arena->GetView(ViewType::SRV, FakeResource(2), DXGI_FORMAT_R8G8B8A8_UNORM);
+    arena->GetView(ViewType::DSV, FakeResource(3), DXGI_FORMAT_D32_FLOAT);
+
+    // the swapchains were recreated and a new resource got the address of an old one
+    arena->ReleaseViews();
+    const DescriptorArena::View view = arena->GetView(ViewType::SRV, FakeResource(2), DXGI_FORMAT_R8G8B8A8_UNORM);
+    CHECK_EQ(view.slot, 0u);
+    CHECK_EQ(arena->GetView(ViewType::DSV, FakeResource(3), DXGI_FORMAT_D32_FLOAT).slot, 0u);
+    CHECK_EQ(backend->createdViews.size(), 5u);
+
+    // releasing also makes the whole heap available again
+    arena->ReleaseViews();
+    for (uint32_t i = 0; i < DescriptorArena::VIEW_CAPACITY[(size_t)ViewType::SRV]; i++) {
+        arena->GetView(ViewType::SRV, FakeResource(i), DXGI_FORMAT_R8G8B8A8_UNORM);
+    }
+}
+
+TEST_CASE(StatsCoverTheLastWindow) {
+    auto [arena, backend] = CreateArena();
+    for (uint32_t frame = 0; frame < DescriptorArena::STATS_WINDOW; frame++) {
+        arena->BeginFrame(frame % DescriptorArena::FRAME_SEGMENTS);
+        const DescriptorArena::View srv = arena->GetView(ViewType::SRV, FakeResource(1), DXGI_FORMAT_R8G8B8A8_UNORM);
+        arena->AllocateTable(std::span(&srv, 1));
+    }
+    CHECK_EQ(arena->GetStats().frames, 0u);
+
+    arena->BeginFrame(0);
+    const DescriptorArena::Stats stats = arena->GetStats();
+    CHECK_EQ(stats.frames, (uint64_t)DescriptorArena::STATS_WINDOW);
+    CHECK_EQ(stats.viewsCreated, 1u);
+    CHECK_EQ(stats.viewsReused, (uint64_t)DescriptorArena::STATS_WINDOW - 1);
+    CHECK_EQ(stats.transientDescriptors, (uint64_t)DescriptorArena::STATS_WINDOW);
+}
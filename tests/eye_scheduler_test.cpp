@@ -0,0 +1,103 @@
+#include "test.h"
+#include "rendering/eye_scheduler.h"
+
+static const std::array<EyeScheduler::Pose, 2> STILL_POSES = {};
+
+// schedules a frame into the alternating slots and reports the captures of the previous frame, like Cemu copies them a frame later
+struct Pipeline {
+    EyeScheduler scheduler;
+    uint32_t frameIdx = 0;
+    std::optional<std::pair<uint32_t, uint8_t>> inFlight;
+
+    EyeScheduler::Plan Frame(const std::array<EyeScheduler::Pose, 2>& poses = STILL_POSES, bool capture = true) {
+        if (inFlight.has_value() && capture) {
+            for (uint8_t eye = 0; eye < 2; eye++) {
+                if ((inFlight->second & EyeScheduler::ToMask(eye)) != 0) {
+                    scheduler.OnCaptured(eye, inFlight->first);
+                }
+            }
+        }
+        EyeScheduler::Plan plan = scheduler.Schedule(frameIdx, true, poses);
+        inFlight = { frameIdx, plan.eyes };
+        frameIdx ^= 1;
+        return plan;
+    }
+};
+
+TEST_CASE(RendersBothEyesUntilBothAreCaptured) {
+    EyeScheduler scheduler;
+    CHECK_EQ(scheduler.Schedule(0, true, STILL_POSES).eyes, EyeScheduler::BOTH_EYES);
+    // scheduling alone doesn't count as a capture
+    CHECK(!scheduler.HasCapture(0));
+    CHECK_EQ(scheduler.Schedule(1, true, STILL_POSES).eyes, EyeScheduler::BOTH_EYES);
+
+    scheduler.OnCaptured(0, 0);
+    scheduler.OnCaptured(1, 0);
+    CHECK(scheduler.HasCapture(0));
+    CHECK(scheduler.HasCapture(1));
+    CHECK(scheduler.Schedule(0, true, STILL_POSES).IsSingleEye());
+    CHECK(!scheduler.Schedule(1, false, STILL_POSES).IsSingleEye());
+}
+
+TEST_CASE(CapturesOfUnscheduledEyesAreIgnored) {
+    EyeScheduler scheduler;
+    scheduler.OnCaptured(0, 0);
+    CHECK(!scheduler.HasCapture(0));
+}
+
+TEST_CASE(StillHeadAlternatesEyes) {
+    Pipeline pipeline;
+    pipeline.Frame();
+    pipeline.Frame();
+    std::array<uint32_t, 2> rendered = {};
+    for (int i = 0; i < 100; i++) {
+        EyeScheduler::Plan plan = pipeline.Frame();
+        CHECK(plan.IsSingleEye());
+        rendered[plan.firstEye]++;
+    }
+    CHECK_EQ(rendered[0], 50u);
+    CHECK_EQ(rendered[1], 50u);
+}
+
+TEST_CASE(MovingEyeIsRenderedMoreOftenButNeitherIsLeftOutTooLong) {
+    Pipeline pipeline;
+    std::array<EyeScheduler::Pose, 2> poses = STILL_POSES;
+    std::array<uint32_t, 2> rendered = {};
+    std::array<uint32_t, 2> leftOut = {};
+    for (int i = 0; i < 200; i++) {
+        // only the right eye turns
+        poses[1].orientation = glm::angleAxis(0.05f * (float)i, glm::fvec3(0.0f, 1.0f, 0.0f));
+        EyeScheduler::Plan plan = pipeline.Frame(poses);
+        for (uint8_t eye = 0; eye < 2; eye++) {
+            if ((plan.eyes & EyeScheduler::ToMask(eye)) != 0) {
+                rendered[eye]++;
+                leftOut[eye] = 0;
+            }
+            else {
+                leftOut[eye]++;
+                CHECK(leftOut[eye] <= EyeScheduler::MAX_STALE_FRAMES);
+            }
+        }
+    }
+    CHECK(rendered[1] > rendered[0]);
+    CHECK(rendered[0] > 0);
+}
+
+TEST_CASE(MissedCapturesFallBackToBothEyes) {
+    Pipeline pipeline;
+    pipeline.Frame();
+    pipeline.Frame();
+    CHECK(pipeline.Frame().IsSingleEye());
+
+    // Cemu stops copying, so the captures end up too old to reproject from
+    bool fellBack = false;
+    for (int i = 0; i < 10; i++) {
+        fellBack |= !pipeline.Frame(STILL_POSES, false).IsSingleEye();
+    }
+    CHECK(fellBack);
+
+    for (uint32_t i = 0; i < EyeScheduler::STATS_WINDOW; i++) {
+        pipeline.Frame(STILL_POSES, false);
+    }
+    CHECK(pipeline.scheduler.GetStats().missedCaptures > 0);
+}
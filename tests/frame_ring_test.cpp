@@ -0,0 +1,259 @@
+#include "test.h"
+#include "rendering/frame_ring.h"
+
+#include <deque>
+
+// explores every interleaving of the capture hooks, EndFrame and the present queue finishing its work, and checks that the ring
+// never lets Cemu capture into a slot that's still being read, never needs an illegal transition and can't get stuck
+
+constexpr std::array<FrameCapture, 5> CAPTURES = { CAPTURE_COLOR_LEFT, CAPTURE_DEPTH_LEFT, CAPTURE_COLOR_RIGHT, CAPTURE_DEPTH_RIGHT, CAPTURE_HUD };
+
+template <size_t Depth>
+struct Model {
+    static constexpr size_t DEPTH = Depth;
+    static constexpr uint8_t CAPTURE_ACTIONS = (uint8_t)(DEPTH * CAPTURES.size());
+    static constexpr uint8_t END_FRAME_ACTION = CAPTURE_ACTIONS;
+    static constexpr uint8_t GPU_ACTION = CAPTURE_ACTIONS + 1;
+    static constexpr uint8_t ACTION_COUNT = CAPTURE_ACTIONS + 2;
+
+    FrameRing<DEPTH> ring;
+    // the present lane's timeline, EndFrame schedules one compose job per presented slot
+    uint64_t scheduled = 0;
+    uint64_t completed = 0;
+    // the timeline value that the present lane stops reading the slot at, or 0 if it doesn't read it
+    std::array<uint64_t, DEPTH> readsDone = {};
+    long lastPresented = DEPTH - 1;
+    std::string error;
+
+    bool IsRead(long slot) const { return readsDone[slot] > completed; }
+    bool Fail(std::string message) {
+        if (error.empty()) error = std::move(message);
+        return false;
+    }
+
+    // the clear hooks only copy into a slot that can take the capture, and then mark it through RND_Renderer::On3DColorCopied and friends
+    bool Capture(long slot, FrameCapture capture) {
+        if (!ring.CanCapture(slot, capture)) {
+            return true;
+        }
+        const bool captured = ring.MarkCaptured(slot, capture);
+        if (captured && IsRead(slot)) {
+            return Fail(std::format("slot {} was captured into while the present queue still reads it", slot));
+        }
+        return true;
+    }
+
+    // the same steps that RND_Renderer::EndFrame takes
+    bool EndFrame() {
+        const uint32_t released = ring.ReleaseCompleted(completed);
+        for (long i = 0; i < (long)DEPTH; i++) {
+            if ((released & (1u << i)) != 0) {
+                if (IsRead(i)) {
+                    return Fail(std::format("slot {} was released while the present queue still reads it", i));
+                }
+                readsDone[i] = 0;
+            }
+            else if (ring.GetState(i) == FrameSlotState::PRESENTED && !IsRead(i)) {
+                return Fail(std::format("slot {} wasn't released once the present queue was done with it", i));
+            }
+        }
+
+        bool anyComplete = false;
+        for (long i = 0; i < (long)DEPTH; i++) {
+            anyComplete |= ring.GetState(i) != FrameSlotState::PRESENTED && ring.Is3DComplete(i) && ring.Is2DComplete(i);
+        }
+
+        long slot = ring.FindReadySlot();
+        if (slot != -1) {
+            if (!ring.Is2DComplete(slot) || (anyComplete && !ring.Is3DComplete(slot))) {
+                return Fail(std::format("slot {} was picked over a more complete one", slot));
+            }
+            if (!ring.Submit(slot)) {
+                return Fail(std::format("slot {} was ready but couldn't be submitted", slot));
+            }
+            readsDone[slot] = ++scheduled;
+            if (!ring.Present(slot, readsDone[slot])) {
+                return Fail(std::format("slot {} couldn't be presented", slot));
+            }
+            lastPresented = slot;
+        }
+        ring.OnEndFrame(slot != -1);
+
+        if (ring.GetStats().illegalTransitions != 0) {
+            return Fail("the ring needed an illegal transition");
+        }
+        return true;
+    }
+
+    void FinishGpuWork(bool all) {
+        if (completed < scheduled) {
+            completed = all ? scheduled : completed + 1;
+        }
+    }
+
+    bool Apply(uint8_t action) {
+        if (action < CAPTURE_ACTIONS) {
+            return Capture((long)(action / CAPTURES.size()), CAPTURES[action % CAPTURES.size()]);
+        }
+        if (action == END_FRAME_ACTION) {
+            return EndFrame();
+        }
+        if (action == GPU_ACTION) {
+            FinishGpuWork(false);
+        }
+        return true;
+    }
+
+    // everything that decides what the next actions do, the generations and counters only grow and don't matter
+    uint64_t GetKey() const {
+        uint64_t key = 0;
+        for (long i = 0; i < (long)DEPTH; i++) {
+            uint64_t captures = 0;
+            for (size_t c = 0; c < CAPTURES.size(); c++) {
+                captures |= ring.HasCaptured(i, CAPTURES[c]) ? 1ull << c : 0;
+            }
+            const uint64_t readOrder = IsRead(i) ? readsDone[i] - completed : 0;
+            key = (key << 16) | ((uint64_t)ring.GetState(i) << 12) | (readOrder << 8) | captures;
+        }
+        return (key << 8) | ((scheduled - completed) << 4) | (uint64_t)lastPresented;
+    }
+};
+
+template <size_t Depth>
+static std::unique_ptr<Model<Depth>> Replay(const std::vector<uint8_t>& path) {
+    auto model = std::make_unique<Model<Depth>>();
+    for (uint8_t action : path) {
+        if (!model->Apply(action)) {
+            break;
+        }
+    }
+    return model;
+}
+
+template <size_t Depth>
+static std::string DescribePath(const std::vector<uint8_t>& path) {
+    using M = Model<Depth>;
+    std::string description;
+    for (uint8_t action : path) {
+        if (action < M::CAPTURE_ACTIONS) description += std::format("capture({}, 0x{:02X}) ", action / CAPTURES.size(), (uint8_t)CAPTURES[action % CAPTURES.size()]);
+        else if (action == M::END_FRAME_ACTION) description += "EndFrame ";
+        else description += "gpu ";
+    }
+    return description;
+}
+
+// returns the number of reachable states and the longest path needed to reach one of them
+template <size_t Depth>
+static std::pair<size_t, size_t> ExploreInterleavings() {
+    using M = Model<Depth>;
+    std::unordered_map<uint64_t, std::vector<uint8_t>> visited;
+    std::deque<std::vector<uint8_t>> queue = { {} };
+    visited.emplace(Replay<Depth>({})->GetKey(), std::vector<uint8_t>());
+
+    size_t maxDepth = 0;
+    while (!queue.empty()) {
+        std::vector<uint8_t> path = std::move(queue.front());
+        queue.pop_front();
+        maxDepth = std::max(maxDepth, path.size());
+
+        for (uint8_t action = 0; action < M::ACTION_COUNT; action++) {
+            std::vector<uint8_t> next = path;
+            next.push_back(action);
+            std::unique_ptr<M> model = Replay<Depth>(next);
+            if (!model->error.empty()) {
+                Test::Fail(__FILE__, __LINE__, std::format("{} after {}", model->error, DescribePath<Depth>(next)));
+                return {};
+            }
+            if (visited.emplace(model->GetKey(), next).second) {
+                queue.push_back(std::move(next));
+            }
+        }
+    }
+
+    // from every reachable state, finishing the HUD of every slot and letting the present queue catch up hands all slots back empty
+    for (const auto& [key, path] : visited) {
+        std::unique_ptr<M> model = Replay<Depth>(path);
+        for (long i = 0; i < (long)Depth; i++) {
+            model->Capture(i, CAPTURE_HUD);
+        }
+        for (size_t i = 0; i < Depth + 1; i++) {
+            model->FinishGpuWork(true);
+            model->EndFrame();
+        }
+        model->FinishGpuWork(true);
+        model->EndFrame();
+
+        bool drained = model->error.empty();
+        for (long i = 0; i < (long)Depth; i++) {
+            for (FrameCapture capture : CAPTURES) {
+                drained &= model->ring.CanCapture(i, capture);
+            }
+        }
+        if (!drained) {
+            Test::Fail(__FILE__, __LINE__, std::format("the ring got stuck after {}{}", DescribePath<Depth>(path), model->error));
+            return {};
+        }
+    }
+    return { visited.size(), maxDepth };
+}
+
+TEST_CASE(EveryInterleavingKeepsTheInvariants) {
+    // both slots can be anywhere between empty and read by the present queue, with both read at once too
+    auto [states, maxDepth] = ExploreInterleavings<2>();
+    CHECK(states > 5000u);
+    CHECK(maxDepth >= 12u);
+}
+
+TEST_CASE(EveryInterleavingOfADeeperRingKeepsTheInvariants) {
+    // the renderer is limited to two slots by the graphic pack, but nothing in the ring itself depends on that
+    auto [states, maxDepth] = ExploreInterleavings<3>();
+    CHECK(states > 200000u);
+    CHECK(maxDepth >= 20u);
+}
+
+TEST_CASE(TheOtherSlotIsCapturedWhileOneIsRead) {
+    Model<2> model;
+    for (FrameCapture capture : CAPTURES) {
+        CHECK(model.Capture(0, capture));
+    }
+    CHECK(model.EndFrame());
+    CHECK_EQ(model.ring.GetState(0), FrameSlotState::PRESENTED);
+    CHECK(!model.ring.CanCapture(0, CAPTURE_HUD));
+
+    // the next frame goes into the other slot while the present queue is still busy with the first
+    for (FrameCapture capture : CAPTURES) {
+        CHECK(model.Capture(1, capture));
+    }
+    CHECK(model.EndFrame());
+    CHECK_EQ(model.ring.GetState(0), FrameSlotState::PRESENTED);
+    CHECK_EQ(model.ring.GetState(1), FrameSlotState::PRESENTED);
+
+    model.FinishGpuWork(false);
+    CHECK(model.EndFrame());
+    CHECK_EQ(model.ring.GetState(0), FrameSlotState::ACQUIRED);
+    CHECK(model.ring.CanCapture(0, CAPTURE_COLOR_LEFT));
+    CHECK_EQ(model.ring.GetState(1), FrameSlotState::PRESENTED);
+    CHECK_EQ(model.ring.GetStats().submitted, 2u);
+}
+
+TEST_CASE(OnlyUnsubmittedCapturesAreTheNextFrame) {
+    FrameRing<2> ring;
+    for (FrameCapture capture : CAPTURES) {
+        CHECK(ring.MarkCaptured(0, capture));
+    }
+    CHECK(ring.Submit(0));
+    CHECK(ring.Present(0, 1));
+
+    // the presented slot keeps its captures until the present queue is done with it, but they're not a new frame
+    CHECK(!ring.Has3DCaptureBesides(1));
+
+    CHECK(ring.MarkCaptured(1, CAPTURE_COLOR_LEFT));
+    CHECK(ring.MarkCaptured(1, CAPTURE_DEPTH_LEFT));
+    CHECK(!ring.Has3DCaptureBesides(0));
+
+    // the HUD isn't needed, only the eyes can be reprojected
+    CHECK(ring.MarkCaptured(1, CAPTURE_COLOR_RIGHT));
+    CHECK(ring.MarkCaptured(1, CAPTURE_DEPTH_RIGHT));
+    CHECK(ring.Has3DCaptureBesides(0));
+    CHECK(!ring.Has3DCaptureBesides(1));
+}
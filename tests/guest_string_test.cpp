@@ -0,0 +1,122 @@
+#include "test.h"
+#include "hooking/guest_string.h"
+
+TEST_CASE(HashMatchesFnv1a) {
+    CHECK_EQ(GuestStringHash(""), 0x811C9DC5u);
+    CHECK_EQ(GuestStringHash("a"), 0xE40C292Cu);
+    static_assert(GuestStringHash("Camera") == GuestStringHash(std::string_view("Camera")));
+}
+
+TEST_CASE(ViewStopsAtMaxLength) {
+    const char buffer[8] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' };
+    GuestStringView view(0x10000000, buffer, 4);
+    CHECK_EQ(view.View(), std::string_view("abcd"));
+    CHECK(GuestStringView(0, nullptr).Empty());
+}
+
+TEST_CASE(InternReturnsTheSameSymbol) {
+    GuestSymbol first = GuestStringPool::Intern(std::string_view("Link"));
+    GuestSymbol second = GuestStringPool::Intern(std::string("Link"));
+    CHECK(first);
+    CHECK(first == second);
+    CHECK_EQ(GuestStringPool::GetString(first), std::string_view("Link"));
+    CHECK(GuestStringPool::Find("Link") == first);
+    CHECK(!GuestStringPool::Find("NeverInterned"));
+}
+
+TEST_CASE(GuestAddressCacheChecksContents) {
+    // the guest reuses its buffers, so a cached address with different contents has to be interned again
+    char buffer[16] = "Zelda";
+    GuestSymbol zelda = GuestStringPool::Intern(GuestStringView(0x20000000, buffer));
+    std::strcpy(buffer, "Ganon");
+    GuestSymbol ganon = GuestStringPool::Intern(GuestStringView(0x20000000, buffer));
+    CHECK(!(zelda == ganon));
+    CHECK_EQ(GuestStringPool::GetString(ganon), std::string_view("Ganon"));
+
+    GuestStringPool::Stats before = GuestStringPool::GetStats();
+    GuestStringPool::Intern(GuestStringView(0x20000000, buffer));
+    CHECK_EQ(GuestStringPool::GetStats().cacheHits, before.cacheHits + 1);
+}
+
+// counts every allocation of the test, so that a frame's worth of name lookups can be checked for allocating
+static std::atomic_uint64_t s_allocations = 0;
+
+void* operator new(size_t size) {
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// a guest arena with actor names like the ones that the actor, weapon and job hooks read every frame
+struct GuestArena {
+    static constexpr uint32_t BASE_ADDRESS = 0x30000000;
+    static constexpr uint32_t NAME_STRIDE = 0x40;
+
+    std::vector<char> memory;
+    uint32_t names = 0;
+
+    explicit GuestArena(uint32_t nameCount): memory(nameCount * NAME_STRIDE, '\0'), names(nameCount) {
+        for (uint32_t i = 0; i < nameCount; i++) {
+            std::snprintf(&memory[i * NAME_STRIDE], NAME_STRIDE, "Enemy_Bokoblin_Junior_%03u", i);
+        }
+    }
+
+    GuestStringView Name(uint32_t i) const { return GuestStringView(BASE_ADDRESS + i * NAME_STRIDE, &memory[i * NAME_STRIDE], NAME_STRIDE); }
+};
+
+TEST_CASE(FrameOfLookupsDoesNotAllocate) {
+    // every name is looked up a few times per frame, but more names than the per-thread cache holds
+    constexpr uint32_t NAMES = 200;
+    constexpr uint32_t LOOKUPS_PER_NAME = 3;
+    constexpr uint32_t FRAMES = 100;
+    const GuestArena arena(NAMES);
+
+    // the first frame interns every name
+    for (uint32_t i = 0; i < NAMES; i++) {
+        GuestStringPool::Intern(arena.Name(i));
+    }
+
+    uint64_t checksum = 0;
+    const GuestStringPool::Stats statsBefore = GuestStringPool::GetStats();
+    const uint64_t internAllocationsBefore = s_allocations.load();
+    const auto internStart = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        for (uint32_t i = 0; i < NAMES * LOOKUPS_PER_NAME; i++) {
+            checksum += GuestStringPool::Intern(arena.Name(i % NAMES)).id;
+        }
+    }
+    const auto internTime = std::chrono::steady_clock::now() - internStart;
+    const uint64_t internAllocations = s_allocations.load() - internAllocationsBefore;
+    const GuestStringPool::Stats stats = GuestStringPool::GetStats();
+    const double cacheHitRate = (double)(stats.cacheHits - statsBefore.cacheHits) / (double)(stats.lookups - statsBefore.lookups) * 100.0;
+
+    // what the hooks did before, copying each name into a std::string
+    const uint64_t copyAllocationsBefore = s_allocations.load();
+    const auto copyStart = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        for (uint32_t i = 0; i < NAMES * LOOKUPS_PER_NAME; i++) {
+            const std::string name = arena.Name(i % NAMES).Str();
+            checksum += name.size();
+        }
+    }
+    const auto copyTime = std::chrono::steady_clock::now() - copyStart;
+    const uint64_t copyAllocations = s_allocations.load() - copyAllocationsBefore;
+
+    CHECK_EQ(internAllocations, 0u);
+    CHECK_EQ(copyAllocations, (uint64_t)FRAMES * NAMES * LOOKUPS_PER_NAME);
+    CHECK(checksum != 0);
+
+    const double lookups = (double)FRAMES * NAMES * LOOKUPS_PER_NAME;
+    std::printf("%u lookups per frame: interning allocated %.1f times per frame at %.1fns per lookup with %.1f%% cache hits, copying into a std::string allocated %.1f times per frame at %.1fns per lookup\n",
+        NAMES * LOOKUPS_PER_NAME, (double)internAllocations / FRAMES, std::chrono::duration<double, std::nano>(internTime).count() / lookups, cacheHitRate, (double)copyAllocations / FRAMES, std::chrono::duration<double, std::nano>(copyTime).count() / lookups);
+}
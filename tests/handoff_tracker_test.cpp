@@ -0,0 +1,77 @@
+#include "test.h"
+#include "rendering/handoff_tracker.h"
+
+using Api = HandoffTracker::Api;
+
+TEST_CASE(AlternatingHandoffsKeepTheParity) {
+    HandoffTracker tracker;
+    uint64_t completed = 0;
+    const HandoffTracker::TimelineId id = tracker.AddTimeline("texture", [&completed] { return completed; });
+
+    CHECK_EQ(tracker.Wait(id, Api::VULKAN), 0u);
+    CHECK_EQ(tracker.Signal(id, Api::VULKAN).value, 1u);
+    CHECK_EQ(tracker.Wait(id, Api::D3D12), 1u);
+    CHECK_EQ(tracker.Signal(id, Api::D3D12).value, 2u);
+
+    // D3D12 skipped a frame, so vulkan waits for the same value again and skips one to keep signaling odd values
+    CHECK_EQ(tracker.Wait(id, Api::VULKAN), 2u);
+    CHECK_EQ(tracker.Signal(id, Api::VULKAN).value, 3u);
+    CHECK_EQ(tracker.Wait(id, Api::VULKAN), 2u);
+    CHECK_EQ(tracker.Signal(id, Api::VULKAN).value, 5u);
+    CHECK(tracker.GetLastProducer(id) == Api::VULKAN);
+    CHECK_EQ(tracker.GetViolations(), 0u);
+}
+
+TEST_CASE(SignalWithoutWaitingForTheOtherApiIsAViolation) {
+    HandoffTracker tracker;
+    const HandoffTracker::TimelineId id = tracker.AddTimeline("texture", [] { return 0; });
+
+    tracker.Wait(id, Api::VULKAN);
+    tracker.Signal(id, Api::VULKAN);
+    tracker.Wait(id, Api::D3D12);
+    tracker.Signal(id, Api::D3D12);
+    CHECK_EQ(tracker.GetViolations(), 0u);
+
+    // vulkan copies into the texture again while D3D12 might still be reading it
+    tracker.Signal(id, Api::VULKAN);
+    CHECK_EQ(tracker.GetViolations(), 1u);
+
+    // the first handoff has nothing to wait for, but D3D12 still has to wait for what vulkan signaled
+    const HandoffTracker::TimelineId otherId = tracker.AddTimeline("other texture", [] { return 0; });
+    tracker.Wait(otherId, Api::VULKAN);
+    tracker.Signal(otherId, Api::VULKAN);
+    tracker.Signal(otherId, Api::D3D12);
+    CHECK_EQ(tracker.GetViolations(), 2u);
+}
+
+TEST_CASE(SkippedSignalIsReportedAsADeadlock) {
+    using namespace std::chrono_literals;
+    HandoffTracker tracker;
+    uint64_t completed = 0;
+    uint64_t otherCompleted = 0;
+    const HandoffTracker::TimelineId id = tracker.AddTimeline("texture", [&completed] { return completed; });
+    const HandoffTracker::TimelineId otherId = tracker.AddTimeline("other texture", [&otherCompleted] { return otherCompleted; });
+    const HandoffTracker::Clock::time_point start = HandoffTracker::Clock::now();
+
+    // vulkan issues its signal of the texture, but then only submits the signal of the other texture after it
+    tracker.Wait(id, Api::VULKAN, start);
+    tracker.Signal(id, Api::VULKAN, start);
+    tracker.Wait(otherId, Api::VULKAN, start);
+    tracker.Signal(otherId, Api::VULKAN, start);
+    CHECK_EQ(tracker.Wait(id, Api::D3D12, start), 1u);
+
+    CHECK(tracker.Poll(start + 10ms, 100ms).empty());
+    std::vector<HandoffTracker::Stall> stalls = tracker.Poll(start + 200ms, 100ms);
+    CHECK_EQ(stalls.size(), 1u);
+    CHECK(!stalls[0].deadlocked);
+
+    // vulkan finishes its signals in order, so the other texture finishing means that the texture's signal was skipped
+    otherCompleted = 1;
+    stalls = tracker.Poll(start + 300ms, 100ms);
+    CHECK_EQ(stalls.size(), 1u);
+    CHECK(stalls[0].deadlocked);
+
+    completed = 1;
+    CHECK(tracker.Poll(start + 400ms, 100ms).empty());
+    CHECK_EQ(tracker.GetViolations(), 0u);
+}
@@ -0,0 +1,69 @@
+#include "test.h"
+#include "hooking/held_weapons.h"
+
+// the cache only looks at the name itself, not at where it lives in guest memory
+static GuestStringView Name(const char* name) {
+    return GuestStringView(0x10000000, name);
+}
+
+TEST_CASE(TypeIsOnlyReadWhenTheHandStartsHoldingADifferentWeapon) {
+    HeldWeapons weapons;
+    uint32_t typeReads = 0;
+    auto readType = [&typeReads] { typeReads++; return 3u; };
+
+    CHECK(weapons.Update(1, 0x3F000000, Name("Weapon_Sword_001"), readType));
+    CHECK_EQ(weapons.Get(1).actorPtr, 0x3F000000u);
+    CHECK_EQ(weapons.Get(1).type, 3u);
+    CHECK(weapons.Get(1).droppable);
+
+    // the hook runs every frame for as long as the weapon is held
+    for (int frame = 0; frame < 100; frame++) {
+        CHECK(!weapons.Update(1, 0x3F000000, Name("Weapon_Sword_001"), readType));
+    }
+    CHECK_EQ(typeReads, 1u);
+    CHECK_EQ(weapons.GetRefreshes(), 1u);
+
+    // a different actor is picked up
+    CHECK(weapons.Update(1, 0x3F001000, Name("Weapon_Sword_001"), readType));
+    CHECK_EQ(typeReads, 2u);
+}
+
+TEST_CASE(ReusedActorMemoryIsNoticedByItsName) {
+    HeldWeapons weapons;
+    CHECK(weapons.Update(0, 0x3F000000, Name("Weapon_Shield_001"), [] { return 7u; }));
+    CHECK(weapons.Get(0).droppable);
+
+    // the game freed the shield and spawned an arrow at the same address
+    CHECK(weapons.Update(0, 0x3F000000, Name("NormalArrow"), [] { return 0u; }));
+    CHECK_EQ(weapons.Get(0).nameHash, GuestStringHash("NormalArrow"));
+    CHECK_EQ(weapons.Get(0).type, 0u);
+    CHECK(!weapons.Get(0).droppable);
+}
+
+TEST_CASE(HandsAreTrackedSeparately) {
+    HeldWeapons weapons;
+    CHECK(weapons.Update(0, 0x3F000000, Name("Weapon_Shield_001"), [] { return 7u; }));
+    CHECK(weapons.Update(1, 0x3F002000, Name("Weapon_Sword_070"), [] { return 0u; }));
+
+    CHECK(!weapons.Update(0, 0x3F000000, Name("Weapon_Shield_001"), [] { return 7u; }));
+    CHECK(weapons.Get(0).droppable);
+    CHECK(!weapons.Get(1).droppable);
+    CHECK_EQ(weapons.GetRefreshes(), 2u);
+}
+
+TEST_CASE(QuestItemsAndArrowsCantBeDropped) {
+    // the master sword and the other listed items
+    CHECK(!HeldWeapons::IsDroppable("Weapon_Sword_070"));
+    CHECK(!HeldWeapons::IsDroppable("Obj_KorokNuts"));
+    CHECK(!HeldWeapons::IsDroppable("GameROMPlayer"));
+
+    // every arrow, even the ones that aren't listed
+    CHECK(!HeldWeapons::IsDroppable("FireArrow"));
+    CHECK(!HeldWeapons::IsDroppable("Obj_ArrowBundle_A_01"));
+
+    CHECK(HeldWeapons::IsDroppable("Weapon_Sword_001"));
+    CHECK(HeldWeapons::IsDroppable("Weapon_Lsword_020"));
+    CHECK(HeldWeapons::IsDroppable("Weapon_Shield_001"));
+    // only the exact names are protected
+    CHECK(HeldWeapons::IsDroppable("Weapon_Sword_0700"));
+}
@@ -0,0 +1,93 @@
+#include "test.h"
+#include "hooking/ik_solver.h"
+
+#include <random>
+
+static const IKSolver::JointLimits NO_LIMITS = {};
+
+// the solved joints need to keep the bone lengths and have the upper and lower directions point between them
+static void CheckChain(const glm::fvec3& rootPos, float upperLength, float lowerLength, const IKSolver::TwoBoneResult& result) {
+    CHECK_NEAR(glm::distance(rootPos, result.midPos), upperLength, 1e-4);
+    CHECK_NEAR(glm::distance(result.midPos, result.endPos), lowerLength, 1e-3);
+    CHECK_NEAR(glm::dot(result.upperDir, glm::normalize(result.midPos - rootPos)), 1.0f, 1e-4);
+    CHECK_NEAR(glm::dot(result.lowerDir, glm::normalize(result.endPos - result.midPos)), 1.0f, 1e-4);
+}
+
+TEST_CASE(ReachableTargetIsReached) {
+    const glm::fvec3 rootPos(0.1f, 1.4f, 0.0f);
+    const glm::fvec3 targetPos(0.4f, 1.1f, -0.2f);
+    IKSolver::TwoBoneResult result = IKSolver::SolveTwoBone(rootPos, 0.3f, 0.25f, targetPos, glm::fvec3(0.0f, -1.0f, 0.0f), NO_LIMITS);
+    CheckChain(rootPos, 0.3f, 0.25f, result);
+    CHECK_NEAR(result.reachError, 0.0f, 1e-4);
+}
+
+TEST_CASE(MiddleJointBendsTowardsThePole) {
+    const glm::fvec3 rootPos(0.0f);
+    const glm::fvec3 targetPos(0.4f, 0.0f, 0.0f);
+    for (const glm::fvec3 poleDir : { glm::fvec3(0.0f, -1.0f, 0.0f), glm::fvec3(0.0f, 0.0f, 1.0f) }) {
+        IKSolver::TwoBoneResult result = IKSolver::SolveTwoBone(rootPos, 0.3f, 0.3f, targetPos, poleDir, NO_LIMITS);
+        CHECK(glm::dot(result.midPos - rootPos, poleDir) > 0.1f);
+        CHECK_NEAR(result.midPos.x, 0.2f, 1e-4);
+    }
+}
+
+TEST_CASE(TargetOutOfReachStretchesTheChain) {
+    const glm::fvec3 targetPos(2.0f, 0.0f, 0.0f);
+    IKSolver::TwoBoneResult result = IKSolver::SolveTwoBone(glm::fvec3(0.0f), 0.3f, 0.3f, targetPos, glm::fvec3(0.0f, -1.0f, 0.0f), NO_LIMITS);
+    CHECK_NEAR(result.endPos.x, 0.6f, 0.01);
+    CHECK_NEAR(result.endPos.y, 0.0f, 1e-5);
+    CHECK_NEAR(result.reachError, glm::distance(result.endPos, targetPos), 1e-6);
+}
+
+TEST_CASE(JointLimitsAreKept) {
+    // the target right next to the root would fold the elbow completely
+    const IKSolver::JointLimits limits = { .minBend = glm::radians(2.0f), .maxBend = glm::radians(150.0f) };
+    IKSolver::TwoBoneResult result = IKSolver::SolveTwoBone(glm::fvec3(0.0f), 0.3f, 0.3f, glm::fvec3(0.01f, 0.0f, 0.0f), glm::fvec3(0.0f, -1.0f, 0.0f), limits);
+    CheckChain(glm::fvec3(0.0f), 0.3f, 0.3f, result);
+    const float bend = std::acos(std::clamp(glm::dot(result.upperDir, result.lowerDir), -1.0f, 1.0f));
+    CHECK(bend <= limits.maxBend + 1e-3f);
+    CHECK(result.reachError > 0.0f);
+}
+
+TEST_CASE(PoleAlongTheTargetFallsBackToAnotherPlane) {
+    IKSolver::TwoBoneResult result = IKSolver::SolveTwoBone(glm::fvec3(0.0f), 0.3f, 0.3f, glm::fvec3(0.0f, -0.4f, 0.0f), glm::fvec3(0.0f, -1.0f, 0.0f), NO_LIMITS);
+    CHECK(std::isfinite(result.midPos.x) && std::isfinite(result.midPos.y) && std::isfinite(result.midPos.z));
+    CheckChain(glm::fvec3(0.0f), 0.3f, 0.3f, result);
+    CHECK_NEAR(result.reachError, 0.0f, 1e-4);
+}
+
+TEST_CASE(RandomChainsStayValid) {
+    // arm-sized chains with targets all around them, which also shows how long a solve takes
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> coord(-0.8f, 0.8f);
+    std::uniform_real_distribution<float> length(0.15f, 0.4f);
+
+    constexpr uint32_t SOLVES = 200000;
+    uint32_t invalid = 0;
+    double maxReachableError = 0.0;
+    const auto startTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < SOLVES; i++) {
+        const glm::fvec3 rootPos(coord(rng), coord(rng), coord(rng));
+        const glm::fvec3 targetPos(coord(rng), coord(rng), coord(rng));
+        const glm::fvec3 poleDir(coord(rng), coord(rng), coord(rng));
+        const float upperLength = length(rng), lowerLength = length(rng);
+
+        IKSolver::TwoBoneResult result = IKSolver::SolveTwoBone(rootPos, upperLength, lowerLength, targetPos, poleDir, NO_LIMITS);
+        const float upperError = std::abs(glm::distance(rootPos, result.midPos) - upperLength);
+        const float lowerError = std::abs(glm::distance(result.midPos, result.endPos) - lowerLength);
+        if (!std::isfinite(result.reachError) || upperError > 1e-3f || lowerError > 1e-2f) {
+            invalid++;
+        }
+
+        // targets that are comfortably within reach should be hit exactly
+        const float targetDist = glm::distance(rootPos, targetPos);
+        if (targetDist > std::abs(upperLength - lowerLength) + 0.01f && targetDist < upperLength + lowerLength - 0.01f) {
+            maxReachableError = std::max(maxReachableError, (double)result.reachError);
+        }
+    }
+    const double nsPerSolve = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count() / SOLVES;
+    std::printf("%u random solves, %.1fns per solve, max error within reach %.6fm\n", SOLVES, nsPerSolve, maxReachableError);
+
+    CHECK_EQ(invalid, 0u);
+    CHECK(maxReachableError < 1e-3);
+}
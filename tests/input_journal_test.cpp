@@ -0,0 +1,109 @@
+#include "test.h"
+#include "hooking/input_journal.h"
+
+#include <random>
+
+// records a made up session the same way hook_InjectXRInput does, with buttons that are tapped, held and released and sticks that sweep around
+static std::unique_ptr<InputJournal> RecordSession(uint32_t frames, uint32_t seed, uint32_t corruptFrame = ~0u) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> pressLength(1, 20);
+    std::uniform_int_distribution<uint32_t> button((uint32_t)InputMapping::Source::JUMP, (uint32_t)InputMapping::Source::CANCEL);
+
+    InputMapping mapping;
+    mapping.LoadProfile();
+    auto journal = std::make_unique<InputJournal>();
+
+    const int64_t startTime = 1'000'000'000'000;
+    InputMapping::SourceMask held = 0;
+    uint32_t framesUntilChange = 0;
+    uint32_t stickButtons = 0;
+    for (uint32_t i = 0; i < frames; i++) {
+        if (framesUntilChange-- == 0) {
+            held = held != 0 ? 0 : InputMapping::SourceBit((InputMapping::Source)button(rng));
+            framesUntilChange = pressLength(rng);
+        }
+
+        const InputMapping::SourceMask sources = held | InputMapping::SourceBit(InputMapping::Source::MENU_ALLOWED) | InputMapping::SourceBit(InputMapping::Source::GRAB_ALLOWED);
+        const int64_t time = startTime + (int64_t)i * 33'333'333;
+        const XrVector2f leftStick = { std::sin(i * 0.05f), std::cos(i * 0.05f) };
+        const XrVector2f rightStick = { std::cos(i * 0.11f) * 0.7f, 0.0f };
+
+        const uint32_t mappedButtons = mapping.Evaluate(InputMapping::LAYER_GAMEPLAY, sources, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(time)));
+        stickButtons = InputMapping::EmulateStickButtons(stickButtons, leftStick, rightStick);
+        journal->Record({
+            .time = time,
+            .sources = sources,
+            .layer = InputMapping::LAYER_GAMEPLAY,
+            .xrLeftStick = leftStick,
+            .xrRightStick = rightStick,
+            .mappedButtons = i == corruptFrame ? mappedButtons ^ VPAD_BUTTON_A : mappedButtons,
+            .stickButtons = stickButtons,
+            .vpadHold = mappedButtons | stickButtons,
+            .vpadLeftStick = leftStick,
+            .vpadRightStick = rightStick
+        });
+    }
+    return journal;
+}
+
+static uint32_t GetDefaultProfileHash() {
+    InputMapping mapping;
+    mapping.LoadProfile();
+    return mapping.GetProfileHash();
+}
+
+static std::optional<InputJournal::ReplayResult> ReplayWithDefaultProfile(std::string_view data) {
+    InputMapping mapping;
+    mapping.LoadProfile();
+    return InputJournal::Replay(data, mapping);
+}
+
+TEST_CASE(ReplayMatchesTheRecording) {
+    const std::string data = RecordSession(600, 1)->Serialize(GetDefaultProfileHash());
+    std::optional<InputJournal::ReplayResult> result = ReplayWithDefaultProfile(data);
+    CHECK(result.has_value());
+    CHECK_EQ(result->frames, 600u);
+    CHECK(result->comparedFrames > 500u);
+    CHECK_EQ(result->mappingDivergences, 0u);
+    CHECK_EQ(result->stickDivergences, 0u);
+    CHECK(result->profileMatches);
+}
+
+TEST_CASE(ReplayOfAFullJournalStartsAtTheOldestFrame) {
+    // only the last CAPACITY frames are kept, so the replay starts in the middle of the session
+    const std::string data = RecordSession(InputJournal::CAPACITY + 700, 2)->Serialize(GetDefaultProfileHash());
+    std::optional<InputJournal::ReplayResult> result = ReplayWithDefaultProfile(data);
+    CHECK(result.has_value());
+    CHECK_EQ(result->frames, InputJournal::CAPACITY);
+    CHECK_EQ(result->mappingDivergences, 0u);
+    CHECK_EQ(result->stickDivergences, 0u);
+}
+
+TEST_CASE(ReplayFindsDivergences) {
+    const std::string data = RecordSession(600, 3, 450)->Serialize(GetDefaultProfileHash());
+    std::optional<InputJournal::ReplayResult> result = ReplayWithDefaultProfile(data);
+    CHECK(result.has_value());
+    CHECK_EQ(result->mappingDivergences, 1u);
+}
+
+TEST_CASE(ReplayNoticesAnotherProfile) {
+    const std::string data = RecordSession(60, 4)->Serialize(GetDefaultProfileHash() + 1);
+    std::optional<InputJournal::ReplayResult> result = ReplayWithDefaultProfile(data);
+    CHECK(result.has_value());
+    CHECK(!result->profileMatches);
+}
+
+TEST_CASE(ReplayStopsAtTruncatedData) {
+    const std::string data = RecordSession(200, 5)->Serialize(GetDefaultProfileHash());
+    std::optional<InputJournal::ReplayResult> result = ReplayWithDefaultProfile(std::string_view(data).substr(0, data.size() / 2));
+    CHECK(result.has_value());
+    CHECK(result->frames > 0u && result->frames < 200u);
+}
+
+TEST_CASE(ReplayRejectsOtherFiles) {
+    std::string data = RecordSession(10, 6)->Serialize(GetDefaultProfileHash());
+    CHECK(data.starts_with("JRVB"));
+    data[0] = 'X';
+    CHECK(!ReplayWithDefaultProfile(data).has_value());
+    CHECK(!ReplayWithDefaultProfile("JRV").has_value());
+}
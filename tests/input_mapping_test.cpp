@@ -0,0 +1,175 @@
+#include "test.h"
+#include "hooking/input_mapping.h"
+
+using Source = InputMapping::Source;
+
+static constexpr InputMapping::SourceMask Bits(std::initializer_list<Source> sources) {
+    InputMapping::SourceMask mask = 0;
+    for (Source source : sources) {
+        mask |= InputMapping::SourceBit(source);
+    }
+    return mask;
+}
+
+// a scripted timeline, each step keeps its sources active until the given time
+struct TimelineStep {
+    int64_t untilMs;
+    InputMapping::SourceMask sources;
+};
+
+struct TimelineFrame {
+    int64_t timeMs;
+    uint32_t buttons;
+};
+
+// evaluates the timeline every 10ms, the same mapping can be played again to continue where the last timeline stopped
+static std::vector<TimelineFrame> Play(InputMapping& mapping, InputMapping::Layer layer, std::initializer_list<TimelineStep> steps, int64_t startMs = 0) {
+    std::vector<TimelineFrame> frames;
+    int64_t timeMs = startMs;
+    for (const TimelineStep& step : steps) {
+        for (; timeMs < step.untilMs; timeMs += 10) {
+            const auto now = std::chrono::steady_clock::time_point(std::chrono::milliseconds(1'000'000 + timeMs));
+            frames.push_back({ timeMs, mapping.Evaluate(layer, step.sources, now) });
+        }
+    }
+    return frames;
+}
+
+static std::vector<int64_t> FramesWith(const std::vector<TimelineFrame>& frames, uint32_t button) {
+    std::vector<int64_t> times;
+    for (const TimelineFrame& frame : frames) {
+        if (HAS_FLAG(frame.buttons, button)) {
+            times.push_back(frame.timeMs);
+        }
+    }
+    return times;
+}
+
+static InputMapping DefaultMapping() {
+    InputMapping mapping;
+    mapping.LoadProfile();
+    return mapping;
+}
+
+TEST_CASE(TapFiresOnceTheDoubleTapWindowRunsOut) {
+    InputMapping mapping = DefaultMapping();
+    const auto frames = Play(mapping, InputMapping::LAYER_GAMEPLAY, {
+        { 50, Bits({ Source::MAP_INVENTORY, Source::MENU_ALLOWED }) },
+        { 500, Bits({ Source::MENU_ALLOWED }) }
+    });
+
+    // released at 50ms, so the window runs out with the first evaluation after 200ms
+    CHECK(FramesWith(frames, VPAD_BUTTON_PLUS) == std::vector<int64_t>{ 210 });
+    CHECK(FramesWith(frames, VPAD_BUTTON_MINUS).empty());
+}
+
+TEST_CASE(LongPressFiresWhileHeldAndNoTapAfterIt) {
+    InputMapping mapping = DefaultMapping();
+    const auto frames = Play(mapping, InputMapping::LAYER_GAMEPLAY, {
+        { 400, Bits({ Source::MAP_INVENTORY, Source::MENU_ALLOWED }) },
+        { 800, Bits({ Source::MENU_ALLOWED }) }
+    });
+
+    const std::vector<int64_t> minus = FramesWith(frames, VPAD_BUTTON_MINUS);
+    CHECK_EQ(minus.size(), 15u);
+    CHECK_EQ(minus.front(), 250);
+    CHECK_EQ(minus.back(), 390);
+    CHECK(FramesWith(frames, VPAD_BUTTON_PLUS).empty());
+}
+
+TEST_CASE(SecondTapWithinTheWindowIsNoTap) {
+    InputMapping mapping = DefaultMapping();
+    const auto frames = Play(mapping, InputMapping::LAYER_GAMEPLAY, {
+        { 50, Bits({ Source::MAP_INVENTORY, Source::MENU_ALLOWED }) },
+        { 100, Bits({ Source::MENU_ALLOWED }) },
+        { 150, Bits({ Source::MAP_INVENTORY, Source::MENU_ALLOWED }) },
+        { 600, Bits({ Source::MENU_ALLOWED }) }
+    });
+
+    // the second press makes it a double tap, which the default profile doesn't map
+    CHECK(FramesWith(frames, VPAD_BUTTON_PLUS).empty());
+}
+
+TEST_CASE(DoubleTapFiresOnTheSecondPress) {
+    InputMapping mapping;
+    CHECK(mapping.Compile("gameplay double jump -> y\ngameplay tap jump -> x", "test"));
+    const auto frames = Play(mapping, InputMapping::LAYER_GAMEPLAY, {
+        { 50, Bits({ Source::JUMP }) },
+        { 100, 0 },
+        { 150, Bits({ Source::JUMP }) },
+        { 600, 0 }
+    });
+
+    CHECK(FramesWith(frames, VPAD_BUTTON_Y) == std::vector<int64_t>{ 100 });
+    CHECK(FramesWith(frames, VPAD_BUTTON_X).empty());
+}
+
+TEST_CASE(MenuAllowedGatesTheMapButtons) {
+    InputMapping mapping = DefaultMapping();
+    const auto frames = Play(mapping, InputMapping::LAYER_GAMEPLAY, {
+        { 400, Bits({ Source::MAP_INVENTORY }) },
+        { 800, 0 }
+    });
+
+    CHECK(FramesWith(frames, VPAD_BUTTON_MINUS).empty());
+    CHECK(FramesWith(frames, VPAD_BUTTON_PLUS).empty());
+}
+
+TEST_CASE(DpadNeedsTheLeftHandInFrontAndMenuAllowed) {
+    InputMapping mapping = DefaultMapping();
+    const auto frames = Play(mapping, InputMapping::LAYER_GAMEPLAY, {
+        { 100, Bits({ Source::GRAB_LEFT, Source::LEFT_STICK_UP, Source::MENU_ALLOWED }) },
+        { 200, Bits({ Source::GRAB_LEFT, Source::LEFT_STICK_UP }) },
+        { 300, Bits({ Source::GRAB_LEFT, Source::LEFT_STICK_UP, Source::MENU_ALLOWED, Source::LEFT_HAND_BEHIND_HEAD }) }
+    });
+
+    CHECK_EQ(frames[0].buttons, (uint32_t)(VPAD_BUTTON_UP | VPAD_BUTTON_A));
+    CHECK_EQ(frames[10].buttons, (uint32_t)VPAD_BUTTON_A);
+    CHECK_EQ(frames[20].buttons, 0u);
+}
+
+TEST_CASE(GrabAllowedGatesTheRightHandGrab) {
+    // hook_InjectXRInput clears grab_allowed before evaluating while the dpad is used, so the right hand doesn't grab in the same frame
+    InputMapping mapping = DefaultMapping();
+    const auto frames = Play(mapping, InputMapping::LAYER_GAMEPLAY, {
+        { 100, Bits({ Source::GRAB_RIGHT, Source::GRAB_ALLOWED }) },
+        { 200, Bits({ Source::GRAB_RIGHT }) },
+        { 300, Bits({ Source::GRAB_RIGHT, Source::GRAB_ALLOWED, Source::RIGHT_STICK_DOWN }) }
+    });
+
+    CHECK_EQ(frames[0].buttons, (uint32_t)VPAD_BUTTON_A);
+    CHECK_EQ(frames[10].buttons, 0u);
+    CHECK_EQ(frames[20].buttons, 0u);
+}
+
+TEST_CASE(InactiveLayersKeepTrackingTheChord) {
+    InputMapping mapping = DefaultMapping();
+    const auto menuFrames = Play(mapping, InputMapping::LAYER_MENU, { { 300, Bits({ Source::RUN }) } });
+    CHECK(FramesWith(menuFrames, VPAD_BUTTON_B).empty());
+
+    // the run started in the menu, so it's already long enough once gameplay resumes
+    const auto gameplayFrames = Play(mapping, InputMapping::LAYER_GAMEPLAY, { { 350, Bits({ Source::RUN }) } }, 300);
+    CHECK(FramesWith(gameplayFrames, VPAD_BUTTON_B) == std::vector<int64_t>({ 300, 310, 320, 330, 340 }));
+}
+
+TEST_CASE(StickButtonsHaveHysteresis) {
+    uint32_t buttons = InputMapping::EmulateStickButtons(0, { 0.3f, 0.0f }, { 0.0f, 0.0f });
+    CHECK_EQ(buttons, 0u);
+    buttons = InputMapping::EmulateStickButtons(buttons, { 0.6f, 0.0f }, { 0.0f, -0.7f });
+    CHECK_EQ(buttons, (uint32_t)(VPAD_STICK_L_EMULATION_RIGHT | VPAD_STICK_R_EMULATION_DOWN));
+    buttons = InputMapping::EmulateStickButtons(buttons, { 0.3f, 0.0f }, { 0.0f, -0.2f });
+    CHECK_EQ(buttons, (uint32_t)(VPAD_STICK_L_EMULATION_RIGHT | VPAD_STICK_R_EMULATION_DOWN));
+    buttons = InputMapping::EmulateStickButtons(buttons, { 0.05f, 0.0f }, { 0.0f, 0.2f });
+    CHECK_EQ(buttons, 0u);
+}
+
+TEST_CASE(CompileKeepsTheOldNodesOnAnError) {
+    InputMapping mapping;
+    CHECK(mapping.Compile("gameplay hold jump -> x", "first"));
+    CHECK_EQ(mapping.GetNodeCount(), 1u);
+
+    CHECK(!mapping.Compile("gameplay hold jump -> x\ngameplay hold bogus -> y", "second"));
+    CHECK_EQ(mapping.GetNodeCount(), 1u);
+    const auto frames = Play(mapping, InputMapping::LAYER_GAMEPLAY, { { 10, Bits({ Source::JUMP }) } });
+    CHECK_EQ(frames[0].buttons, (uint32_t)VPAD_BUTTON_X);
+}
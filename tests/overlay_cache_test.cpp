@@ -0,0 +1,181 @@
+#include "test.h"
+#include "rendering/overlay_cache.h"
+
+using Rect = OverlayDrawCache::Rect;
+
+// a list of commands that each draw one quad inside their clip rect, which is all the cache looks at
+struct TestList {
+    std::vector<Rect> commands;
+    float vertexX = 0.0f;
+    ImTextureID texture = 1;
+};
+
+// imgui builds the draw data anew every frame, and Prepare empties the clip rects of what it skips, so every frame is built from scratch
+class TestFrame {
+public:
+    explicit TestFrame(const std::vector<TestList>& lists, ImVec2 displayPos = ImVec2(0.0f, 0.0f)) {
+        m_drawData.DisplayPos = displayPos;
+        m_drawData.DisplaySize = ImVec2(100.0f, 100.0f);
+        m_drawData.FramebufferScale = ImVec2(1.0f, 1.0f);
+        for (const TestList& list : lists) {
+            auto& drawList = m_lists.emplace_back(std::make_unique<ImDrawList>(nullptr));
+            for (const Rect& rect : list.commands) {
+                ImDrawCmd cmd;
+                cmd.ClipRect = ImVec4(displayPos.x + (float)rect.minX, displayPos.y + (float)rect.minY, displayPos.x + (float)rect.maxX, displayPos.y + (float)rect.maxY);
+                cmd.TextureId = list.texture;
+                cmd.VtxOffset = (unsigned int)drawList->VtxBuffer.Size;
+                cmd.IdxOffset = (unsigned int)drawList->IdxBuffer.Size;
+                cmd.ElemCount = 6;
+                drawList->CmdBuffer.push_back(cmd);
+                for (ImDrawIdx index : { 0, 1, 2, 0, 2, 3 }) {
+                    drawList->IdxBuffer.push_back(index);
+                }
+                for (int i = 0; i < 4; i++) {
+                    drawList->VtxBuffer.push_back(ImDrawVert{ .pos = ImVec2(list.vertexX + (float)rect.minX, (float)rect.minY), .uv = ImVec2(0.0f, 0.0f), .col = 0xFFFFFFFF });
+                }
+            }
+            m_drawData.CmdLists.push_back(drawList.get());
+        }
+        m_drawData.CmdListsCount = m_drawData.CmdLists.Size;
+        m_drawData.Valid = true;
+    }
+
+    ImDrawData* Get() { return &m_drawData; }
+
+    bool IsSkipped(size_t list, size_t command) const {
+        const ImVec4& clip = m_lists[list]->CmdBuffer[(int)command].ClipRect;
+        return clip.z <= clip.x || clip.w <= clip.y;
+    }
+
+private:
+    std::vector<std::unique_ptr<ImDrawList>> m_lists;
+    ImDrawData m_drawData;
+};
+
+static uint64_t NoTextureVersion(ImTextureID) {
+    return 0;
+}
+
+static OverlayDrawCache::Plan Prepare(OverlayDrawCache& cache, const std::vector<TestList>& lists, size_t target = 0) {
+    TestFrame frame(lists);
+    return cache.Prepare(target, frame.Get(), NoTextureVersion);
+}
+
+static const Rect FRAMEBUFFER = { 0, 0, 100, 100 };
+
+TEST_CASE(FirstFrameRedrawsEverything) {
+    OverlayDrawCache cache(2);
+    const OverlayDrawCache::Plan plan = Prepare(cache, { { .commands = { { 10, 10, 20, 20 } } } });
+    CHECK(plan.redraw);
+    CHECK(plan.dirtyRects == std::vector<Rect>{ FRAMEBUFFER });
+}
+
+TEST_CASE(UnchangedListsAreSkipped) {
+    OverlayDrawCache cache(2);
+    const std::vector<TestList> lists = { { .commands = { { 10, 10, 20, 20 } } }, { .commands = { { 50, 50, 70, 70 } } } };
+    Prepare(cache, lists, 0);
+
+    const OverlayDrawCache::Plan plan = Prepare(cache, lists, 0);
+    CHECK(!plan.redraw);
+    CHECK(plan.dirtyRects.empty());
+
+    // every framebuffer remembers what it holds on its own
+    CHECK(Prepare(cache, lists, 1).redraw);
+    CHECK(!Prepare(cache, lists, 1).redraw);
+
+    // as do the textures, the game's frames are drawn through the same ids with new contents
+    TestFrame frame(lists);
+    CHECK(cache.Prepare(0, frame.Get(), [](ImTextureID) -> uint64_t { return 1; }).redraw);
+}
+
+TEST_CASE(ChangedListRedrawsWhereItWasAndIs) {
+    OverlayDrawCache cache(1);
+    Prepare(cache, { { .commands = { { 10, 10, 20, 20 } } }, { .commands = { { 60, 60, 70, 70 } } } });
+
+    TestFrame frame({ { .commands = { { 10, 10, 20, 20 } } }, { .commands = { { 60, 70, 70, 80 } } } });
+    const OverlayDrawCache::Plan plan = cache.Prepare(0, frame.Get(), NoTextureVersion);
+    CHECK(plan.redraw);
+    CHECK(plan.dirtyRects == (std::vector<Rect>{ { 60, 60, 70, 80 } }));
+    CHECK(frame.IsSkipped(0, 0));
+    CHECK(!frame.IsSkipped(1, 0));
+}
+
+TEST_CASE(MovedDisplayRedrawsEverything) {
+    OverlayDrawCache cache(1);
+    const std::vector<TestList> lists = { { .commands = { { 10, 10, 20, 20 } } } };
+    Prepare(cache, lists);
+
+    TestFrame frame(lists, ImVec2(5.0f, 0.0f));
+    const OverlayDrawCache::Plan plan = cache.Prepare(0, frame.Get(), NoTextureVersion);
+    CHECK(plan.dirtyRects == std::vector<Rect>{ FRAMEBUFFER });
+}
+
+TEST_CASE(CommandsStraddlingARectGrowIt) {
+    OverlayDrawCache cache(1);
+    const TestList straddling = { .commands = { { 40, 40, 80, 80 } }, .vertexX = 0.0f, .texture = 2 };
+    const TestList outside = { .commands = { { 90, 0, 100, 10 } }, .vertexX = 0.0f, .texture = 3 };
+    Prepare(cache, { { .commands = { { 0, 0, 50, 50 } } }, straddling, outside });
+
+    // only the first list changed, but clearing its rect would cut into the second list's quad, which is then drawn over a cleared and an
+    // uncleared part. the rect grows to contain the quad instead, and the third list's quad is left as it is
+    TestFrame frame({ { .commands = { { 0, 0, 50, 50 } }, .vertexX = 1.0f }, straddling, outside });
+    const OverlayDrawCache::Plan plan = cache.Prepare(0, frame.Get(), NoTextureVersion);
+    CHECK(plan.dirtyRects == (std::vector<Rect>{ { 0, 0, 80, 80 } }));
+    CHECK(!frame.IsSkipped(0, 0));
+    CHECK(!frame.IsSkipped(1, 0));
+    CHECK(frame.IsSkipped(2, 0));
+}
+
+TEST_CASE(OverlappingAndAdjacentRectsMerge) {
+    std::vector<Rect> overlapping = { { 0, 0, 20, 20 }, { 10, 10, 30, 30 } };
+    OverlayDrawCache::MergeRects(overlapping, OverlayDrawCache::MAX_DIRTY_RECTS);
+    CHECK(overlapping == (std::vector<Rect>{ { 0, 0, 30, 30 } }));
+
+    // neighbours that share a whole edge become one rect that covers nothing more
+    std::vector<Rect> adjacent = { { 0, 0, 10, 10 }, { 10, 0, 20, 10 }, { 0, 10, 20, 20 } };
+    OverlayDrawCache::MergeRects(adjacent, OverlayDrawCache::MAX_DIRTY_RECTS);
+    CHECK(adjacent == (std::vector<Rect>{ { 0, 0, 20, 20 } }));
+
+    // only touching at a corner or along part of an edge would cover more, so they stay apart
+    std::vector<Rect> corner = { { 0, 0, 10, 10 }, { 10, 10, 20, 20 }, { 20, 0, 30, 5 } };
+    OverlayDrawCache::MergeRects(corner, OverlayDrawCache::MAX_DIRTY_RECTS);
+    CHECK_EQ(corner.size(), 3u);
+
+    // a union can reach rects that neither part overlapped
+    std::vector<Rect> chained = { { 0, 0, 10, 10 }, { 25, 0, 30, 5 }, { 8, 8, 30, 12 } };
+    OverlayDrawCache::MergeRects(chained, OverlayDrawCache::MAX_DIRTY_RECTS);
+    CHECK(chained == (std::vector<Rect>{ { 0, 0, 30, 12 } }));
+
+    std::vector<Rect> empty = { { 0, 0, 0, 10 }, { 5, 5, 5, 5 } };
+    OverlayDrawCache::MergeRects(empty, OverlayDrawCache::MAX_DIRTY_RECTS);
+    CHECK(empty.empty());
+}
+
+TEST_CASE(TooManyRectsMergeTheLeastWasteful) {
+    std::vector<Rect> rects = { { 0, 0, 10, 10 }, { 12, 0, 22, 10 }, { 80, 80, 90, 90 } };
+    OverlayDrawCache::MergeRects(rects, 2);
+    CHECK(rects == (std::vector<Rect>{ { 0, 0, 22, 10 }, { 80, 80, 90, 90 } }));
+
+    OverlayDrawCache::MergeRects(rects, 1);
+    CHECK(rects == (std::vector<Rect>{ { 0, 0, 90, 90 } }));
+}
+
+TEST_CASE(StatsCoverTheLastWindow) {
+    OverlayDrawCache cache(1);
+    const std::vector<TestList> lists = { { .commands = { { 0, 0, 50, 10 } } }, { .commands = { { 0, 50, 50, 60 } } } };
+    Prepare(cache, lists);
+    for (uint32_t i = 1; i < OverlayDrawCache::STATS_WINDOW - 1; i++) {
+        Prepare(cache, lists);
+    }
+    Prepare(cache, { lists[0], { .commands = { { 0, 50, 50, 60 } }, .vertexX = 1.0f } });
+    CHECK_EQ(cache.GetStats().frames, 0u);
+
+    // the window is only closed by the frame after it
+    Prepare(cache, lists);
+    const OverlayDrawCache::Stats stats = cache.GetStats();
+    CHECK_EQ(stats.frames, OverlayDrawCache::STATS_WINDOW);
+    CHECK_EQ(stats.fullFrames, 1u);
+    CHECK_EQ(stats.partialFrames, 1u);
+    CHECK_EQ(stats.skippedFrames, OverlayDrawCache::STATS_WINDOW - 2);
+    CHECK_NEAR(stats.partialCoverage, 0.05, 1e-9);
+}
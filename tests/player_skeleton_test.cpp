@@ -0,0 +1,89 @@
+#include "test.h"
+#include "hooking/player_skeleton.h"
+
+#include <random>
+
+// a player standing somewhere in the world with the headset and both controllers moving around it
+static PlayerSkeleton::PassInputs MakeInputs(std::mt19937& rng) {
+    std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+    std::uniform_real_distribution<float> angle(-glm::pi<float>(), glm::pi<float>());
+
+    auto randomRotation = [&] {
+        return glm::angleAxis(angle(rng), glm::normalize(glm::fvec3(offset(rng), 1.0f, offset(rng))));
+    };
+
+    const glm::fvec3 playerPos(120.0f + offset(rng), 30.0f, -450.0f + offset(rng));
+    PlayerSkeleton::PassInputs inputs = {
+        .cameraMtx = glm::translate(glm::identity<glm::mat4>(), playerPos + glm::fvec3(0.0f, 0.2f, 0.0f)) * glm::mat4_cast(randomRotation()),
+        .playerMtx = glm::translate(glm::identity<glm::mat4>(), playerPos) * glm::mat4_cast(randomRotation()),
+        .headsetMtx = glm::translate(glm::identity<glm::mat4>(), glm::fvec3(offset(rng), 1.6f, offset(rng))) * glm::mat4_cast(randomRotation())
+    };
+    inputs.hands[0] = std::pair{ glm::fvec3(-0.25f + offset(rng), 1.1f + offset(rng), -0.3f + offset(rng)), randomRotation() };
+    inputs.hands[1] = std::pair{ glm::fvec3(0.25f + offset(rng), 1.1f + offset(rng), -0.3f + offset(rng)), randomRotation() };
+    return inputs;
+}
+
+static void CheckSameMatrix(const glm::fmat4x3& a, const glm::fmat4x3& b) {
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 3; r++) {
+            CHECK_NEAR(a[c][r], b[c][r], 1e-5);
+        }
+    }
+}
+
+TEST_CASE(OnePassMatchesSolvingForEveryBone) {
+    // the bone hook used to pose the skeleton again for every bone it was called for, and now poses it once per pass
+    std::mt19937 rng(7);
+    PlayerSkeleton perBone;
+    PlayerSkeleton perPass;
+    for (uint32_t frame = 0; frame < 50; frame++) {
+        const PlayerSkeleton::PassInputs inputs = MakeInputs(rng);
+        const std::vector<glm::fmat4x3> passMatrices = perPass.ComputePass(inputs);
+        CHECK_EQ(passMatrices.size(), perBone.GetBoneCount());
+
+        for (size_t i = 0; i < perBone.GetBoneCount(); i++) {
+            CheckSameMatrix(perBone.ComputePass(inputs)[i], passMatrices[i]);
+        }
+    }
+}
+
+TEST_CASE(PassDoesNotDependOnThePreviousOne) {
+    std::mt19937 rng(99);
+    const PlayerSkeleton::PassInputs first = MakeInputs(rng);
+    const PlayerSkeleton::PassInputs second = MakeInputs(rng);
+
+    PlayerSkeleton reused;
+    reused.ComputePass(first);
+    const std::vector<glm::fmat4x3> reusedMatrices = reused.ComputePass(second);
+
+    PlayerSkeleton fresh;
+    const std::vector<glm::fmat4x3> freshMatrices = fresh.ComputePass(second);
+    for (size_t i = 0; i < freshMatrices.size(); i++) {
+        CheckSameMatrix(reusedMatrices[i], freshMatrices[i]);
+    }
+}
+
+TEST_CASE(UntrackedHandKeepsItsArm) {
+    // the hook doesn't write the bones of an untracked hand, they're only kept from the last pass that posed them
+    std::mt19937 rng(3);
+    PlayerSkeleton skeleton;
+    const int arm = skeleton.GetBoneIndex("Arm_1_L");
+    const int otherArm = skeleton.GetBoneIndex("Arm_1_R");
+    CHECK(arm != -1 && otherArm != -1);
+
+    const std::vector<glm::fmat4x3> before = skeleton.ComputePass(MakeInputs(rng));
+
+    PlayerSkeleton::PassInputs inputs = MakeInputs(rng);
+    inputs.hands[0] = std::nullopt;
+    const std::vector<glm::fmat4x3>& after = skeleton.ComputePass(inputs);
+    CheckSameMatrix(after[arm], before[arm]);
+    CHECK(!(after[otherArm] == before[otherArm]));
+}
+
+TEST_CASE(FaceBones) {
+    CHECK(PlayerSkeleton::IsFaceBone("Eyelid_L"));
+    CHECK(PlayerSkeleton::IsFaceBone("Head"));
+    CHECK(PlayerSkeleton::IsFaceBone("Teeth_Upper"));
+    CHECK(!PlayerSkeleton::IsFaceBone("Wrist_L"));
+    CHECK(!PlayerSkeleton::IsFaceBone("Skl_Root"));
+}
@@ -0,0 +1,80 @@
+#include "test.h"
+#include "rendering/pose_predictor.h"
+
+constexpr XrTime START_TIME = 1'000'000'000'000;
+constexpr XrDuration FRAME_TIME = 11'111'111; // 90hz
+
+static XrPosef PoseAtX(float x) {
+    return { .orientation = { 0.0f, 0.0f, 0.0f, 1.0f }, .position = { x, 0.0f, 0.0f } };
+}
+
+static XrSpaceVelocity VelocityX(float x) {
+    return {
+        .type = XR_TYPE_SPACE_VELOCITY,
+        .velocityFlags = XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT,
+        .linearVelocity = { x, 0.0f, 0.0f },
+        .angularVelocity = { 0.0f, 0.0f, 0.0f }
+    };
+}
+
+TEST_CASE(TargetTimeIsThePredictedDisplayTime) {
+    PosePredictor predictor;
+    predictor.SetFrameTiming(START_TIME);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    // the time spent in the hooks doesn't push the prediction past when the frame is shown
+    CHECK_EQ(predictor.GetTargetTime(), START_TIME);
+
+    predictor.SetFrameTiming(START_TIME + FRAME_TIME);
+    CHECK_EQ(predictor.GetTargetTime(), START_TIME + FRAME_TIME);
+    predictor.SetFrameTiming(START_TIME);
+    CHECK_EQ(predictor.GetTargetTime(), START_TIME + FRAME_TIME);
+}
+
+TEST_CASE(InterpolatesAndCapsTheExtrapolation) {
+    PosePredictor predictor;
+    predictor.SetConfig({ .filter = PosePredictor::Filter::NONE, .minCutoff = 0.0f, .beta = 0.0f, .derivativeCutoff = 0.0f, .maxExtrapolation = 50'000'000 });
+    const XrSpaceVelocity velocity = VelocityX(1.0f);
+    for (int i = 0; i < 3; i++) {
+        const XrPosef pose = PoseAtX((float)i * (float)FRAME_TIME / 1e9f);
+        predictor.Record(PosePredictor::Device::LEFT_HAND, START_TIME + i * FRAME_TIME, pose, &velocity);
+    }
+
+    CHECK(!predictor.PoseAt(PosePredictor::Device::RIGHT_HAND, START_TIME).has_value());
+    CHECK_NEAR(predictor.PoseAt(PosePredictor::Device::LEFT_HAND, START_TIME + FRAME_TIME / 2)->position.x, (float)FRAME_TIME / 2e9f, 1e-5);
+    CHECK_NEAR(predictor.PoseAt(PosePredictor::Device::LEFT_HAND, START_TIME + 3 * FRAME_TIME)->position.x, 3.0f * (float)FRAME_TIME / 1e9f, 1e-5);
+    CHECK_NEAR(predictor.PoseAt(PosePredictor::Device::LEFT_HAND, START_TIME + 2 * FRAME_TIME + 500'000'000)->position.x, 2.0f * (float)FRAME_TIME / 1e9f + 0.05f, 1e-5);
+}
+
+TEST_CASE(FilteredVelocityFollowsASlowHandThatStartsMoving) {
+    // slow movements barely raise the cutoff, so this is where the minimum cutoff shows up as lag
+    PosePredictor predictor;
+    const XrSpaceVelocity still = VelocityX(0.0f);
+    const XrSpaceVelocity moving = VelocityX(0.1f);
+    XrTime time = START_TIME;
+    for (int i = 0; i < 30; i++, time += FRAME_TIME) {
+        predictor.Record(PosePredictor::Device::LEFT_HAND, time, PoseAtX(0.0f), &still);
+    }
+
+    // five frames into the movement the extrapolation should be using most of the real speed already
+    float x = 0.0f;
+    for (int i = 0; i < 5; i++, time += FRAME_TIME) {
+        x += 0.1f * (float)FRAME_TIME / 1e9f;
+        predictor.Record(PosePredictor::Device::LEFT_HAND, time, PoseAtX(x), &moving);
+    }
+    const XrTime newest = time - FRAME_TIME;
+    CHECK(predictor.PoseAt(PosePredictor::Device::LEFT_HAND, newest)->linearVelocity.x > 0.085f);
+}
+
+TEST_CASE(FilteredVelocityDampsJitter) {
+    PosePredictor predictor;
+    XrTime time = START_TIME;
+    float maxVelocity = 0.0f;
+    for (int i = 0; i < 60; i++, time += FRAME_TIME) {
+        const XrSpaceVelocity velocity = VelocityX(i % 2 == 0 ? 0.1f : -0.1f);
+        predictor.Record(PosePredictor::Device::LEFT_HAND, time, PoseAtX(0.0f), &velocity);
+        if (i >= 30) {
+            maxVelocity = std::max(maxVelocity, std::abs(predictor.PoseAt(PosePredictor::Device::LEFT_HAND, time)->linearVelocity.x));
+        }
+    }
+    CHECK(maxVelocity < 0.05f);
+}
@@ -0,0 +1,133 @@
+#include "test.h"
+#include "rendering/present_graph.h"
+
+using Lane = PresentGraph::Lane;
+
+static bool HasWaits(const PresentGraph::Job& job, std::initializer_list<PresentGraph::Wait> waits) {
+    if (job.waits.size() != waits.size()) {
+        return false;
+    }
+    size_t i = 0;
+    for (const PresentGraph::Wait& wait : waits) {
+        if (job.waits[i].lane != wait.lane || job.waits[i].value != wait.value) {
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
+
+// the chain that RND_Renderer::EndFrame adds every frame
+struct FrameJobs {
+    PresentGraph::JobId compose;
+    PresentGraph::JobId release;
+    PresentGraph::JobId submit;
+};
+
+static FrameJobs AddFrame(PresentGraph& graph) {
+    graph.BeginFrame();
+    const PresentGraph::JobId compose = graph.Add("compose", Lane::PRESENT);
+    const PresentGraph::JobId release = graph.Add("release", Lane::DIRECT, { compose });
+    const PresentGraph::JobId submit = graph.Add("xrEndFrame", Lane::SUBMIT, { release });
+    return { compose, release, submit };
+}
+
+TEST_CASE(ComposeReleaseAndEndFrameFormAChain) {
+    PresentGraph graph;
+    const FrameJobs frame = AddFrame(graph);
+
+    CHECK(HasWaits(graph.GetJob(frame.compose), {}));
+    CHECK(HasWaits(graph.GetJob(frame.release), { { Lane::PRESENT, 1 } }));
+    // xrEndFrame only needs the release, which already waited for the compose
+    CHECK(HasWaits(graph.GetJob(frame.submit), { { Lane::DIRECT, 1 } }));
+
+    const PresentGraph::Timeline expected = { 1, 1, 1 };
+    CHECK(graph.GetJob(frame.submit).reached == expected);
+    CHECK(graph.GetScheduled() == expected);
+
+    // the jobs finish in the order of the chain
+    CHECK(!graph.IsCompleted(frame.compose));
+    graph.OnCompleted(Lane::PRESENT, 1);
+    CHECK(graph.IsCompleted(frame.compose));
+    CHECK(!graph.IsCompleted(frame.release));
+    graph.OnCompleted(Lane::DIRECT, 1);
+    graph.OnCompleted(Lane::SUBMIT, 1);
+    CHECK(graph.IsCompleted(frame.submit));
+}
+
+TEST_CASE(EveryLaneCountsItsOwnJobs) {
+    PresentGraph graph;
+    const PresentGraph::JobId firstCompose = graph.Add("compose left", Lane::PRESENT);
+    const PresentGraph::JobId secondCompose = graph.Add("compose right", Lane::PRESENT);
+    const PresentGraph::JobId copy = graph.Add("copy", Lane::DIRECT);
+    const PresentGraph::JobId release = graph.Add("release", Lane::DIRECT, { firstCompose, secondCompose });
+
+    CHECK_EQ(graph.GetJob(firstCompose).signalValue, 1u);
+    CHECK_EQ(graph.GetJob(secondCompose).signalValue, 2u);
+    CHECK_EQ(graph.GetJob(copy).signalValue, 1u);
+    CHECK_EQ(graph.GetJob(release).signalValue, 2u);
+    // only the latest job of a lane is waited for, since the lane finishes them in order
+    CHECK(HasWaits(graph.GetJob(release), { { Lane::PRESENT, 2 } }));
+
+    const PresentGraph::Timeline scheduled = { 2, 2, 0 };
+    CHECK(graph.GetScheduled() == scheduled);
+    CHECK_EQ(graph.GetInFlight(Lane::PRESENT), 2u);
+    graph.OnCompleted(Lane::PRESENT, 1);
+    CHECK_EQ(graph.GetInFlight(Lane::PRESENT), 1u);
+    CHECK(graph.IsCompleted(firstCompose));
+    CHECK(!graph.IsCompleted(secondCompose));
+
+    // fences only move forward, and can't get ahead of what was scheduled
+    graph.OnCompleted(Lane::PRESENT, 0);
+    CHECK_EQ(graph.GetCompleted(Lane::PRESENT), 1u);
+    CHECK_THROWS(graph.OnCompleted(Lane::PRESENT, 3));
+    CHECK_THROWS(graph.OnCompleted(Lane::SUBMIT, 1));
+}
+
+TEST_CASE(WaitsThatAreAlreadyImpliedAreSkipped) {
+    PresentGraph graph;
+    const PresentGraph::JobId compose = graph.Add("compose", Lane::PRESENT);
+    const PresentGraph::JobId release = graph.Add("release", Lane::DIRECT, { compose });
+
+    // a later job on the same lane already knows that the compose finished
+    const PresentGraph::JobId copy = graph.Add("copy", Lane::DIRECT, { compose });
+    CHECK(HasWaits(graph.GetJob(copy), {}));
+
+    // depending on both the release and the compose only needs the release
+    const PresentGraph::JobId submit = graph.Add("xrEndFrame", Lane::SUBMIT, { compose, release });
+    CHECK(HasWaits(graph.GetJob(submit), { { Lane::DIRECT, 1 } }));
+
+    // the same holds when the implied wait is on a lane that comes before the implying one
+    const PresentGraph::JobId nextCompose = graph.Add("compose", Lane::PRESENT, { release, submit });
+    CHECK(HasWaits(graph.GetJob(nextCompose), { { Lane::SUBMIT, 1 } }));
+
+    const PresentGraph::Timeline reached = { 1, 2, 1 };
+    CHECK(graph.GetJob(nextCompose).reached == reached);
+}
+
+TEST_CASE(TimelinesKeepCountingAcrossFrames) {
+    PresentGraph graph;
+    const FrameJobs first = AddFrame(graph);
+    CHECK_EQ(graph.GetJobs().size(), 3u);
+
+    // BeginFrame hands out the job ids from the start again
+    const FrameJobs second = AddFrame(graph);
+    CHECK_EQ(second.compose, first.compose);
+    CHECK_EQ(second.submit, first.submit);
+    CHECK_EQ(graph.GetJobs().size(), 3u);
+
+    CHECK_EQ(graph.GetJob(second.compose).signalValue, 2u);
+    CHECK_EQ(graph.GetJob(second.release).signalValue, 2u);
+    CHECK_EQ(graph.GetJob(second.submit).signalValue, 2u);
+    CHECK(HasWaits(graph.GetJob(second.release), { { Lane::PRESENT, 2 } }));
+    CHECK(HasWaits(graph.GetJob(second.submit), { { Lane::DIRECT, 2 } }));
+
+    // the previous frame is still in flight while this one is recorded
+    graph.OnCompleted(Lane::PRESENT, 1);
+    CHECK_EQ(graph.GetInFlight(Lane::PRESENT), 1u);
+    CHECK_EQ(graph.GetInFlight(Lane::DIRECT), 2u);
+
+    // the jobs of the previous frame are gone
+    graph.BeginFrame();
+    CHECK_THROWS(graph.Add("release", Lane::DIRECT, { second.compose }));
+}
@@ -0,0 +1,54 @@
+#include "test.h"
+#include "rendering/quad_compositor.h"
+
+TEST_CASE(FollowFactorMatchesTheOldPerFrameLerp) {
+    CHECK_NEAR(QuadCompositor::GetFollowFactor(1.0 / 90.0), QuadCompositor::FOLLOW_LERP_AT_90HZ, 1e-6);
+    CHECK_EQ(QuadCompositor::GetFollowFactor(0.0), 0.0f);
+
+    // two frames at 90Hz end up where one frame at 45Hz does
+    const float once = QuadCompositor::GetFollowFactor(1.0 / 90.0);
+    CHECK_NEAR(1.0f - (1.0f - once) * (1.0f - once), QuadCompositor::GetFollowFactor(2.0 / 90.0), 1e-6);
+}
+
+TEST_CASE(PlaceInFrontFacesTheHead) {
+    const glm::quat identity = glm::identity<glm::quat>();
+    XrPosef pose = QuadCompositor::PlaceInFront(glm::vec3(0.0f, 1.5f, 0.0f), identity, 2.0f);
+    CHECK_NEAR(pose.position.x, 0.0f, 1e-5);
+    CHECK_NEAR(pose.position.y, 1.5f, 1e-5);
+    CHECK_NEAR(pose.position.z, -2.0f, 1e-5);
+
+    const glm::vec3 forward = ToGLM(pose.orientation) * glm::vec3(0.0f, 0.0f, -1.0f);
+    CHECK_NEAR(forward.z, -1.0f, 1e-5);
+}
+
+TEST_CASE(QuadSizeKeepsTheShorterSide) {
+    XrExtent2Df wide = QuadCompositor::GetQuadSize(16.0f / 9.0f, 1.0f);
+    CHECK_NEAR(wide.height, 1.0f, 1e-6);
+    CHECK_NEAR(wide.width, 16.0f / 9.0f, 1e-6);
+
+    XrExtent2Df tall = QuadCompositor::GetQuadSize(0.5f, 2.0f);
+    CHECK_NEAR(tall.width, 2.0f, 1e-6);
+    CHECK_NEAR(tall.height, 4.0f, 1e-6);
+}
+
+TEST_CASE(LayersAreInSlotOrder) {
+    QuadCompositor compositor;
+    XrCompositionLayerQuad hud = { .type = XR_TYPE_COMPOSITION_LAYER_QUAD };
+    hud.size = { 1.0f, 1.0f };
+    XrCompositionLayerQuad hand = hud;
+    hand.size = { 0.1f, 0.1f };
+
+    compositor.Show(QuadCompositor::Slot::RIGHT_HAND, hand);
+    compositor.Show(QuadCompositor::Slot::HUD, hud);
+    QuadCompositor::Layers layers = compositor.GetLayers();
+    CHECK_EQ(layers.count, 2u);
+    CHECK_EQ(layers.Get()[0].size.width, 1.0f);
+    CHECK_EQ(layers.Get()[1].size.width, 0.1f);
+
+    compositor.Hide(QuadCompositor::Slot::HUD);
+    CHECK_EQ(compositor.GetLayers().count, 1u);
+
+    CHECK(!compositor.IsRendered(QuadCompositor::Slot::HUD, 3));
+    compositor.OnRendered(QuadCompositor::Slot::HUD, 3);
+    CHECK(compositor.IsRendered(QuadCompositor::Slot::HUD, 3));
+}
@@ -0,0 +1,218 @@
+#include "test.h"
+#include "rendering/reprojection.h"
+
+constexpr float NEAR_Z = 0.1f;
+constexpr float FAR_Z = 1000.0f;
+// 45 degrees to every side, so that the tangents go from -1 to 1 across the image
+constexpr XrFovf FOV = { -0.785398163f, 0.785398163f, 0.785398163f, -0.785398163f };
+
+static Reprojection::Eye EyeAt(glm::fvec3 position, float yaw = 0.0f) {
+    return { position, glm::angleAxis(yaw, glm::fvec3(0.0f, 1.0f, 0.0f)), FOV };
+}
+
+// the device depth that a surface at the given distance in front of the eye is captured at
+static float DeviceDepth(float distance) {
+    return FAR_Z * (distance - NEAR_Z) / (distance * (FAR_Z - NEAR_Z));
+}
+
+static Reprojection::Image Warp(Reprojection::Quality quality, const Reprojection::Eye& from, const Reprojection::Eye& to, const Reprojection::Image& source) {
+    const Reprojection::Settings settings = Reprojection::GetSettings(quality, from, to, source.width, source.height, source.width, source.height, NEAR_Z, FAR_Z);
+    // cleared like the swapchain, a pixel that nothing is warped to stays transparent
+    Reprojection::Image target(source.width, source.height, glm::fvec4(0.0f), 1.0f);
+    Reprojection::Warp(settings, source, target);
+    return target;
+}
+
+// every texel's color is its own coordinate, so that the target tells where each pixel was sampled from
+static Reprojection::Image CoordinateImage(uint32_t width, uint32_t height, float depth) {
+    Reprojection::Image image(width, height, glm::fvec4(0.0f), depth);
+    for (int32_t y = 0; y < (int32_t)height; y++) {
+        for (int32_t x = 0; x < (int32_t)width; x++) {
+            image.color[image.Index(x, y)] = glm::fvec4((float)x, (float)y, 0.0f, 1.0f);
+        }
+    }
+    return image;
+}
+
+// a white box a meter in front of the eye, with a black background that's far enough away to barely move
+static Reprojection::Image BoxImage(uint32_t width, uint32_t height, glm::ivec2 boxMin, glm::ivec2 boxMax) {
+    Reprojection::Image image(width, height, glm::fvec4(0.0f, 0.0f, 0.0f, 1.0f), DeviceDepth(100.0f));
+    for (int32_t y = boxMin.y; y <= boxMax.y; y++) {
+        for (int32_t x = boxMin.x; x <= boxMax.x; x++) {
+            image.color[image.Index(x, y)] = glm::fvec4(1.0f);
+            image.depth[image.Index(x, y)] = DeviceDepth(1.0f);
+        }
+    }
+    return image;
+}
+
+// '#' for the box, '.' for the background and ' ' for pixels that nothing was warped to
+static std::vector<std::string> ToAscii(const Reprojection::Image& image) {
+    std::vector<std::string> rows;
+    for (int32_t y = 0; y < (int32_t)image.height; y++) {
+        std::string row;
+        for (int32_t x = 0; x < (int32_t)image.width; x++) {
+            const glm::fvec4& color = image.ColorAt(x, y);
+            row += color.w == 0.0f ? ' ' : color.x > 0.5f ? '#' : '.';
+        }
+        rows.push_back(std::move(row));
+    }
+    return rows;
+}
+
+static void CheckGolden(const Reprojection::Image& image, const std::vector<std::string>& golden, const char* file, int line) {
+    const std::vector<std::string> rows = ToAscii(image);
+    if (rows != golden) {
+        std::string message = "the warped image doesn't match the golden image, it was:\n";
+        for (const std::string& row : rows) {
+            message += std::format("    \"{}\",\n", row);
+        }
+        Test::Fail(file, line, message);
+    }
+}
+
+#define CHECK_GOLDEN(image, ...) CheckGolden(image, __VA_ARGS__, __FILE__, __LINE__)
+
+TEST_CASE(IdentityReproducesTheSource) {
+    const Reprojection::Image source = CoordinateImage(64, 48, DeviceDepth(5.0f));
+    for (Reprojection::Quality quality : { Reprojection::Quality::LOW, Reprojection::Quality::MEDIUM, Reprojection::Quality::HIGH }) {
+        const Reprojection::Image target = Warp(quality, EyeAt(glm::fvec3(0.0f)), EyeAt(glm::fvec3(0.0f)), source);
+        CHECK(target.color == source.color);
+    }
+}
+
+TEST_CASE(RotationSamplesWhereTheRayWasCaptured) {
+    // a rotation doesn't depend on the depth, so every pixel can be traced back to the texel it should show
+    constexpr float YAW = 0.1f;
+    const Reprojection::Image source = CoordinateImage(64, 64, DeviceDepth(5.0f));
+    const Reprojection::Image target = Warp(Reprojection::Quality::LOW, EyeAt(glm::fvec3(0.0f)), EyeAt(glm::fvec3(0.0f), YAW), source);
+
+    const glm::fquat rotation = glm::angleAxis(YAW, glm::fvec3(0.0f, 1.0f, 0.0f));
+    uint32_t checkedPixels = 0;
+    float maxError = 0.0f;
+    for (int32_t y = 0; y < (int32_t)target.height; y++) {
+        for (int32_t x = 0; x < (int32_t)target.width; x++) {
+            const glm::fvec3 ray = rotation * glm::fvec3(((float)x + 0.5f) / 32.0f - 1.0f, 1.0f - ((float)y + 0.5f) / 32.0f, -1.0f);
+            const glm::fvec2 texel = glm::fvec2(ray.x / -ray.z + 1.0f, 1.0f - ray.y / -ray.z) * 32.0f;
+            // the pixels that were warped from the source's border are clamped to it
+            if (texel.x < 1.0f || texel.x > 63.0f || texel.y < 1.0f || texel.y > 63.0f) {
+                continue;
+            }
+            const glm::fvec4& color = target.ColorAt(x, y);
+            CHECK(color.w == 1.0f);
+            maxError = std::max({ maxError, std::abs(color.x + 0.5f - texel.x), std::abs(color.y + 0.5f - texel.y) });
+            checkedPixels++;
+        }
+    }
+    CHECK(checkedPixels > 3000u);
+    CHECK(maxError <= 1.0f);
+}
+
+TEST_CASE(LowIgnoresThePositionAndTheDepth) {
+    const Reprojection::Image source = BoxImage(48, 24, { 16, 4 }, { 31, 19 });
+    const Reprojection::Image target = Warp(Reprojection::Quality::LOW, EyeAt(glm::fvec3(0.0f)), EyeAt(glm::fvec3(0.25f, 0.0f, 0.0f)), source);
+    CHECK(target.color == source.color);
+}
+
+// a quarter meter to the right moves the box 6 pixels to the left. the cells that its edges cross are stretched between its depth and
+// the background's, so the hole filling eats into the box there by up to a cell and bleeds it into the hole by up to the tolerance.
+TEST_CASE(HighMovesTheBoxAndFillsTheHole) {
+    const Reprojection::Image source = BoxImage(48, 24, { 16, 4 }, { 31, 19 });
+    const Reprojection::Image target = Warp(Reprojection::Quality::HIGH, EyeAt(glm::fvec3(0.0f)), EyeAt(glm::fvec3(0.25f, 0.0f, 0.0f)), source);
+    CHECK_GOLDEN(target, {
+        "................................................",
+        "................................................",
+        "................................................",
+        "................................................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "..........###############.......................",
+        "...........##############.......................",
+        "............##.##.####.##.......................",
+        "................................................",
+        "................................................",
+        "................................................",
+        "................................................",
+        "................................................",
+        "................................................",
+    });
+}
+
+TEST_CASE(MediumMovesTheBoxAndFillsTheHole) {
+    const Reprojection::Image source = BoxImage(48, 24, { 16, 4 }, { 31, 19 });
+    const Reprojection::Image target = Warp(Reprojection::Quality::MEDIUM, EyeAt(glm::fvec3(0.0f)), EyeAt(glm::fvec3(0.25f, 0.0f, 0.0f)), source);
+    CHECK_GOLDEN(target, {
+        "................................................",
+        "................................................",
+        "................................................",
+        "................................................",
+        "................................................",
+        "............##.##.####.#........................",
+        "...........###########.#........................",
+        "..........############.#........................",
+        "..........############.#........................",
+        "..........############.#........................",
+        "..........############.#........................",
+        "..........############.#........................",
+        "..........############.#........................",
+        "..........############.#........................",
+        "..........############.#........................",
+        "..........############.#........................",
+        "..........############..........................",
+        "...........###########..........................",
+        "............##.##.###...........................",
+        "................................................",
+        "................................................",
+        "................................................",
+        "................................................",
+        "................................................",
+    });
+}
+
+TEST_CASE(HighTurnsAndMovesTheOtherWay) {
+    // the hole opens up on the other side of the box, and the image's edge comes into view without anything to warp there
+    const Reprojection::Image source = BoxImage(48, 24, { 16, 4 }, { 31, 19 });
+    const Reprojection::Image target = Warp(Reprojection::Quality::HIGH, EyeAt(glm::fvec3(0.0f)), EyeAt(glm::fvec3(-0.25f, 0.0f, 0.0f), 0.1f), source);
+    CHECK_GOLDEN(target, {
+        "               .................................",
+        "    ............................................",
+        "    ............................................",
+        "    ............................................",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................#############...........",
+        "    ....................############............",
+        "    ...........................####.............",
+        "    ............................................",
+        "    ............................................",
+        "    ............................................",
+        "    ............................................",
+        "    ............................................",
+        "               .................................",
+    });
+}
+
+TEST_CASE(MismatchedImagesAreRejected) {
+    const Reprojection::Image source = CoordinateImage(64, 48, DeviceDepth(5.0f));
+    const Reprojection::Settings settings = Reprojection::GetSettings(Reprojection::Quality::HIGH, EyeAt(glm::fvec3(0.0f)), EyeAt(glm::fvec3(0.0f)), 64, 48, 32, 32, NEAR_Z, FAR_Z);
+    Reprojection::Image target(64, 48);
+    CHECK_THROWS(Reprojection::Warp(settings, source, target));
+}
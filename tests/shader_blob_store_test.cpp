@@ -0,0 +1,129 @@
+#include "test.h"
+#include "rendering/shader_blob_store.h"
+
+static constexpr uint32_t COMPILER_VERSION = 47;
+static constexpr uint32_t COMPILE_FLAGS = 0x2801;
+
+static constexpr ShaderBlobStore::ShaderKey VERTEX_SHADER = { ShaderBlobStore::Hash("float4 VSMain() : SV_Position { return 0; }"), "VSMain", "vs_5_1" };
+static constexpr ShaderBlobStore::ShaderKey PIXEL_SHADER = { ShaderBlobStore::Hash("float4 PSMain() : SV_Target { return 1; }"), "PSMain", "ps_5_1" };
+
+// stands in for D3DCompile, the bytecode is made up from the entry point so that every shader gets different bytes
+struct FakeCompiler {
+    uint32_t compiles = 0;
+    std::vector<uint8_t> bytes;
+
+    auto For(const ShaderBlobStore::ShaderKey& key) {
+        return [this, key] {
+            compiles++;
+            bytes.assign(key.entryPoint.begin(), key.entryPoint.end());
+            bytes.resize(64, 0xCC);
+            return std::span<const uint8_t>(bytes);
+        };
+    }
+};
+
+static ShaderBlobStore Compiled(FakeCompiler& compiler, uint32_t compilerVersion = COMPILER_VERSION) {
+    ShaderBlobStore store(compilerVersion);
+    store.FindOrCompile(ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS, 0), compiler.For(VERTEX_SHADER));
+    store.FindOrCompile(ShaderBlobStore::GetCacheKey(PIXEL_SHADER, COMPILE_FLAGS, 0), compiler.For(PIXEL_SHADER));
+    return store;
+}
+
+TEST_CASE(SavedShadersAreLoadedWithoutCompiling) {
+    FakeCompiler compiler;
+    ShaderBlobStore saved = Compiled(compiler);
+    CHECK_EQ(compiler.compiles, 2u);
+    CHECK_EQ(saved.GetMisses(), 2u);
+
+    ShaderBlobStore loaded(COMPILER_VERSION);
+    CHECK(loaded.Deserialize(saved.Serialize()));
+    CHECK_EQ(loaded.GetCount(), 2u);
+    CHECK_EQ(loaded.GetRejectedCount(), 0u);
+
+    const std::vector<uint8_t>& vertexBytes = loaded.FindOrCompile(ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS, 0), compiler.For(VERTEX_SHADER));
+    const std::vector<uint8_t>& pixelBytes = loaded.FindOrCompile(ShaderBlobStore::GetCacheKey(PIXEL_SHADER, COMPILE_FLAGS, 0), compiler.For(PIXEL_SHADER));
+    CHECK_EQ(compiler.compiles, 2u);
+    CHECK_EQ(loaded.GetHits(), 2u);
+    CHECK(vertexBytes == *saved.Find(ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS, 0)));
+    CHECK(pixelBytes == *saved.Find(ShaderBlobStore::GetCacheKey(PIXEL_SHADER, COMPILE_FLAGS, 0)));
+    CHECK(vertexBytes != pixelBytes);
+
+    // saving what was loaded keeps every entry
+    ShaderBlobStore reloaded(COMPILER_VERSION);
+    CHECK(reloaded.Deserialize(loaded.Serialize()));
+    CHECK_EQ(reloaded.GetCount(), 2u);
+}
+
+TEST_CASE(OutdatedFilesAreRecompiled) {
+    FakeCompiler compiler;
+    const std::string file = Compiled(compiler).Serialize();
+
+    // the header is the magic, the file version and the compiler version as uint32
+    std::string wrongMagic = file;
+    wrongMagic[0] ^= 0x01;
+    std::string wrongVersion = file;
+    wrongVersion[4] ^= 0x01;
+    std::string truncated = file.substr(0, file.size() - 1);
+
+    for (const std::string& data : { wrongMagic, wrongVersion, truncated }) {
+        ShaderBlobStore loaded(COMPILER_VERSION);
+        CHECK(!loaded.Deserialize(data));
+        CHECK_EQ(loaded.GetCount(), 0u);
+    }
+
+    // a file from another compiler is refused as a whole, so every shader is compiled again
+    ShaderBlobStore otherCompiler(COMPILER_VERSION + 1);
+    CHECK(!otherCompiler.Deserialize(file));
+    const uint32_t compilesBefore = compiler.compiles;
+    otherCompiler.FindOrCompile(ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS, 0), compiler.For(VERTEX_SHADER));
+    otherCompiler.FindOrCompile(ShaderBlobStore::GetCacheKey(PIXEL_SHADER, COMPILE_FLAGS, 0), compiler.For(PIXEL_SHADER));
+    CHECK_EQ(compiler.compiles, compilesBefore + 2);
+    CHECK_EQ(otherCompiler.GetHits(), 0u);
+}
+
+TEST_CASE(CorruptedEntriesAreRecompiled) {
+    FakeCompiler compiler;
+    ShaderBlobStore saved(COMPILER_VERSION);
+    saved.FindOrCompile(ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS, 0), compiler.For(VERTEX_SHADER));
+    std::string file = saved.Serialize();
+
+    // flip a byte of the bytecode, which is at the end of the only entry
+    file[file.size() - 1] ^= 0x01;
+    ShaderBlobStore loaded(COMPILER_VERSION);
+    CHECK(loaded.Deserialize(file));
+    CHECK_EQ(loaded.GetRejectedCount(), 1u);
+    CHECK_EQ(loaded.GetCount(), 0u);
+
+    loaded.FindOrCompile(ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS, 0), compiler.For(VERTEX_SHADER));
+    CHECK_EQ(compiler.compiles, 2u);
+    CHECK_EQ(loaded.GetMisses(), 1u);
+}
+
+TEST_CASE(PermutationsGetDistinctKeys) {
+    // the same source with another entry point or profile, and the same shader with other compile flags or build configuration
+    const ShaderBlobStore::ShaderKey vertexAsPixel = { VERTEX_SHADER.sourceHash, VERTEX_SHADER.entryPoint, "ps_5_1" };
+    const ShaderBlobStore::ShaderKey otherEntry = { VERTEX_SHADER.sourceHash, "VSMainDepth", VERTEX_SHADER.profile };
+    const std::array keys = {
+        ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS, 0),
+        ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS, 1),
+        ShaderBlobStore::GetCacheKey(VERTEX_SHADER, COMPILE_FLAGS | 0x4, 0),
+        ShaderBlobStore::GetCacheKey(PIXEL_SHADER, COMPILE_FLAGS, 0),
+        ShaderBlobStore::GetCacheKey(vertexAsPixel, COMPILE_FLAGS, 0),
+        ShaderBlobStore::GetCacheKey(otherEntry, COMPILE_FLAGS, 0),
+    };
+    CHECK_EQ(std::unordered_set<uint64_t>(keys.begin(), keys.end()).size(), keys.size());
+
+    // fields are terminated, so moving characters between the entry point and the profile changes the key
+    const ShaderBlobStore::ShaderKey shifted = { 0, "VSMainv", "s_5_1" };
+    const ShaderBlobStore::ShaderKey unshifted = { 0, "VSMain", "vs_5_1" };
+    CHECK(shifted.Hash() != unshifted.Hash());
+
+    // the pipelines of both depth permutations and every swapchain format
+    std::unordered_set<uint64_t> pipelineKeys;
+    for (bool depth : { false, true }) {
+        for (uint32_t format : { 28u, 29u, 87u, 91u }) {
+            pipelineKeys.emplace(ShaderBlobStore::HashValues(VERTEX_SHADER.Hash(), PIXEL_SHADER.Hash(), depth, format));
+        }
+    }
+    CHECK_EQ(pipelineKeys.size(), 8u);
+}
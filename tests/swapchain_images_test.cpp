@@ -0,0 +1,258 @@
+#include "test.h"
+#include "rendering/swapchain_images.h"
+
+// a runtime with three images per swapchain that can be told to time out or to take a while, and remembers what was asked for
+struct MockRuntime {
+    static constexpr uint32_t IMAGE_COUNT = 3;
+
+    std::queue<XrResult> acquireResults;
+    std::queue<XrResult> waitResults;
+    std::chrono::microseconds waitDelay = {};
+
+    uint32_t acquires = 0;
+    uint32_t releases = 0;
+    uint32_t nextImage = 0;
+    std::vector<std::pair<XrSwapchain, XrDuration>> waits;
+
+    static XrResult Next(std::queue<XrResult>& results) {
+        if (results.empty()) {
+            return XR_SUCCESS;
+        }
+        XrResult result = results.front();
+        results.pop();
+        return result;
+    }
+};
+static MockRuntime s_runtime;
+
+XRAPI_ATTR XrResult XRAPI_CALL xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index) {
+    XrResult result = MockRuntime::Next(s_runtime.acquireResults);
+    if (result == XR_SUCCESS) {
+        s_runtime.acquires++;
+        *index = s_runtime.nextImage;
+        s_runtime.nextImage = (s_runtime.nextImage + 1) % MockRuntime::IMAGE_COUNT;
+    }
+    return result;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo) {
+    s_runtime.waits.emplace_back(swapchain, waitInfo->timeout);
+    if (s_runtime.waitDelay.count() > 0) {
+        std::this_thread::sleep_for(s_runtime.waitDelay);
+    }
+    return MockRuntime::Next(s_runtime.waitResults);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo) {
+    s_runtime.releases++;
+    return XR_SUCCESS;
+}
+
+static const XrSwapchain COLOR_SWAPCHAIN = (XrSwapchain)0x1;
+static const XrSwapchain DEPTH_SWAPCHAIN = (XrSwapchain)0x2;
+static constexpr XrDuration DISPLAY_PERIOD = 1'000'000'000 / 90;
+
+static void ResetRuntime() {
+    s_runtime = {};
+}
+
+static SwapchainDeadline MakeDeadline() {
+    return SwapchainDeadline::FromDisplayPeriod(DISPLAY_PERIOD);
+}
+
+TEST_CASE(ReleasingAcquiresTheNextImageAhead) {
+    ResetRuntime();
+    SwapchainImages images("Color");
+    images.SetHandle(COLOR_SWAPCHAIN);
+
+    CHECK(images.StartRendering(MakeDeadline()));
+    CHECK_EQ(s_runtime.acquires, 1u);
+    CHECK_EQ(images.GetImageIndex(), 0u);
+
+    images.FinishRendering();
+    CHECK_EQ(s_runtime.releases, 1u);
+    CHECK_EQ(s_runtime.acquires, 2u);
+    CHECK(images.IsAcquired());
+    CHECK(images.HasReleasedImage());
+    CHECK_EQ(images.GetImageIndex(), 1u);
+
+    // the next frame only waits for the image that was acquired ahead
+    CHECK(images.StartRendering(MakeDeadline()));
+    CHECK_EQ(s_runtime.acquires, 2u);
+    CHECK_EQ(s_runtime.waits.size(), 2u);
+
+    // preparing or starting again before the release doesn't call the runtime again
+    CHECK(images.PrepareRendering());
+    CHECK(images.StartRendering(MakeDeadline()));
+    CHECK_EQ(s_runtime.acquires, 2u);
+    CHECK_EQ(s_runtime.waits.size(), 2u);
+}
+
+TEST_CASE(ReleasingBeforeTheWaitThrows) {
+    ResetRuntime();
+    SwapchainImages images("Color");
+    images.SetHandle(COLOR_SWAPCHAIN);
+
+    images.PrepareRendering();
+    CHECK_THROWS(images.FinishRendering());
+    CHECK_EQ(s_runtime.releases, 0u);
+}
+
+TEST_CASE(TimedOutWaitIsRetriedForTheSameImage) {
+    ResetRuntime();
+    SwapchainImages images("Color");
+    images.SetHandle(COLOR_SWAPCHAIN);
+    s_runtime.waitResults.push(XR_TIMEOUT_EXPIRED);
+    s_runtime.waitResults.push(XR_TIMEOUT_EXPIRED);
+
+    // before the first release the layer has to be dropped, since the runtime has no image of it to show instead
+    CHECK(!images.StartRendering(MakeDeadline()));
+    CHECK(!images.HasReleasedImage());
+    CHECK(images.IsAcquired());
+    CHECK(!images.StartRendering(MakeDeadline()));
+    CHECK(images.StartRendering(MakeDeadline()));
+
+    CHECK_EQ(s_runtime.acquires, 1u);
+    CHECK_EQ(s_runtime.waits.size(), 3u);
+    CHECK_EQ(images.GetImageIndex(), 0u);
+
+    images.FinishRendering();
+    CHECK_EQ(s_runtime.releases, 1u);
+}
+
+TEST_CASE(TimedOutWaitAfterAReleaseKeepsTheLastImage) {
+    ResetRuntime();
+    SwapchainImages images("Color");
+    images.SetHandle(COLOR_SWAPCHAIN);
+
+    CHECK(images.StartRendering(MakeDeadline()));
+    images.FinishRendering();
+
+    // the runtime keeps showing image 0 while image 1 isn't ready, so nothing is released
+    s_runtime.waitResults.push(XR_TIMEOUT_EXPIRED);
+    CHECK(!images.StartRendering(MakeDeadline()));
+    CHECK(images.HasReleasedImage());
+    CHECK_EQ(s_runtime.releases, 1u);
+    CHECK_EQ(images.GetImageIndex(), 1u);
+
+    CHECK(images.StartRendering(MakeDeadline()));
+    CHECK_EQ(images.GetImageIndex(), 1u);
+    CHECK_EQ(s_runtime.acquires, 2u);
+}
+
+TEST_CASE(TimedOutAcquireIsTriedAgain) {
+    ResetRuntime();
+    SwapchainImages images("Color");
+    images.SetHandle(COLOR_SWAPCHAIN);
+    s_runtime.acquireResults.push(XR_TIMEOUT_EXPIRED);
+
+    // nothing can be waited for without an image
+    CHECK(!images.StartRendering(MakeDeadline()));
+    CHECK(!images.IsAcquired());
+    CHECK(s_runtime.waits.empty());
+
+    CHECK(images.StartRendering(MakeDeadline()));
+    CHECK_EQ(s_runtime.acquires, 1u);
+    CHECK_EQ(s_runtime.waits.size(), 1u);
+
+    // the acquire ahead can time out as well, the release still went through
+    s_runtime.acquireResults.push(XR_TIMEOUT_EXPIRED);
+    images.FinishRendering();
+    CHECK_EQ(s_runtime.releases, 1u);
+    CHECK(!images.IsAcquired());
+    CHECK(images.StartRendering(MakeDeadline()));
+    CHECK_EQ(s_runtime.acquires, 2u);
+}
+
+TEST_CASE(FailedCallsThrow) {
+    ResetRuntime();
+    SwapchainImages images("Color");
+    images.SetHandle(COLOR_SWAPCHAIN);
+
+    s_runtime.acquireResults.push(XR_ERROR_SESSION_LOST);
+    CHECK_THROWS(images.PrepareRendering());
+
+    s_runtime.waitResults.push(XR_ERROR_SESSION_LOST);
+    CHECK_THROWS(images.StartRendering(MakeDeadline()));
+}
+
+TEST_CASE(DeadlineIsHalfTheDisplayPeriod) {
+    const XrDuration remaining = SwapchainDeadline::FromDisplayPeriod(DISPLAY_PERIOD).GetRemaining();
+    CHECK(remaining <= DISPLAY_PERIOD / 2);
+    CHECK(remaining > DISPLAY_PERIOD / 2 - 1'000'000);
+
+    // a runtime that hasn't predicted a period yet gets the one of a 90Hz headset
+    const XrDuration fallback = SwapchainDeadline::FromDisplayPeriod(0).GetRemaining();
+    CHECK(fallback <= DISPLAY_PERIOD / 2);
+    CHECK(fallback > DISPLAY_PERIOD / 2 - 1'000'000);
+
+    const SwapchainDeadline passed(SwapchainDeadline::Clock::now() - std::chrono::milliseconds(1));
+    CHECK_EQ(passed.GetRemaining(), 0);
+}
+
+TEST_CASE(SlowWaitsShareTheDeadline) {
+    ResetRuntime();
+    SwapchainImages color("Color");
+    color.SetHandle(COLOR_SWAPCHAIN);
+    SwapchainImages depth("Depth");
+    depth.SetHandle(DEPTH_SWAPCHAIN);
+    s_runtime.waitDelay = std::chrono::milliseconds(2);
+
+    const SwapchainDeadline deadline = MakeDeadline();
+    CHECK(color.StartRendering(deadline));
+    CHECK(depth.StartRendering(deadline));
+
+    // the depth swapchain only gets what the slow color wait left over
+    CHECK_EQ(s_runtime.waits.size(), 2u);
+    CHECK_EQ(s_runtime.waits[0].first, COLOR_SWAPCHAIN);
+    CHECK_EQ(s_runtime.waits[1].first, DEPTH_SWAPCHAIN);
+    CHECK(s_runtime.waits[0].second <= DISPLAY_PERIOD / 2);
+    CHECK(s_runtime.waits[1].second <= s_runtime.waits[0].second - 2'000'000);
+}
+
+TEST_CASE(HistogramBucketsDoubleUntilTheLastOne) {
+    using Ms = std::chrono::duration<double, std::milli>;
+    LatencyHistogram histogram;
+    histogram.Record(Ms(0.1));
+    histogram.Record(Ms(0.125));
+    histogram.Record(Ms(0.2));
+    histogram.Record(Ms(1.0));
+    histogram.Record(Ms(15.9));
+    histogram.Record(Ms(16.0));
+    histogram.Record(Ms(100.0));
+
+    const std::array<uint32_t, LatencyHistogram::BUCKET_COUNT> expected = { 1, 2, 0, 0, 1, 0, 0, 1, 2 };
+    CHECK(histogram.GetBuckets() == expected);
+    CHECK_EQ(histogram.GetCount(), 7u);
+    CHECK_NEAR(histogram.GetMaxMs(), 100.0, 1e-9);
+    CHECK_NEAR(LatencyHistogram::GetBucketBoundMs(0), 0.125, 1e-9);
+    CHECK_NEAR(LatencyHistogram::GetBucketBoundMs(LatencyHistogram::BUCKET_COUNT - 2), 16.0, 1e-9);
+    CHECK(histogram.ToString().starts_with("<0.125ms: 1, <0.25ms: 2, <2ms: 1, <16ms: 1, >=16ms: 2 (max "));
+    CHECK(LatencyHistogram().ToString().starts_with("none (max "));
+}
+
+TEST_CASE(StatsCoverTheLastWindowOfReleases) {
+    ResetRuntime();
+    SwapchainImages images("Color");
+    images.SetHandle(COLOR_SWAPCHAIN);
+
+    s_runtime.waitResults.push(XR_TIMEOUT_EXPIRED);
+    CHECK(!images.StartRendering(MakeDeadline()));
+    for (uint32_t i = 0; i < SwapchainStats::WINDOW - 1; i++) {
+        CHECK(images.StartRendering(MakeDeadline()));
+        images.FinishRendering();
+    }
+    CHECK_EQ(images.GetStats().waitLatency.GetCount(), 0u);
+
+    CHECK(images.StartRendering(MakeDeadline()));
+    images.FinishRendering();
+    const SwapchainStats stats = images.GetStats();
+    CHECK_EQ(stats.timeouts, 1u);
+    CHECK_EQ(stats.waitLatency.GetCount(), SwapchainStats::WINDOW + 1);
+    CHECK_EQ(stats.acquireLatency.GetCount(), SwapchainStats::WINDOW);
+
+    // the acquire ahead of the last release already counts towards the next window
+    CHECK(images.StartRendering(MakeDeadline()));
+    images.FinishRendering();
+    CHECK_EQ(images.GetStats().timeouts, 1u);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+// every test executable is a list of cases that are run in order, a case keeps going after a failed check so that all of them are printed
+
+namespace Test {
+    struct Case {
+        const char* name;
+        void (*run)();
+    };
+
+    inline std::vector<Case>& GetCases() {
+        static std::vector<Case> cases;
+        return cases;
+    }
+
+    inline uint32_t& GetFailures() {
+        static uint32_t failures = 0;
+        return failures;
+    }
+
+    struct Register {
+        Register(const char* name, void (*run)()) { GetCases().push_back({ name, run }); }
+    };
+
+    inline void Fail(const char* file, int line, const std::string& message) {
+        std::fprintf(stderr, "%s:%d: %s\n", file, line, message.c_str());
+        GetFailures()++;
+    }
+}
+
+#define TEST_CASE(name)                                            \
+    static void name();                                            \
+    static const Test::Register name##_register(#name, &name);    \
+    static void name()
+
+#define CHECK(condition)                                                \
+    do {                                                                \
+        if (!(condition)) Test::Fail(__FILE__, __LINE__, #condition);   \
+    } while (false)
+
+#define CHECK_EQ(actual, expected)                                                                                          \
+    do {                                                                                                                    \
+        const auto& actualValue = (actual);                                                                                 \
+        const auto& expectedValue = (expected);                                                                             \
+        if (!(actualValue == expectedValue)) Test::Fail(__FILE__, __LINE__, std::format("{} == {}", #actual, #expected));  \
+    } while (false)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                                                                         \
+    do {                                                                                                                                                \
+        const double actualValue = (double)(actual);                                                                                                    \
+        const double expectedValue = (double)(expected);                                                                                                \
+        if (!(std::abs(actualValue - expectedValue) <= (double)(tolerance)))                                                                            \
+            Test::Fail(__FILE__, __LINE__, std::format("{} is {}, expected {} within {}", #actual, actualValue, expectedValue, (double)(tolerance)));   \
+    } while (false)
+
+#define CHECK_THROWS(expression)                                                        \
+    do {                                                                                \
+        bool hasThrown = false;                                                         \
+        try { (void)(expression); } catch (const std::exception&) { hasThrown = true; } \
+        if (!hasThrown) Test::Fail(__FILE__, __LINE__, #expression " didn't throw");   \
+    } while (false)
@@ -0,0 +1,15 @@
+#include "test.h"
+
+int main() {
+    for (const Test::Case& testCase : Test::GetCases()) {
+        const uint32_t failuresBefore = Test::GetFailures();
+        try {
+            testCase.run();
+        }
+        catch (const std::exception& e) {
+            Test::Fail(__FILE__, __LINE__, std::format("{} threw: {}", testCase.name, e.what()));
+        }
+        std::printf("%s %s\n", Test::GetFailures() == failuresBefore ? "[pass]" : "[FAIL]", testCase.name);
+    }
+    return Test::GetFailures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+// stands in for include/pch.h when the modules that don't touch Windows, D3D12 or the vulkan layer are built on their own.
+// it has the same std, vulkan, OpenXR, glm and imgui setup, and a logger that throws on assertions instead of showing a message box.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <queue>
+#include <iostream>
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan_core.h>
+
+#include <openxr/openxr.h>
+
+#define GLM_FORCE_XYZW_ONLY
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_access.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/norm.hpp>
+#include <glm/gtx/string_cast.hpp>
+#include <glm/gtx/euler_angles.hpp>
+#undef GLM_ENABLE_EXPERIMENTAL
+
+#include "xr_glm.h"
+
+#include <imgui.h>
+
+template <typename T1, typename T2>
+constexpr bool HAS_FLAG(T1 flags, T2 test_flag) {
+    return ((uint64_t)(flags) & (uint64_t)test_flag) == (uint64_t)(test_flag);
+}
+
+// the modules only ask Windows for the folder of Cemu's executable, without one the files are looked up in the working directory
+constexpr uint32_t MAX_PATH = 260;
+inline uint32_t GetModuleFileNameA(void* module, char* path, uint32_t size) {
+    return 0;
+}
+
+enum class LogType {
+    // verbose logging types
+    RENDERING,
+    INTEROP,
+    CONTROLS,
+    PPC,
+    XR_DEBUGUTILS,
+
+    // generic types
+    INFO,
+    WARNING,
+    ERROR,
+    VERBOSE
+};
+
+using enum LogType;
+
+// only warnings and errors are printed, so that a failing test shows what the module complained about
+class Log {
+public:
+    template <LogType L>
+    static consteval bool isLogTypeEnabled() {
+        return L == ERROR || L == WARNING;
+    }
+
+    template <LogType L>
+    static inline void print(const char* message) {
+        if constexpr (isLogTypeEnabled<L>()) {
+            std::fprintf(stderr, "%s\n", message);
+        }
+    }
+
+    template <LogType L, class... Args>
+    static inline void print(const char* format, Args&&... args) {
+        if constexpr (isLogTypeEnabled<L>()) {
+            Log::print<L>(std::vformat(format, std::make_format_args(args...)).c_str());
+        }
+    }
+};
+
+// the barrier planner records through vkroots' dispatch tables, which keep the barriers here so that the tests can check them
+namespace vkroots::tables {
+    struct RecordingCommandBufferDispatch {
+        std::vector<std::vector<VkImageMemoryBarrier2>> pipelineBarriers;
+
+        void CmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfo* pDependencyInfo) {
+            pipelineBarriers.emplace_back(pDependencyInfo->pImageMemoryBarriers, pDependencyInfo->pImageMemoryBarriers + pDependencyInfo->imageMemoryBarrierCount);
+        }
+    };
+
+    struct RecordingCommandBufferDispatches {
+        RecordingCommandBufferDispatch dispatch;
+
+        RecordingCommandBufferDispatch* find(VkCommandBuffer commandBuffer) { return &dispatch; }
+    };
+
+    inline RecordingCommandBufferDispatches CommandBufferDispatches;
+}
+
+// the descriptor arena only passes these through to its backend, so opaque stand-ins are enough to drive it with a fake one
+struct ID3D12Device;
+struct ID3D12Resource;
+struct ID3D12DescriptorHeap;
+enum DXGI_FORMAT : uint32_t {
+    DXGI_FORMAT_UNKNOWN = 0,
+    DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+    DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+    DXGI_FORMAT_D32_FLOAT = 40,
+    DXGI_FORMAT_R32_FLOAT = 41,
+};
+struct D3D12_CPU_DESCRIPTOR_HANDLE {
+    size_t ptr;
+};
+struct D3D12_GPU_DESCRIPTOR_HANDLE {
+    uint64_t ptr;
+};
+
+static void checkXRResult(const XrResult result, const char* errorMessage) {
+    if (XR_FAILED(result)) {
+        throw std::runtime_error(std::format("Error {}: {}", (int32_t)result, errorMessage == nullptr ? "Unidentified error occurred!" : errorMessage));
+    }
+}
+
+static void checkAssert(const bool assert, const char* errorMessage) {
+    if (!assert) {
+        throw std::runtime_error(errorMessage == nullptr ? "Unexpected assertion occurred!" : errorMessage);
+    }
+}